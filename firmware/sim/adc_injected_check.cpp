@@ -0,0 +1,226 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  ADC injected channels check: configures injected channels through
+ *         the Data API (owntech_spin_api DataAPI.cpp) and the ADC driver
+ *         (owntech_adc_driver adc.c and adc_core.c) on the fake register
+ *         blocks of fakes/adc/stm32_ll_adc.h, starts the ADCs and checks
+ *         JSQR: sequence length (JL), channel of each rank (JSQ1 to JSQ4),
+ *         trigger (JEXTSEL) and edge (JEXTEN), for 1 to 4 channels. PWM
+ *         triggers of ADC 1 and ADC 2 must select HRTIM ADC triggers 2
+ *         and 4, and a fifth channel must be rejected.
+ *
+ *         Then writes codes to the injected data registers of ADC 1 and
+ *         checks the values returned by getInjectedValue(): injected
+ *         conversions are not oversampled, so they must be rescaled by the
+ *         extra bits of the regular oversampling of the ADC and converted
+ *         like regular values.
+ *
+ *         Usage: adc_injected_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+
+#include "SpinAPI.h"
+#include "adc.h"
+#include "data_conversion.h"
+#include "stm32_ll_adc.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t field(uint32_t reg, uint32_t mask, uint32_t pos)
+{
+    return (reg & mask) >> pos;
+}
+
+static uint32_t jsq(uint32_t jsqr, uint8_t rank)
+{
+    static const uint32_t positions[] = {ADC_JSQR_JSQ1_Pos, ADC_JSQR_JSQ2_Pos,
+                                         ADC_JSQR_JSQ3_Pos, ADC_JSQR_JSQ4_Pos};
+    return (jsqr >> positions[rank - 1]) & ADC_JSQR_JSQx_Msk;
+}
+
+/* Spin pins acquired as injected on ADC 1 and ADC 2, and their channels */
+static const uint8_t adc1_pins[] = {29, 30};
+static const uint8_t adc1_channels[] = {1, 2};
+static const uint8_t adc2_pin = 34;
+static const uint8_t adc2_channel = 3;
+
+/* Channels added to ADC 3 and ADC 4 through the ADC driver */
+static const uint8_t adc3_channels[] = {4, 9, 11};
+static const uint8_t adc4_channels[] = {2, 6, 15, 17};
+
+static void check_jsqr(const char* adc, uint32_t jsqr,
+                       const uint8_t* channels, uint8_t count,
+                       uint32_t trigger)
+{
+    char what[96];
+
+    snprintf(what, sizeof(what), "%s: JL for %u channels", adc, count);
+    check(field(jsqr, ADC_JSQR_JL, ADC_JSQR_JL_Pos) == (uint32_t)(count - 1),
+          what);
+
+    /* Unused ranks repeat the first channel */
+    for (uint8_t rank = 1 ; rank <= 4 ; rank++) {
+        uint8_t channel = (rank <= count) ? channels[rank - 1] : channels[0];
+        snprintf(what, sizeof(what), "%s: JSQ%u channel %u", adc, rank,
+                 channel);
+        check(jsq(jsqr, rank) == channel, what);
+    }
+
+    snprintf(what, sizeof(what), "%s: JEXTSEL", adc);
+    check((jsqr & ADC_JSQR_JEXTSEL) == trigger, what);
+
+    /* Software triggers leave the external trigger disabled */
+    uint32_t edge = (trigger != LL_ADC_INJ_TRIG_SOFTWARE)
+                    ? LL_ADC_INJ_TRIG_EXT_RISING : 0;
+    snprintf(what, sizeof(what), "%s: JEXTEN", adc);
+    check((jsqr & ADC_JSQR_JEXTEN) == edge, what);
+}
+
+static void configure()
+{
+    for (uint8_t pin : adc1_pins) {
+        check(spin.data.enableInjectedAcquisition(pin, ADC_1) == 0,
+              "ADC 1 injected pin enabled");
+    }
+    check(spin.data.configureInjectedTriggerSource(ADC_1, TRIG_PWM) == 0,
+          "ADC 1 PWM trigger");
+
+    check(spin.data.enableInjectedAcquisition(adc2_pin, ADC_2) == 0,
+          "ADC 2 injected pin enabled");
+    check(spin.data.configureInjectedTriggerSource(ADC_2, TRIG_PWM) == 0,
+          "ADC 2 PWM trigger");
+    check(spin.data.configureInjectedTriggerSource(ADC_3, TRIG_PWM) != 0,
+          "no PWM trigger for ADC 3");
+
+    for (uint8_t channel : adc3_channels) {
+        adc_add_injected_channel(3, channel);
+    }
+    adc_configure_injected_trigger_source(3, software);
+
+    for (uint8_t rank = 1 ; rank <= 4 ; rank++) {
+        check(adc_add_injected_channel(4, adc4_channels[rank - 1]) == rank,
+              "ADC 4 channel added at its rank");
+    }
+    check(adc_add_injected_channel(4, 3) < 0, "fifth channel rejected");
+    check(adc_get_injected_channels_count(4) == 4, "ADC 4 keeps 4 channels");
+    check(adc_get_injected_data_register(4, 5) == nullptr,
+          "no data register for a fifth rank");
+    adc_configure_injected_trigger_source(4, hrtim_ev5);
+}
+
+static void check_sequences()
+{
+    check_jsqr("ADC 1", ADC1->JSQR, adc1_channels, 2,
+               LL_ADC_INJ_TRIG_EXT_HRTIM_TRG2);
+    check_jsqr("ADC 2", ADC2->JSQR, &adc2_channel, 1,
+               LL_ADC_INJ_TRIG_EXT_HRTIM_TRG4);
+    check_jsqr("ADC 3", ADC3->JSQR, adc3_channels, 3,
+               LL_ADC_INJ_TRIG_SOFTWARE);
+    check_jsqr("ADC 4", ADC4->JSQR, adc4_channels, 4,
+               LL_ADC_INJ_TRIG_EXT_HRTIM_TRG5);
+    check(ADC5->JSQR == 0, "ADC 5 without injected channels left untouched");
+}
+
+/* Values of ADC 1 injected pins for every code, with the extra bits of an
+ * oversampling configuration */
+static void check_values(uint16_t ratio, uint8_t shift, int8_t extra_bits)
+{
+    const float32_t gain = 0.5F;
+    const float32_t offset = -3.0F;
+    char what[96];
+
+    check(spin.data.configureOversampling(ADC_1, ratio, shift, false) == 0,
+          "ADC 1 oversampling");
+    check(spin.data.start() == 0, "started");
+    check(adc_get_oversampling_extra_bits(1) == extra_bits,
+          "ADC 1 extra bits");
+
+    /* After start, which initializes conversion */
+    for (uint8_t channel : adc1_channels) {
+        data_conversion_set_conversion_parameters_linear(1, channel, gain,
+                                                         offset);
+    }
+
+    volatile uint32_t* jdr[] = {&ADC1->JDR1, &ADC1->JDR2};
+    for (uint16_t code = 0 ; code < 4096 ; code++) {
+        for (uint8_t i = 0 ; i < 2 ; i++) {
+            *jdr[i] = code ^ (i * 0xA5);
+        }
+        for (uint8_t i = 0 ; i < 2 ; i++) {
+            uint16_t written = code ^ (i * 0xA5);
+
+            /* Bits below the regular resolution are lost */
+            uint16_t kept = (extra_bits >= 0)
+                            ? written
+                            : (uint16_t)((written >> -extra_bits)
+                                         << -extra_bits);
+            float32_t expected = kept * gain + offset;
+
+            uint8_t valid = DATA_IS_MISSING;
+            check(spin.data.getInjectedRawValue(adc1_pins[i], &valid)
+                  == written, "raw value is the data register");
+            float32_t value = spin.data.getInjectedValue(adc1_pins[i],
+                                                         &valid);
+            snprintf(what, sizeof(what),
+                     "ratio %u shift %u: pin %u code %u value %g, expected %g",
+                     ratio, shift, adc1_pins[i], written, value, expected);
+            check(valid == DATA_IS_OK && value == expected, what);
+        }
+    }
+
+    check(spin.data.stop() == 0, "stopped");
+}
+
+int main()
+{
+    configure();
+
+    check(spin.data.start() == 0, "started");
+    check_sequences();
+    check(spin.data.enableInjectedAcquisition(31, ADC_1) != 0,
+          "no injected pin added once started");
+    check(spin.data.stop() == 0, "stopped");
+
+    /* 4 extra bits, then 2 bits discarded by the shift */
+    check_values(16, 0, 4);
+    check_values(2, 3, -2);
+
+    uint8_t valid = DATA_IS_OK;
+    check(spin.data.getInjectedValue(24, &valid) == NO_VALUE
+          && valid == DATA_IS_MISSING, "pin without injected acquisition");
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  ADC oversampling check: configures oversampling through the ADC
+ *         driver (owntech_adc_driver adc.c and adc_core.c) on the fake
+ *         register blocks of fakes/adc/stm32_ll_adc.h, starts the ADCs and
+ *         checks the ratio (OVSR), shift (OVSS), regular oversampling
+ *         enable (ROVSE) and triggered mode (TROVS) fields of CFGR2, for
+ *         every ratio and shift. Shifts too small for the sum to fit the
+ *         16-bit data register must be increased by the driver.
+ *
+ *         Usage: adc_oversampling_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+
+#include "adc.h"
+#include "stm32_ll_adc.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static uint32_t field(uint32_t reg, uint32_t mask, uint32_t pos)
+{
+    return (reg & mask) >> pos;
+}
+
+/* CFGR2 of ADC 1 after a start with the given configuration */
+static uint32_t started_cfgr2(uint16_t ratio, uint8_t shift, bool triggered)
+{
+    check(adc_configure_oversampling(1, ratio, shift, triggered) == 0,
+          "valid configuration accepted");
+    adc_start();
+    uint32_t cfgr2 = ADC1->CFGR2;
+    adc_stop();
+    return cfgr2;
+}
+
+static void check_ratios()
+{
+    char what[96];
+
+    for (uint8_t ratio_bits = 1 ; ratio_bits <= 8 ; ratio_bits++) {
+        uint16_t ratio = 1 << ratio_bits;
+        for (uint8_t shift = 0 ; shift <= 8 ; shift++) {
+            for (int triggered = 0 ; triggered <= 1 ; triggered++) {
+                uint32_t cfgr2 = started_cfgr2(ratio, shift, triggered);
+
+                /* Sum of ratio 12-bit codes on 16 bits at most */
+                uint8_t expected_shift = shift;
+                if (ratio_bits > shift + 4) {
+                    expected_shift = ratio_bits - 4;
+                }
+
+                snprintf(what, sizeof(what),
+                         "ratio %u shift %u triggered %d: OVSR",
+                         ratio, shift, triggered);
+                check(field(cfgr2, ADC_CFGR2_OVSR, ADC_CFGR2_OVSR_Pos)
+                      == (uint32_t)(ratio_bits - 1), what);
+
+                snprintf(what, sizeof(what),
+                         "ratio %u shift %u triggered %d: OVSS %u",
+                         ratio, shift, triggered, expected_shift);
+                check(field(cfgr2, ADC_CFGR2_OVSS, ADC_CFGR2_OVSS_Pos)
+                      == expected_shift, what);
+
+                snprintf(what, sizeof(what),
+                         "ratio %u shift %u triggered %d: ROVSE",
+                         ratio, shift, triggered);
+                check((cfgr2 & ADC_CFGR2_ROVSE) != 0, what);
+
+                snprintf(what, sizeof(what),
+                         "ratio %u shift %u triggered %d: TROVS",
+                         ratio, shift, triggered);
+                check(((cfgr2 & ADC_CFGR2_TROVS) != 0) == (triggered != 0),
+                      what);
+
+                snprintf(what, sizeof(what),
+                         "ratio %u shift %u triggered %d: extra bits",
+                         ratio, shift, triggered);
+                check(adc_get_oversampling_extra_bits(1)
+                      == ratio_bits - expected_shift, what);
+            }
+        }
+    }
+}
+
+static void check_disable()
+{
+    uint32_t cfgr2 = started_cfgr2(1, 0, false);
+    check((cfgr2 & ADC_CFGR2_ROVSE) == 0, "ratio 1 disables oversampling");
+    check(adc_get_oversampling_extra_bits(1) == 0, "ratio 1 extra bits");
+}
+
+/* Invalid configurations are rejected and leave the previous one */
+static void check_invalid()
+{
+    uint32_t cfgr2 = started_cfgr2(16, 2, true);
+
+    check(adc_configure_oversampling(1, 0, 0, false) != 0, "ratio 0");
+    check(adc_configure_oversampling(1, 3, 0, false) != 0, "ratio 3");
+    check(adc_configure_oversampling(1, 512, 0, false) != 0, "ratio 512");
+    check(adc_configure_oversampling(1, 16, 9, false) != 0, "shift 9");
+    check(adc_configure_oversampling(0, 16, 0, false) != 0, "ADC 0");
+    check(adc_configure_oversampling(6, 16, 0, false) != 0, "ADC 6");
+
+    adc_start();
+    check(ADC1->CFGR2 == cfgr2, "configuration kept after invalid ones");
+    adc_stop();
+}
+
+/* Oversampling is only applied to ADCs with enabled channels */
+static void check_unused_adc()
+{
+    check(adc_configure_oversampling(3, 16, 0, false) == 0,
+          "ADC 3 configuration accepted");
+    adc_start();
+    check(ADC3->CFGR2 == 0, "ADC without channels left untouched");
+    adc_stop();
+}
+
+int main()
+{
+    adc_add_channel(1, 1);
+
+    check_ratios();
+    check_disable();
+    check_invalid();
+    check_unused_adc();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,757 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Data dispatch check: replays ADC conversions through the DMA
+ *         model of fakes/adc_dma_model.h into data dispatch
+ *         (owntech_spin_api data_dispatch.cpp), and checks the values read
+ *         from each channel against the converted ones: dispatch on DMA
+ *         interrupt, full buffers, dispatch callback and its repetitions,
+ *         buffers filled again while the callback runs, dispatch at task
+ *         start, the latest DMA word of each channel, ADC 1 and
+ *         ADC 2 values packed in the same DMA words in dual mode, and
+ *         DMA buffers freed on init and on allocation failures.
+ *
+ *         With the benchmark argument, times data_dispatch_do_dispatch()
+ *         instead, on a DMA buffer of ADC 1 replayed on interrupt and at
+ *         task start, including reads of the channel buffers before they
+ *         are full, and compares it with the dispatch loop used before
+ *         the dispatch kernels, which found the channel of every DMA
+ *         value with a modulo. Dispatch times also include the timestamp
+ *         and timing statistics of each dispatch, which the loop does not
+ *         have. As for trig_benchmark, host times only rank the
+ *         implementations: they are not the cycle counts of the board.
+ *
+ *         Usage: data_dispatch_check [benchmark [dispatches]]
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include <zephyr/kernel.h>
+
+#include "data_dispatch.h"
+#include "dma.h"
+#include "adc_dma_model.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static const uint8_t ADCS = 5;
+static const uint8_t MAX_RANKS = 8;
+
+/* Converted values of each channel, and number of them already read */
+static std::vector<uint16_t> converted[ADCS][MAX_RANKS];
+static size_t read_count[ADCS][MAX_RANKS];
+static uint8_t channels_count[ADCS];
+static uint8_t next_rank[ADCS];
+static bool dual_mode = false;
+
+/* Pseudo-random sequence, the same on every run */
+static uint32_t random_state = 1;
+
+static uint32_t next_random()
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7FFF;
+}
+
+/* ADC, rank and index in the upper bits: never PEEK_NO_VALUE */
+static uint16_t sample_value(uint8_t adc_number, uint8_t rank, size_t index)
+{
+    return (uint16_t)((adc_number << 12) | (rank << 8) | (index & 0xFF));
+}
+
+static void setup(const uint8_t (&counts)[ADCS], dispatch_t method,
+                  uint32_t repetitions, bool dual = false)
+{
+    adc_dma_model_reset();
+    adc_dma_model_set_dual_mode(dual);
+    dual_mode = dual;
+    for (uint8_t index = 0; index < ADCS; index++) {
+        channels_count[index] = counts[index];
+        next_rank[index] = 0;
+        adc_dma_model_set_channels(index + 1, counts[index]);
+        for (uint8_t rank = 0; rank < MAX_RANKS; rank++) {
+            converted[index][rank].clear();
+            read_count[index][rank] = 0;
+        }
+    }
+    check(data_dispatch_init(method, repetitions) == 0, "init");
+}
+
+/* Next value of the next channel of an ADC */
+static uint16_t next_value(uint8_t adc_number)
+{
+    uint8_t index = adc_number - 1;
+    uint8_t rank = next_rank[index] + 1;
+    next_rank[index] = rank % channels_count[index];
+
+    std::vector<uint16_t> &values = converted[index][rank - 1];
+    uint16_t value = sample_value(adc_number, rank, values.size());
+    values.push_back(value);
+
+    return value;
+}
+
+/* Convert the next channel of an ADC, and of ADC 2 along ADC 1 in dual mode */
+static void convert(uint8_t adc_number)
+{
+    uint16_t value = next_value(adc_number);
+    uint16_t slave_value = 0;
+    if (dual_mode && adc_number == 1) {
+        slave_value = next_value(2);
+    }
+
+    adc_dma_model_convert(adc_number, value, slave_value);
+}
+
+/* Convert all the channels of an ADC, as after one trigger */
+static void convert_sequence(uint8_t adc_number)
+{
+    for (uint8_t rank = 0; rank < channels_count[adc_number - 1]; rank++) {
+        convert(adc_number);
+    }
+}
+
+/**
+ * Read a channel, compare with the values dispatched since the previous
+ * read: when more than a buffer was dispatched, the buffer holds the
+ * first ones, its last value being the latest one.
+ */
+static bool read_channel(uint8_t adc_number, uint8_t rank, size_t dispatched)
+{
+    uint8_t index = adc_number - 1;
+    const std::vector<uint16_t> &values = converted[index][rank - 1];
+    size_t first = read_count[index][rank - 1];
+    size_t expected = dispatched - first;
+
+    uint32_t count = 0;
+    uint16_t* data = data_dispatch_get_acquired_values(adc_number, rank,
+                                                       count);
+    read_count[index][rank - 1] = dispatched;
+
+    if (expected == 0) {
+        return data == nullptr && count == 0;
+    }
+    if (data == nullptr) {
+        return false;
+    }
+    if (expected > CHANNELS_BUFFERS_SIZE) {
+        if (count != CHANNELS_BUFFERS_SIZE
+            || data[CHANNELS_BUFFERS_SIZE - 1] != values[dispatched - 1]) {
+            return false;
+        }
+        expected = CHANNELS_BUFFERS_SIZE - 1;
+    } else if (count != expected) {
+        return false;
+    }
+    for (size_t value = 0; value < expected; value++) {
+        if (data[value] != values[first + value]) {
+            return false;
+        }
+    }
+    return data_dispatch_peek_acquired_value(adc_number, rank)
+           == values[dispatched - 1];
+}
+
+/* On interrupt, each dispatch adds one value to every channel */
+static bool read_interrupt_channel(uint8_t adc_number, uint8_t rank)
+{
+    return read_channel(adc_number, rank,
+                        adc_dma_model_get_interrupts(adc_number));
+}
+
+static void check_interrupt_dispatch()
+{
+    const uint8_t counts[ADCS] = {3, 2, 0, 1, 0};
+    setup(counts, interrupt, 0);
+    uint32_t sequence = data_dispatch_get_sequence();
+
+    uint32_t count = 0;
+    check(data_dispatch_get_acquired_values(3, 1, count) == nullptr,
+          "no data for an ADC without channels");
+    check(data_dispatch_peek_acquired_value(1, 1) == PEEK_NO_VALUE,
+          "no value peeked before the first dispatch");
+
+    const uint8_t adcs[] = {1, 2, 4};
+    uint32_t errors = 0;
+    for (uint32_t step = 0; step < 5000; step++) {
+        uint8_t adc_number = adcs[next_random() % sizeof(adcs)];
+        if (next_random() % 4 != 0) {
+            convert(adc_number);
+            continue;
+        }
+        uint8_t rank = next_random() % channels_count[adc_number - 1] + 1;
+        if (!read_interrupt_channel(adc_number, rank)) {
+            errors++;
+        }
+    }
+    check(errors == 0, "values read match the converted ones on interrupt");
+    check(data_dispatch_get_sequence() - sequence
+          == adc_dma_model_get_interrupts(1),
+          "sequence counts the dispatches of the first ADC on interrupt");
+
+    for (uint8_t sequence = 0; sequence < 2 * CHANNELS_BUFFERS_SIZE;
+         sequence++) {
+        convert_sequence(1);
+    }
+    bool full = true;
+    for (uint8_t rank = 1; rank <= channels_count[0]; rank++) {
+        full = read_interrupt_channel(1, rank) && full;
+    }
+    check(full, "full buffers keep the latest value");
+}
+
+static void check_sequence()
+{
+    const uint8_t counts[ADCS] = {0, 2, 1, 0, 0};
+    setup(counts, interrupt, 0);
+
+    uint32_t sequence = data_dispatch_get_sequence();
+    for (uint8_t cycle = 0; cycle < 20; cycle++) {
+        convert_sequence(3);
+        convert_sequence(2);
+    }
+    check(data_dispatch_get_sequence() == sequence + 20,
+          "sequence counts the cycles without ADC 1 channels");
+}
+
+static uint32_t callback_calls = 0;
+static bool callback_fresh = true;
+static bool callback_pending = false;
+static bool convert_in_callback = false;
+
+/* Latest converted value of each ADC 1 channel must be dispatched */
+static void dispatch_callback()
+{
+    callback_calls++;
+    for (uint8_t rank = 1; rank <= channels_count[0]; rank++) {
+        callback_fresh = callback_fresh
+                         && data_dispatch_peek_acquired_value(1, rank)
+                            == converted[0][rank - 1].back();
+    }
+
+    /* Slow callback: next buffer filled before it returns */
+    if (convert_in_callback) {
+        convert_in_callback = false;
+        convert_sequence(1);
+        callback_pending = data_dispatch_is_callback_dispatch_pending();
+    }
+}
+
+static void check_dispatch_callback()
+{
+    const uint8_t counts[ADCS] = {3, 2, 0, 0, 0};
+    setup(counts, interrupt, 0);
+
+    check(data_dispatch_set_dispatch_callback(3, dispatch_callback, 1) == -1,
+          "no callback on an ADC without channels");
+    check(data_dispatch_set_dispatch_callback(1, dispatch_callback, 0) == -1,
+          "no callback without repetitions");
+    check(data_dispatch_set_dispatch_callback(1, dispatch_callback, 3) == 0,
+          "callback every 3 dispatches");
+
+    for (uint8_t sequence = 0; sequence < 30; sequence++) {
+        convert_sequence(1);
+        convert_sequence(2);
+        check(!data_dispatch_is_callback_dispatch_pending(),
+              "no dispatch pending between interrupts");
+    }
+    check(callback_calls == 10, "callback called every 3 dispatches");
+    check(callback_fresh, "callback sees the latest values");
+
+    /* Buffer filled again while the callback runs */
+    check(data_dispatch_set_dispatch_callback(1, dispatch_callback, 1) == 0,
+          "callback on every dispatch");
+    callback_calls = 0;
+    convert_in_callback = true;
+    convert_sequence(1);
+    check(callback_pending, "slow callback sees the next buffer pending");
+    check(callback_calls == 2, "pending buffer is dispatched after it");
+
+    bool replayed = true;
+    for (uint8_t rank = 1; rank <= channels_count[0]; rank++) {
+        replayed = read_interrupt_channel(1, rank) && replayed;
+    }
+    check(replayed, "no value lost by a slow callback");
+
+    check(data_dispatch_set_dispatch_callback(1, nullptr, 0) == 0,
+          "callback removed");
+    callback_calls = 0;
+    convert_sequence(1);
+    check(callback_calls == 0, "removed callback is not called");
+
+    check(data_dispatch_set_dispatch_callback(1, dispatch_callback, 1) == 0,
+          "callback registered again");
+    setup(counts, interrupt, 0);
+    convert_sequence(1);
+    check(callback_calls == 0, "init clears the callback");
+
+    setup(counts, task, 4);
+    check(data_dispatch_set_dispatch_callback(1, dispatch_callback, 1) == -1,
+          "no callback when dispatching at task start");
+}
+
+static void check_task_dispatch()
+{
+    const uint32_t repetitions = 6;
+    const uint8_t counts[ADCS] = {3, 2, 0, 0, 0};
+    setup(counts, task, repetitions);
+
+    uint32_t sequence = data_dispatch_get_sequence();
+    uint32_t errors = 0;
+    for (uint32_t period = 0; period < 500; period++) {
+        /* Up to the repetitions between two dispatches */
+        uint32_t conversions = next_random() % (repetitions + 1);
+        for (uint32_t conversion = 0; conversion < conversions; conversion++) {
+            convert(1);
+            convert(2);
+        }
+        data_dispatch_do_full_dispatch();
+
+        for (uint8_t adc_number = 1; adc_number <= 2; adc_number++) {
+            for (uint8_t rank = 1; rank <= channels_count[adc_number - 1];
+                 rank++) {
+                size_t dispatched = converted[adc_number - 1][rank - 1].size();
+                if (!read_channel(adc_number, rank, dispatched)) {
+                    errors++;
+                }
+            }
+        }
+    }
+    check(errors == 0, "values read match the converted ones at task start");
+    check(data_dispatch_get_sequence() == sequence + 500,
+          "sequence counts the full dispatches at task start");
+    check(adc_dma_model_get_interrupts(1) == 0,
+          "no DMA interrupt when dispatching at task start");
+}
+
+/* Latest DMA word of every channel must hold its latest converted value */
+static bool check_latest_words(uint8_t adc_number)
+{
+    uint8_t index = adc_number - 1;
+    for (uint8_t rank = 1; rank <= channels_count[index]; rank++) {
+        const volatile uint16_t* word =
+            data_dispatch_get_latest_dma_word(adc_number, rank);
+        const std::vector<uint16_t> &values = converted[index][rank - 1];
+        uint16_t expected = values.empty() ? PEEK_NO_VALUE : values.back();
+        if (word == nullptr || *word != expected) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_latest_dma_word()
+{
+    const uint8_t counts[ADCS] = {3, 1, 0, 5, 0};
+    const dispatch_t methods[] = {interrupt, task};
+
+    for (dispatch_t method : methods) {
+        /* 7 repetitions: DMA buffer of 9 words for 3 channels */
+        setup(counts, method, 7);
+
+        check(data_dispatch_get_latest_dma_word(1, 4) == nullptr,
+              "no DMA word for a rank above the channels count");
+        check(data_dispatch_get_latest_dma_word(3, 1) == nullptr,
+              "no DMA word for an ADC without channels");
+        check(check_latest_words(1) && check_latest_words(4),
+              "DMA words empty before the first conversion");
+
+        /* Every position of the write index, over several wraps */
+        const uint8_t adcs[] = {1, 2, 4};
+        uint32_t errors = 0;
+        for (uint32_t step = 0; step < 3000; step++) {
+            uint8_t adc_number = adcs[next_random() % sizeof(adcs)];
+            convert(adc_number);
+            if (!check_latest_words(adc_number)) {
+                errors++;
+            }
+            if (method == task && next_random() % 8 == 0) {
+                data_dispatch_do_full_dispatch();
+            }
+        }
+        check(errors == 0, method == interrupt
+              ? "latest DMA words on interrupt"
+              : "latest DMA words at task start");
+    }
+}
+
+static void check_dual_mode()
+{
+    /* Simultaneous conversions: same channels count on ADC 1 and ADC 2 */
+    const uint8_t counts[ADCS] = {3, 3, 0, 2, 0};
+    const dispatch_t methods[] = {interrupt, task};
+
+    for (dispatch_t method : methods) {
+        setup(counts, method, 7, true);
+
+        size_t size = 0;
+        check(adc_dma_model_get_buffer(2, &size) == nullptr,
+              "no DMA for ADC 2 in dual mode");
+        check(data_dispatch_get_latest_dma_word(2, 1) != nullptr
+              && *data_dispatch_get_latest_dma_word(2, 1) == PEEK_NO_VALUE,
+              "ADC 2 DMA words empty before the first conversion");
+
+        const uint8_t adcs[] = {1, 4};
+        uint32_t errors = 0;
+        uint32_t word_errors = 0;
+        uint32_t conversions = 0;
+        for (uint32_t step = 0; step < 3000; step++) {
+            uint8_t adc_number = adcs[next_random() % sizeof(adcs)];
+            convert(adc_number);
+            if (!check_latest_words(1) || !check_latest_words(2)) {
+                word_errors++;
+            }
+            if (method == task) {
+                /* Up to the repetitions between two dispatches */
+                conversions++;
+                if (conversions < 7 && next_random() % 4 != 0) {
+                    continue;
+                }
+                conversions = 0;
+                data_dispatch_do_full_dispatch();
+            }
+            if (next_random() % 4 != 0) {
+                continue;
+            }
+
+            /* ADC 2 is dispatched along with ADC 1 */
+            for (uint8_t adc = 1; adc <= 2; adc++) {
+                for (uint8_t rank = 1; rank <= channels_count[adc - 1];
+                     rank++) {
+                    size_t dispatched = method == interrupt
+                        ? adc_dma_model_get_interrupts(1)
+                        : converted[adc - 1][rank - 1].size();
+                    if (!read_channel(adc, rank, dispatched)) {
+                        errors++;
+                    }
+                }
+            }
+        }
+        check(errors == 0, method == interrupt
+              ? "dual mode values read on interrupt"
+              : "dual mode values read at task start");
+        check(word_errors == 0, method == interrupt
+              ? "dual mode latest DMA words on interrupt"
+              : "dual mode latest DMA words at task start");
+    }
+
+    /* Later checks use independent ADCs */
+    dual_mode = false;
+}
+
+static void check_dma_buffers()
+{
+    const uint8_t counts[ADCS] = {3, 2, 0, 1, 0};
+    const uint8_t too_many[ADCS] = {8, 8, 0, 1, 0};
+
+    /* Buffers of the previous init are freed, whatever the method */
+    setup(counts, interrupt, 0);
+    size_t blocks = sim_heap_blocks;
+    for (uint32_t init = 0; init < 50; init++) {
+        setup(counts, init % 2 ? task : interrupt, init + 1);
+    }
+    setup(counts, interrupt, 0);
+    check(sim_heap_blocks == blocks, "DMA buffers reused on every init");
+
+    /* Allocation of the second ADC buffer fails */
+    sim_heap_blocks_limit = sim_heap_blocks - 3 + 1;
+    adc_dma_model_reset();
+    for (uint8_t index = 0; index < ADCS; index++) {
+        adc_dma_model_set_channels(index + 1, counts[index]);
+    }
+    check(data_dispatch_init(interrupt, 0) == -1,
+          "init fails when DMA buffers can not be allocated");
+    sim_heap_blocks_limit = SIZE_MAX;
+    check(sim_heap_blocks == blocks - 3, "no DMA buffer left on failure");
+    check(data_dispatch_get_latest_dma_word(1, 1) == nullptr
+          && data_dispatch_peek_acquired_value(1, 1) == 0,
+          "no channel dispatched after a failed init");
+
+    adc_dma_model_reset();
+    for (uint8_t index = 0; index < ADCS; index++) {
+        adc_dma_model_set_channels(index + 1, too_many[index]);
+    }
+    check(data_dispatch_init(interrupt, 0) == -1
+          && sim_heap_blocks == blocks - 3,
+          "no DMA buffer left with too many channels");
+
+    /* Init works again afterwards */
+    setup(counts, interrupt, 0);
+    check(sim_heap_blocks == blocks, "DMA buffers allocated again");
+    convert_sequence(1);
+    check(read_interrupt_channel(1, 1), "dispatch after a failed init");
+}
+
+/* Benchmark: DMA buffers of ADC 1 dispatched by the benchmark */
+
+typedef struct {
+    dispatch_t method;
+    uint8_t channels_count;
+    uint32_t repetitions;
+} benchmark_case_t;
+
+static const benchmark_case_t benchmark_cases[] = {
+    {interrupt, 3, 0},
+    {interrupt, 8, 0},
+    {task, 3, 10},
+    {task, 8, 40},
+};
+
+/* Sum of the values read by each implementation, which must match */
+static uint32_t dispatch_read_sum;
+static uint32_t modulo_read_sum;
+
+/* Most values added to a channel by one dispatch */
+static uint32_t values_per_dispatch(const benchmark_case_t &benchmark)
+{
+    if (benchmark.method == interrupt) {
+        return 1;
+    }
+    return (benchmark.repetitions + benchmark.channels_count - 1)
+           / benchmark.channels_count;
+}
+
+static void read_channels(uint8_t channels)
+{
+    for (uint8_t rank = 1; rank <= channels; rank++) {
+        uint32_t count = 0;
+        uint16_t* data = data_dispatch_get_acquired_values(1, rank, count);
+        if (data != nullptr) {
+            for (uint32_t value = 0; value < count; value++) {
+                dispatch_read_sum += data[value];
+            }
+        }
+    }
+}
+
+/**
+ * Channel buffers of the dispatch loop used before the dispatch kernels,
+ * with the layout of data_dispatch.cpp for ADC 1 channels.
+ */
+static uint16_t modulo_buffers[DATA_DISPATCH_MAX_CHANNELS][2]
+                              [CHANNELS_BUFFERS_SIZE];
+static uint32_t modulo_counts[DATA_DISPATCH_MAX_CHANNELS];
+static uint8_t modulo_current[DATA_DISPATCH_MAX_CHANNELS];
+static uint8_t modulo_dma_half;
+static size_t modulo_dma_index;
+
+/**
+ * Dispatch loop used before the dispatch kernels: the dispatch method is
+ * tested and the channel found with a modulo for every DMA value. Buffers
+ * are read before they are full, the loop would write past them.
+ */
+static void modulo_dispatch(dispatch_t method, const uint16_t* dma_main,
+                            size_t dma_size, uint8_t channels)
+{
+    const uint16_t* dma_buffer = dma_main;
+    if (method == interrupt) {
+        if (modulo_dma_half == 0) {
+            modulo_dma_half = 1;
+        } else {
+            dma_buffer = dma_main + channels;
+            modulo_dma_half = 0;
+        }
+    }
+
+    size_t data_count = method == interrupt
+                        ? channels : dma_get_retrieved_data_count(1);
+
+    for (size_t dma_index = 0; dma_index < data_count; dma_index++) {
+        size_t dma_buffer_index;
+        if (method == interrupt) {
+            dma_buffer_index = dma_index % channels;
+        } else {
+            dma_buffer_index = modulo_dma_index;
+            if (modulo_dma_index < dma_size - 1) {
+                modulo_dma_index++;
+            } else {
+                modulo_dma_index = 0;
+            }
+        }
+
+        uint8_t slot = dma_buffer_index % channels;
+        uint32_t count = modulo_counts[slot];
+        modulo_buffers[slot][modulo_current[slot]][count] =
+            dma_buffer[dma_buffer_index];
+        if (count < CHANNELS_BUFFERS_SIZE) {
+            modulo_counts[slot] = count + 1;
+        }
+    }
+}
+
+static void modulo_read_channels(uint8_t channels)
+{
+    for (uint8_t slot = 0; slot < channels; slot++) {
+        uint32_t count = modulo_counts[slot];
+        const uint16_t* data = modulo_buffers[slot][modulo_current[slot]];
+        modulo_current[slot] ^= 1;
+        modulo_counts[slot] = 0;
+        for (uint32_t value = 0; value < count; value++) {
+            modulo_read_sum += data[value];
+        }
+    }
+}
+
+/**
+ * Same DMA buffer and state for every implementation: the buffer is
+ * filled once, then its content is dispatched again and again.
+ */
+static const uint16_t* start_benchmark(const benchmark_case_t &benchmark,
+                                       size_t* size)
+{
+    const uint8_t counts[ADCS] = {benchmark.channels_count, 0, 0, 0, 0};
+    setup(counts, benchmark.method, benchmark.repetitions);
+
+    const uint16_t* dma_buffer =
+        (const uint16_t*)adc_dma_model_get_buffer(1, size);
+    for (size_t transfer = 0; transfer < *size; transfer++) {
+        convert(1);
+    }
+    read_channels(benchmark.channels_count);
+    dispatch_read_sum = 0;
+
+    return dma_buffer;
+}
+
+/* Host time of one dispatch */
+static double benchmark_dispatch(const benchmark_case_t &benchmark,
+                                 uint32_t dispatches)
+{
+    size_t size = 0;
+    start_benchmark(benchmark, &size);
+
+    /* Channels are read before their buffers overflow */
+    uint32_t read_period = CHANNELS_BUFFERS_SIZE
+                           / values_per_dispatch(benchmark);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t dispatch = 1; dispatch <= dispatches; dispatch++) {
+        if (benchmark.method == task) {
+            adc_dma_model_advance(1, benchmark.repetitions);
+        }
+        data_dispatch_do_dispatch(1);
+        if (dispatch % read_period == 0) {
+            read_channels(benchmark.channels_count);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count()
+           / dispatches;
+}
+
+/* Host time of one dispatch by the loop used before the kernels */
+static double benchmark_modulo(const benchmark_case_t &benchmark,
+                               uint32_t dispatches)
+{
+    size_t size = 0;
+    const uint16_t* dma_buffer = start_benchmark(benchmark, &size);
+    for (uint8_t slot = 0; slot < benchmark.channels_count; slot++) {
+        modulo_counts[slot] = 0;
+        modulo_current[slot] = 0;
+    }
+    modulo_dma_half = 0;
+    modulo_dma_index = 0;
+    modulo_read_sum = 0;
+
+    uint32_t read_period = CHANNELS_BUFFERS_SIZE
+                           / values_per_dispatch(benchmark);
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t dispatch = 1; dispatch <= dispatches; dispatch++) {
+        if (benchmark.method == task) {
+            adc_dma_model_advance(1, benchmark.repetitions);
+        }
+        modulo_dispatch(benchmark.method, dma_buffer, size,
+                        benchmark.channels_count);
+        if (dispatch % read_period == 0) {
+            modulo_read_channels(benchmark.channels_count);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count()
+           / dispatches;
+}
+
+static void run_benchmark(uint32_t dispatches)
+{
+    printf("%u dispatches of ADC 1\n", dispatches);
+    printf("%-10s %8s %11s %10s %12s %10s\n", "", "channels",
+           "repetitions", "modulo ns", "dispatch ns", "value ns");
+
+    for (const benchmark_case_t &benchmark : benchmark_cases) {
+        double modulo_ns = benchmark_modulo(benchmark, dispatches);
+        double dispatch_ns = benchmark_dispatch(benchmark, dispatches);
+        check(dispatch_read_sum == modulo_read_sum,
+              "same values read after both dispatch loops");
+
+        /* Values copied by one dispatch */
+        uint32_t values = benchmark.method == interrupt
+                          ? benchmark.channels_count
+                          : benchmark.repetitions;
+        printf("%-10s %8u %11u %10.1f %12.1f %10.2f\n",
+               benchmark.method == interrupt ? "interrupt" : "task",
+               benchmark.channels_count, benchmark.repetitions, modulo_ns,
+               dispatch_ns, dispatch_ns / values);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        int dispatches = (argc > 2) ? atoi(argv[2]) : 1000000;
+        if (strcmp(argv[1], "benchmark") != 0 || dispatches <= 0) {
+            fprintf(stderr, "usage: %s [benchmark [dispatches]]\n", argv[0]);
+            return 1;
+        }
+        run_benchmark(dispatches);
+
+        return failures == 0 ? 0 : 1;
+    }
+
+    check_interrupt_dispatch();
+    check_sequence();
+    check_dispatch_callback();
+    check_task_dispatch();
+    check_latest_dma_word();
+    check_dual_mode();
+    check_dma_buffers();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,65 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Host replacement for the OwnTech Safety API, limited to the
+ *         hardware overcurrent trip. The simulator checks the plant
+ *         currents against the thresholds on every plant step, as the
+ *         comparators do continuously. A trip is a safety alert and an
+ *         error of its sensor, as reported by the safety task.
+ */
+
+#ifndef SAFETYAPI_H_
+#define SAFETYAPI_H_
+
+#include <stdint.h>
+#include <arm_math.h>
+
+#include "ShieldAPI.h"
+
+class SafetyAPI
+{
+public:
+    int8_t setChannelHardwareTrip(sensor_t* sensors_trip,
+                                  float32_t* threshold_max,
+                                  uint8_t sensors_trip_number);
+    bool getChannelHardwareTrip(sensor_t sensor_trip);
+    void clearHardwareTrip();
+    bool getChannelError(sensor_t sensors_error);
+    uint32_t getTripCount();
+
+    /**
+     * Simulator access: latches the trip of a sensor if its value is above
+     * its threshold.
+     *
+     * @return true if the sensor trips now.
+     */
+    bool checkHardwareTrip(sensor_t sensor, float32_t value);
+
+    bool hw_trip_enabled[SENSORS_COUNT + 1] = {false};
+    float32_t hw_trip_threshold[SENSORS_COUNT + 1] = {0};
+    bool hw_trip_latched[SENSORS_COUNT + 1] = {false};
+    uint32_t trip_count = 0;
+};
+
+extern SafetyAPI safety;
+
+#endif // SAFETYAPI_H_
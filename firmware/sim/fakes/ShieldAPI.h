@@ -0,0 +1,157 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the OwnTech Shield API, with the sensors
+ *         and power legs of the uSolarVerter shield. Sensors values and
+ *         legs commands are exchanged with the plant model by the
+ *         simulator.
+ */
+
+#ifndef SHIELDAPI_H_
+#define SHIELDAPI_H_
+
+#include <stdint.h>
+#include <arm_math.h>
+
+#include "SpinAPI.h"
+
+/* Same order as the shield device tree */
+typedef enum
+{
+    UNDEFINED_SENSOR = 0,
+    VLow,
+    VAC,
+    VDCBus,
+    ILow1,
+    ILow2,
+    IAC,
+    TEMP_SENSOR
+} sensor_t;
+
+const uint8_t SENSORS_COUNT = 7;
+
+typedef struct
+{
+    float32_t values[SENSORS_COUNT + 1];
+    uint8_t   data_valid[SENSORS_COUNT + 1];
+    uint32_t  sequence;
+} sensors_snapshot_t;
+
+typedef enum
+{
+    LEG1_LOW,
+    LEG2_LOW,
+    LEG1_HIGH,
+    LEG2_HIGH,
+    ALL
+} leg_t;
+
+static const uint8_t LEGS_COUNT = ALL;
+
+typedef struct
+{
+    leg_t leg;
+    float32_t duty_value;
+} leg_duty_cycle_t;
+
+class SensorsAPI
+{
+public:
+    int8_t enableSensor(sensor_t sensor_name, adc_t adc_num = DEFAULT_ADC);
+    float32_t getLatestValue(sensor_t sensor_name,
+                             uint8_t* dataValid = nullptr,
+                             uint32_t* timestamp = nullptr);
+    void getLatestValues(sensors_snapshot_t& snapshot);
+
+    /**
+     * Simulator access: set the physical value seen by a sensor.
+     * The value is quantized as a 12-bit ADC would with the shield
+     * default calibration.
+     */
+    void setMeasuredValue(sensor_t sensor_name, float32_t value);
+    void newAcquisition(uint32_t timestamp);
+
+private:
+    bool enabled[SENSORS_COUNT + 1] = {false};
+    float32_t values[SENSORS_COUNT + 1] = {0};
+    uint8_t data_valid[SENSORS_COUNT + 1] = {0};
+    uint32_t sequence = 0;
+    uint32_t latest_timestamp = 0;
+};
+
+class PowerAPI
+{
+public:
+    void initBuck(leg_t leg);
+    void initBoost(leg_t leg);
+    void setDutyCycle(leg_t leg, float32_t duty_value);
+    void setDutyCycles(const leg_duty_cycle_t* duty_cycles, uint8_t count);
+    template <size_t N>
+    void setDutyCycles(const leg_duty_cycle_t (&duty_cycles)[N])
+    {
+        setDutyCycles(duty_cycles, N);
+    }
+    void setDeadTime(leg_t leg, uint16_t ns_rising_dt, uint16_t ns_falling_dt);
+    void start(leg_t leg);
+    void stop(leg_t leg);
+
+    /**
+     * Simulator access: HRTIM register model. Duty cycles are written to
+     * the preload registers, and become active (duty_cycle) on update
+     * events, except for legs whose register update is disabled.
+     */
+    void updateEvent();
+
+    float32_t duty_cycle[LEGS_COUNT] = {0};
+    bool initialized[LEGS_COUNT] = {false};
+    bool started[LEGS_COUNT] = {false};
+    float32_t preload[LEGS_COUNT] = {0};
+    bool update_disabled[LEGS_COUNT] = {false};
+
+    /* Worst case timing: an update event right after each register write */
+    bool update_after_writes = false;
+
+    /* Critical task period of the preload and active values */
+    uint32_t write_period = 0;
+    uint32_t preload_period[LEGS_COUNT] = {0};
+    uint32_t active_period[LEGS_COUNT] = {0};
+
+    /* Legs that must switch together, and update events where they did not */
+    bool synchronous[LEGS_COUNT] = {false};
+    uint32_t split_updates = 0;
+
+private:
+    void initLeg(leg_t leg);
+    /* Like the firmware, setDutyCycles() ignores legs not initialized */
+    bool isLegInitialized(leg_t leg);
+    void writeDutyCycle(uint8_t leg, float32_t duty_value);
+};
+
+class ShieldAPI
+{
+public:
+    static SensorsAPI sensors;
+    static PowerAPI power;
+};
+
+extern ShieldAPI shield;
+
+#endif // SHIELDAPI_H_
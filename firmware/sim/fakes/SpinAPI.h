@@ -0,0 +1,106 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the OwnTech Spin API, limited to the
+ *         LED and data acquisition functions used by the application.
+ */
+
+#ifndef SPINAPI_H_
+#define SPINAPI_H_
+
+#include <stdint.h>
+#include <arm_math.h>
+
+/* Hardware-independent module shared with the firmware */
+#include "timing_stats.h"
+
+typedef enum : int8_t
+{
+    UNKNOWN_ADC = -1,
+    DEFAULT_ADC = 0,
+    ADC_1 = 1,
+    ADC_2 = 2,
+    ADC_3 = 3,
+    ADC_4 = 4,
+    ADC_5 = 5
+} adc_t;
+
+typedef enum : uint8_t
+{
+    TRIG_SOFTWARE,
+    TRIG_PWM
+} trigger_source_t;
+
+static const uint8_t ADC_COUNT = 5;
+
+const float32_t NO_VALUE = -10000;
+
+const uint8_t DATA_IS_OK      = 0;
+const uint8_t DATA_IS_OLD     = 1;
+const uint8_t DATA_IS_MISSING = 2;
+
+class LedHAL
+{
+public:
+    void turnOn();
+    void turnOff();
+    void toggle();
+
+    /* Simulator access */
+    bool is_on = false;
+};
+
+class DataAPI
+{
+public:
+    DataAPI();
+
+    void configureTriggerSource(adc_t adc_number,
+                                trigger_source_t trigger_source);
+    void configureDiscontinuousMode(adc_t adc_number,
+                                    uint32_t discontinuous_count);
+    void configureDualSimultaneousMode(bool enable);
+
+    static uint32_t getTimestampFrequency();
+    int8_t getDispatchTimingStatistics(adc_t adc_number,
+                                       timing_stats_t& stats);
+    int8_t resetDispatchTimingStatistics(adc_t adc_number,
+                                         float32_t expected_period_us = 0,
+                                         float32_t bin_width_us = 0);
+
+    /* Simulator access: dispatch of the ADCs triggered by the PWM */
+    void dispatch(uint32_t timestamp);
+
+private:
+    trigger_source_t trigger_sources[ADC_COUNT];
+    timing_stats_t dispatch_timing_stats[ADC_COUNT];
+};
+
+class SpinAPI
+{
+public:
+    static LedHAL led;
+    static DataAPI data;
+};
+
+extern SpinAPI spin;
+
+#endif // SPINAPI_H_
@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the OwnTech Task API. Tasks are only
+ *         registered: the simulator calls them in simulated time, and
+ *         feeds the deadline monitor with simulated timestamps.
+ */
+
+#ifndef TASKAPI_H_
+#define TASKAPI_H_
+
+#include <stdint.h>
+
+/* Shared with the firmware, timed with a host clock */
+#include "task_profiling.h"
+#include "task_deadline.h"
+#include "task_subtasks.h"
+
+typedef void (*task_function_t)();
+
+typedef enum { source_uninitialized,
+               source_hrtim,
+               source_tim6,
+               source_adc_dma }
+               scheduling_interrupt_source_t;
+
+static const uint8_t SIM_BACKGROUND_TASKS_MAX = 8;
+
+class TaskAPI
+{
+public:
+    int8_t createCritical(task_function_t periodic_task,
+                          uint32_t task_period_us,
+                          scheduling_interrupt_source_t int_source = source_hrtim);
+    void startCritical(bool manage_data_acquisition = true);
+    void stopCritical();
+
+    int8_t createCriticalSubTask(task_function_t sub_task, uint16_t divider,
+                                 uint32_t budget_ns = 0);
+    int8_t getCriticalSubTaskStatistics(uint8_t sub_task,
+                                        task_subtask_stats_t& stats);
+    void resetCriticalSubTaskStatistics();
+
+    int8_t createBackground(task_function_t routine);
+    void startBackground(uint8_t task_number);
+    void stopBackground(uint8_t task_number);
+
+    void suspendBackgroundMs(uint32_t duration_ms);
+    void suspendBackgroundUs(uint32_t duration_us);
+
+    int8_t defineProfilingSection(const char* name);
+    uint8_t getProfilingSectionsCount();
+    int8_t getProfilingStatistics(uint8_t section,
+                                  task_profiling_section_t& stats);
+    void resetProfiling();
+    static uint32_t getProfilingFrequency();
+
+    int8_t setCriticalOverrunPolicy(task_overrun_policy_t policy,
+                                    uint8_t consecutive_overruns = 1,
+                                    task_overrun_callback_t callback = nullptr);
+    int8_t getCriticalDeadlineStatistics(task_deadline_stats_t& stats);
+    void resetCriticalDeadlineStatistics();
+
+    /* Simulator access */
+
+    task_function_t critical_task = nullptr;
+    uint32_t critical_period_us = 0;
+    bool critical_started = false;
+
+    task_function_t background_tasks[SIM_BACKGROUND_TASKS_MAX] = {nullptr};
+    bool background_started[SIM_BACKGROUND_TASKS_MAX] = {false};
+    uint8_t background_count = 0;
+
+    /* Total suspension requested by the background task being run */
+    uint64_t background_suspend_us = 0;
+};
+
+extern TaskAPI task;
+
+#endif // TASKAPI_H_
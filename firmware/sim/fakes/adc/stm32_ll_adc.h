@@ -0,0 +1,541 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the STM32 LL ADC header, limited to the
+ *         functions used by the ADC driver (owntech_adc_driver). They
+ *         write fake register blocks with the STM32G4 layout, so that
+ *         checks can read back the configuration set by the driver.
+ *
+ *         Oversampling (CFGR2) and injected sequence (JSQR) fields have
+ *         the bit positions of the reference manual (RM0440). Other
+ *         registers only keep enough state for the driver to run: the
+ *         ADCs are ready and calibrated at once, and no conversion is
+ *         ever ongoing. Channel and regular rank constants are encoded
+ *         for the host, not as in the LL.
+ */
+
+#ifndef STM32_LL_ADC_H_
+#define STM32_LL_ADC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct
+{
+    volatile uint32_t ISR;
+    volatile uint32_t IER;
+    volatile uint32_t CR;
+    volatile uint32_t CFGR;
+    volatile uint32_t CFGR2;
+    volatile uint32_t SMPR1;
+    volatile uint32_t SMPR2;
+    uint32_t RESERVED1;
+    volatile uint32_t TR1;
+    volatile uint32_t TR2;
+    volatile uint32_t TR3;
+    uint32_t RESERVED2;
+    volatile uint32_t SQR1;
+    volatile uint32_t SQR2;
+    volatile uint32_t SQR3;
+    volatile uint32_t SQR4;
+    volatile uint32_t DR;
+    uint32_t RESERVED3[2];
+    volatile uint32_t JSQR;
+    uint32_t RESERVED4[4];
+    volatile uint32_t OFR1;
+    volatile uint32_t OFR2;
+    volatile uint32_t OFR3;
+    volatile uint32_t OFR4;
+    uint32_t RESERVED5[4];
+    volatile uint32_t JDR1;
+    volatile uint32_t JDR2;
+    volatile uint32_t JDR3;
+    volatile uint32_t JDR4;
+    uint32_t RESERVED6[4];
+    volatile uint32_t AWD2CR;
+    volatile uint32_t AWD3CR;
+    uint32_t RESERVED7[2];
+    volatile uint32_t DIFSEL;
+    volatile uint32_t CALFACT;
+    uint32_t RESERVED8[2];
+    volatile uint32_t GCOMP;
+} ADC_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CSR;
+    uint32_t RESERVED;
+    volatile uint32_t CCR;
+    volatile uint32_t CDR;
+} ADC_Common_TypeDef;
+
+/* Register blocks, defined by fake_adc_registers.cpp */
+extern ADC_TypeDef sim_adc[5];
+extern ADC_Common_TypeDef sim_adc12_common;
+extern ADC_Common_TypeDef sim_adc345_common;
+
+#define ADC1 (&sim_adc[0])
+#define ADC2 (&sim_adc[1])
+#define ADC3 (&sim_adc[2])
+#define ADC4 (&sim_adc[3])
+#define ADC5 (&sim_adc[4])
+#define ADC12_COMMON  (&sim_adc12_common)
+#define ADC345_COMMON (&sim_adc345_common)
+
+/**
+ *  Register fields
+ */
+
+#define ADC_ISR_ADRDY (1UL << 0)
+#define ADC_ISR_AWD1  (1UL << 7)
+#define ADC_ISR_AWD2  (1UL << 8)
+#define ADC_ISR_AWD3  (1UL << 9)
+
+#define ADC_CR_ADEN     (1UL << 0)
+#define ADC_CR_ADSTART  (1UL << 2)
+#define ADC_CR_JADSTART (1UL << 3)
+#define ADC_CR_ADVREGEN (1UL << 28)
+#define ADC_CR_DEEPPWD  (1UL << 29)
+#define ADC_CR_ADCALDIF (1UL << 30)
+
+#define ADC_CFGR_DMAEN   (1UL << 0)
+#define ADC_CFGR_DMACFG  (1UL << 1)
+#define ADC_CFGR_EXTSEL  (0x1FUL << 5)
+#define ADC_CFGR_EXTEN   (0x3UL << 10)
+#define ADC_CFGR_DISCEN  (1UL << 16)
+#define ADC_CFGR_DISCNUM (0x7UL << 17)
+#define ADC_CFGR_AWD1SGL (1UL << 22)
+#define ADC_CFGR_AWD1EN  (1UL << 23)
+#define ADC_CFGR_JAWD1EN (1UL << 24)
+#define ADC_CFGR_AWD1CH  (0x1FUL << 26)
+
+#define ADC_CFGR2_ROVSE_Pos 0
+#define ADC_CFGR2_ROVSE     (1UL << ADC_CFGR2_ROVSE_Pos)
+#define ADC_CFGR2_JOVSE     (1UL << 1)
+#define ADC_CFGR2_OVSR_Pos  2
+#define ADC_CFGR2_OVSR      (0x7UL << ADC_CFGR2_OVSR_Pos)
+#define ADC_CFGR2_OVSS_Pos  5
+#define ADC_CFGR2_OVSS      (0xFUL << ADC_CFGR2_OVSS_Pos)
+#define ADC_CFGR2_TROVS_Pos 9
+#define ADC_CFGR2_TROVS     (1UL << ADC_CFGR2_TROVS_Pos)
+#define ADC_CFGR2_ROVSM     (1UL << 10)
+
+#define ADC_SQR1_L (0xFUL << 0)
+
+#define ADC_JSQR_JL_Pos      0
+#define ADC_JSQR_JL          (0x3UL << ADC_JSQR_JL_Pos)
+#define ADC_JSQR_JEXTSEL_Pos 2
+#define ADC_JSQR_JEXTSEL     (0x1FUL << ADC_JSQR_JEXTSEL_Pos)
+#define ADC_JSQR_JEXTEN_Pos  7
+#define ADC_JSQR_JEXTEN      (0x3UL << ADC_JSQR_JEXTEN_Pos)
+#define ADC_JSQR_JSQ1_Pos    9
+#define ADC_JSQR_JSQ2_Pos    15
+#define ADC_JSQR_JSQ3_Pos    21
+#define ADC_JSQR_JSQ4_Pos    27
+#define ADC_JSQR_JSQx_Msk    0x1FUL
+
+#define ADC_CCR_DUAL   (0x1FUL << 0)
+#define ADC_CCR_MDMA   (0x3UL << 14)
+#define ADC_CCR_CKMODE (0x3UL << 16)
+
+/**
+ *  LL constants
+ */
+
+#define LL_ADC_DELAY_INTERNAL_REGUL_STAB_US 20
+
+#define LL_ADC_SINGLE_ENDED       0UL
+#define LL_ADC_DIFFERENTIAL_ENDED ADC_CR_ADCALDIF
+
+#define LL_ADC_CLOCK_SYNC_PCLK_DIV4 (0x3UL << 16)
+
+#define LL_ADC_MULTI_INDEPENDENT      0UL
+#define LL_ADC_MULTI_DUAL_REG_SIMULT  0x6UL
+#define LL_ADC_MULTI_REG_DMA_EACH_ADC 0UL
+#define LL_ADC_MULTI_REG_DMA_UNLMT_RES12_10B ((0x2UL << 14) | (1UL << 13))
+
+/* Host encoding of channels: the channel number itself */
+#define __LL_ADC_DECIMAL_NB_TO_CHANNEL(decimal_nb) ((uint32_t)(decimal_nb))
+#define __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel)    ((uint32_t)(channel) & 0x1FUL)
+
+/* Host encoding of regular ranks: SQR register index and field position */
+#define SIM_ADC_REG_RANK(sqr, pos) (((uint32_t)(sqr) << 8) | (pos))
+#define LL_ADC_REG_RANK_1  SIM_ADC_REG_RANK(0, 6)
+#define LL_ADC_REG_RANK_2  SIM_ADC_REG_RANK(0, 12)
+#define LL_ADC_REG_RANK_3  SIM_ADC_REG_RANK(0, 18)
+#define LL_ADC_REG_RANK_4  SIM_ADC_REG_RANK(0, 24)
+#define LL_ADC_REG_RANK_5  SIM_ADC_REG_RANK(1, 0)
+#define LL_ADC_REG_RANK_6  SIM_ADC_REG_RANK(1, 6)
+#define LL_ADC_REG_RANK_7  SIM_ADC_REG_RANK(1, 12)
+#define LL_ADC_REG_RANK_8  SIM_ADC_REG_RANK(1, 18)
+#define LL_ADC_REG_RANK_9  SIM_ADC_REG_RANK(1, 24)
+#define LL_ADC_REG_RANK_10 SIM_ADC_REG_RANK(2, 0)
+#define LL_ADC_REG_RANK_11 SIM_ADC_REG_RANK(2, 6)
+#define LL_ADC_REG_RANK_12 SIM_ADC_REG_RANK(2, 12)
+#define LL_ADC_REG_RANK_13 SIM_ADC_REG_RANK(2, 18)
+#define LL_ADC_REG_RANK_14 SIM_ADC_REG_RANK(2, 24)
+#define LL_ADC_REG_RANK_15 SIM_ADC_REG_RANK(3, 0)
+#define LL_ADC_REG_RANK_16 SIM_ADC_REG_RANK(3, 6)
+
+#define LL_ADC_SAMPLINGTIME_12CYCLES_5 0x2UL
+
+#define LL_ADC_REG_DMA_TRANSFER_NONE      0UL
+#define LL_ADC_REG_DMA_TRANSFER_UNLIMITED (ADC_CFGR_DMACFG | ADC_CFGR_DMAEN)
+
+#define LL_ADC_REG_SEQ_DISCONT_DISABLE 0UL
+#define LL_ADC_REG_SEQ_DISCONT_1RANK  (ADC_CFGR_DISCEN | (0UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_2RANKS (ADC_CFGR_DISCEN | (1UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_3RANKS (ADC_CFGR_DISCEN | (2UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_4RANKS (ADC_CFGR_DISCEN | (3UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_5RANKS (ADC_CFGR_DISCEN | (4UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_6RANKS (ADC_CFGR_DISCEN | (5UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_7RANKS (ADC_CFGR_DISCEN | (6UL << 17))
+#define LL_ADC_REG_SEQ_DISCONT_8RANKS (ADC_CFGR_DISCEN | (7UL << 17))
+
+/* Regular triggers carry the default rising edge, as in the LL. Their
+ * EXTSEL values are host ones. */
+#define LL_ADC_REG_TRIG_EXT_RISING (0x1UL << 10)
+#define SIM_ADC_REG_TRIG(extsel) \
+    (((uint32_t)(extsel) << 5) | LL_ADC_REG_TRIG_EXT_RISING)
+#define LL_ADC_REG_TRIG_SOFTWARE 0UL
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG1 SIM_ADC_REG_TRIG(21)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG2 SIM_ADC_REG_TRIG(22)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG3 SIM_ADC_REG_TRIG(23)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG4 SIM_ADC_REG_TRIG(24)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG5 SIM_ADC_REG_TRIG(25)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG6 SIM_ADC_REG_TRIG(26)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG7 SIM_ADC_REG_TRIG(27)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG8 SIM_ADC_REG_TRIG(28)
+#define LL_ADC_REG_TRIG_EXT_HRTIM_TRG9 SIM_ADC_REG_TRIG(29)
+
+/* JEXTSEL of the HRTIM triggers of ADC 1 and ADC 2 (RM0440) */
+#define LL_ADC_INJ_TRIG_EXT_RISING (0x1UL << ADC_JSQR_JEXTEN_Pos)
+#define SIM_ADC_INJ_TRIG(jextsel) ((uint32_t)(jextsel) << ADC_JSQR_JEXTSEL_Pos)
+#define LL_ADC_INJ_TRIG_SOFTWARE 0UL
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG2 SIM_ADC_INJ_TRIG(19)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG4 SIM_ADC_INJ_TRIG(20)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG5 SIM_ADC_INJ_TRIG(21)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG6 SIM_ADC_INJ_TRIG(22)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG7 SIM_ADC_INJ_TRIG(23)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG8 SIM_ADC_INJ_TRIG(24)
+#define LL_ADC_INJ_TRIG_EXT_HRTIM_TRG9 SIM_ADC_INJ_TRIG(25)
+
+#define LL_ADC_INJ_SEQ_SCAN_DISABLE       0UL
+#define LL_ADC_INJ_SEQ_SCAN_ENABLE_2RANKS 1UL
+#define LL_ADC_INJ_SEQ_SCAN_ENABLE_3RANKS 2UL
+#define LL_ADC_INJ_SEQ_SCAN_ENABLE_4RANKS 3UL
+
+#define LL_ADC_OVS_DISABLE              0UL
+#define LL_ADC_OVS_GRP_REGULAR_CONTINUED ADC_CFGR2_ROVSE
+#define LL_ADC_OVS_REG_CONT             0UL
+#define LL_ADC_OVS_REG_DISCONT          ADC_CFGR2_TROVS
+
+#define LL_ADC_OVS_RATIO_2   (0UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_4   (1UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_8   (2UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_16  (3UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_32  (4UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_64  (5UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_128 (6UL << ADC_CFGR2_OVSR_Pos)
+#define LL_ADC_OVS_RATIO_256 (7UL << ADC_CFGR2_OVSR_Pos)
+
+#define LL_ADC_OVS_SHIFT_NONE    (0UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_1 (1UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_2 (2UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_3 (3UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_4 (4UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_5 (5UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_6 (6UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_7 (7UL << ADC_CFGR2_OVSS_Pos)
+#define LL_ADC_OVS_SHIFT_RIGHT_8 (8UL << ADC_CFGR2_OVSS_Pos)
+
+#define LL_ADC_AWD1 1UL
+#define LL_ADC_AWD2 2UL
+#define LL_ADC_AWD3 3UL
+#define LL_ADC_AWD_DISABLE 0UL
+#define LL_ADC_GROUP_REGULAR_INJECTED (1UL << 8)
+#define __LL_ADC_ANALOGWD_CHANNEL_GROUP(channel, group) ((channel) | (group))
+
+/**
+ *  Power, calibration and enable
+ */
+
+static inline void LL_ADC_DisableDeepPowerDown(ADC_TypeDef* adc)
+{
+    adc->CR = adc->CR & ~ADC_CR_DEEPPWD;
+}
+
+static inline void LL_ADC_EnableInternalRegulator(ADC_TypeDef* adc)
+{
+    adc->CR = adc->CR | ADC_CR_ADVREGEN;
+}
+
+/* Calibration completes at once */
+static inline void LL_ADC_StartCalibration(ADC_TypeDef* adc, uint32_t mode)
+{
+    adc->CR = (adc->CR & ~ADC_CR_ADCALDIF) | mode;
+}
+
+static inline uint32_t LL_ADC_IsCalibrationOnGoing(ADC_TypeDef* adc)
+{
+    (void)adc;
+    return 0;
+}
+
+static inline void LL_ADC_ClearFlag_ADRDY(ADC_TypeDef* adc)
+{
+    adc->ISR = adc->ISR & ~ADC_ISR_ADRDY;
+}
+
+/* The ADC is ready at once */
+static inline void LL_ADC_Enable(ADC_TypeDef* adc)
+{
+    adc->CR = adc->CR | ADC_CR_ADEN;
+    adc->ISR = adc->ISR | ADC_ISR_ADRDY;
+}
+
+static inline void LL_ADC_Disable(ADC_TypeDef* adc)
+{
+    adc->CR = adc->CR & ~ADC_CR_ADEN;
+}
+
+static inline uint32_t LL_ADC_IsEnabled(ADC_TypeDef* adc)
+{
+    return ((adc->CR & ADC_CR_ADEN) != 0) ? 1 : 0;
+}
+
+static inline uint32_t LL_ADC_IsActiveFlag_ADRDY(ADC_TypeDef* adc)
+{
+    return ((adc->ISR & ADC_ISR_ADRDY) != 0) ? 1 : 0;
+}
+
+static inline void LL_ADC_SetCommonClock(ADC_Common_TypeDef* common,
+                                         uint32_t clock)
+{
+    common->CCR = (common->CCR & ~ADC_CCR_CKMODE) | clock;
+}
+
+static inline void LL_ADC_SetMultimode(ADC_Common_TypeDef* common,
+                                       uint32_t multimode)
+{
+    common->CCR = (common->CCR & ~ADC_CCR_DUAL) | multimode;
+}
+
+static inline void LL_ADC_SetMultiDMATransfer(ADC_Common_TypeDef* common,
+                                              uint32_t transfer)
+{
+    common->CCR = (common->CCR & ~(ADC_CCR_MDMA | (1UL << 13))) | transfer;
+}
+
+/**
+ *  Regular group
+ */
+
+/* Conversions are never ongoing: starting and stopping them has no
+ * effect on the registers */
+static inline void LL_ADC_REG_StartConversion(ADC_TypeDef* adc)
+{
+    (void)adc;
+}
+
+static inline void LL_ADC_REG_StopConversion(ADC_TypeDef* adc)
+{
+    (void)adc;
+}
+
+static inline uint32_t LL_ADC_REG_IsConversionOngoing(ADC_TypeDef* adc)
+{
+    return ((adc->CR & ADC_CR_ADSTART) != 0) ? 1 : 0;
+}
+
+static inline void LL_ADC_REG_SetSequencerLength(ADC_TypeDef* adc,
+                                                 uint32_t length)
+{
+    adc->SQR1 = (adc->SQR1 & ~ADC_SQR1_L) | length;
+}
+
+static inline void LL_ADC_REG_SetSequencerRanks(ADC_TypeDef* adc,
+                                                uint32_t rank,
+                                                uint32_t channel)
+{
+    volatile uint32_t* sqr = &adc->SQR1 + (rank >> 8);
+    uint32_t pos = rank & 0xFF;
+    *sqr = (*sqr & ~(0x1FUL << pos))
+         | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(channel) << pos);
+}
+
+static inline void LL_ADC_SetChannelSamplingTime(ADC_TypeDef* adc,
+                                                 uint32_t channel,
+                                                 uint32_t sampling_time)
+{
+    uint32_t number = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+    volatile uint32_t* smpr = (number < 10) ? &adc->SMPR1 : &adc->SMPR2;
+    uint32_t pos = (number % 10) * 3;
+    *smpr = (*smpr & ~(0x7UL << pos)) | (sampling_time << pos);
+}
+
+static inline void LL_ADC_SetChannelSingleDiff(ADC_TypeDef* adc,
+                                               uint32_t channel,
+                                               uint32_t mode)
+{
+    uint32_t bit = 1UL << __LL_ADC_CHANNEL_TO_DECIMAL_NB(channel);
+    adc->DIFSEL = (mode == LL_ADC_DIFFERENTIAL_ENDED) ? (adc->DIFSEL | bit)
+                                                     : (adc->DIFSEL & ~bit);
+}
+
+static inline void LL_ADC_REG_SetDMATransfer(ADC_TypeDef* adc,
+                                             uint32_t transfer)
+{
+    adc->CFGR = (adc->CFGR & ~(ADC_CFGR_DMAEN | ADC_CFGR_DMACFG)) | transfer;
+}
+
+static inline void LL_ADC_REG_SetTriggerEdge(ADC_TypeDef* adc, uint32_t edge)
+{
+    adc->CFGR = (adc->CFGR & ~ADC_CFGR_EXTEN) | edge;
+}
+
+static inline void LL_ADC_REG_SetTriggerSource(ADC_TypeDef* adc,
+                                               uint32_t trigger)
+{
+    adc->CFGR = (adc->CFGR & ~(ADC_CFGR_EXTEN | ADC_CFGR_EXTSEL)) | trigger;
+}
+
+static inline void LL_ADC_REG_SetSequencerDiscont(ADC_TypeDef* adc,
+                                                  uint32_t discont)
+{
+    adc->CFGR = (adc->CFGR & ~(ADC_CFGR_DISCEN | ADC_CFGR_DISCNUM)) | discont;
+}
+
+/**
+ *  Oversampling
+ */
+
+static inline void LL_ADC_ConfigOverSamplingRatioShift(ADC_TypeDef* adc,
+                                                       uint32_t ratio,
+                                                       uint32_t shift)
+{
+    adc->CFGR2 = (adc->CFGR2 & ~(ADC_CFGR2_OVSR | ADC_CFGR2_OVSS))
+               | ratio | shift;
+}
+
+static inline void LL_ADC_SetOverSamplingDiscont(ADC_TypeDef* adc,
+                                                 uint32_t discont)
+{
+    adc->CFGR2 = (adc->CFGR2 & ~ADC_CFGR2_TROVS) | discont;
+}
+
+static inline void LL_ADC_SetOverSamplingScope(ADC_TypeDef* adc,
+                                               uint32_t scope)
+{
+    adc->CFGR2 = (adc->CFGR2
+                  & ~(ADC_CFGR2_ROVSE | ADC_CFGR2_JOVSE | ADC_CFGR2_ROVSM))
+               | scope;
+}
+
+/**
+ *  Injected group
+ */
+
+/* The external edge is only written for external triggers, as in the LL */
+static inline void LL_ADC_INJ_ConfigQueueContext(ADC_TypeDef* adc,
+                                                 uint32_t trigger,
+                                                 uint32_t edge,
+                                                 uint32_t ranks,
+                                                 uint32_t rank1_channel,
+                                                 uint32_t rank2_channel,
+                                                 uint32_t rank3_channel,
+                                                 uint32_t rank4_channel)
+{
+    uint32_t external = (trigger != LL_ADC_INJ_TRIG_SOFTWARE) ? edge : 0;
+
+    adc->JSQR = (trigger & ADC_JSQR_JEXTSEL)
+              | (external & ADC_JSQR_JEXTEN)
+              | (ranks & ADC_JSQR_JL)
+              | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(rank1_channel) << ADC_JSQR_JSQ1_Pos)
+              | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(rank2_channel) << ADC_JSQR_JSQ2_Pos)
+              | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(rank3_channel) << ADC_JSQR_JSQ3_Pos)
+              | (__LL_ADC_CHANNEL_TO_DECIMAL_NB(rank4_channel) << ADC_JSQR_JSQ4_Pos);
+}
+
+static inline void LL_ADC_INJ_StartConversion(ADC_TypeDef* adc)
+{
+    (void)adc;
+}
+
+static inline void LL_ADC_INJ_StopConversion(ADC_TypeDef* adc)
+{
+    (void)adc;
+}
+
+static inline uint32_t LL_ADC_INJ_IsConversionOngoing(ADC_TypeDef* adc)
+{
+    return ((adc->CR & ADC_CR_JADSTART) != 0) ? 1 : 0;
+}
+
+/**
+ *  Analog watchdogs
+ */
+
+static inline void LL_ADC_SetAnalogWDMonitChannels(ADC_TypeDef* adc,
+                                                   uint32_t watchdog,
+                                                   uint32_t channels)
+{
+    uint32_t number = __LL_ADC_CHANNEL_TO_DECIMAL_NB(channels);
+
+    if (watchdog == LL_ADC_AWD1) {
+        uint32_t cfgr = adc->CFGR & ~(ADC_CFGR_AWD1CH | ADC_CFGR_AWD1SGL
+                                      | ADC_CFGR_AWD1EN | ADC_CFGR_JAWD1EN);
+        if (channels != LL_ADC_AWD_DISABLE) {
+            cfgr |= (number << 26) | ADC_CFGR_AWD1SGL
+                  | ADC_CFGR_AWD1EN | ADC_CFGR_JAWD1EN;
+        }
+        adc->CFGR = cfgr;
+    } else {
+        volatile uint32_t* awdcr = (watchdog == LL_ADC_AWD2) ? &adc->AWD2CR
+                                                             : &adc->AWD3CR;
+        *awdcr = (channels != LL_ADC_AWD_DISABLE) ? (1UL << number) : 0;
+    }
+}
+
+/* Watchdogs 2 and 3 only compare the 8 most significant bits */
+static inline void LL_ADC_ConfigAnalogWDThresholds(ADC_TypeDef* adc,
+                                                   uint32_t watchdog,
+                                                   uint32_t high,
+                                                   uint32_t low)
+{
+    if (watchdog == LL_ADC_AWD1) {
+        adc->TR1 = (high << 16) | low;
+    } else {
+        volatile uint32_t* tr = (watchdog == LL_ADC_AWD2) ? &adc->TR2
+                                                          : &adc->TR3;
+        *tr = ((high >> 4) << 16) | (low >> 4);
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // STM32_LL_ADC_H_
@@ -0,0 +1,42 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the STM32 LL bus header: peripheral clocks
+ *         are always enabled. On the target, the LL ADC definitions come
+ *         with the SoC headers, here with this header.
+ */
+
+#ifndef STM32_LL_BUS_H_
+#define STM32_LL_BUS_H_
+
+#include <stdint.h>
+
+#include "stm32_ll_adc.h"
+
+#define LL_AHB2_GRP1_PERIPH_ADC12  (1UL << 13)
+#define LL_AHB2_GRP1_PERIPH_ADC345 (1UL << 14)
+
+static inline void LL_AHB2_GRP1_EnableClock(uint32_t periphs)
+{
+    (void)periphs;
+}
+
+#endif // STM32_LL_BUS_H_
@@ -0,0 +1,84 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host model of the ADC conversions stored by the DMA 1 channels,
+ *         behind the adc.h and dma.h functions used by data dispatch.
+ *
+ *         Each ADC converts its enabled channels in rank order, and each
+ *         conversion is one DMA transfer to the circular buffer given to
+ *         dma.h, packing ADC 1 and ADC 2 values in a 32-bit word in dual
+ *         mode. Half and full buffer events set the flags of the channel.
+ *         With interrupts enabled, the flags are cleared and
+ *         data_dispatch_do_dispatch() is called as by the DMA interrupt;
+ *         events raised while the interrupt runs stay pending until it
+ *         returns, then they are served in turn.
+ */
+
+#ifndef ADC_DMA_MODEL_H_
+#define ADC_DMA_MODEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Reset the model: no channel, independent ADCs, no DMA configured.
+ */
+void adc_dma_model_reset();
+
+/**
+ * Number of enabled channels of an ADC, returned by
+ * adc_get_enabled_channels_count().
+ */
+void adc_dma_model_set_channels(uint8_t adc_number, uint8_t channels_count);
+
+/**
+ * ADC 1 and ADC 2 in dual simultaneous mode.
+ */
+void adc_dma_model_set_dual_mode(bool enable);
+
+/**
+ * Convert the next channel of an ADC. In dual mode, ADC 1 conversions
+ * also convert ADC 2, with slave_value.
+ *
+ * @return Rank of the converted channel, starting from 1.
+ */
+uint8_t adc_dma_model_convert(uint8_t adc_number, uint16_t value,
+                              uint16_t slave_value = 0);
+
+/**
+ * Move the DMA write index of an ADC by a number of transfers, as if the
+ * DMA had written the current buffer content again, without interrupts:
+ * times the dispatch of a DMA buffer without the conversions model.
+ */
+void adc_dma_model_advance(uint8_t adc_number, size_t transfers_count);
+
+/**
+ * Buffer and size in transfers configured for the DMA channel of an ADC,
+ * nullptr if none.
+ */
+const void* adc_dma_model_get_buffer(uint8_t adc_number, size_t* size);
+
+/**
+ * Number of DMA interrupts served for an ADC.
+ */
+uint32_t adc_dma_model_get_interrupts(uint8_t adc_number);
+
+#endif // ADC_DMA_MODEL_H_
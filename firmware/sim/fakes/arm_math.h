@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the CMSIS-DSP header. Only provides the
+ *         types and functions used by the application and its libraries,
+ *         implemented with the C math library.
+ */
+
+#ifndef ARM_MATH_H
+#define ARM_MATH_H
+
+#include <stdint.h>
+#include <math.h>
+
+typedef float  float32_t;
+typedef double float64_t;
+typedef int16_t q15_t;
+typedef int32_t q31_t;
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+typedef enum
+{
+    ARM_MATH_SUCCESS        =  0,
+    ARM_MATH_ARGUMENT_ERROR = -1,
+} arm_status;
+
+static inline float32_t arm_sin_f32(float32_t x)
+{
+    return sinf(x);
+}
+
+static inline float32_t arm_cos_f32(float32_t x)
+{
+    return cosf(x);
+}
+
+static inline arm_status arm_sqrt_f32(float32_t in, float32_t* out)
+{
+    if (in < 0.0F) {
+        *out = 0.0F;
+        return ARM_MATH_ARGUMENT_ERROR;
+    }
+    *out = sqrtf(in);
+    return ARM_MATH_SUCCESS;
+}
+
+static inline arm_status arm_atan2_f32(float32_t y, float32_t x,
+                                       float32_t* result)
+{
+    *result = atan2f(y, x);
+    return ARM_MATH_SUCCESS;
+}
+
+static inline void arm_sin_cos_f32(float32_t theta_deg, float32_t* sin_val,
+                                   float32_t* cos_val)
+{
+    float32_t theta = theta_deg * PI / 180.0F;
+    *sin_val = sinf(theta);
+    *cos_val = cosf(theta);
+}
+
+static inline void arm_mult_f32(const float32_t* src_a,
+                                const float32_t* src_b,
+                                float32_t* dst, uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++) {
+        dst[i] = src_a[i] * src_b[i];
+    }
+}
+
+static inline void arm_add_f32(const float32_t* src_a,
+                               const float32_t* src_b,
+                               float32_t* dst, uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++) {
+        dst[i] = src_a[i] + src_b[i];
+    }
+}
+
+static inline q15_t arm_sim_saturate_q15(q31_t value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (q15_t)value;
+}
+
+/**
+ * Same rounding as CMSIS-DSP: the product is truncated by the shift,
+ * which is at most 15.
+ */
+static inline void arm_scale_q15(const q15_t* src, q15_t scale_fract,
+                                 int8_t shift, q15_t* dst,
+                                 uint32_t block_size)
+{
+    int8_t right_shift = 15 - shift;
+    for (uint32_t i = 0; i < block_size; i++) {
+        q31_t product = (q31_t)src[i] * scale_fract;
+        dst[i] = arm_sim_saturate_q15(product >> right_shift);
+    }
+}
+
+static inline void arm_offset_q15(const q15_t* src, q15_t offset,
+                                  q15_t* dst, uint32_t block_size)
+{
+    for (uint32_t i = 0; i < block_size; i++) {
+        dst[i] = arm_sim_saturate_q15((q31_t)src[i] + offset);
+    }
+}
+
+#endif // ARM_MATH_H
@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host ADC configuration for the Data API, on top of the DMA model
+ *         of adc_dma_model.h: adding or removing a channel changes the
+ *         number of channels converted by the model, dual mode is the
+ *         model one. Triggers, oversampling and injected channels are
+ *         not modelled.
+ */
+
+#include "adc.h"
+#include "adc_dma_model.h"
+
+void adc_configure_trigger_source(uint8_t adc_number,
+                                  adc_ev_src_t trigger_source)
+{
+    (void)adc_number;
+    (void)trigger_source;
+}
+
+void adc_configure_discontinuous_mode(uint8_t adc_number,
+                                      uint32_t discontinuous_count)
+{
+    (void)adc_number;
+    (void)discontinuous_count;
+}
+
+int8_t adc_configure_oversampling(uint8_t adc_number, uint16_t ratio,
+                                  uint8_t shift, bool triggered_mode)
+{
+    (void)adc_number;
+    (void)ratio;
+    (void)shift;
+    (void)triggered_mode;
+    return -1;
+}
+
+int8_t adc_get_oversampling_extra_bits(uint8_t adc_number)
+{
+    (void)adc_number;
+    return 0;
+}
+
+void adc_configure_dual_mode(bool enable)
+{
+    adc_dma_model_set_dual_mode(enable);
+}
+
+void adc_add_channel(uint8_t adc_number, uint8_t channel)
+{
+    (void)channel;
+    adc_dma_model_set_channels(adc_number,
+                               adc_get_enabled_channels_count(adc_number) + 1);
+}
+
+void adc_remove_channel(uint8_t adc_number, uint8_t channel)
+{
+    (void)channel;
+    uint32_t count = adc_get_enabled_channels_count(adc_number);
+    if (count > 0) {
+        adc_dma_model_set_channels(adc_number, count - 1);
+    }
+}
+
+void adc_configure_use_dma(uint8_t adc_number, bool use_dma)
+{
+    (void)adc_number;
+    (void)use_dma;
+}
+
+void adc_configure_injected_trigger_source(uint8_t adc_number,
+                                           adc_ev_src_t trigger_source)
+{
+    (void)adc_number;
+    (void)trigger_source;
+}
+
+int8_t adc_add_injected_channel(uint8_t adc_number, uint8_t channel)
+{
+    (void)adc_number;
+    (void)channel;
+    return -1;
+}
+
+uint32_t adc_get_injected_channels_count(uint8_t adc_number)
+{
+    (void)adc_number;
+    return 0;
+}
+
+const volatile uint32_t* adc_get_injected_data_register(uint8_t adc_number,
+                                                        uint8_t rank)
+{
+    (void)adc_number;
+    (void)rank;
+    return nullptr;
+}
+
+void adc_start()
+{
+}
+
+void adc_stop()
+{
+}
+
+void adc_trigger_software_conversion(uint8_t adc_number,
+                                     uint8_t number_of_acquisitions)
+{
+    (void)adc_number;
+    (void)number_of_acquisitions;
+}
+
+void adc_trigger_software_injected_conversion(uint8_t adc_number)
+{
+    (void)adc_number;
+}
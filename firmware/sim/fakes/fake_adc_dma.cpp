@@ -0,0 +1,251 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Host implementation of the adc.h and dma.h functions used by
+ *         data dispatch, on the model of adc_dma_model.h, and of the SoC
+ *         globals of soc.h. When the ADC driver itself is built on fake
+ *         registers (SIM_ADC_DRIVER), its adc.h functions are used.
+ */
+
+#include <string.h>
+
+#include <soc.h>
+
+#include "adc.h"
+#include "dma.h"
+#include "data_dispatch.h"
+#include "adc_dma_model.h"
+
+DWT_Type sim_dwt = {};
+CoreDebug_Type sim_core_debug = {};
+uint32_t SystemCoreClock = 170000000;
+
+static const uint8_t ADCS = 5;
+
+typedef struct {
+    uint8_t channels_count;
+    uint8_t next_rank;
+    // DMA channel
+    void* buffer;
+    size_t size;
+    uint8_t transfer_size;
+    bool interrupts;
+    size_t next_index;
+    // retrieved by dma_get_retrieved_data_count()
+    size_t retrieved_index;
+    bool half_flag;
+    bool complete_flag;
+    uint32_t interrupts_count;
+} adc_dma_channel_t;
+
+static adc_dma_channel_t channels[ADCS];
+static bool dual_mode = false;
+static bool in_interrupt = false;
+
+static void configure(uint8_t adc_number, bool disable_interrupts,
+                      void* buffer, size_t buffer_size, uint8_t transfer_size)
+{
+    adc_dma_channel_t &channel = channels[adc_number - 1];
+    channel.buffer = buffer;
+    channel.size = buffer_size;
+    channel.transfer_size = transfer_size;
+    channel.interrupts = !disable_interrupts;
+    channel.next_index = 0;
+    channel.retrieved_index = 0;
+    channel.half_flag = false;
+    channel.complete_flag = false;
+    channel.next_rank = 0;
+}
+
+/* DMA interrupt: flags are cleared before the dispatch, as by the driver */
+static void serve_interrupts()
+{
+    if (in_interrupt) {
+        return;
+    }
+    in_interrupt = true;
+
+    bool served = true;
+    while (served) {
+        served = false;
+        for (uint8_t index = 0; index < ADCS; index++) {
+            adc_dma_channel_t &channel = channels[index];
+            if (!channel.interrupts
+                || !(channel.half_flag || channel.complete_flag)) {
+                continue;
+            }
+            // As the driver: half transfer first when both are pending
+            if (channel.half_flag) {
+                channel.half_flag = false;
+            } else {
+                channel.complete_flag = false;
+            }
+            channel.interrupts_count++;
+            data_dispatch_do_dispatch(index + 1);
+            served = true;
+        }
+    }
+
+    in_interrupt = false;
+}
+
+static void transfer(adc_dma_channel_t &channel, uint16_t value,
+                     uint16_t slave_value)
+{
+    if (channel.buffer == nullptr) {
+        return;
+    }
+
+    if (channel.transfer_size == sizeof(uint32_t)) {
+        uint32_t word = ((uint32_t)slave_value << 16) | value;
+        ((uint32_t*)channel.buffer)[channel.next_index] = word;
+    } else {
+        ((uint16_t*)channel.buffer)[channel.next_index] = value;
+    }
+
+    channel.next_index++;
+    if (channel.next_index == channel.size / 2) {
+        channel.half_flag = true;
+    }
+    if (channel.next_index == channel.size) {
+        channel.complete_flag = true;
+        channel.next_index = 0;
+    }
+}
+
+void adc_dma_model_reset()
+{
+    memset(channels, 0, sizeof(channels));
+    dual_mode = false;
+    in_interrupt = false;
+}
+
+void adc_dma_model_set_channels(uint8_t adc_number, uint8_t channels_count)
+{
+    channels[adc_number - 1].channels_count = channels_count;
+}
+
+void adc_dma_model_set_dual_mode(bool enable)
+{
+    dual_mode = enable;
+}
+
+uint8_t adc_dma_model_convert(uint8_t adc_number, uint16_t value,
+                              uint16_t slave_value)
+{
+    adc_dma_channel_t &channel = channels[adc_number - 1];
+    uint8_t rank = channel.next_rank + 1;
+
+    if (channel.channels_count > 0) {
+        channel.next_rank = rank % channel.channels_count;
+    }
+    if (dual_mode && adc_number == 1) {
+        adc_dma_channel_t &slave = channels[1];
+        if (slave.channels_count > 0) {
+            slave.next_rank = (slave.next_rank + 1) % slave.channels_count;
+        }
+    }
+
+    transfer(channel, value, slave_value);
+    serve_interrupts();
+
+    return rank;
+}
+
+void adc_dma_model_advance(uint8_t adc_number, size_t transfers_count)
+{
+    adc_dma_channel_t &channel = channels[adc_number - 1];
+    if (channel.size > 0) {
+        channel.next_index = (channel.next_index + transfers_count)
+                             % channel.size;
+    }
+}
+
+const void* adc_dma_model_get_buffer(uint8_t adc_number, size_t* size)
+{
+    const adc_dma_channel_t &channel = channels[adc_number - 1];
+    *size = channel.size;
+    return channel.buffer;
+}
+
+uint32_t adc_dma_model_get_interrupts(uint8_t adc_number)
+{
+    return channels[adc_number - 1].interrupts_count;
+}
+
+#ifndef SIM_ADC_DRIVER
+
+/* adc.h */
+
+uint32_t adc_get_enabled_channels_count(uint8_t adc_number)
+{
+    return channels[adc_number - 1].channels_count;
+}
+
+bool adc_is_dual_mode_active()
+{
+    return dual_mode;
+}
+
+#endif // SIM_ADC_DRIVER
+
+/* dma.h */
+
+void dma_configure_adc_acquisition(uint8_t adc_number,
+                                   bool disable_interrupts,
+                                   uint16_t* buffer,
+                                   size_t buffer_size)
+{
+    configure(adc_number, disable_interrupts, buffer, buffer_size,
+              sizeof(uint16_t));
+}
+
+void dma_configure_adc12_dual_acquisition(bool disable_interrupts,
+                                          uint32_t* buffer,
+                                          size_t buffer_size)
+{
+    configure(1, disable_interrupts, buffer, buffer_size, sizeof(uint32_t));
+}
+
+uint32_t dma_get_retrieved_data_count(uint8_t adc_number)
+{
+    adc_dma_channel_t &channel = channels[adc_number - 1];
+
+    size_t count = channel.next_index >= channel.retrieved_index
+                   ? channel.next_index - channel.retrieved_index
+                   : channel.next_index + channel.size
+                     - channel.retrieved_index;
+    channel.retrieved_index = channel.next_index;
+
+    return count;
+}
+
+uint32_t dma_get_next_write_index(uint8_t adc_number)
+{
+    return channels[adc_number - 1].next_index;
+}
+
+bool dma_is_transfer_pending(uint8_t adc_number)
+{
+    const adc_dma_channel_t &channel = channels[adc_number - 1];
+    return channel.half_flag || channel.complete_flag;
+}
@@ -0,0 +1,541 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host implementation of the OwnTech APIs used by the application.
+ */
+
+#include "TaskAPI.h"
+#include "SpinAPI.h"
+#include "ShieldAPI.h"
+#include "SafetyAPI.h"
+
+TaskAPI task;
+
+SpinAPI spin;
+LedHAL SpinAPI::led;
+DataAPI SpinAPI::data;
+
+ShieldAPI shield;
+SensorsAPI ShieldAPI::sensors;
+PowerAPI ShieldAPI::power;
+
+SafetyAPI safety;
+
+/* Timestamps have the same frequency as the Spin core clock */
+static const uint32_t TIMESTAMP_FREQUENCY = 170000000;
+
+/* Default uSolarVerter shield calibration, from the device tree */
+typedef struct {
+    float32_t gain;
+    float32_t offset;
+} sensor_calibration_t;
+
+static const sensor_calibration_t sensors_calibration[SENSORS_COUNT + 1] = {
+    {1.0F,    0.0F},     // UNDEFINED_SENSOR
+    {0.045F, -92.203F},  // VLow
+    {0.045F, -92.203F},  // VAC
+    {0.029964F, 0.0F},   // VDCBus
+    {0.005F, -10.0F},    // ILow1
+    {0.005F, -10.0F},    // ILow2
+    {0.005F, -10.0F},    // IAC
+    {1.0F,    0.0F},     // TEMP_SENSOR
+};
+
+static const float32_t ADC_MAX_RAW = 4095.0F;
+
+/* Task API */
+
+int8_t TaskAPI::createCritical(task_function_t periodic_task,
+                               uint32_t task_period_us,
+                               scheduling_interrupt_source_t int_source)
+{
+    (void)int_source;
+    if (periodic_task == nullptr || task_period_us == 0) {
+        return -1;
+    }
+    critical_task = periodic_task;
+    critical_period_us = task_period_us;
+    return 0;
+}
+
+void TaskAPI::startCritical(bool manage_data_acquisition)
+{
+    (void)manage_data_acquisition;
+    if (critical_task != nullptr) {
+        critical_started = true;
+    }
+}
+
+void TaskAPI::stopCritical()
+{
+    critical_started = false;
+}
+
+/* Sub-tasks budgets are in host clock units, i.e. ns */
+int8_t TaskAPI::createCriticalSubTask(task_function_t sub_task,
+                                      uint16_t divider, uint32_t budget_ns)
+{
+    return task_subtasks_add(sub_task, divider, budget_ns);
+}
+
+int8_t TaskAPI::getCriticalSubTaskStatistics(uint8_t sub_task,
+                                             task_subtask_stats_t& stats)
+{
+    const task_subtask_stats_t* sub_task_stats =
+        task_subtasks_get_stats(sub_task);
+    if (sub_task_stats == nullptr) {
+        return -1;
+    }
+    stats = *sub_task_stats;
+    return 0;
+}
+
+void TaskAPI::resetCriticalSubTaskStatistics()
+{
+    task_subtasks_reset_stats();
+}
+
+int8_t TaskAPI::createBackground(task_function_t routine)
+{
+    if (routine == nullptr || background_count >= SIM_BACKGROUND_TASKS_MAX) {
+        return -1;
+    }
+    background_tasks[background_count] = routine;
+    return background_count++;
+}
+
+void TaskAPI::startBackground(uint8_t task_number)
+{
+    if (task_number < background_count) {
+        background_started[task_number] = true;
+    }
+}
+
+void TaskAPI::stopBackground(uint8_t task_number)
+{
+    if (task_number < background_count) {
+        background_started[task_number] = false;
+    }
+}
+
+void TaskAPI::suspendBackgroundMs(uint32_t duration_ms)
+{
+    background_suspend_us += (uint64_t)duration_ms * 1000;
+}
+
+void TaskAPI::suspendBackgroundUs(uint32_t duration_us)
+{
+    background_suspend_us += duration_us;
+}
+
+int8_t TaskAPI::defineProfilingSection(const char* name)
+{
+    return task_profiling_define_section(name);
+}
+
+uint8_t TaskAPI::getProfilingSectionsCount()
+{
+    return task_profiling_get_sections_count();
+}
+
+int8_t TaskAPI::getProfilingStatistics(uint8_t section,
+                                       task_profiling_section_t& stats)
+{
+    const task_profiling_section_t* section_stats =
+        task_profiling_get_section(section);
+    if (section_stats == nullptr) {
+        return -1;
+    }
+    stats = *section_stats;
+    return 0;
+}
+
+void TaskAPI::resetProfiling()
+{
+    task_profiling_reset();
+}
+
+uint32_t TaskAPI::getProfilingFrequency()
+{
+    return task_profiling_get_frequency();
+}
+
+int8_t TaskAPI::setCriticalOverrunPolicy(task_overrun_policy_t policy,
+                                         uint8_t consecutive_overruns,
+                                         task_overrun_callback_t callback)
+{
+    return task_deadline_set_policy(policy, consecutive_overruns, callback);
+}
+
+int8_t TaskAPI::getCriticalDeadlineStatistics(task_deadline_stats_t& stats)
+{
+    stats = *task_deadline_get_stats();
+    return 0;
+}
+
+void TaskAPI::resetCriticalDeadlineStatistics()
+{
+    task_deadline_reset();
+}
+
+/* Spin API */
+
+void LedHAL::turnOn()
+{
+    is_on = true;
+}
+
+void LedHAL::turnOff()
+{
+    is_on = false;
+}
+
+void LedHAL::toggle()
+{
+    is_on = !is_on;
+}
+
+DataAPI::DataAPI()
+{
+    for (uint8_t adc_index = 0; adc_index < ADC_COUNT; adc_index++) {
+        trigger_sources[adc_index] = TRIG_SOFTWARE;
+        timing_stats_reset(&dispatch_timing_stats[adc_index], 0, 0);
+    }
+}
+
+void DataAPI::configureTriggerSource(adc_t adc_number,
+                                     trigger_source_t trigger_source)
+{
+    if (adc_number >= ADC_1 && adc_number <= ADC_5) {
+        trigger_sources[adc_number - 1] = trigger_source;
+    }
+}
+
+void DataAPI::configureDiscontinuousMode(adc_t adc_number,
+                                         uint32_t discontinuous_count)
+{
+    (void)adc_number;
+    (void)discontinuous_count;
+}
+
+void DataAPI::configureDualSimultaneousMode(bool enable)
+{
+    (void)enable;
+}
+
+uint32_t DataAPI::getTimestampFrequency()
+{
+    return TIMESTAMP_FREQUENCY;
+}
+
+int8_t DataAPI::getDispatchTimingStatistics(adc_t adc_number,
+                                            timing_stats_t& stats)
+{
+    if (adc_number < ADC_1 || adc_number > ADC_5) {
+        return -1;
+    }
+    stats = dispatch_timing_stats[adc_number - 1];
+    return 0;
+}
+
+int8_t DataAPI::resetDispatchTimingStatistics(adc_t adc_number,
+                                              float32_t expected_period_us,
+                                              float32_t bin_width_us)
+{
+    if (adc_number < ADC_1 || adc_number > ADC_5) {
+        return -1;
+    }
+    if (expected_period_us < 0 || bin_width_us < 0) {
+        return -1;
+    }
+
+    float32_t units_per_us = (float32_t)TIMESTAMP_FREQUENCY / 1000000;
+    timing_stats_reset(&dispatch_timing_stats[adc_number - 1],
+                       expected_period_us * units_per_us,
+                       bin_width_us * units_per_us);
+    return 0;
+}
+
+void DataAPI::dispatch(uint32_t timestamp)
+{
+    for (uint8_t adc_index = 0; adc_index < ADC_COUNT; adc_index++) {
+        if (trigger_sources[adc_index] == TRIG_PWM) {
+            timing_stats_add_timestamp(&dispatch_timing_stats[adc_index],
+                                       timestamp);
+        }
+    }
+}
+
+/* Shield API: sensors */
+
+int8_t SensorsAPI::enableSensor(sensor_t sensor_name, adc_t adc_num)
+{
+    (void)adc_num;
+    if (sensor_name == UNDEFINED_SENSOR || sensor_name > SENSORS_COUNT) {
+        return -1;
+    }
+    enabled[sensor_name] = true;
+    data_valid[sensor_name] = DATA_IS_MISSING;
+    return 0;
+}
+
+void SensorsAPI::setMeasuredValue(sensor_t sensor_name, float32_t value)
+{
+    if (sensor_name == UNDEFINED_SENSOR || sensor_name > SENSORS_COUNT) {
+        return;
+    }
+
+    const sensor_calibration_t& calibration = sensors_calibration[sensor_name];
+    float32_t raw = roundf((value - calibration.offset) / calibration.gain);
+    if (raw < 0.0F) {
+        raw = 0.0F;
+    }
+    if (raw > ADC_MAX_RAW) {
+        raw = ADC_MAX_RAW;
+    }
+    values[sensor_name] = raw * calibration.gain + calibration.offset;
+}
+
+void SensorsAPI::newAcquisition(uint32_t timestamp)
+{
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        if (enabled[sensor]) {
+            data_valid[sensor] = DATA_IS_OK;
+        }
+    }
+    latest_timestamp = timestamp;
+    sequence++;
+}
+
+float32_t SensorsAPI::getLatestValue(sensor_t sensor_name,
+                                     uint8_t* dataValid,
+                                     uint32_t* timestamp)
+{
+    uint8_t valid = DATA_IS_MISSING;
+    float32_t value = NO_VALUE;
+
+    if (sensor_name != UNDEFINED_SENSOR && sensor_name <= SENSORS_COUNT
+        && enabled[sensor_name]) {
+        valid = data_valid[sensor_name];
+        if (valid != DATA_IS_MISSING) {
+            value = values[sensor_name];
+            data_valid[sensor_name] = DATA_IS_OLD;
+        }
+    }
+
+    if (dataValid != nullptr) {
+        *dataValid = valid;
+    }
+    if (timestamp != nullptr) {
+        *timestamp = latest_timestamp;
+    }
+    return value;
+}
+
+void SensorsAPI::getLatestValues(sensors_snapshot_t& snapshot)
+{
+    snapshot.values[UNDEFINED_SENSOR] = NO_VALUE;
+    snapshot.data_valid[UNDEFINED_SENSOR] = DATA_IS_MISSING;
+
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        snapshot.values[sensor] =
+            getLatestValue((sensor_t)sensor, &snapshot.data_valid[sensor]);
+    }
+    snapshot.sequence = sequence;
+}
+
+/* Shield API: power */
+
+void PowerAPI::initBuck(leg_t leg)
+{
+    initLeg(leg);
+}
+
+void PowerAPI::initBoost(leg_t leg)
+{
+    initLeg(leg);
+}
+
+void PowerAPI::initLeg(leg_t leg)
+{
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (leg == ALL || leg == l) {
+            initialized[l] = true;
+        }
+    }
+}
+
+bool PowerAPI::isLegInitialized(leg_t leg)
+{
+    return leg < ALL && initialized[leg];
+}
+
+void PowerAPI::writeDutyCycle(uint8_t leg, float32_t duty_value)
+{
+    if (duty_value < 0.0F) {
+        duty_value = 0.0F;
+    }
+    if (duty_value > 1.0F) {
+        duty_value = 1.0F;
+    }
+
+    preload[leg] = duty_value;
+    preload_period[leg] = write_period;
+    if (update_after_writes) {
+        updateEvent();
+    }
+}
+
+void PowerAPI::setDutyCycle(leg_t leg, float32_t duty_value)
+{
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (leg == ALL || leg == l) {
+            writeDutyCycle(l, duty_value);
+        }
+    }
+}
+
+void PowerAPI::setDutyCycles(const leg_duty_cycle_t* duty_cycles,
+                             uint8_t count)
+{
+    for (uint8_t i = 0; i < count; i++) {
+        if (isLegInitialized(duty_cycles[i].leg)) {
+            update_disabled[duty_cycles[i].leg] = true;
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (isLegInitialized(duty_cycles[i].leg)) {
+            writeDutyCycle(duty_cycles[i].leg, duty_cycles[i].duty_value);
+        }
+    }
+
+    for (uint8_t i = 0; i < count; i++) {
+        if (isLegInitialized(duty_cycles[i].leg)) {
+            update_disabled[duty_cycles[i].leg] = false;
+        }
+    }
+    if (update_after_writes) {
+        updateEvent();
+    }
+}
+
+void PowerAPI::updateEvent()
+{
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (!update_disabled[l]) {
+            duty_cycle[l] = preload[l];
+            active_period[l] = preload_period[l];
+        }
+    }
+
+    /* Running legs that must switch together come from the same period */
+    int8_t first = -1;
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (!synchronous[l] || !started[l]) {
+            continue;
+        }
+        if (first < 0) {
+            first = l;
+        } else if (active_period[l] != active_period[first]) {
+            split_updates++;
+            return;
+        }
+    }
+}
+
+void PowerAPI::setDeadTime(leg_t leg, uint16_t ns_rising_dt,
+                           uint16_t ns_falling_dt)
+{
+    (void)leg;
+    (void)ns_rising_dt;
+    (void)ns_falling_dt;
+}
+
+void PowerAPI::start(leg_t leg)
+{
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (leg == ALL || leg == l) {
+            started[l] = true;
+        }
+    }
+}
+
+void PowerAPI::stop(leg_t leg)
+{
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (leg == ALL || leg == l) {
+            started[l] = false;
+        }
+    }
+}
+
+/* Safety API */
+
+int8_t SafetyAPI::setChannelHardwareTrip(sensor_t* sensors_trip,
+                                         float32_t* threshold_max,
+                                         uint8_t sensors_trip_number)
+{
+    // As on the board: fault states can not be written while running
+    for (uint8_t l = 0; l < LEGS_COUNT; l++) {
+        if (shield.power.started[l]) {
+            return -1;
+        }
+    }
+    for (uint8_t i = 0; i < sensors_trip_number; i++) {
+        hw_trip_enabled[sensors_trip[i]] = true;
+        hw_trip_threshold[sensors_trip[i]] = threshold_max[i];
+    }
+    return 0;
+}
+
+bool SafetyAPI::getChannelHardwareTrip(sensor_t sensor_trip)
+{
+    return hw_trip_latched[sensor_trip];
+}
+
+void SafetyAPI::clearHardwareTrip()
+{
+    for (uint8_t s = 0; s <= SENSORS_COUNT; s++) {
+        hw_trip_latched[s] = false;
+    }
+}
+
+bool SafetyAPI::getChannelError(sensor_t sensors_error)
+{
+    return hw_trip_latched[sensors_error];
+}
+
+uint32_t SafetyAPI::getTripCount()
+{
+    return trip_count;
+}
+
+bool SafetyAPI::checkHardwareTrip(sensor_t sensor, float32_t value)
+{
+    if (!hw_trip_enabled[sensor] || hw_trip_latched[sensor]
+        || value <= hw_trip_threshold[sensor]) {
+        return false;
+    }
+    hw_trip_latched[sensor] = true;
+    trip_count++;
+    return true;
+}
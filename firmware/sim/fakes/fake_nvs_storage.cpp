@@ -0,0 +1,187 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Host implementation of nvs_storage.h on the flash model of
+ *         nvs_storage_model.h. Return values are the ones of the board,
+ *         including sizes returned as int8_t.
+ */
+
+#include <errno.h>
+#include <string.h>
+#include <map>
+#include <vector>
+
+#include "nvs_storage.h"
+#include "nvs_storage_model.h"
+
+static const uint16_t current_storage_version = 0x0001;
+
+/* Latest version of each item */
+static std::map<uint16_t, std::vector<uint8_t>> items;
+
+/* Space used in the current sector */
+static uint32_t sector_used = 0;
+static uint32_t erases = 0;
+static uint32_t max_item_size = 0;
+static int32_t writes_before_power_loss = -1;
+
+/* Close and garbage collection done ATEs are reserved in each sector */
+static const uint32_t sector_capacity = NVS_MODEL_SECTOR_SIZE
+                                        - 2 * NVS_MODEL_ATE_SIZE;
+
+static uint32_t entry_size(uint32_t data_size)
+{
+    uint32_t blocks = (data_size + NVS_MODEL_WRITE_BLOCK - 1)
+                      / NVS_MODEL_WRITE_BLOCK;
+    return blocks * NVS_MODEL_WRITE_BLOCK + NVS_MODEL_ATE_SIZE;
+}
+
+static int write_item(uint16_t id, const void* data, uint32_t size)
+{
+    if (writes_before_power_loss == 0) {
+        return -EIO;
+    }
+
+    const uint8_t* bytes = (const uint8_t*)data;
+    auto item = items.find(id);
+    if (item != items.end() && item->second.size() == size
+        && memcmp(item->second.data(), bytes, size) == 0) {
+        /* Same data as the latest version: nothing written */
+        return 0;
+    }
+
+    uint32_t required = entry_size(size);
+    if (sector_used + required > sector_capacity) {
+        /* Close the sector, copy the latest items to the erased one */
+        erases++;
+        sector_used = nvs_model_live_bytes();
+        if (sector_used + required > sector_capacity) {
+            return -ENOSPC;
+        }
+    }
+
+    sector_used += required;
+    items[id].assign(bytes, bytes + size);
+    if (size > max_item_size) {
+        max_item_size = size;
+    }
+    if (writes_before_power_loss > 0) {
+        writes_before_power_loss--;
+    }
+    return size;
+}
+
+/* Model access */
+
+void nvs_model_erase()
+{
+    items.clear();
+    sector_used = 0;
+    erases = 0;
+    max_item_size = 0;
+}
+
+void nvs_model_set_power_loss(int32_t writes)
+{
+    writes_before_power_loss = writes;
+}
+
+uint32_t nvs_model_live_bytes()
+{
+    uint32_t bytes = 0;
+    for (const auto& item : items) {
+        bytes += entry_size(item.second.size());
+    }
+    return bytes;
+}
+
+uint32_t nvs_model_free_bytes()
+{
+    return sector_capacity - nvs_model_live_bytes();
+}
+
+uint32_t nvs_model_erases()
+{
+    return erases;
+}
+
+uint32_t nvs_model_max_item_size()
+{
+    return max_item_size;
+}
+
+uint32_t nvs_model_items(uint16_t category)
+{
+    uint32_t count = 0;
+    for (const auto& item : items) {
+        if ((item.first & 0xFF00) == category) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/* nvs_storage.h */
+
+int8_t nvs_storage_store_data(uint16_t data_id,
+                              const void* data,
+                              uint8_t data_size)
+{
+    if (items.count(VERSION) == 0) {
+        int rc = write_item(VERSION, &current_storage_version, 2);
+        if (rc != 2) {
+            return -1;
+        }
+    }
+    return write_item(data_id, data, data_size);
+}
+
+int8_t nvs_storage_retrieve_data(uint16_t data_id,
+                                 void* data_buffer,
+                                 uint8_t data_buffer_size)
+{
+    auto item = items.find(data_id);
+    if (item == items.end()) {
+        return -ENOENT;
+    }
+    if (item->second.size() > data_buffer_size) {
+        return -1;
+    }
+    memcpy(data_buffer, item->second.data(), item->second.size());
+    return item->second.size();
+}
+
+int8_t nvs_storage_clear_all_stored_data()
+{
+    nvs_model_erase();
+    return 0;
+}
+
+uint16_t nvs_storage_get_current_version()
+{
+    return current_storage_version;
+}
+
+uint16_t nvs_storage_get_version_in_nvs()
+{
+    return items.count(VERSION) == 0 ? 0 : current_storage_version;
+}
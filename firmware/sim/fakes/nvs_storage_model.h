@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Host model of the flash storage behind nvs_storage.h, for the
+ *         simulator and the fault record check. It follows the Zephyr NVS
+ *         file system on the spin board: 2 sectors of 2 kB, data and
+ *         allocation table entries (ATE) written by 8 bytes, a sector
+ *         closed when full and its latest items copied to the erased one.
+ *         Power losses are modelled by failing all the writes after a
+ *         given number.
+ */
+
+#ifndef NVS_STORAGE_MODEL_H_
+#define NVS_STORAGE_MODEL_H_
+
+#include <stdint.h>
+
+static const uint32_t NVS_MODEL_SECTOR_SIZE = 2048;
+static const uint32_t NVS_MODEL_SECTOR_COUNT = 2;
+static const uint32_t NVS_MODEL_WRITE_BLOCK = 8;
+static const uint32_t NVS_MODEL_ATE_SIZE = 8;
+
+/**
+ * Erase the storage.
+ */
+void nvs_model_erase();
+
+/**
+ * Power loss after the given number of successful writes, -1 for never.
+ */
+void nvs_model_set_power_loss(int32_t writes);
+
+/**
+ * Flash space taken in a sector by the latest version of all the items,
+ * with their ATE.
+ */
+uint32_t nvs_model_live_bytes();
+
+/**
+ * Flash space left in a sector once all the latest items are copied to it.
+ */
+uint32_t nvs_model_free_bytes();
+
+/**
+ * Number of sector erases, i.e. of sector changes when full.
+ */
+uint32_t nvs_model_erases();
+
+/**
+ * Largest item written.
+ */
+uint32_t nvs_model_max_item_size();
+
+/**
+ * Number of items whose id is in a category (upper byte of the id).
+ */
+uint32_t nvs_model_items(uint16_t category);
+
+#endif // NVS_STORAGE_MODEL_H_
@@ -0,0 +1,82 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the Spin API seen by the critical task
+ *         scheduling: the Data API members it uses, on top of the data
+ *         dispatch module built on the host.
+ */
+
+#ifndef SPINAPI_H_
+#define SPINAPI_H_
+
+#include <stdint.h>
+
+typedef enum : int8_t
+{
+    UNKNOWN_ADC = -1,
+    DEFAULT_ADC = 0,
+    ADC_1 = 1,
+    ADC_2 = 2,
+    ADC_3 = 3,
+    ADC_4 = 4,
+    ADC_5 = 5
+} adc_t;
+
+enum class DispatchMethod_t
+{
+    on_dma_interrupt,
+    externally_triggered
+};
+
+static const uint8_t ADC_COUNT = 5;
+
+class DataAPI
+{
+public:
+    int8_t start();
+    bool started();
+    int8_t stop();
+
+    void setDispatchMethod(DispatchMethod_t dispatch_method);
+    void setRepetitionsBetweenDispatches(uint32_t repetition);
+    void doFullDispatch();
+    int8_t setDispatchCallback(adc_t adc_number,
+                               void (*callback)(),
+                               uint32_t repetition);
+    bool isDispatchCallbackPending();
+    static uint16_t* getChannelRawValues(adc_t adc_number,
+                                         uint8_t channel_num,
+                                         uint32_t& number_of_values_acquired);
+
+    DispatchMethod_t dispatch_method = DispatchMethod_t::externally_triggered;
+    uint32_t repetition_count_between_dispatches = 0;
+    bool is_started = false;
+};
+
+class SpinAPI
+{
+public:
+    DataAPI data;
+};
+
+extern SpinAPI spin;
+
+#endif // SPINAPI_H_
@@ -0,0 +1,91 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host Spin API for the critical task scheduling: the Data API
+ *         forwards to data dispatch, ADC channels being configured by the
+ *         DMA model instead of the ADC driver.
+ */
+
+#include "SpinAPI.h"
+#include "hrtim.h"
+#include "data_dispatch.h"
+
+SpinAPI spin;
+
+uint32_t sim_hrtim_period_us = 0;
+
+int8_t DataAPI::start()
+{
+    dispatch_t method = (dispatch_method == DispatchMethod_t::on_dma_interrupt)
+                        ? interrupt : task;
+    if (data_dispatch_init(method, repetition_count_between_dispatches) != 0)
+        return -1;
+
+    is_started = true;
+    return 0;
+}
+
+bool DataAPI::started()
+{
+    return is_started;
+}
+
+int8_t DataAPI::stop()
+{
+    is_started = false;
+    return 0;
+}
+
+void DataAPI::setDispatchMethod(DispatchMethod_t dispatch_method)
+{
+    this->dispatch_method = dispatch_method;
+}
+
+void DataAPI::setRepetitionsBetweenDispatches(uint32_t repetition)
+{
+    repetition_count_between_dispatches = repetition;
+}
+
+void DataAPI::doFullDispatch()
+{
+    data_dispatch_do_full_dispatch();
+}
+
+int8_t DataAPI::setDispatchCallback(adc_t adc_number,
+                                    void (*callback)(),
+                                    uint32_t repetition)
+{
+    return data_dispatch_set_dispatch_callback(adc_number, callback,
+                                               repetition);
+}
+
+bool DataAPI::isDispatchCallbackPending()
+{
+    return data_dispatch_is_callback_dispatch_pending();
+}
+
+uint16_t* DataAPI::getChannelRawValues(adc_t adc_number,
+                                       uint8_t channel_num,
+                                       uint32_t& number_of_values_acquired)
+{
+    return data_dispatch_get_acquired_values(adc_number, channel_num,
+                                             number_of_values_acquired);
+}
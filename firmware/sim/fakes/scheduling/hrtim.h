@@ -0,0 +1,84 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the HRTIM driver, limited to the master
+ *         period and periodic event functions used by the critical task
+ *         scheduling. The periodic event is never raised on the host.
+ */
+
+#ifndef HRTIM_H_
+#define HRTIM_H_
+
+#include <stdint.h>
+
+typedef void (*hrtim_callback_t)();
+
+typedef enum
+{
+    MSTR,
+    TIMA,
+    TIMB,
+    TIMC,
+    TIMD,
+    TIME,
+    TIMF
+} hrtim_tu_t;
+
+/* Master period returned by hrtim_period_Master_get_us() */
+extern uint32_t sim_hrtim_period_us;
+
+static inline uint32_t hrtim_period_Master_get_us()
+{
+    return sim_hrtim_period_us;
+}
+
+static inline void hrtim_PeriodicEvent_configure(hrtim_tu_t tu,
+                                                 uint32_t repetition,
+                                                 hrtim_callback_t callback)
+{
+    (void)tu;
+    (void)repetition;
+    (void)callback;
+}
+
+static inline void hrtim_PeriodicEvent_en(hrtim_tu_t tu)
+{
+    (void)tu;
+}
+
+static inline void hrtim_PeriodicEvent_dis(hrtim_tu_t tu)
+{
+    (void)tu;
+}
+
+static inline uint32_t hrtim_PeriodicEvent_GetRep(hrtim_tu_t tu)
+{
+    (void)tu;
+    return 1;
+}
+
+static inline uint32_t hrtim_PeriodicEvent_is_pending(hrtim_tu_t tu)
+{
+    (void)tu;
+    return 0;
+}
+
+#endif // HRTIM_H_
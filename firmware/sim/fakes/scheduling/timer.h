@@ -0,0 +1,78 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the timer driver, limited to the TIM6
+ *         functions used by the critical task scheduling. The timer is
+ *         never ready on the host.
+ */
+
+#ifndef TIMER_H_
+#define TIMER_H_
+
+#include <stdint.h>
+
+struct device
+{
+    int unused;
+};
+
+#define DEVICE_DT_GET(node) (nullptr)
+#define TIMER6_DEVICE 6
+
+typedef void (*timer_callback_t)();
+
+struct timer_config_t
+{
+    uint32_t         timer_enable_irq : 1;
+    timer_callback_t timer_irq_callback;
+    uint32_t         timer_irq_t_usec;
+    uint32_t         timer_use_zero_latency : 1;
+};
+
+static inline bool device_is_ready(const struct device* dev)
+{
+    return dev != nullptr;
+}
+
+static inline void timer_config(const struct device* dev,
+                                const struct timer_config_t* config)
+{
+    (void)dev;
+    (void)config;
+}
+
+static inline void timer_start(const struct device* dev)
+{
+    (void)dev;
+}
+
+static inline void timer_stop(const struct device* dev)
+{
+    (void)dev;
+}
+
+static inline uint32_t timer_is_pending(const struct device* dev)
+{
+    (void)dev;
+    return 0;
+}
+
+#endif // TIMER_H_
@@ -0,0 +1,170 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host devicetree of a shield with the Twist v1.4.1 sensors used
+ *         by the application: V1_LOW, I1_LOW, V_HIGH and I_HIGH on ADC 1
+ *         and ADC 2, and the TEMP_SENSOR_1 thermistor on ADC 4.
+ *
+ *         Only the macros used by the Shield API sensors are provided.
+ *         As in Zephyr, a node identifier is a token, and its properties
+ *         are macros named after it.
+ */
+
+#ifndef ZEPHYR_DEVICETREE_H
+#define ZEPHYR_DEVICETREE_H
+
+#define SIM_DT_CAT(a, b) SIM_DT_CAT_(a, b)
+#define SIM_DT_CAT_(a, b) a##b
+
+#define DT_FOREACH_STATUS_OKAY(compat, fn) \
+    SIM_DT_CAT(SIM_DT_OKAY_, compat)(fn)
+#define DT_FOREACH_CHILD(node_id, fn) \
+    SIM_DT_CAT(node_id, _FOREACH_CHILD)(fn)
+#define DT_PARENT(node_id) SIM_DT_CAT(node_id, _PARENT)
+#define DT_PROP(node_id, prop) SIM_DT_CAT(node_id, _P_##prop)
+#define DT_PROP_OR(node_id, prop, default_value) DT_PROP(node_id, prop)
+#define DT_STRING_TOKEN(node_id, prop) DT_PROP(node_id, prop)
+#define DT_PHANDLE(node_id, prop) \
+    SIM_DT_CAT(node_id, _P_##prop##_IDX_0_PH)
+#define DT_PHA_BY_IDX(node_id, pha, idx, cell) \
+    SIM_DT_CAT(node_id, _P_##pha##_IDX_##idx##_VAL_##cell)
+#define DT_REG_ADDR(node_id) SIM_DT_CAT(node_id, _REG_ADDR)
+
+/* ADCs */
+#define SIM_DT_ADC1_REG_ADDR 0x50000000
+#define SIM_DT_ADC2_REG_ADDR 0x50000100
+#define SIM_DT_ADC4_REG_ADDR 0x50000500
+
+#define SIM_DT_OKAY_shield_sensors(fn) \
+    fn(SIM_DT_V1_LOW) fn(SIM_DT_V_HIGH) fn(SIM_DT_I1_LOW) \
+    fn(SIM_DT_I_HIGH) fn(SIM_DT_TEMP_1)
+
+/* Linear sensor, defaults are the bits of float values */
+#define SIM_DT_V1_LOW_P_sensor_name V1_LOW
+#define SIM_DT_V1_LOW_P_sensor_conv_type LINEAR
+#define SIM_DT_V1_LOW_P_default_gain 0x3d3851ec
+#define SIM_DT_V1_LOW_P_default_offset 0xc2b867f0
+#define SIM_DT_V1_LOW_P_default_r0 0
+#define SIM_DT_V1_LOW_P_default_b 0
+#define SIM_DT_V1_LOW_P_default_rdiv 0
+#define SIM_DT_V1_LOW_P_default_t0 0
+#define SIM_DT_V1_LOW_FOREACH_CHILD(fn) \
+    fn(SIM_DT_V1_LOW_ADC1) fn(SIM_DT_V1_LOW_ADC2)
+
+#define SIM_DT_V1_LOW_ADC1_PARENT SIM_DT_V1_LOW
+#define SIM_DT_V1_LOW_ADC1_P_io_channels_IDX_0_PH SIM_DT_ADC1
+#define SIM_DT_V1_LOW_ADC1_P_io_channels_IDX_0_VAL_input 1
+#define SIM_DT_V1_LOW_ADC1_P_spin_pin 29
+#define SIM_DT_V1_LOW_ADC1_P_differential 0
+
+#define SIM_DT_V1_LOW_ADC2_PARENT SIM_DT_V1_LOW
+#define SIM_DT_V1_LOW_ADC2_P_io_channels_IDX_0_PH SIM_DT_ADC2
+#define SIM_DT_V1_LOW_ADC2_P_io_channels_IDX_0_VAL_input 1
+#define SIM_DT_V1_LOW_ADC2_P_spin_pin 29
+#define SIM_DT_V1_LOW_ADC2_P_differential 0
+
+#define SIM_DT_V_HIGH_P_sensor_name V_HIGH
+#define SIM_DT_V_HIGH_P_sensor_conv_type LINEAR
+#define SIM_DT_V_HIGH_P_default_gain 0x3cf57710
+#define SIM_DT_V_HIGH_P_default_offset 0x00000000
+#define SIM_DT_V_HIGH_P_default_r0 0
+#define SIM_DT_V_HIGH_P_default_b 0
+#define SIM_DT_V_HIGH_P_default_rdiv 0
+#define SIM_DT_V_HIGH_P_default_t0 0
+#define SIM_DT_V_HIGH_FOREACH_CHILD(fn) \
+    fn(SIM_DT_V_HIGH_ADC1) fn(SIM_DT_V_HIGH_ADC2)
+
+#define SIM_DT_V_HIGH_ADC1_PARENT SIM_DT_V_HIGH
+#define SIM_DT_V_HIGH_ADC1_P_io_channels_IDX_0_PH SIM_DT_ADC1
+#define SIM_DT_V_HIGH_ADC1_P_io_channels_IDX_0_VAL_input 9
+#define SIM_DT_V_HIGH_ADC1_P_spin_pin 27
+#define SIM_DT_V_HIGH_ADC1_P_differential 0
+
+#define SIM_DT_V_HIGH_ADC2_PARENT SIM_DT_V_HIGH
+#define SIM_DT_V_HIGH_ADC2_P_io_channels_IDX_0_PH SIM_DT_ADC2
+#define SIM_DT_V_HIGH_ADC2_P_io_channels_IDX_0_VAL_input 9
+#define SIM_DT_V_HIGH_ADC2_P_spin_pin 27
+#define SIM_DT_V_HIGH_ADC2_P_differential 0
+
+#define SIM_DT_I1_LOW_P_sensor_name I1_LOW
+#define SIM_DT_I1_LOW_P_sensor_conv_type LINEAR
+#define SIM_DT_I1_LOW_P_default_gain 0x3ba3d70a
+#define SIM_DT_I1_LOW_P_default_offset 0xc1200000
+#define SIM_DT_I1_LOW_P_default_r0 0
+#define SIM_DT_I1_LOW_P_default_b 0
+#define SIM_DT_I1_LOW_P_default_rdiv 0
+#define SIM_DT_I1_LOW_P_default_t0 0
+#define SIM_DT_I1_LOW_FOREACH_CHILD(fn) \
+    fn(SIM_DT_I1_LOW_ADC1) fn(SIM_DT_I1_LOW_ADC2)
+
+#define SIM_DT_I1_LOW_ADC1_PARENT SIM_DT_I1_LOW
+#define SIM_DT_I1_LOW_ADC1_P_io_channels_IDX_0_PH SIM_DT_ADC1
+#define SIM_DT_I1_LOW_ADC1_P_io_channels_IDX_0_VAL_input 2
+#define SIM_DT_I1_LOW_ADC1_P_spin_pin 30
+#define SIM_DT_I1_LOW_ADC1_P_differential 0
+
+#define SIM_DT_I1_LOW_ADC2_PARENT SIM_DT_I1_LOW
+#define SIM_DT_I1_LOW_ADC2_P_io_channels_IDX_0_PH SIM_DT_ADC2
+#define SIM_DT_I1_LOW_ADC2_P_io_channels_IDX_0_VAL_input 2
+#define SIM_DT_I1_LOW_ADC2_P_spin_pin 30
+#define SIM_DT_I1_LOW_ADC2_P_differential 0
+
+#define SIM_DT_I_HIGH_P_sensor_name I_HIGH
+#define SIM_DT_I_HIGH_P_sensor_conv_type LINEAR
+#define SIM_DT_I_HIGH_P_default_gain 0x3ba3d70a
+#define SIM_DT_I_HIGH_P_default_offset 0xc1200000
+#define SIM_DT_I_HIGH_P_default_r0 0
+#define SIM_DT_I_HIGH_P_default_b 0
+#define SIM_DT_I_HIGH_P_default_rdiv 0
+#define SIM_DT_I_HIGH_P_default_t0 0
+#define SIM_DT_I_HIGH_FOREACH_CHILD(fn) \
+    fn(SIM_DT_I_HIGH_ADC1) fn(SIM_DT_I_HIGH_ADC2)
+
+#define SIM_DT_I_HIGH_ADC1_PARENT SIM_DT_I_HIGH
+#define SIM_DT_I_HIGH_ADC1_P_io_channels_IDX_0_PH SIM_DT_ADC1
+#define SIM_DT_I_HIGH_ADC1_P_io_channels_IDX_0_VAL_input 8
+#define SIM_DT_I_HIGH_ADC1_P_spin_pin 26
+#define SIM_DT_I_HIGH_ADC1_P_differential 0
+
+#define SIM_DT_I_HIGH_ADC2_PARENT SIM_DT_I_HIGH
+#define SIM_DT_I_HIGH_ADC2_P_io_channels_IDX_0_PH SIM_DT_ADC2
+#define SIM_DT_I_HIGH_ADC2_P_io_channels_IDX_0_VAL_input 8
+#define SIM_DT_I_HIGH_ADC2_P_spin_pin 26
+#define SIM_DT_I_HIGH_ADC2_P_differential 0
+
+/* Thermistor sensor */
+#define SIM_DT_TEMP_1_P_sensor_name TEMP_SENSOR_1
+#define SIM_DT_TEMP_1_P_sensor_conv_type THERMISTANCE
+#define SIM_DT_TEMP_1_P_default_gain 0
+#define SIM_DT_TEMP_1_P_default_offset 0
+#define SIM_DT_TEMP_1_P_default_r0 0x461c4000
+#define SIM_DT_TEMP_1_P_default_b 0x4557a000
+#define SIM_DT_TEMP_1_P_default_rdiv 0x469c4000
+#define SIM_DT_TEMP_1_P_default_t0 0x43951333
+#define SIM_DT_TEMP_1_FOREACH_CHILD(fn) fn(SIM_DT_TEMP_1_ADC4)
+
+#define SIM_DT_TEMP_1_ADC4_PARENT SIM_DT_TEMP_1
+#define SIM_DT_TEMP_1_ADC4_P_io_channels_IDX_0_PH SIM_DT_ADC4
+#define SIM_DT_TEMP_1_ADC4_P_io_channels_IDX_0_VAL_input 5
+#define SIM_DT_TEMP_1_ADC4_P_spin_pin 6
+#define SIM_DT_TEMP_1_ADC4_P_differential 0
+
+#endif // ZEPHYR_DEVICETREE_H
@@ -0,0 +1,35 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the Zephyr console header.
+ *         The simulator does not read from the console: reads return
+ *         an empty line.
+ */
+
+#ifndef ZEPHYR_CONSOLE_CONSOLE_H
+#define ZEPHYR_CONSOLE_CONSOLE_H
+
+static inline int console_getchar(void)
+{
+    return '\n';
+}
+
+#endif // ZEPHYR_CONSOLE_CONSOLE_H
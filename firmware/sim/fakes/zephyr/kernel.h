@@ -0,0 +1,96 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host replacement for the Zephyr kernel header, limited to the
+ *         heap, interrupt locking, busy waits and thread types used by
+ *         the OwnTech modules built on the host. Interrupts are modelled
+ *         by direct calls, so locking them does nothing, and busy waits
+ *         return at once. Heap blocks are counted in C++, and allocations
+ *         can be made to fail.
+ */
+
+#ifndef ZEPHYR_KERNEL_H
+#define ZEPHYR_KERNEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <zephyr/sys/printk.h>
+#include <zephyr/devicetree.h>
+
+/* Zephyr kernel gets the SoC definitions, such as SystemCoreClock */
+#include <soc.h>
+
+#ifdef __cplusplus
+/* Heap blocks allocated and not freed, and the limit after which
+ * allocations fail */
+inline size_t sim_heap_blocks = 0;
+inline size_t sim_heap_blocks_limit = SIZE_MAX;
+#endif
+
+static inline void* k_malloc(size_t size)
+{
+#ifdef __cplusplus
+    if (sim_heap_blocks >= sim_heap_blocks_limit) {
+        return NULL;
+    }
+    sim_heap_blocks++;
+#endif
+    return malloc(size);
+}
+
+static inline void k_free(void* ptr)
+{
+#ifdef __cplusplus
+    if (ptr != NULL) {
+        sim_heap_blocks--;
+    }
+#endif
+    free(ptr);
+}
+
+static inline unsigned int irq_lock(void)
+{
+    return 0;
+}
+
+static inline void irq_unlock(unsigned int key)
+{
+    (void)key;
+}
+
+static inline void k_busy_wait(uint32_t usec_to_wait)
+{
+    (void)usec_to_wait;
+}
+
+struct k_thread
+{
+    int unused;
+};
+
+typedef uint8_t k_thread_stack_t;
+typedef struct k_thread* k_tid_t;
+typedef void (*k_thread_entry_t)(void*, void*, void*);
+
+#endif // ZEPHYR_KERNEL_H
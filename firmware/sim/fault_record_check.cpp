@@ -0,0 +1,255 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Fault record check: checks the pre-trigger ring of the fault
+ *         recorder, then the storage of records in the NVS on the flash
+ *         model of fakes/nvs_storage_model.h: round trip, item sizes and
+ *         ids, power losses while storing, clearing, and the flash space
+ *         left with the worst case calibration and threshold items.
+ *
+ *         Usage: fault_record_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "fault_recorder.h"
+#include "nvs_storage.h"
+#include "nvs_storage_model.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* Value of a channel at a period, unique across the test */
+static float32_t channel_value(uint32_t tick, uint8_t channel)
+{
+    return tick * 10.0F + channel;
+}
+
+static void record_periods(FaultRecorder& recorder, uint32_t first,
+                           uint32_t count)
+{
+    for (uint32_t tick = first; tick < first + count; tick++) {
+        recorder.sample(channel_value(tick, 0), channel_value(tick, 1),
+                        channel_value(tick, 2), channel_value(tick, 3),
+                        channel_value(tick, 4), channel_value(tick, 5));
+    }
+}
+
+/* Samples of the periods up to last, zeros before first */
+static bool has_samples(const fault_record_t& record, uint32_t first,
+                        uint32_t last)
+{
+    for (uint8_t sample = 0; sample < FAULT_RECORD_SAMPLES; sample++) {
+        int64_t tick = (int64_t)last - (FAULT_RECORD_SAMPLES - 1) + sample;
+        for (uint8_t channel = 0; channel < FAULT_CHANNELS; channel++) {
+            float32_t expected = tick < (int64_t)first
+                                 ? 0.0F : channel_value(tick, channel);
+            if (record.samples[channel][sample] != expected) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void check_ring()
+{
+    FaultRecorder recorder;
+    fault_record_t record;
+
+    check(!recorder.collect(record), "nothing to collect before a trip");
+
+    /* Trip before the ring is full */
+    record_periods(recorder, 1, 5);
+    check(recorder.trip(FAULT_CAUSE_OVERCURRENT, 1, 5, 0x10),
+          "first trip freezes the ring");
+    check(recorder.collect(record), "trip is collected");
+    check(record.header.layout == FAULT_RECORD_LAYOUT
+          && record.header.cause == FAULT_CAUSE_OVERCURRENT
+          && record.header.mode == 1 && record.header.tick == 5
+          && record.header.sensor_errors == 0x10
+          && record.header.samples == 5,
+          "header of a trip before the ring is full");
+    check(has_samples(record, 1, 5), "samples before the ring is full");
+
+    /* Trip after the ring wrapped, samples after the trip are ignored */
+    record_periods(recorder, 6, 3 * FAULT_RECORD_SAMPLES + 7);
+    uint32_t last = 5 + 3 * FAULT_RECORD_SAMPLES + 7;
+    check(recorder.trip(FAULT_CAUSE_SAFETY, 4, last, 0),
+          "re-armed by the collect");
+    check(!recorder.trip(FAULT_CAUSE_OVERRUN, 3, last + 1, 0),
+          "trip before the collect is ignored");
+    record_periods(recorder, last + 1, 10);
+    check(recorder.collect(record), "second trip is collected");
+    check(record.header.cause == FAULT_CAUSE_SAFETY
+          && record.header.samples == FAULT_RECORD_SAMPLES,
+          "header of a trip after the ring wrapped");
+    check(has_samples(record, 0, last), "samples after the ring wrapped");
+    check(!recorder.collect(record), "a trip is collected once");
+}
+
+static void make_record(fault_record_t& record, uint32_t count)
+{
+    memset(&record, 0, sizeof(record));
+    record.header.layout = FAULT_RECORD_LAYOUT;
+    record.header.cause = FAULT_CAUSE_OVERCURRENT;
+    record.header.mode = 4;
+    record.header.samples = FAULT_RECORD_SAMPLES;
+    record.header.count = count;
+    record.header.tick = 1000 * count;
+    record.header.sensor_errors = 1 << 4;
+    for (uint8_t sample = 0; sample < FAULT_RECORD_SAMPLES; sample++) {
+        for (uint8_t channel = 0; channel < FAULT_CHANNELS; channel++) {
+            record.samples[channel][sample] =
+                channel_value(count * 100 + sample, channel);
+        }
+    }
+}
+
+static bool is_stored(const fault_record_t& expected)
+{
+    fault_record_t record;
+    return fault_record_retrieve(&record) == 0
+           && memcmp(&record, &expected, sizeof(record)) == 0;
+}
+
+static void check_storage()
+{
+    fault_record_t record;
+    fault_record_t previous;
+
+    nvs_model_erase();
+    check(fault_record_retrieve(&record) < 0, "no record in erased flash");
+
+    /* Round trip, items of the FAULT_RECORD category only */
+    make_record(previous, 1);
+    check(fault_record_store(&previous) == 0, "record is stored");
+    check(is_stored(previous), "stored record is read back");
+    check(nvs_model_max_item_size() <= INT8_MAX,
+          "item sizes fit in the int8_t returned by nvs_storage");
+    uint32_t record_items = nvs_model_items(FAULT_RECORD);
+    check(record_items > 1 && nvs_model_items(VERSION) == 1
+          && nvs_model_items(ADC_CALIBRATION) == 0
+          && nvs_model_items(MEASURE_THRESHOLD) == 0,
+          "record items are in the FAULT_RECORD category");
+
+    /* Power loss after each write of the next record */
+    make_record(record, 2);
+    int torn = 0;
+    for (int32_t writes = 0; writes <= (int32_t)record_items; writes++) {
+        check(fault_record_store(&previous) == 0, "previous record restored");
+        nvs_model_set_power_loss(writes);
+        bool complete = fault_record_store(&record) == 0;
+        nvs_model_set_power_loss(-1);
+
+        fault_record_t read;
+        int8_t rc = fault_record_retrieve(&read);
+        if (complete) {
+            check(rc == 0 && memcmp(&read, &record, sizeof(read)) == 0,
+                  "record completely stored is read back");
+        } else if (rc == 0) {
+            check(memcmp(&read, &previous, sizeof(read)) == 0,
+                  "interrupted store keeps the previous record or none");
+        } else {
+            torn++;
+        }
+    }
+    check(torn > 0, "interrupted stores are detected");
+
+    /* Clear keeps the count */
+    check(fault_record_clear(2) == 0, "record is cleared");
+    check(fault_record_retrieve(&record) == 1 && record.header.count == 2
+          && record.header.cause == FAULT_CAUSE_NONE,
+          "cleared record keeps its count");
+    make_record(record, 3);
+    check(fault_record_store(&record) == 0 && is_stored(record),
+          "record stored after a clear");
+
+    printf("record of %u items, largest %u bytes, %u bytes of flash\n",
+           record_items, nvs_model_max_item_size(),
+           nvs_model_live_bytes());
+}
+
+/* Calibration and threshold items of all the sensors, with the longest
+ * names: the largest items stored by the Spin and Safety APIs */
+static void store_worst_case_items(uint8_t sensors)
+{
+    uint8_t calibration[1 + 23 + 1 + 1 + 1 + 4 * 4] = {};
+    uint8_t threshold[1 + 23 + 1 + 4 + 4] = {};
+
+    for (uint8_t sensor = 1; sensor <= sensors; sensor++) {
+        uint8_t adc = 1 + sensor % 5;
+        uint16_t id = ADC_CALIBRATION | adc << 4 | sensor;
+        calibration[0] = sensor;
+        check(nvs_storage_store_data(id, calibration,
+                                     sizeof(calibration)) > 0,
+              "calibration item is stored");
+        threshold[0] = sensor;
+        check(nvs_storage_store_data(MEASURE_THRESHOLD | sensor, threshold,
+                                     sizeof(threshold)) > 0,
+              "threshold item is stored");
+    }
+}
+
+static void check_flash_budget()
+{
+    const uint32_t records = 100;
+    fault_record_t record;
+
+    nvs_model_erase();
+    store_worst_case_items(9);
+    uint32_t other_bytes = nvs_model_live_bytes();
+    uint32_t erases = nvs_model_erases();
+
+    for (uint32_t count = 1; count <= records; count++) {
+        make_record(record, count);
+        check(fault_record_store(&record) == 0,
+              "record fits with the worst case items");
+    }
+    check(is_stored(record), "last record is read back");
+
+    printf("worst case: %u bytes of other items, %u bytes left in a "
+           "sector, %.1f erases per record\n", other_bytes,
+           nvs_model_free_bytes(),
+           (float)(nvs_model_erases() - erases) / records);
+}
+
+int main()
+{
+    check_ring();
+    check_storage();
+    check_flash_budget();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
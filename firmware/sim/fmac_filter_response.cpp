@@ -0,0 +1,247 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  FMAC filter response: runs a filter through the FMAC software
+ *         model and a double precision reference, to check a filter
+ *         design and its q1.15 errors without the board.
+ *
+ *         Usage: fmac_filter_response <filter> [options]
+ *           --lowpass=<tau>      first-order low-pass, time constant in s
+ *           --notch=<f0>         notch biquad at f0 Hz
+ *           --quality=<q>        notch quality factor (default 1)
+ *           --b=<b0,b1,...>      custom transfer function numerator
+ *           --a=<a1,a2,...>      custom transfer function denominator
+ *           --ts=<s>             sampling period (default 100e-6)
+ *           --full-scale=<v>     value of q1.15 full scale (default 1)
+ *           --samples=<n>        number of samples (default 20000)
+ *           --sine=<Hz>          sine input instead of a step
+ *           --amplitude=<v>      input amplitude (default full scale / 2)
+ *           --csv=<file>         input, reference and FMAC outputs
+ *           --expect-max-error=<v> exit with an error if the FMAC output
+ *                                differs more from the reference
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "FmacFilter.h"
+
+static const int MAX_COEFFICIENTS = 8;
+
+typedef struct {
+    float32_t b[MAX_COEFFICIENTS];
+    float32_t a[MAX_COEFFICIENTS];
+    int b_count;
+    int a_count;
+    float64_t ts;
+    float64_t full_scale;
+    float64_t lowpass_tau;
+    float64_t notch_f0;
+    float64_t quality;
+    int samples;
+    float64_t sine_frequency;
+    float64_t amplitude;
+    const char* csv;
+    float64_t expect_max_error;
+} response_options_t;
+
+static int parse_list(const char* text, float32_t* values)
+{
+    int count = 0;
+    while (*text != '\0' && count < MAX_COEFFICIENTS) {
+        char* end;
+        values[count++] = strtof(text, &end);
+        if (*end != ',') {
+            break;
+        }
+        text = end + 1;
+    }
+    return count;
+}
+
+static bool parse_options(int argc, char** argv, response_options_t* options)
+{
+    *options = {};
+    options->ts = 100e-6;
+    options->full_scale = 1.0;
+    options->quality = 1.0;
+    options->samples = 20000;
+    options->amplitude = -1.0;
+    options->expect_max_error = -1.0;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = strchr(arg, '=');
+        value = (value != nullptr) ? value + 1 : "";
+
+        if (strncmp(arg, "--lowpass=", 10) == 0) {
+            options->lowpass_tau = atof(value);
+        } else if (strncmp(arg, "--notch=", 8) == 0) {
+            options->notch_f0 = atof(value);
+        } else if (strncmp(arg, "--quality=", 10) == 0) {
+            options->quality = atof(value);
+        } else if (strncmp(arg, "--b=", 4) == 0) {
+            options->b_count = parse_list(value, options->b);
+        } else if (strncmp(arg, "--a=", 4) == 0) {
+            options->a_count = parse_list(value, options->a);
+        } else if (strncmp(arg, "--ts=", 5) == 0) {
+            options->ts = atof(value);
+        } else if (strncmp(arg, "--full-scale=", 13) == 0) {
+            options->full_scale = atof(value);
+        } else if (strncmp(arg, "--samples=", 10) == 0) {
+            options->samples = atoi(value);
+        } else if (strncmp(arg, "--sine=", 7) == 0) {
+            options->sine_frequency = atof(value);
+        } else if (strncmp(arg, "--amplitude=", 12) == 0) {
+            options->amplitude = atof(value);
+        } else if (strncmp(arg, "--csv=", 6) == 0) {
+            options->csv = value;
+        } else if (strncmp(arg, "--expect-max-error=", 19) == 0) {
+            options->expect_max_error = atof(value);
+        } else {
+            fprintf(stderr, "unknown option %s\n", arg);
+            return false;
+        }
+    }
+
+    if (options->amplitude < 0) {
+        options->amplitude = options->full_scale / 2;
+    }
+    return options->samples > 0;
+}
+
+/* Same designs as FmacFilter, in the transfer function form */
+static bool design(response_options_t* options)
+{
+    if (options->lowpass_tau > 0) {
+        float64_t k = options->ts / (options->lowpass_tau + options->ts);
+        options->b[0] = k;
+        options->a[0] = k - 1.0;
+        options->b_count = 1;
+        options->a_count = 1;
+    } else if (options->notch_f0 > 0) {
+        float64_t w0 = 2.0 * M_PI * options->notch_f0 * options->ts;
+        float64_t alpha = sin(w0) / (2.0 * options->quality);
+        float64_t a0 = 1.0 + alpha;
+        float64_t c = -2.0 * cos(w0) / a0;
+        options->b[0] = 1.0 / a0;
+        options->b[1] = c;
+        options->b[2] = 1.0 / a0;
+        options->a[0] = c;
+        options->a[1] = (1.0 - alpha) / a0;
+        options->b_count = 3;
+        options->a_count = 2;
+    }
+    return options->b_count > 0;
+}
+
+int main(int argc, char** argv)
+{
+    response_options_t options;
+    if (!parse_options(argc, argv, &options) || !design(&options)) {
+        fprintf(stderr, "usage: %s --lowpass=<tau> | --notch=<f0> | "
+                        "--b=<b0,...> [--a=<a1,...>] [options]\n", argv[0]);
+        return 1;
+    }
+
+    FmacFilter filter;
+    int8_t status;
+    if (options.lowpass_tau > 0) {
+        status = filter.initLowPassFirstOrder(options.ts, options.lowpass_tau,
+                                              options.full_scale);
+    } else if (options.notch_f0 > 0) {
+        status = filter.initNotch(options.ts, options.notch_f0,
+                                  options.quality, options.full_scale);
+    } else {
+        status = filter.init(options.b, options.b_count, options.a,
+                             options.a_count, options.full_scale);
+    }
+    if (status != 0) {
+        fprintf(stderr, "filter coefficients do not fit the FMAC\n");
+        return 1;
+    }
+
+    FILE* csv = nullptr;
+    if (options.csv != nullptr) {
+        csv = fopen(options.csv, "w");
+        if (csv == nullptr) {
+            perror(options.csv);
+            return 1;
+        }
+        fprintf(csv, "time,input,reference,fmac\n");
+    }
+
+    /* Direct form I reference on the unquantized coefficients */
+    float64_t x_history[MAX_COEFFICIENTS] = {0};
+    float64_t y_history[MAX_COEFFICIENTS] = {0};
+    float64_t max_error = 0;
+    float64_t reference = 0;
+    float64_t output = 0;
+
+    for (int n = 0; n < options.samples; n++) {
+        float64_t time = n * options.ts;
+        float64_t input = options.amplitude;
+        if (options.sine_frequency > 0) {
+            input *= sin(2.0 * M_PI * options.sine_frequency * time);
+        }
+
+        memmove(x_history + 1, x_history,
+                (MAX_COEFFICIENTS - 1) * sizeof(float64_t));
+        x_history[0] = input;
+
+        reference = 0;
+        for (int k = 0; k < options.b_count; k++) {
+            reference += options.b[k] * x_history[k];
+        }
+        for (int k = 0; k < options.a_count; k++) {
+            reference -= options.a[k] * y_history[k];
+        }
+        memmove(y_history + 1, y_history,
+                (MAX_COEFFICIENTS - 1) * sizeof(float64_t));
+        y_history[0] = reference;
+
+        output = filter.calculateWithReturn(input);
+        max_error = fmax(max_error, fabs(output - reference));
+
+        if (csv != nullptr) {
+            fprintf(csv, "%.6f,%.6g,%.6g,%.6g\n", time, input, reference,
+                    output);
+        }
+    }
+
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+
+    printf("%d samples, final reference %.6g, final FMAC %.6g, "
+           "max error %.6g (%.3g LSB)\n",
+           options.samples, reference, output, max_error,
+           max_error / options.full_scale * 32768.0);
+
+    if (options.expect_max_error >= 0 && max_error > options.expect_max_error) {
+        fprintf(stderr, "max error %.6g above %.6g\n", max_error,
+                options.expect_max_error);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Mode state machine check: forces a writer preempted between
+ *         the claim and the publication of its event (e.g. a ThingSet
+ *         request interrupted by the critical task), and checks that the
+ *         events queued behind it are held back while a fault served by
+ *         dispatch() changes the mode in the same period.
+ *
+ *         Usage: mode_fsm_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+
+#include "mode_fsm.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+enum
+{
+    IDLE = 0,
+    POWER,
+    ERROR
+};
+
+enum
+{
+    EVENT_TICK = MODE_FSM_EVENT_TICK,
+    EVENT_IDLE_REQUEST,
+    EVENT_POWER_REQUEST,
+    EVENT_OVERCURRENT
+};
+
+static uint32_t stop_actions = 0;
+
+static void action_stop()
+{
+    stop_actions++;
+}
+
+static const mode_transition_t transitions[] = {
+    {MODE_FSM_ANY, EVENT_OVERCURRENT,   nullptr, ERROR, action_stop},
+    {MODE_FSM_ANY, EVENT_IDLE_REQUEST,  nullptr, IDLE,  action_stop},
+    {IDLE,         EVENT_POWER_REQUEST, nullptr, POWER, nullptr},
+};
+
+/* Gives access to the queue to stall a writer */
+class StalledWriterStateMachine : public ModeStateMachine
+{
+public:
+    StalledWriterStateMachine()
+        : ModeStateMachine(IDLE, transitions,
+                           sizeof(transitions) / sizeof(transitions[0]))
+    {
+    }
+
+    bool claim(uint32_t &position)
+    {
+        return queue.claim(position);
+    }
+
+    void publish(uint32_t position, uint8_t event)
+    {
+        queue.publish(position, {event, getTick()});
+    }
+};
+
+static void check_queue()
+{
+    EventQueue<uint8_t, 4> queue;
+    uint8_t value;
+    uint32_t stalled;
+
+    check(queue.claim(stalled), "writer claims a position");
+    check(queue.push(2), "interrupting writer claims the next one");
+    check(!queue.pop(value), "reader stops at the unpublished position");
+
+    queue.publish(stalled, 1);
+    check(queue.pop(value) && value == 1, "published value is read first");
+    check(queue.pop(value) && value == 2, "then the value queued behind");
+    check(!queue.pop(value), "queue is empty");
+}
+
+static void check_fault_during_stalled_post()
+{
+    StalledWriterStateMachine fsm;
+
+    fsm.post(EVENT_POWER_REQUEST);
+    fsm.process();
+    check(fsm.getMode() == POWER, "power request served");
+
+    /* Background request preempted by the critical task */
+    uint32_t stalled;
+    check(fsm.claim(stalled), "background writer claims a position");
+
+    /* Posted fault: held back by the stalled writer */
+    fsm.post(EVENT_OVERCURRENT);
+    fsm.process();
+    check(fsm.getMode() == POWER,
+          "posted fault is held back behind the stalled writer");
+
+    /* Fault of the critical task: served in the same period */
+    uint32_t actions = stop_actions;
+    fsm.dispatch(EVENT_OVERCURRENT);
+    check(fsm.getMode() == ERROR, "dispatched fault changes the mode at once");
+    check(stop_actions == actions + 1, "dispatched fault action is called");
+
+    mode_trace_t record;
+    check(fsm.getTrace(fsm.getTraceCount() - 1, record)
+          && record.event == EVENT_OVERCURRENT && record.from == POWER
+          && record.to == ERROR && record.latency == 0,
+          "dispatched fault is traced with no latency");
+
+    fsm.process();
+    check(fsm.getMode() == ERROR, "still in error while the writer stalls");
+
+    /* The writer resumes: its request, then the posted fault, are served */
+    fsm.publish(stalled, EVENT_IDLE_REQUEST);
+    fsm.process();
+    check(fsm.getMode() == ERROR,
+          "queued events are served in order once published");
+}
+
+int main()
+{
+    check_queue();
+    check_fault_during_stalled_post();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,174 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+#include "plant.h"
+
+static float32_t grid_voltage(const plant_params_t* params, float64_t time)
+{
+    return params->v_grid_amp
+           * sinf((float32_t)fmod(2.0 * M_PI * params->f_grid * time,
+                                  2.0 * M_PI));
+}
+
+/* Update an inductor current, a stopped converter only letting
+ * its diodes conduct: the current cannot cross zero. */
+static float32_t inductor_step(float32_t i, float32_t v, float32_t l,
+                               float32_t dt, bool unidirectional)
+{
+    float32_t i_next = i + v / l * dt;
+    if (unidirectional && (i_next * i < 0.0F)) {
+        return 0.0F;
+    }
+    return i_next;
+}
+
+void plant_default_params(plant_params_t* params)
+{
+    params->v_in = 20.0F;
+    params->r_in = 0.1F;
+    params->l_boost = 100.0e-6F;
+    params->r_boost = 0.05F;
+    params->c_dc = 1.0e-3F;
+    params->r_dc_leak = 10.0e3F;
+    params->l_f = 1.0e-3F;
+    params->r_f = 0.1F;
+    params->c_f = 10.0e-6F;
+    params->grid_connected = true;
+    params->v_grid_amp = 20.0F;
+    params->f_grid = 50.0F;
+    params->l_g = 1.0e-3F;
+    params->r_g = 0.5F;
+    params->r_load = 10.0F;
+}
+
+void plant_reset(plant_state_t* state, const plant_params_t* params)
+{
+    state->i_boost[0] = 0.0F;
+    state->i_boost[1] = 0.0F;
+    state->v_dc = params->v_in;
+    state->i_f = 0.0F;
+    state->v_cf = 0.0F;
+    state->i_g = 0.0F;
+    state->v_cm = params->v_in / 2.0F;
+    state->time = 0.0;
+}
+
+void plant_step(plant_state_t* state, const plant_params_t* params,
+                const plant_inputs_t* inputs, float32_t dt)
+{
+    float32_t v_dc = state->v_dc;
+    float32_t i_in = state->i_boost[0] + state->i_boost[1];
+    float32_t v_source = params->v_in - params->r_in * i_in;
+
+    /* Boost legs: a stopped leg is a diode towards the bus */
+    float32_t i_dc_in = 0.0F;
+    for (uint8_t leg = 0; leg < 2; leg++) {
+        float32_t i = state->i_boost[leg];
+        float32_t v_l;
+        if (inputs->boost_on[leg]) {
+            v_l = v_source - (1.0F - inputs->boost_duty[leg]) * v_dc
+                  - params->r_boost * i;
+            state->i_boost[leg] = inductor_step(i, v_l, params->l_boost,
+                                                dt, false);
+            i_dc_in += (1.0F - inputs->boost_duty[leg]) * state->i_boost[leg];
+        } else {
+            if (i <= 0.0F && v_source <= v_dc) {
+                state->i_boost[leg] = 0.0F;
+                continue;
+            }
+            v_l = v_source - v_dc - params->r_boost * i;
+            state->i_boost[leg] = inductor_step(i > 0.0F ? i : 0.0F, v_l,
+                                                params->l_boost, dt, true);
+            i_dc_in += state->i_boost[leg];
+        }
+    }
+
+    /* H-bridge: a stopped bridge is a diode rectifier */
+    float32_t v_bridge;
+    bool bridge_conducting = true;
+    if (inputs->bridge_on) {
+        v_bridge = (inputs->bridge_duty[0] - inputs->bridge_duty[1]) * v_dc;
+        state->v_cm = (inputs->bridge_duty[0] + inputs->bridge_duty[1])
+                      / 2.0F * v_dc;
+    } else {
+        state->v_cm = v_dc / 2.0F;
+        if (state->i_f > 0.0F) {
+            v_bridge = -v_dc;
+        } else if (state->i_f < 0.0F) {
+            v_bridge = v_dc;
+        } else if (state->v_cf > v_dc) {
+            v_bridge = v_dc;
+        } else if (state->v_cf < -v_dc) {
+            v_bridge = -v_dc;
+        } else {
+            v_bridge = 0.0F;
+            bridge_conducting = false;
+        }
+    }
+
+    if (bridge_conducting) {
+        float32_t v_lf = v_bridge - state->v_cf - params->r_f * state->i_f;
+        state->i_f = inductor_step(state->i_f, v_lf, params->l_f, dt,
+                                   !inputs->bridge_on);
+    } else {
+        state->i_f = 0.0F;
+    }
+
+    float32_t i_dc_out = 0.0F;
+    if (v_dc > 0.0F) {
+        i_dc_out = v_bridge * state->i_f / v_dc;
+    }
+
+    /* Grid or load */
+    float32_t i_o;
+    if (params->grid_connected) {
+        float32_t v_lg = state->v_cf - grid_voltage(params, state->time)
+                         - params->r_g * state->i_g;
+        state->i_g = inductor_step(state->i_g, v_lg, params->l_g, dt, false);
+        i_o = state->i_g;
+    } else {
+        state->i_g = state->v_cf / params->r_load;
+        i_o = state->i_g;
+    }
+
+    /* Capacitors, from the updated currents */
+    state->v_cf += (state->i_f - i_o) / params->c_f * dt;
+    state->v_dc += (i_dc_in - i_dc_out - v_dc / params->r_dc_leak)
+                   / params->c_dc * dt;
+    if (state->v_dc < 0.0F) {
+        state->v_dc = 0.0F;
+    }
+
+    state->time += dt;
+}
+
+void plant_measure(const plant_state_t* state, const plant_params_t* params,
+                   plant_measurements_t* meas)
+{
+    meas->v_low = state->v_cm + state->v_cf / 2.0F;
+    meas->v_ac = state->v_cm - state->v_cf / 2.0F;
+    meas->v_dc_bus = state->v_dc;
+    meas->i_low1 = state->i_f;
+    meas->i_low2 = state->i_boost[0] + state->i_boost[1];
+    meas->i_ac = state->i_g;
+    meas->v_grid = params->grid_connected
+                   ? grid_voltage(params, state->time)
+                   : 0.0F;
+}
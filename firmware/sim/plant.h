@@ -0,0 +1,132 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Averaged discrete-time model of the micro-inverter power stages:
+ *         two interleaved boost legs feeding the DC bus, an H-bridge with
+ *         an LC output filter, and either a 50 Hz grid behind an inductor
+ *         or a resistive load.
+ *
+ *         Switches are modeled by their duty cycle over a PWM period.
+ *         Stopped legs behave as their body diodes.
+ */
+
+#ifndef PLANT_H
+#define PLANT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <arm_math.h>
+
+typedef struct {
+    /* Low voltage source */
+    float32_t v_in;          // [V] source voltage
+    float32_t r_in;          // [Ohm] source resistance
+    /* Boost legs */
+    float32_t l_boost;       // [H] inductance of each leg
+    float32_t r_boost;       // [Ohm] series resistance of each leg
+    /* DC bus */
+    float32_t c_dc;          // [F]
+    float32_t r_dc_leak;     // [Ohm] bus discharge resistance
+    /* H-bridge output filter */
+    float32_t l_f;           // [H]
+    float32_t r_f;           // [Ohm]
+    float32_t c_f;           // [F]
+    /* Grid or load */
+    bool grid_connected;     // grid if true, resistive load otherwise
+    float32_t v_grid_amp;    // [V] grid peak voltage
+    float32_t f_grid;        // [Hz]
+    float32_t l_g;           // [H] grid side inductance
+    float32_t r_g;           // [Ohm] grid side resistance
+    float32_t r_load;        // [Ohm]
+} plant_params_t;
+
+typedef struct {
+    float32_t boost_duty[2]; // low side switch duty cycle of LEG1/2_LOW
+    bool boost_on[2];
+    float32_t bridge_duty[2];// high side switch duty cycle of LEG1/2_HIGH
+    bool bridge_on;          // both H-bridge legs switching
+} plant_inputs_t;
+
+typedef struct {
+    float32_t i_boost[2];    // [A] boost inductors currents
+    float32_t v_dc;          // [V] DC bus voltage
+    float32_t i_f;           // [A] H-bridge output current
+    float32_t v_cf;          // [V] output filter capacitor voltage
+    float32_t i_g;           // [A] grid current
+    float32_t v_cm;          // [V] H-bridge common mode voltage
+    float64_t time;          // [s]
+} plant_state_t;
+
+/**
+ * Physical values seen by the shield sensors.
+ * ILow1 measures the H-bridge output current, ILow2 the boost input
+ * current and IAC the grid or load current.
+ */
+typedef struct {
+    float32_t v_low;
+    float32_t v_ac;
+    float32_t v_dc_bus;
+    float32_t i_low1;
+    float32_t i_low2;
+    float32_t i_ac;
+    float32_t v_grid;
+} plant_measurements_t;
+
+/**
+ * @brief Fill parameters with default values close to the uSolarVerter
+ * bench setup: 20 V source, 20 V peak grid.
+ *
+ * @param params Parameters to fill.
+ */
+void plant_default_params(plant_params_t* params);
+
+/**
+ * @brief Reset the plant: capacitors charged to the source voltage and
+ * no current flowing.
+ *
+ * @param state State to reset.
+ * @param params Plant parameters.
+ */
+void plant_reset(plant_state_t* state, const plant_params_t* params);
+
+/**
+ * @brief Advance the plant by one integration step, inputs being held.
+ *
+ * @param state State to update.
+ * @param params Plant parameters.
+ * @param inputs Switching commands applied during the step.
+ * @param dt Integration step [s], well below the filters time constants.
+ */
+void plant_step(plant_state_t* state, const plant_params_t* params,
+                const plant_inputs_t* inputs, float32_t dt);
+
+/**
+ * @brief Compute the values seen by the sensors.
+ *
+ * @param state Current state.
+ * @param params Plant parameters.
+ * @param meas Output measurements.
+ */
+void plant_measure(const plant_state_t* state, const plant_params_t* params,
+                   plant_measurements_t* meas);
+
+#endif // PLANT_H
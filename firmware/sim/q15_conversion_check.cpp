@@ -0,0 +1,305 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Fixed-point conversion check: Q15 values converted by data
+ *         conversion (owntech_spin_api data_conversion.cpp) through the
+ *         host fallback of arm_scale_q15() and arm_offset_q15()
+ *         (fakes/arm_math.h), compared bit-exactly with a reference model
+ *         of the parameters and kernels in 64-bit integers, and against
+ *         the float conversion of the same channel within the Q15
+ *         rounding. Covers every raw code, oversampled ADCs, negative and
+ *         tiny gains, saturation, in-place conversion and parameters
+ *         updates.
+ *
+ *         Usage: q15_conversion_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <math.h>
+#include <stdio.h>
+
+#include "data_conversion.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* Pseudo-random sequence, the same on every run */
+static uint32_t random_state = 1;
+
+static double next_uniform(double min, double max)
+{
+    random_state = random_state * 1103515245 + 12345;
+    return min + (max - min) * ((random_state >> 8) & 0xFFFFFF) / 16777216.0;
+}
+
+/* Q15 parameters, as specified by data_conversion.h */
+typedef struct {
+    int32_t gain;
+    int32_t shift;
+    int32_t offset;
+} q15_parameters_t;
+
+static int32_t saturate(int64_t value)
+{
+    if (value > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (value < INT16_MIN) {
+        return INT16_MIN;
+    }
+    return (int32_t)value;
+}
+
+/**
+ * Reference parameters: the factor is the float product of the spec, then
+ * split with frexp() in a fraction in [0.5, 1) rounded to Q15 and a shift
+ * in [-16, 15].
+ */
+static q15_parameters_t reference_parameters(float gain, float offset,
+                                             float full_scale,
+                                             int8_t extra_bits)
+{
+    float raw_scale = ldexpf(1.0f, -extra_bits);
+    float factor = gain * raw_scale * 32768.0f / full_scale;
+
+    q15_parameters_t parameters = {0, 0, 0};
+    if (factor != 0) {
+        int exponent;
+        frexp(factor, &exponent);
+        if (exponent > 15) {
+            exponent = 15;
+        }
+        if (exponent < -16) {
+            exponent = -16;
+        }
+        double fraction = ldexp(factor, -exponent);
+        /* Rounded fraction of 1.0 takes the next shift */
+        if (round(fraction * 32768.0) >= 32768.0 && exponent < 15) {
+            exponent++;
+            fraction = ldexp(factor, -exponent);
+        }
+        parameters.gain = saturate((int64_t)round(fraction * 32768.0));
+        parameters.shift = exponent;
+    }
+    parameters.offset = saturate((int64_t)roundf(offset * 32768.0f
+                                                 / full_scale));
+
+    return parameters;
+}
+
+/* Reference kernels: floor of the shifted product, then saturations */
+static int32_t reference_convert(const q15_parameters_t &parameters,
+                                 uint16_t raw_value)
+{
+    int64_t product = (int64_t)raw_value * parameters.gain;
+    int64_t divisor = (int64_t)1 << (15 - parameters.shift);
+    int64_t scaled = product >= 0 ? product / divisor
+                                  : -((-product + divisor - 1) / divisor);
+    return saturate((int64_t)saturate(scaled) + parameters.offset);
+}
+
+typedef struct {
+    float gain;
+    float offset;
+    float full_scale;
+} channel_t;
+
+static const uint8_t ADC_NUM = 1;
+static const uint8_t CHANNEL_NUM = 2;
+static const uint32_t CODES = 32768;
+
+static uint16_t raw_values[CODES];
+static q15_t q15_values[CODES];
+
+/**
+ * Convert every raw code of the ADC resolution, compare with the
+ * reference model and, where neither the gain product, the offset nor
+ * the result saturate, with the float conversion.
+ */
+static bool check_channel(const channel_t &channel, int8_t extra_bits,
+                          uint32_t &accuracy_errors)
+{
+    data_conversion_set_adc_extra_bits(ADC_NUM, extra_bits);
+    data_conversion_set_conversion_parameters_linear(ADC_NUM, CHANNEL_NUM,
+                                                     channel.gain,
+                                                     channel.offset);
+    if (data_conversion_set_q15_full_scale(ADC_NUM, CHANNEL_NUM,
+                                           channel.full_scale) != 0) {
+        return false;
+    }
+
+    uint32_t codes = 4096u << extra_bits;
+    for (uint32_t raw = 0; raw < codes; raw++) {
+        raw_values[raw] = (uint16_t)raw;
+    }
+    if (data_conversion_convert_raw_values_q15(ADC_NUM, CHANNEL_NUM,
+                                               raw_values, q15_values,
+                                               codes) != 0) {
+        return false;
+    }
+
+    q15_parameters_t parameters = reference_parameters(
+        channel.gain, channel.offset, channel.full_scale, extra_bits);
+    double lsb = channel.full_scale / 32768.0;
+    /* Truncation, offset rounding and gain rounding on the largest code */
+    double tolerance = lsb * (1.5 + ldexp(0.5 * codes / 32768.0,
+                                          parameters.shift));
+
+    bool exact = true;
+    for (uint32_t raw = 0; raw < codes; raw++) {
+        if (q15_values[raw] != reference_convert(parameters, raw)) {
+            exact = false;
+        }
+
+        double scaled = ldexp((double)raw, -extra_bits) * channel.gain;
+        double value = scaled + channel.offset;
+        double limit = channel.full_scale * (1.0 - 1e-3) - tolerance;
+        if (fabs(scaled) > limit || fabs(channel.offset) > limit
+            || fabs(value) > limit) {
+            continue;
+        }
+        double expected = data_conversion_convert_raw_value(
+            ADC_NUM, CHANNEL_NUM, (uint16_t)raw);
+        if (fabs(q15_values[raw] * lsb - expected)
+            > tolerance + 1e-6 * fabs(expected)) {
+            accuracy_errors++;
+        }
+    }
+
+    return exact;
+}
+
+static void check_channels()
+{
+    /**
+     * Twist-like sensors, gains to 0 and beyond the shifts range, and a
+     * fraction rounded to 1.0
+     */
+    const channel_t channels[] = {
+        {0.0306f, 0.0f, 128.0f},
+        {0.0306f, -0.4f, 100.0f},
+        {-0.005f, 10.24f, 16.0f},
+        {0.0f, 1.0f, 4.0f},
+        {1.0f, 0.0f, 8192.0f},
+        {1e-7f, 1e-4f, 1.0f},
+        {300.0f, -2.0f, 10.0f},
+        {0.0306f, -80.0f, 64.0f},
+        {1.0f - 1.0f / 131072, 0.0f, 32768.0f},
+    };
+
+    uint32_t exact_errors = 0;
+    uint32_t accuracy_errors = 0;
+    for (const channel_t &channel : channels) {
+        for (int8_t extra_bits = 0; extra_bits <= 3; extra_bits++) {
+            if (!check_channel(channel, extra_bits, accuracy_errors)) {
+                exact_errors++;
+            }
+        }
+    }
+
+    /* Random channels, full scale above or below the converted values */
+    for (uint32_t index = 0; index < 400; index++) {
+        float gain = (float)(pow(10.0, next_uniform(-5.0, 1.0))
+                             * (index % 2 ? -1 : 1));
+        float full_scale = (float)pow(10.0, next_uniform(-1.0, 3.0));
+        float offset = (float)next_uniform(-full_scale, full_scale);
+        channel_t channel = {gain, offset, full_scale};
+        if (!check_channel(channel, (int8_t)(index % 4), accuracy_errors)) {
+            exact_errors++;
+        }
+    }
+
+    check(exact_errors == 0, "Q15 values bit-exact with the reference");
+    check(accuracy_errors == 0, "Q15 values match the float conversion");
+
+    data_conversion_set_adc_extra_bits(ADC_NUM, 0);
+}
+
+static void check_configuration()
+{
+    const uint16_t raw[4] = {0, 1000, 2000, 4095};
+    q15_t values[4];
+
+    check(data_conversion_set_q15_full_scale(ADC_NUM, 3, 0.0f) == 0
+          && data_conversion_convert_raw_values_q15(ADC_NUM, 3, raw,
+                                                    values, 4) == -1,
+          "no fixed-point conversion without full scale");
+    check(data_conversion_get_q15_full_scale(ADC_NUM, 3) == 0.0f,
+          "no full scale by default");
+
+    data_conversion_set_conversion_parameters_therm(ADC_NUM, 4, 10000.0f,
+                                                    3450.0f, 20000.0f,
+                                                    298.15f);
+    check(data_conversion_set_q15_full_scale(ADC_NUM, 4, 100.0f) == -1,
+          "no fixed-point conversion for a thermistor");
+
+    /* Negative full scale is taken as its absolute value */
+    data_conversion_set_conversion_parameters_linear(ADC_NUM, 3, 0.01f, 1.0f);
+    check(data_conversion_set_q15_full_scale(ADC_NUM, 3, -64.0f) == 0
+          && data_conversion_get_q15_full_scale(ADC_NUM, 3) == 64.0f,
+          "full scale absolute value");
+
+    data_conversion_set_adc_extra_bits(ADC_NUM, 4);
+    check(data_conversion_convert_raw_values_q15(ADC_NUM, 3, raw, values, 4)
+          == -1, "no fixed-point conversion above 3 extra bits");
+    data_conversion_set_adc_extra_bits(ADC_NUM, 0);
+
+    /* In place, as getValuesQ15() does on its buffers */
+    uint16_t in_place[4] = {0, 1000, 2000, 4095};
+    check(data_conversion_convert_raw_values_q15(ADC_NUM, 3, raw, values, 4)
+          == 0 && data_conversion_convert_raw_values_q15(
+                      ADC_NUM, 3, in_place, (q15_t*)in_place, 4) == 0,
+          "in-place conversion");
+    bool same = true;
+    for (uint8_t index = 0; index < 4; index++) {
+        same = same && (q15_t)in_place[index] == values[index];
+    }
+    check(same, "in-place conversion matches");
+
+    /* Q15 parameters follow the linear parameters */
+    data_conversion_set_conversion_parameters_linear(ADC_NUM, 3, 0.02f, -1.0f);
+    data_conversion_convert_raw_values_q15(ADC_NUM, 3, raw, values, 4);
+    q15_parameters_t parameters = reference_parameters(0.02f, -1.0f,
+                                                       64.0f, 0);
+    check(values[3] == reference_convert(parameters, raw[3]),
+          "Q15 parameters updated with the linear parameters");
+}
+
+int main()
+{
+    data_conversion_init();
+
+    check_channels();
+    check_configuration();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,165 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  ADC watchdog check: checks the allocation of the ADC analog
+ *         watchdogs to watched channels, and that the windows computed
+ *         from raw limits flag every code out of the limits, for all the
+ *         12-bit codes, watchdogs with full codes and with 8 MSBs, and
+ *         limits across the code range. Codes within the limits that are
+ *         also flagged (checked by software) are counted.
+ *
+ *         Usage: safety_adc_watchdog_check [--verbose]
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "safety_adc_watchdog.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* Comparison of the ADC: full codes for watchdog 1, 8 MSBs else */
+static bool awd_flags(uint8_t watchdog, const safety_awd_window_t* window,
+                      uint16_t code)
+{
+    uint16_t compared = watchdog == 1 ? code
+                                      : code >> SAFETY_AWD_MSB_SHIFT;
+    return compared < window->low || compared > window->high;
+}
+
+/* Same decisions as safety_raw_is_outside() */
+static bool is_outside(const safety_raw_limits_t* limits, uint16_t code)
+{
+    if (code == 0) {
+        return !limits->zero_within;
+    }
+    return code < limits->low || code > limits->high;
+}
+
+/* Returns the largest number of codes within limits that are flagged */
+static int check_window(uint8_t watchdog, const safety_raw_limits_t* limits,
+                        bool verbose)
+{
+    safety_awd_window_t window;
+    safety_awd_compute_window(watchdog, limits, &window);
+
+    int false_flags = 0;
+    for (uint32_t code = 0; code <= SAFETY_AWD_CODE_MAX; code++) {
+        bool outside = is_outside(limits, (uint16_t)code);
+        bool flagged = awd_flags(watchdog, &window, (uint16_t)code);
+        if (outside && !flagged) {
+            printf("failed: watchdog %u, limits [%d, %d] zero %d, code %u "
+                   "not flagged (window [%u, %u])\n", watchdog, limits->low,
+                   limits->high, limits->zero_within, code, window.low,
+                   window.high);
+            failures++;
+            return 0;
+        }
+        if (!outside && flagged) {
+            false_flags++;
+        }
+    }
+    if (verbose) {
+        printf("watchdog %u, limits [%d, %d] zero %d: window [%u, %u], "
+               "%d codes within flagged\n", watchdog, limits->low,
+               limits->high, limits->zero_within, window.low, window.high,
+               false_flags);
+    }
+
+    return false_flags;
+}
+
+int main(int argc, char** argv)
+{
+    bool verbose = argc > 1 && strcmp(argv[1], "--verbose") == 0;
+
+    /* Watchdog 1 first, then 2 and 3, independently on each ADC */
+    safety_awd_allocation_t allocation;
+    memset(&allocation, 0, sizeof(allocation));
+    check(safety_awd_allocate(1, 6, &allocation) == 1
+          && safety_awd_allocate(1, 7, &allocation) == 2
+          && safety_awd_allocate(1, 8, &allocation) == 3,
+          "three channels of ADC 1 get watchdogs 1, 2 and 3");
+    check(safety_awd_allocate(1, 9, &allocation) < 0,
+          "a fourth channel of ADC 1 is watched by software");
+    check(safety_awd_allocate(2, 6, &allocation) == 1,
+          "ADC 2 has its own watchdogs");
+    check(safety_awd_allocate(0, 1, &allocation) < 0
+          && safety_awd_allocate(SAFETY_AWD_ADCS + 1, 1, &allocation) < 0
+          && safety_awd_allocate(3, 0, &allocation) < 0,
+          "invalid ADC or channel is rejected");
+    check(allocation.channel[1][1] == 6 && allocation.channel[1][2] == 7
+          && allocation.channel[1][3] == 8 && allocation.channel[2][1] == 6
+          && allocation.channel[2][2] == 0,
+          "allocation table");
+
+    /* Limits across the range, with the edge cases of the raw limits */
+    const int32_t edges[] = {1, 2, 15, 16, 17, 31, 32, 2048, 4079, 4080,
+                             4081, 4094, 4095, 4096};
+    int windows = 0;
+    int max_false_flags[SAFETY_AWD_WATCHDOGS + 1] = {0};
+    for (uint8_t watchdog = 1; watchdog <= SAFETY_AWD_WATCHDOGS; watchdog++) {
+        for (int32_t low = 1; low <= 4096; low += 61) {
+            for (int32_t high = 0; high <= 4095; high += 67) {
+                for (int zero = 0; zero < 2; zero++) {
+                    safety_raw_limits_t limits = {low, high, zero != 0};
+                    int false_flags = check_window(watchdog, &limits,
+                                                   verbose);
+                    if (high >= low && false_flags
+                                       > max_false_flags[watchdog]) {
+                        max_false_flags[watchdog] = false_flags;
+                    }
+                    windows++;
+                }
+            }
+        }
+        for (int32_t low : edges) {
+            for (int32_t high : edges) {
+                safety_raw_limits_t limits = {low, high - 1, true};
+                check_window(watchdog, &limits, verbose);
+                windows++;
+            }
+        }
+    }
+
+    /* Codes within limits flagged: code 0, and up to 15 codes per side */
+    check(max_false_flags[1] <= 1, "watchdog 1 only flags code 0 within");
+    check(max_false_flags[2] <= 31 && max_false_flags[3] <= 31,
+          "watchdogs 2 and 3 flag at most 15 codes within on each side, "
+          "and code 0");
+
+    printf("%d windows checked, at most %d/%d/%d codes within flagged, "
+           "%d failures\n", windows, max_false_flags[1], max_false_flags[2],
+           max_false_flags[3], failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,187 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Hardware trip check: for every analog code of linear
+ *         conversions (both slopes) and thresholds across the measurement
+ *         range, checks that the comparator against the computed DAC code
+ *         trips exactly on the codes whose converted value is above the
+ *         threshold. Also checks the routes of the sensor pins, the
+ *         rejection of thresholds out of range and the register map of
+ *         the uSolarVerter current sensors.
+ *
+ *         Usage: safety_hw_trip_check [--verbose]
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "safety_hw_trip.h"
+#include "gpio_pin_map.h"
+
+typedef struct {
+    float32_t gain;
+    float32_t offset;
+} conversion_case_t;
+
+/* Same operations as data_conversion_convert_raw_value() */
+static float32_t convert(uint16_t code, const void* context)
+{
+    const conversion_case_t* conversion = (const conversion_case_t*)context;
+    return (code * conversion->gain) + conversion->offset;
+}
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* Comparator decision against the software decision, for every code */
+static int check_thresholds(const conversion_case_t* conversion,
+                            bool verbose)
+{
+    const uint8_t THRESHOLDS = 64;
+    float32_t first = convert(0, conversion);
+    float32_t last = convert(SAFETY_HW_TRIP_CODE_MAX, conversion);
+    float32_t low = first < last ? first : last;
+    float32_t high = first < last ? last : first;
+    int checked = 0;
+
+    for (uint8_t t = 1; t < THRESHOLDS; t++) {
+        float32_t threshold = low + (high - low) * t / THRESHOLDS;
+        uint16_t dac_code;
+        bool inverted;
+
+        if (safety_hw_trip_compute_dac_code(convert, conversion, threshold,
+                                            &dac_code, &inverted) != 0) {
+            printf("failed: gain %g offset %g threshold %g rejected\n",
+                   conversion->gain, conversion->offset, threshold);
+            failures++;
+            continue;
+        }
+        checked++;
+
+        for (uint32_t code = 0; code <= SAFETY_HW_TRIP_CODE_MAX; code++) {
+            bool trip = inverted ? code < dac_code : code > dac_code;
+            bool expected = convert((uint16_t)code, conversion) > threshold;
+            if (trip != expected) {
+                printf("failed: gain %g offset %g threshold %g, code %u "
+                       "trips %d (DAC code %u)\n", conversion->gain,
+                       conversion->offset, threshold, code, trip, dac_code);
+                failures++;
+                break;
+            }
+        }
+        if (verbose) {
+            printf("gain %g offset %g threshold %g: DAC code %u%s\n",
+                   conversion->gain, conversion->offset, threshold, dac_code,
+                   inverted ? " inverted" : "");
+        }
+    }
+
+    return checked;
+}
+
+int main(int argc, char** argv)
+{
+    bool verbose = argc > 1 && strcmp(argv[1], "--verbose") == 0;
+
+    /* Current sensors of the uSolarVerter, and a decreasing one */
+    const conversion_case_t conversions[] = {
+        {0.005F, -10.0F},
+        {-0.005F, 10.0F},
+        {0.0123F, -25.0F},
+        {-0.0077F, 3.0F},
+    };
+    int thresholds = 0;
+    for (const conversion_case_t& conversion : conversions) {
+        thresholds += check_thresholds(&conversion, verbose);
+    }
+
+    /* Thresholds that would never or always trip */
+    const conversion_case_t* current = &conversions[0];
+    const conversion_case_t* decreasing = &conversions[1];
+    uint16_t dac_code;
+    bool inverted;
+    check(safety_hw_trip_compute_dac_code(convert, current, 15.0F,
+                                          &dac_code, &inverted) != 0,
+          "threshold above the range is rejected");
+    check(safety_hw_trip_compute_dac_code(convert, current, -11.0F,
+                                          &dac_code, &inverted) != 0,
+          "threshold below the range is rejected");
+    check(safety_hw_trip_compute_dac_code(convert, decreasing, 15.0F,
+                                          &dac_code, &inverted) != 0,
+          "inverted threshold above the range is rejected");
+    check(safety_hw_trip_compute_dac_code(convert, decreasing, -11.0F,
+                                          &dac_code, &inverted) != 0,
+          "inverted threshold below the range is rejected");
+
+    /* ILow1 on spin pin 30 (PA1), ILow2 on spin pin 25 (PC1) */
+    safety_hw_trip_route_t ilow1;
+    safety_hw_trip_route_t ilow2;
+    safety_hw_trip_route_t other;
+    check(safety_hw_trip_get_route(gpio_pin_map_get_port(30),
+                                   gpio_pin_map_get_pin_number(30),
+                                   &ilow1) == 0
+          && ilow1.comparator == 1 && ilow1.dac == 3 && ilow1.fault == 4,
+          "pin 30 is COMP1, DAC3, FLT4");
+    check(safety_hw_trip_get_route(gpio_pin_map_get_port(25),
+                                   gpio_pin_map_get_pin_number(25),
+                                   &ilow2) == 0
+          && ilow2.comparator == 3 && ilow2.dac == 1 && ilow2.fault == 5,
+          "pin 25 is COMP3, DAC1, FLT5");
+    check(safety_hw_trip_get_route(gpio_pin_map_get_port(24),
+                                   gpio_pin_map_get_pin_number(24),
+                                   &other) != 0,
+          "pin 24 has no route");
+
+    /* 10 A on both: 20 A above the offset, 4000 codes */
+    safety_hw_trip_registers_t registers;
+    memset(&registers, 0, sizeof(registers));
+    check(safety_hw_trip_compute_dac_code(convert, current, 10.0F,
+                                          &dac_code, &inverted) == 0
+          && dac_code == 4000 && !inverted,
+          "10 A is DAC code 4000");
+    check(safety_hw_trip_add_sensor(&ilow1, dac_code, inverted,
+                                    &registers) == 0
+          && safety_hw_trip_add_sensor(&ilow2, dac_code, inverted,
+                                       &registers) == 0,
+          "both current sensors are added");
+    check(safety_hw_trip_add_sensor(&ilow1, dac_code, inverted,
+                                    &registers) != 0,
+          "a route used twice is rejected");
+    check(registers.comparator_enabled[1] && registers.comparator_enabled[3]
+          && registers.dac_code[1] == 4000 && registers.dac_code[3] == 4000
+          && registers.fault_enabled[4] && registers.fault_enabled[5]
+          && registers.timer_faults == 0x18,
+          "register map of the uSolarVerter current sensors");
+
+    printf("%d thresholds checked, %d failures\n", thresholds, failures);
+
+    return failures == 0 ? 0 : 1;
+}
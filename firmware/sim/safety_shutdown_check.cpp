@@ -0,0 +1,253 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Safety shutdown check: computes the emergency shutdown GPIO
+ *         masks from the leg pins of shield devicetree overlays, and
+ *         checks them against the HRTIM outputs of the legs.
+ *
+ *         Usage: safety_shutdown_check <overlay>...
+ *
+ *         For each leg, the Spin pins (pwm-pin-num) must be the outputs
+ *         of the leg HRTIM timer (pwms). The masks are then applied to
+ *         a model of the GPIO registers, for both reactions: all switch
+ *         pins must become outputs at their safe level, other pins must
+ *         not change. Exits with an error on any failure.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <fstream>
+#include <regex>
+#include <string>
+#include <vector>
+
+#include "safety_shutdown.h"
+
+typedef struct {
+    char timer;
+    int pins[2];
+    bool okay;
+} leg_t;
+
+typedef struct {
+    uint8_t port;
+    uint8_t pin_number;
+} gpio_t;
+
+/* HRTIM outputs 1 and 2 of timers A to F on the STM32G474 */
+static const gpio_t hrtim_outputs[6][2] = {
+    {{GPIO_PIN_MAP_PORT_A, 8},  {GPIO_PIN_MAP_PORT_A, 9}},
+    {{GPIO_PIN_MAP_PORT_A, 10}, {GPIO_PIN_MAP_PORT_A, 11}},
+    {{GPIO_PIN_MAP_PORT_B, 12}, {GPIO_PIN_MAP_PORT_B, 13}},
+    {{GPIO_PIN_MAP_PORT_B, 14}, {GPIO_PIN_MAP_PORT_B, 15}},
+    {{GPIO_PIN_MAP_PORT_C, 8},  {GPIO_PIN_MAP_PORT_C, 9}},
+    {{GPIO_PIN_MAP_PORT_C, 6},  {GPIO_PIN_MAP_PORT_C, 7}},
+};
+
+/* Legs of the power shield node, in devicetree order */
+static std::vector<leg_t> read_legs(const char* path)
+{
+    std::vector<leg_t> legs;
+    std::ifstream file(path);
+    std::string line;
+    std::regex pwms(R"(pwms\s*=\s*<&pwm([a-f]))");
+    std::regex pin_num(R"(pwm-pin-num\s*=\s*<(\d+)\s+(\d+)>)");
+    std::regex status(R"(status\s*=\s*\"(\w+)\")");
+    std::smatch match;
+    int depth = 0;
+
+    while (std::getline(file, line)) {
+        int opening = 0;
+        int closing = 0;
+        for (char c : line) {
+            opening += c == '{';
+            closing += c == '}';
+        }
+
+        if (depth == 0) {
+            if (line.find("power-shield") != std::string::npos && opening) {
+                depth = 1;
+            }
+            continue;
+        }
+
+        if (depth == 1 && opening) {
+            legs.push_back({0, {0, 0}, false});
+        } else if (depth == 2 && std::regex_search(line, match, pwms)) {
+            legs.back().timer = match[1].str()[0];
+        } else if (depth == 2 && std::regex_search(line, match, pin_num)) {
+            legs.back().pins[0] = std::stoi(match[1]);
+            legs.back().pins[1] = std::stoi(match[2]);
+        } else if (depth == 2 && std::regex_search(line, match, status)) {
+            legs.back().okay = match[1] == "okay";
+        }
+
+        depth += opening - closing;
+    }
+
+    return legs;
+}
+
+static int check_overlay(const char* path)
+{
+    std::vector<leg_t> all_legs = read_legs(path);
+    std::vector<leg_t> legs;
+    for (const leg_t& leg : all_legs) {
+        if (leg.okay) {
+            legs.push_back(leg);
+        }
+    }
+    if (legs.empty()) {
+        printf("%s: no leg found\n", path);
+        return 1;
+    }
+
+    int failures = 0;
+    uint8_t pins_high[8];
+    uint8_t pins_low[8];
+    gpio_t gpios[8][2];
+
+    for (size_t i = 0; i < legs.size(); i++) {
+        pins_high[i] = (uint8_t)legs[i].pins[0];
+        pins_low[i] = (uint8_t)legs[i].pins[1];
+
+        for (int side = 0; side < 2; side++) {
+            uint8_t pin = (uint8_t)legs[i].pins[side];
+            gpios[i][side] = {gpio_pin_map_get_port(pin),
+                              gpio_pin_map_get_pin_number(pin)};
+        }
+
+        /* Older overlays do not name the timer: any HRTIM output pair */
+        bool found = false;
+        for (int timer = 0; timer < 6; timer++) {
+            if (legs[i].timer != 0 && legs[i].timer - 'a' != timer) continue;
+            const gpio_t* outputs = hrtim_outputs[timer];
+            found |= gpios[i][0].port == outputs[0].port &&
+                     gpios[i][0].pin_number == outputs[0].pin_number &&
+                     gpios[i][1].port == outputs[1].port &&
+                     gpios[i][1].pin_number == outputs[1].pin_number;
+        }
+        if (!found) {
+            printf("%s: leg %zu pins %d %d are not the HRTIM outputs of "
+                   "its timer\n", path, i + 1, legs[i].pins[0],
+                   legs[i].pins[1]);
+            failures++;
+        }
+    }
+
+    safety_reaction_t reactions[] = {Open_Circuit, Short_Circuit};
+    for (safety_reaction_t reaction : reactions) {
+        safety_shutdown_masks_t masks;
+        if (safety_compute_shutdown_masks(pins_high, pins_low,
+                                          (uint8_t)legs.size(), reaction,
+                                          &masks) != 0) {
+            printf("%s: unknown pin\n", path);
+            failures++;
+            continue;
+        }
+
+        /* Switch pins in alternate function, other pins random */
+        uint32_t moder[GPIO_PIN_MAP_PORTS];
+        uint32_t odr[GPIO_PIN_MAP_PORTS];
+        uint32_t moder_before[GPIO_PIN_MAP_PORTS];
+        uint32_t odr_before[GPIO_PIN_MAP_PORTS];
+        for (uint8_t port = 0; port < GPIO_PIN_MAP_PORTS; port++) {
+            moder[port] = 0x5A3C96E1u * (port + 1);
+            odr[port] = 0xFFFFu ^ (0x1234u * (port + 1));
+        }
+        for (size_t i = 0; i < legs.size(); i++) {
+            for (int side = 0; side < 2; side++) {
+                gpio_t gpio = gpios[i][side];
+                moder[gpio.port] &= ~(0x3u << (2 * gpio.pin_number));
+                moder[gpio.port] |= 0x2u << (2 * gpio.pin_number);
+                odr[gpio.port] ^= 1u << gpio.pin_number;
+            }
+        }
+        memcpy(moder_before, moder, sizeof(moder));
+        memcpy(odr_before, odr, sizeof(odr));
+
+        /* Same writes as the safety action */
+        for (uint8_t port = 0; port < GPIO_PIN_MAP_PORTS; port++) {
+            const safety_port_shutdown_t& port_masks = masks.ports[port];
+            if (port_masks.moder_mask == 0) continue;
+            odr[port] |= port_masks.bsrr & 0xFFFF;
+            odr[port] &= ~(port_masks.bsrr >> 16);
+            moder[port] = (moder[port] & ~port_masks.moder_mask) |
+                          port_masks.moder_output;
+        }
+
+        /* Switch pins are safe outputs */
+        uint32_t switch_pins[GPIO_PIN_MAP_PORTS] = {0};
+        for (size_t i = 0; i < legs.size(); i++) {
+            for (int side = 0; side < 2; side++) {
+                gpio_t gpio = gpios[i][side];
+                switch_pins[gpio.port] |= 1u << gpio.pin_number;
+                bool level = (side == 1) && (reaction == Short_Circuit);
+                uint32_t mode = (moder[gpio.port] >> (2 * gpio.pin_number)) & 0x3;
+                bool odr_level = (odr[gpio.port] >> gpio.pin_number) & 1;
+                if (mode != 0x1 || odr_level != level) {
+                    printf("%s: %s, leg %zu %s side P%c%u mode %u level %d\n",
+                           path, reaction == Open_Circuit ? "open" : "short",
+                           i + 1, side == 0 ? "high" : "low",
+                           'A' + gpio.port, gpio.pin_number, mode, odr_level);
+                    failures++;
+                }
+            }
+        }
+
+        /* Other pins are untouched */
+        for (uint8_t port = 0; port < GPIO_PIN_MAP_PORTS; port++) {
+            uint32_t other_moder = ~0u;
+            for (uint8_t n = 0; n < 16; n++) {
+                if (switch_pins[port] & (1u << n)) {
+                    other_moder &= ~(0x3u << (2 * n));
+                }
+            }
+            if (((moder[port] ^ moder_before[port]) & other_moder) != 0 ||
+                ((odr[port] ^ odr_before[port]) & ~switch_pins[port]) != 0) {
+                printf("%s: port %c other pins changed\n", path, 'A' + port);
+                failures++;
+            }
+        }
+    }
+
+    printf("%s: %zu legs, %s\n", path, legs.size(),
+           failures == 0 ? "ok" : "FAILED");
+
+    return failures;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        printf("usage: %s <overlay>...\n", argv[0]);
+        return 1;
+    }
+
+    int failures = 0;
+    for (int i = 1; i < argc; i++) {
+        failures += check_overlay(argv[i]);
+    }
+
+    return failures == 0 ? 0 : 1;
+}
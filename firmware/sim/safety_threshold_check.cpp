@@ -0,0 +1,159 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Safety threshold check: compares the decisions of the safety
+ *         watch on raw codes against the decisions on converted values,
+ *         for every raw code of linear and thermistor conversions, with
+ *         thresholds placed on converted values and right next to them.
+ *
+ *         Usage: safety_threshold_check [--verbose]
+ *
+ *         Exits with an error if any decision differs.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "safety_raw_limits.h"
+
+static const uint16_t ADC_RAW_MAX = 4095;
+
+typedef struct {
+    bool therm;
+    float32_t raw_scale;
+    float32_t gain;
+    float32_t offset;
+} conversion_case_t;
+
+/* Same operations as data_conversion_convert_raw_value() */
+static float32_t convert(uint16_t raw_value, const void* context)
+{
+    const conversion_case_t* conversion = (const conversion_case_t*)context;
+    float32_t scaled_value = raw_value * conversion->raw_scale;
+
+    if (!conversion->therm) {
+        return (scaled_value * conversion->gain) + conversion->offset;
+    }
+
+    /* 10 kOhm NTC, B = 3950 K, 10 kOhm divider */
+    float32_t local_r0 = 10000.0f;
+    float32_t local_b = 3950.0f;
+    float32_t local_rdiv = 10000.0f;
+    float32_t local_t0 = 298.15f;
+
+    float32_t V_adc = (scaled_value / 4096.0f) * 2.048f;
+    float32_t R_t = (V_adc / (3.3f - V_adc)) * local_rdiv;
+    float32_t T =
+        local_t0 /
+        (1 + (float32_t)log(R_t / local_r0) * (local_t0 / local_b));
+    return (T - 273.15f);
+}
+
+static int check_case(const conversion_case_t& conversion, bool verbose)
+{
+    uint16_t raw_max = (uint16_t)(ADC_RAW_MAX / conversion.raw_scale);
+    static float32_t values[65536];
+    for (uint32_t raw = 0; raw <= raw_max; raw++) {
+        values[raw] = convert(raw, &conversion);
+    }
+
+    /* Thresholds on converted values, right next to them and out of range */
+    static const uint16_t codes[] = {0, 1, 2, 100, 1000, 2047, 3000};
+    float32_t thresholds[64];
+    int threshold_count = 0;
+    for (uint16_t code : codes) {
+        uint16_t raws[] = {code, (uint16_t)(raw_max - code)};
+        for (uint16_t raw : raws) {
+            float32_t value = values[raw];
+            thresholds[threshold_count++] = value;
+            thresholds[threshold_count++] = nextafterf(value, INFINITY);
+            thresholds[threshold_count++] = nextafterf(value, -INFINITY);
+        }
+    }
+    thresholds[threshold_count++] = 1e6f;
+    thresholds[threshold_count++] = -1e6f;
+
+    int mismatches = 0;
+    for (int i = 0; i < threshold_count; i++) {
+        for (int j = 0; j < threshold_count; j++) {
+            float32_t threshold_min = thresholds[i];
+            float32_t threshold_max = thresholds[j];
+
+            safety_raw_limits_t limits;
+            safety_compute_raw_limits(convert, &conversion, raw_max,
+                                      threshold_min, threshold_max, &limits);
+
+            for (uint32_t raw = 0; raw <= raw_max; raw++) {
+                float32_t value = values[raw];
+                bool outside = value > threshold_max || value < threshold_min;
+                if (outside == safety_raw_is_outside(&limits, raw)) {
+                    continue;
+                }
+                if (verbose || mismatches == 0) {
+                    printf("mismatch: %s gain %g offset %g scale %g, "
+                           "min %.9g max %.9g, raw %u value %.9g, "
+                           "limits [%d, %d]\n",
+                           conversion.therm ? "therm" : "linear",
+                           conversion.gain, conversion.offset,
+                           conversion.raw_scale, threshold_min,
+                           threshold_max, raw, value, limits.low,
+                           limits.high);
+                }
+                mismatches++;
+            }
+        }
+    }
+
+    return mismatches;
+}
+
+int main(int argc, char** argv)
+{
+    bool verbose = argc > 1 && strcmp(argv[1], "--verbose") == 0;
+
+    static const float32_t gains[] = {0.0305f, -0.0305f, 0.05f, -0.1f,
+                                      1.0f, 0.00123f};
+    static const float32_t offsets[] = {-50.0f, 62.5f, 0.0f, -0.5f};
+    static const float32_t raw_scales[] = {1.0f, 0.5f, 0.25f};
+
+    int cases = 0;
+    int mismatches = 0;
+    for (float32_t raw_scale : raw_scales) {
+        for (float32_t gain : gains) {
+            for (float32_t offset : offsets) {
+                conversion_case_t conversion = {false, raw_scale, gain,
+                                                offset};
+                mismatches += check_case(conversion, verbose);
+                cases++;
+            }
+        }
+        conversion_case_t conversion = {true, raw_scale, 0, 0};
+        mismatches += check_case(conversion, verbose);
+        cases++;
+    }
+
+    printf("%d conversions checked, %d mismatching decisions\n", cases,
+           mismatches);
+
+    return mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,196 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Sensors snapshot check: the latest values of all sensors taken
+ *         at once by SensorsAPI::getLatestValues() (owntech_shield_api
+ *         Sensors.cpp), checked against the values taken one by one by
+ *         getLatestValue(), on ADC conversions replayed through the DMA
+ *         model of fakes/adc_dma_model.h. The shield is described by the
+ *         host devicetree of fakes/sensors: linear sensors on ADC 1, one
+ *         of them not enabled, and a thermistor on ADC 4.
+ *
+ *         Values must be bit-exact, validity must match, and the snapshot
+ *         sequence must count acquisition cycles.
+ *
+ *         Usage: sensors_snapshot_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Sensors.h"
+#include "data_dispatch.h"
+#include "adc_dma_model.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static SensorsAPI sensors;
+
+/* Enabled sensors, ADC 1 ones in rank order */
+static const sensor_t adc1_sensors[] = {V1_LOW, I1_LOW, V_HIGH};
+static const sensor_t adc4_sensor = TEMP_SENSOR_1;
+
+/* Pseudo-random sequence, the same on every run */
+static uint32_t random_state = 1;
+
+static uint32_t next_random()
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7FFF;
+}
+
+/* Away from the ends, where the thermistor conversion diverges */
+static uint16_t random_raw_value()
+{
+    return (uint16_t)(64 + next_random() % 3968);
+}
+
+static bool same_value(float32_t a, float32_t b)
+{
+    return memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/**
+ * Validity of the second read of a value: read again if it was read
+ * first, missing if it was missing.
+ */
+static bool second_validity(uint8_t first, uint8_t second)
+{
+    if (first == DATA_IS_MISSING) {
+        return second == DATA_IS_MISSING;
+    }
+    return second == DATA_IS_OLD;
+}
+
+/**
+ * Take a snapshot and the values one by one, either first, and compare
+ * them. Returns the number of mismatches.
+ */
+static uint32_t compare(bool snapshot_first, sensors_snapshot_t &snapshot)
+{
+    float32_t values[SENSORS_COUNT + 1];
+    uint8_t data_valid[SENSORS_COUNT + 1];
+
+    if (snapshot_first) {
+        sensors.getLatestValues(snapshot);
+    }
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        values[sensor] = sensors.getLatestValue((sensor_t)sensor,
+                                                &data_valid[sensor]);
+    }
+    if (!snapshot_first) {
+        sensors.getLatestValues(snapshot);
+    }
+
+    uint32_t mismatches = 0;
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        bool valid = snapshot_first
+            ? second_validity(snapshot.data_valid[sensor], data_valid[sensor])
+            : second_validity(data_valid[sensor], snapshot.data_valid[sensor]);
+        if (!valid || !same_value(snapshot.values[sensor], values[sensor])) {
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+static void check_snapshot()
+{
+    adc_dma_model_reset();
+    for (sensor_t sensor : adc1_sensors) {
+        check(sensors.enableSensor(sensor, ADC_1) == 0, "sensor enabled");
+    }
+    check(sensors.enableSensor(adc4_sensor, ADC_4) == 0, "thermistor enabled");
+    check(spin.data.start() == 0, "data started");
+
+    sensors_snapshot_t snapshot;
+    sensors.getLatestValues(snapshot);
+    bool missing = true;
+    for (uint8_t sensor = 0; sensor <= SENSORS_COUNT; sensor++) {
+        missing = missing && snapshot.data_valid[sensor] == DATA_IS_MISSING
+                  && snapshot.values[sensor] == NO_VALUE;
+    }
+    check(missing, "all sensors missing before the first conversion");
+
+    uint32_t sequence = snapshot.sequence;
+    uint32_t cycles = 0;
+    uint32_t mismatches = 0;
+    bool sequence_ok = true;
+    bool not_enabled_missing = true;
+
+    for (uint32_t step = 0; step < 2000; step++) {
+        /* Whole acquisition cycles, then part of the next one */
+        uint32_t conversions = next_random() % 8;
+        for (uint32_t conversion = 0; conversion < conversions; conversion++) {
+            if (adc_dma_model_convert(1, random_raw_value())
+                == sizeof(adc1_sensors) / sizeof(adc1_sensors[0])) {
+                cycles++;
+            }
+            if (next_random() % 2 == 0) {
+                adc_dma_model_convert(4, random_raw_value());
+            }
+        }
+
+        /* Conversion parameters changed while running */
+        if (step == 1000) {
+            sensors.setConversionParametersLinear(V_HIGH, 0.125f, -3.0f);
+        }
+
+        mismatches += compare(step % 2 == 0, snapshot);
+
+        sequence_ok = sequence_ok && snapshot.sequence == sequence + cycles;
+        not_enabled_missing = not_enabled_missing
+                              && snapshot.data_valid[I_HIGH] == DATA_IS_MISSING;
+    }
+
+    check(mismatches == 0, "snapshot matches the values taken one by one");
+    check(sequence_ok, "snapshot sequence counts the acquisition cycles");
+    check(not_enabled_missing, "sensor not enabled is missing");
+
+    sensors_snapshot_t again;
+    sensors.getLatestValues(again);
+    bool same = again.sequence == snapshot.sequence;
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        same = same && same_value(again.values[sensor],
+                                  snapshot.values[sensor]);
+    }
+    check(same, "snapshots with the same sequence hold the same values");
+}
+
+int main()
+{
+    check_snapshot();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
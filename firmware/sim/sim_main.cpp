@@ -0,0 +1,692 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Host closed-loop simulator. Runs the application critical and
+ *         background tasks from src/main.cpp in simulated time against
+ *         the plant model, then dumps the scope records on stdout in the
+ *         same format as on the board. The fault record stored in the
+ *         flash model is read back as after a reset.
+ *
+ *         Usage: micro_inverter_sim [options]
+ *           --duration=<s>       simulated time (default 2)
+ *           --forming            resistive load, grid forming mode
+ *           --vin=<V>            source voltage
+ *           --grid=<V>           grid peak voltage
+ *           --start-at=<s>       power mode and inverter on request time
+ *           --ref-at=<s>         current (voltage if forming) step time
+ *           --ref=<A|V>          Id (Vd if forming) reference of the step
+ *           --trigger-at=<s>     scope trigger time (default: end - 60 ms)
+ *           --csv=<file>         plant and control trace
+ *           --csv-decim=<n>      one CSV line every n critical periods
+ *           --expect-mode=<n>    exit with an error if the final mode
+ *                                differs (regression checks)
+ *           --exec-us=<us>       critical task execution time seen by the
+ *                                deadline monitor (default 20)
+ *           --overrun-at=<s>     inject critical task overruns from then
+ *           --overrun-us=<us>    injected execution time (default 250)
+ *           --overrun-count=<n>  number of injected overruns (default 1)
+ *           --expect-overruns=<n> exit with an error if the deadline
+ *                                monitor counts another number of overruns
+ *           --event=<s>:<name>   post a mode event at the given time, can
+ *                                be repeated: idle, power, overcurrent,
+ *                                overrun, desync
+ *           --expect-latency=<n> exit with an error if a mode change was
+ *                                served more than n periods after its event
+ *           --update-race        HRTIM update event after each duty cycle
+ *                                write (worst case timing)
+ *           --expect-split-updates=<n> exit with an error if the H-bridge
+ *                                legs switched on another number of
+ *                                update events with duty cycles computed
+ *                                in different periods
+ *           --hw-trip=<A>        override the hardware overcurrent trip
+ *                                threshold set by the application
+ *           --expect-hw-trip=<0|1> exit with an error if the hardware
+ *                                overcurrent trip did not (0: did) fire
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+
+#include "TaskAPI.h"
+#include "ShieldAPI.h"
+#include "SpinAPI.h"
+#include "SafetyAPI.h"
+#include "auxiliary.h"
+#include "singlePhaseInverter.h"
+#include "user_data_api.h"
+#include "fault_recorder.h"
+#include "plant.h"
+
+/* Firmware entry point, renamed at build time */
+int firmware_main(void);
+
+/* Firmware variables */
+extern ScopeMimicry scope;
+extern inverter_mode local_mode;
+extern ModeStateMachine mode_fsm;
+
+/* Storage of the data exposed through ThingSet on the board */
+measurements_t user_meas = {0};
+inverter_debug_t user_inv_dbg = {0};
+boost_debug_t user_boost_dbg = {0};
+command_t user_cmd = {0};
+live_status_t user_live = {0};
+timing_status_t user_timing = {0};
+profiling_status_t user_profiling = {0};
+fault_status_t user_fault = {0};
+
+/* ThingSet is not simulated: nothing to serialise against */
+void app_lock_user_data(void)
+{
+}
+
+void app_unlock_user_data(void)
+{
+}
+
+/* Scripted mode events */
+static const uint8_t SIM_EVENTS_MAX = 16;
+
+typedef struct {
+    float64_t time;
+    uint8_t event;
+} sim_event_t;
+
+static const char* const mode_event_names[] = {
+    "tick", "idle", "power", "overcurrent", "overrun", "desync"
+};
+static const uint8_t MODE_EVENT_NAMES_COUNT =
+    sizeof(mode_event_names) / sizeof(mode_event_names[0]);
+
+typedef struct {
+    float64_t duration;
+    bool forming;
+    float64_t start_at;
+    float64_t ref_at;
+    float32_t ref;
+    float64_t trigger_at;
+    const char* csv_path;
+    uint32_t csv_decim;
+    int expect_mode;
+    uint32_t exec_us;
+    float64_t overrun_at;
+    uint32_t overrun_us;
+    uint32_t overrun_count;
+    int64_t expect_overruns;
+    sim_event_t events[SIM_EVENTS_MAX];
+    uint8_t events_count;
+    int64_t expect_latency;
+    bool update_race;
+    int64_t expect_split_updates;
+    float32_t hw_trip;
+    int expect_hw_trip;
+} sim_options_t;
+
+/* Plant integration step */
+static const uint32_t PLANT_STEPS_PER_US = 1;
+/* Timestamps are core clock cycles, as on the board */
+static const uint32_t CYCLES_PER_US = 170;
+
+static bool parse_option(const char* arg, const char* name, const char** value)
+{
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0) {
+        return false;
+    }
+    if (arg[length] == '=') {
+        *value = arg + length + 1;
+        return true;
+    }
+    if (arg[length] == '\0') {
+        *value = nullptr;
+        return true;
+    }
+    return false;
+}
+
+static int parse_event(const char* value, sim_options_t* options)
+{
+    const char* name = strchr(value, ':');
+    if (name == nullptr || options->events_count >= SIM_EVENTS_MAX) {
+        return -1;
+    }
+    name++;
+
+    /* Tick is not a posted event */
+    for (uint8_t event = 1; event < MODE_EVENT_NAMES_COUNT; event++) {
+        if (strcmp(name, mode_event_names[event]) == 0) {
+            sim_event_t& sim_event = options->events[options->events_count];
+            sim_event.time = atof(value);
+            sim_event.event = event;
+            options->events_count++;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+static int parse_options(int argc, char** argv, sim_options_t* options,
+                         plant_params_t* params)
+{
+    options->duration = 2.0;
+    options->forming = false;
+    options->start_at = 0.01;
+    options->ref_at = 1.0;
+    options->ref = 1.0F;
+    options->trigger_at = -1.0;
+    options->csv_path = nullptr;
+    options->csv_decim = 10;
+    options->expect_mode = -1;
+    options->exec_us = 20;
+    options->overrun_at = -1.0;
+    options->overrun_us = 250;
+    options->overrun_count = 1;
+    options->expect_overruns = -1;
+    options->events_count = 0;
+    options->expect_latency = -1;
+    options->update_race = false;
+    options->expect_split_updates = -1;
+    options->hw_trip = -1.0F;
+    options->expect_hw_trip = -1;
+
+    for (int i = 1; i < argc; i++) {
+        const char* value;
+        if (parse_option(argv[i], "--duration", &value) && value) {
+            options->duration = atof(value);
+        } else if (parse_option(argv[i], "--forming", &value)) {
+            options->forming = true;
+        } else if (parse_option(argv[i], "--vin", &value) && value) {
+            params->v_in = atof(value);
+        } else if (parse_option(argv[i], "--grid", &value) && value) {
+            params->v_grid_amp = atof(value);
+        } else if (parse_option(argv[i], "--start-at", &value) && value) {
+            options->start_at = atof(value);
+        } else if (parse_option(argv[i], "--ref-at", &value) && value) {
+            options->ref_at = atof(value);
+        } else if (parse_option(argv[i], "--ref", &value) && value) {
+            options->ref = atof(value);
+        } else if (parse_option(argv[i], "--trigger-at", &value) && value) {
+            options->trigger_at = atof(value);
+        } else if (parse_option(argv[i], "--csv", &value) && value) {
+            options->csv_path = value;
+        } else if (parse_option(argv[i], "--csv-decim", &value) && value) {
+            options->csv_decim = atoi(value) > 0 ? atoi(value) : 1;
+        } else if (parse_option(argv[i], "--expect-mode", &value) && value) {
+            options->expect_mode = atoi(value);
+        } else if (parse_option(argv[i], "--exec-us", &value) && value) {
+            options->exec_us = atoi(value);
+        } else if (parse_option(argv[i], "--overrun-at", &value) && value) {
+            options->overrun_at = atof(value);
+        } else if (parse_option(argv[i], "--overrun-us", &value) && value) {
+            options->overrun_us = atoi(value);
+        } else if (parse_option(argv[i], "--overrun-count", &value)
+                   && value) {
+            options->overrun_count = atoi(value);
+        } else if (parse_option(argv[i], "--expect-overruns", &value)
+                   && value) {
+            options->expect_overruns = atoll(value);
+        } else if (parse_option(argv[i], "--event", &value) && value) {
+            if (parse_event(value, options) != 0) {
+                fprintf(stderr, "Invalid event: %s\n", value);
+                return -1;
+            }
+        } else if (parse_option(argv[i], "--expect-latency", &value)
+                   && value) {
+            options->expect_latency = atoll(value);
+        } else if (parse_option(argv[i], "--update-race", &value)) {
+            options->update_race = true;
+        } else if (parse_option(argv[i], "--expect-split-updates", &value)
+                   && value) {
+            options->expect_split_updates = atoll(value);
+        } else if (parse_option(argv[i], "--hw-trip", &value) && value) {
+            options->hw_trip = (float32_t)atof(value);
+        } else if (parse_option(argv[i], "--expect-hw-trip", &value)
+                   && value) {
+            options->expect_hw_trip = atoi(value);
+        } else {
+            fprintf(stderr, "Unknown option: %s\n", argv[i]);
+            return -1;
+        }
+    }
+
+    if (options->trigger_at < 0.0) {
+        options->trigger_at = options->duration - 0.06;
+    }
+    params->grid_connected = !options->forming;
+    return 0;
+}
+
+/* Commands go through the same path as ThingSet writes */
+static void send_command(void)
+{
+    app_apply_command();
+}
+
+static void apply_scenario(const sim_options_t* options, float64_t time,
+                           float64_t period)
+{
+    if (time <= options->start_at && options->start_at < time + period) {
+        user_cmd.mode_request = POWERMODE;
+        user_cmd.inverter_on = true;
+        send_command();
+    }
+    if (time <= options->ref_at && options->ref_at < time + period) {
+        if (options->forming) {
+            user_cmd.vd_ref = options->ref;
+        } else {
+            user_cmd.id_ref = options->ref;
+        }
+        send_command();
+    }
+    if (time <= options->trigger_at && options->trigger_at < time + period) {
+        user_cmd.scope_trigger = true;
+        send_command();
+    }
+    /* Events go to the nearest period, whatever the rounding of times */
+    for (uint8_t i = 0; i < options->events_count; i++) {
+        const sim_event_t& sim_event = options->events[i];
+        if (time - period / 2 <= sim_event.time
+            && sim_event.time < time + period / 2) {
+            mode_fsm.post(sim_event.event);
+        }
+    }
+}
+
+static void update_sensors(const plant_measurements_t* meas, uint32_t timestamp)
+{
+    shield.sensors.setMeasuredValue(VLow, meas->v_low);
+    shield.sensors.setMeasuredValue(VAC, meas->v_ac);
+    shield.sensors.setMeasuredValue(VDCBus, meas->v_dc_bus);
+    shield.sensors.setMeasuredValue(ILow1, meas->i_low1);
+    shield.sensors.setMeasuredValue(ILow2, meas->i_low2);
+    shield.sensors.setMeasuredValue(IAC, meas->i_ac);
+    shield.sensors.newAcquisition(timestamp);
+    spin.data.dispatch(timestamp);
+}
+
+static void get_inputs(plant_inputs_t* inputs)
+{
+    inputs->boost_duty[0] = shield.power.duty_cycle[LEG1_LOW];
+    inputs->boost_duty[1] = shield.power.duty_cycle[LEG2_LOW];
+    inputs->boost_on[0] = shield.power.started[LEG1_LOW];
+    inputs->boost_on[1] = shield.power.started[LEG2_LOW];
+    inputs->bridge_duty[0] = shield.power.duty_cycle[LEG1_HIGH];
+    inputs->bridge_duty[1] = shield.power.duty_cycle[LEG2_HIGH];
+    inputs->bridge_on = shield.power.started[LEG1_HIGH]
+                        && shield.power.started[LEG2_HIGH];
+}
+
+static void write_csv_header(FILE* csv)
+{
+    fprintf(csv, "time,v_dc,i_in,i_f,v_cf,i_g,v_grid,duty_boost,"
+                 "duty_leg1,duty_leg2,bridge_on,mode,omega,id,iq\n");
+}
+
+static void write_csv_line(FILE* csv, const plant_state_t* state,
+                           const plant_measurements_t* meas,
+                           const plant_inputs_t* inputs)
+{
+    fprintf(csv, "%.6f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f,"
+                 "%d,%d,%.3f,%.4f,%.4f\n",
+            state->time, state->v_dc, meas->i_low2, state->i_f, state->v_cf,
+            state->i_g, meas->v_grid, inputs->boost_duty[0],
+            inputs->bridge_duty[0], inputs->bridge_duty[1],
+            inputs->bridge_on ? 1 : 0, user_live.mode, user_live.omega,
+            user_inv_dbg.idq_d, user_inv_dbg.idq_q);
+}
+
+/* Host execution times of the profiled sections */
+static void print_profiling(void)
+{
+    float32_t us_per_unit = 1.0e6F / task.getProfilingFrequency();
+
+    for (uint8_t section = 0; section < task.getProfilingSectionsCount();
+         section++) {
+        task_profiling_section_t stats;
+        if (task.getProfilingStatistics(section, stats) != 0
+            || stats.count == 0) {
+            continue;
+        }
+        fprintf(stderr, "%-10s mean %7.3f us, max %7.3f us\n", stats.name,
+                (float32_t)stats.total_cycles / stats.count * us_per_unit,
+                stats.max_cycles * us_per_unit);
+    }
+}
+
+/**
+ * Deadline monitor timestamps are simulated nanoseconds, the unit of the
+ * host profiling clock. The critical interrupt keeps a single pending
+ * event: a tick is served late when the previous execution lasts longer
+ * than a period, and lost when it lasts longer than two.
+ */
+typedef struct {
+    uint64_t busy_until_ns;
+    uint32_t injected;
+} sim_deadline_t;
+
+static bool deadline_tick_lost(const sim_deadline_t* deadline,
+                               uint64_t tick_ns, uint64_t period_ns)
+{
+    return deadline->busy_until_ns >= tick_ns + period_ns;
+}
+
+static uint64_t deadline_execution_ns(sim_deadline_t* deadline,
+                                      const sim_options_t* options,
+                                      float64_t time)
+{
+    if (options->overrun_at >= 0.0 && time >= options->overrun_at
+        && deadline->injected < options->overrun_count) {
+        deadline->injected++;
+        return (uint64_t)options->overrun_us * 1000;
+    }
+    return (uint64_t)options->exec_us * 1000;
+}
+
+static void print_deadline(void)
+{
+    task_deadline_stats_t stats;
+    if (task.getCriticalDeadlineStatistics(stats) != 0) {
+        return;
+    }
+    float32_t us_per_unit = 1.0e6F / task.getProfilingFrequency();
+
+    fprintf(stderr, "deadline   %u overruns, %u missed ticks, "
+                    "max jitter %.3f us, max execution %.3f us, "
+                    "decimation %u%s\n",
+            stats.overruns, stats.missed_ticks,
+            stats.max_jitter_cycles * us_per_unit,
+            stats.max_execution_cycles * us_per_unit, stats.decimation,
+            stats.tripped ? ", tripped" : "");
+}
+
+static const char* mode_name(uint8_t mode)
+{
+    switch (mode) {
+        case IDLEMODE:
+            return "idle";
+        case POWERMODE:
+            return "power";
+        case ERRORMODE:
+            return "error";
+        case STARTUPMODE:
+            return "startup";
+        default:
+            return "?";
+    }
+}
+
+/* Kept mode changes, returns the largest event latency */
+static uint32_t print_mode_trace(float64_t period)
+{
+    uint32_t max_latency = 0;
+    uint32_t count = mode_fsm.getTraceCount();
+    uint32_t first = count > MODE_FSM_TRACE_SIZE
+                     ? count - MODE_FSM_TRACE_SIZE : 0;
+
+    for (uint32_t index = first; index < count; index++) {
+        mode_trace_t record;
+        if (!mode_fsm.getTrace(index, record)) {
+            continue;
+        }
+        fprintf(stderr, "mode       %9.4f s %-7s -> %-7s on %-11s "
+                        "latency %u\n",
+                record.tick * period, mode_name(record.from),
+                mode_name(record.to),
+                record.event < MODE_EVENT_NAMES_COUNT
+                ? mode_event_names[record.event] : "?",
+                record.latency);
+        if (record.latency > max_latency) {
+            max_latency = record.latency;
+        }
+    }
+    if (mode_fsm.getDroppedEvents() != 0) {
+        fprintf(stderr, "mode       %u dropped events\n",
+                mode_fsm.getDroppedEvents());
+    }
+    return max_latency;
+}
+
+/* Fault record stored in flash, with its last samples. Its tick counts
+ * critical task calls, the first one is at time 0 */
+static void print_fault_record(float64_t period)
+{
+    static const char* const cause_names[] = {
+        "none", "overcurrent", "overrun", "safety"
+    };
+    fault_record_t record;
+
+    if (fault_record_retrieve(&record) != 0) {
+        return;
+    }
+    const fault_record_header_t& header = record.header;
+    fprintf(stderr, "fault      %9.4f s %-11s in %-7s record %u, "
+                    "sensor errors 0x%x\n",
+            (header.tick - 1) * period,
+            header.cause < sizeof(cause_names) / sizeof(cause_names[0])
+            ? cause_names[header.cause] : "?",
+            mode_name(header.mode), header.count, header.sensor_errors);
+
+    uint8_t first = FAULT_RECORD_SAMPLES - 4;
+    for (uint8_t sample = first; sample < FAULT_RECORD_SAMPLES; sample++) {
+        fprintf(stderr, "fault      %9.4f s Vdc %7.3f V, Igrid %7.3f A, "
+                        "duty boost %6.4f\n",
+                (header.tick - FAULT_RECORD_SAMPLES + sample) * period,
+                record.samples[FAULT_CHANNEL_V_DC_BUS][sample],
+                record.samples[FAULT_CHANNEL_I_GRID][sample],
+                record.samples[FAULT_CHANNEL_DUTY_BOOST][sample]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    sim_options_t options;
+    plant_params_t params;
+    plant_state_t state;
+    plant_inputs_t inputs;
+    plant_measurements_t meas;
+
+    plant_default_params(&params);
+    if (parse_options(argc, argv, &options, &params) != 0) {
+        return 2;
+    }
+    local_mode = options.forming ? FORMING : FOLLOWING;
+    plant_reset(&state, &params);
+
+    firmware_main();
+
+    if (!task.critical_started) {
+        fprintf(stderr, "Critical task was not started\n");
+        return 2;
+    }
+
+    if (options.hw_trip >= 0.0F) {
+        for (uint8_t s = 0; s <= SENSORS_COUNT; s++) {
+            safety.hw_trip_threshold[s] = options.hw_trip;
+        }
+    }
+
+    FILE* csv = nullptr;
+    if (options.csv_path != nullptr) {
+        csv = fopen(options.csv_path, "w");
+        if (csv == nullptr) {
+            fprintf(stderr, "Cannot open %s\n", options.csv_path);
+            return 2;
+        }
+        write_csv_header(csv);
+
+        /* Debug values of the CSV come from the telemetry snapshots */
+        user_cmd.telemetry_decimation = options.csv_decim;
+        send_command();
+    }
+
+    const uint32_t period_us = task.critical_period_us;
+    const float64_t period = period_us * 1.0e-6;
+    const uint32_t plant_steps = period_us * PLANT_STEPS_PER_US;
+    const float32_t plant_dt = (float32_t)(period / plant_steps);
+    const uint64_t periods_count = (uint64_t)(options.duration / period);
+    const uint64_t period_ns = (uint64_t)period_us * 1000;
+
+    /* Both legs of the H-bridge must switch on the same update event */
+    shield.power.synchronous[LEG1_HIGH] = true;
+    shield.power.synchronous[LEG2_HIGH] = true;
+    shield.power.update_after_writes = options.update_race;
+
+    sim_deadline_t deadline = {0, 0};
+    task_deadline_init((uint32_t)period_ns);
+
+    uint64_t background_next_us[SIM_BACKGROUND_TASKS_MAX] = {0};
+
+    /* First hardware trip, negative if none */
+    float64_t hw_trip_time = -1.0;
+    float32_t hw_trip_current = 0.0F;
+
+    auto wall_start = std::chrono::steady_clock::now();
+
+    for (uint64_t k = 0; k < periods_count; k++) {
+        uint64_t now_us = k * period_us;
+        float64_t now = now_us * 1.0e-6;
+
+        apply_scenario(&options, now, period);
+
+        /* ADC sampling on the PWM trigger, then the critical task */
+        plant_measure(&state, &params, &meas);
+        update_sensors(&meas, (uint32_t)(now_us * CYCLES_PER_US));
+        shield.power.write_period = (uint32_t)k;
+        uint64_t tick_ns = k * period_ns;
+        if (task.critical_started
+            && !deadline_tick_lost(&deadline, tick_ns, period_ns)) {
+            uint64_t start_ns = deadline.busy_until_ns > tick_ns
+                                ? deadline.busy_until_ns : tick_ns;
+            if (task_deadline_start((uint32_t)start_ns)) {
+                TASK_PROFILING_START(TASK_PROFILING_SECTION_USER_TASK);
+                task.critical_task();
+                TASK_PROFILING_END(TASK_PROFILING_SECTION_USER_TASK);
+                task_subtasks_run();
+            }
+            deadline.busy_until_ns =
+                start_ns + deadline_execution_ns(&deadline, &options, now);
+            task_deadline_end((uint32_t)deadline.busy_until_ns,
+                              deadline.busy_until_ns >= tick_ns + period_ns);
+        }
+
+        /* New duty cycles apply over the next PWM period */
+        shield.power.updateEvent();
+        get_inputs(&inputs);
+        for (uint32_t step = 0; step < plant_steps; step++) {
+            plant_step(&state, &params, &inputs, plant_dt);
+
+            /* The comparators see the currents at the plant rate and
+             * the fault inputs disable the outputs within the step */
+            float32_t i_low2 = state.i_boost[0] + state.i_boost[1];
+            bool tripped = safety.checkHardwareTrip(ILow1, state.i_f);
+            tripped = safety.checkHardwareTrip(ILow2, i_low2) || tripped;
+            if (tripped) {
+                for (uint8_t leg = 0; leg < LEGS_COUNT; leg++) {
+                    shield.power.started[leg] = false;
+                }
+                get_inputs(&inputs);
+                if (hw_trip_time < 0.0) {
+                    hw_trip_time = state.time;
+                    hw_trip_current = state.i_f > i_low2 ? state.i_f
+                                                         : i_low2;
+                }
+            }
+        }
+
+        /* Background tasks run in the remaining time */
+        for (uint8_t t = 0; t < task.background_count; t++) {
+            if (!task.background_started[t]
+                || background_next_us[t] > now_us) {
+                continue;
+            }
+            task.background_suspend_us = 0;
+            task.background_tasks[t]();
+            uint64_t suspend = task.background_suspend_us;
+            background_next_us[t] = now_us
+                                    + (suspend > period_us ? suspend
+                                                           : period_us);
+        }
+
+        if (csv != nullptr && (k % options.csv_decim) == 0) {
+            app_update_telemetry();
+            write_csv_line(csv, &state, &meas, &inputs);
+        }
+    }
+
+    std::chrono::duration<double> wall =
+        std::chrono::steady_clock::now() - wall_start;
+
+    if (csv != nullptr) {
+        fclose(csv);
+    }
+
+    dump_scope_datas(scope);
+    print_profiling();
+    print_deadline();
+    uint32_t max_latency = print_mode_trace(period);
+    fprintf(stderr, "pwm        %u split H-bridge updates\n",
+            shield.power.split_updates);
+
+    if (hw_trip_time >= 0.0) {
+        fprintf(stderr, "hw trip    at %.6f s, %.2f A\n", hw_trip_time,
+                hw_trip_current);
+    }
+    print_fault_record(period);
+
+    fprintf(stderr, "Simulated %.3f s in %.3f s (x%.0f), final mode %d\n",
+            options.duration, wall.count(),
+            wall.count() > 0.0 ? options.duration / wall.count() : 0.0,
+            user_live.mode);
+
+    if (options.expect_mode >= 0 && user_live.mode != options.expect_mode) {
+        fprintf(stderr, "Expected mode %d\n", options.expect_mode);
+        return 1;
+    }
+    if (options.expect_overruns >= 0) {
+        task_deadline_stats_t stats;
+        task.getCriticalDeadlineStatistics(stats);
+        if (stats.overruns != options.expect_overruns) {
+            fprintf(stderr, "Expected %lld overruns\n",
+                    (long long)options.expect_overruns);
+            return 1;
+        }
+    }
+    if (options.expect_latency >= 0 && max_latency > options.expect_latency) {
+        fprintf(stderr, "Expected mode changes within %lld periods\n",
+                (long long)options.expect_latency);
+        return 1;
+    }
+    if (options.expect_split_updates >= 0
+        && shield.power.split_updates != options.expect_split_updates) {
+        fprintf(stderr, "Expected %lld split H-bridge updates\n",
+                (long long)options.expect_split_updates);
+        return 1;
+    }
+    if (options.expect_hw_trip >= 0
+        && (hw_trip_time >= 0.0) != (options.expect_hw_trip != 0)) {
+        fprintf(stderr, options.expect_hw_trip ? "Expected a hardware trip\n"
+                                               : "Unexpected hardware trip\n");
+        return 1;
+    }
+    return 0;
+}
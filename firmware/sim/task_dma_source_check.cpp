@@ -0,0 +1,185 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  DMA task source check: the critical task called by data dispatch
+ *         on ADC 1 DMA interrupts (owntech_task_api
+ *         uninterruptible_synchronous_task.cpp), with conversions replayed
+ *         through the DMA model of fakes/adc_dma_model.h: task period
+ *         against the HRTIM period, task calls and data seen, overruns
+ *         detected from pending DMA buffers, and stop.
+ *
+ *         Usage: task_dma_source_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+
+#include "uninterruptible_synchronous_task.h"
+#include "task_deadline.h"
+#include "adc_dma_model.h"
+#include "SpinAPI.h"
+#include "hrtim.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static const uint8_t ADC1_CHANNELS = 2;
+static const uint32_t HRTIM_PERIOD_US = 100;
+
+/* Latest value converted on each ADC 1 channel */
+static uint16_t latest[ADC1_CHANNELS];
+static uint16_t conversions = 0;
+
+static uint32_t task_calls = 0;
+static bool task_fresh = true;
+static bool task_slow = false;
+
+/* One ADC 1 sequence, as triggered once per HRTIM period */
+static void convert_sequence()
+{
+    for (uint8_t rank = 0; rank < ADC1_CHANNELS; rank++) {
+        /* Never PEEK_NO_VALUE */
+        latest[rank] = (uint16_t)(conversions++ & 0x7FFF);
+        adc_dma_model_convert(1, latest[rank]);
+    }
+}
+
+static void user_task()
+{
+    task_calls++;
+    for (uint8_t rank = 0; rank < ADC1_CHANNELS; rank++) {
+        uint32_t count = 0;
+        uint16_t* values = spin.data.getChannelRawValues(ADC_1, rank + 1,
+                                                         count);
+        task_fresh = task_fresh && values != nullptr && count > 0
+                     && values[count - 1] == latest[rank];
+    }
+
+    /* Slow task: next HRTIM period starts before it returns */
+    if (task_slow) {
+        task_slow = false;
+        convert_sequence();
+    }
+}
+
+static void start_task(uint32_t period_us)
+{
+    adc_dma_model_reset();
+    adc_dma_model_set_channels(1, ADC1_CHANNELS);
+    spin.data.stop();
+    task_calls = 0;
+    task_fresh = true;
+
+    check(scheduling_define_uninterruptible_synchronous_task(user_task,
+                                                             period_us) == 0,
+          "task defined");
+    scheduling_start_uninterruptible_synchronous_task(true);
+    task_deadline_reset();
+}
+
+static void check_define()
+{
+    scheduling_set_uninterruptible_synchronous_task_interrupt_source(
+        source_adc_dma);
+
+    sim_hrtim_period_us = 0;
+    check(scheduling_define_uninterruptible_synchronous_task(user_task,
+                                                             300) == -1,
+          "no task before the HRTIM period is set");
+
+    sim_hrtim_period_us = HRTIM_PERIOD_US;
+    check(scheduling_define_uninterruptible_synchronous_task(user_task,
+                                                             250) == -1,
+          "no task on a period not multiple of the HRTIM one");
+    check(scheduling_define_uninterruptible_synchronous_task(user_task,
+                                                             0) == -1,
+          "no task on a null period");
+}
+
+static void check_repetitions()
+{
+    start_task(3 * HRTIM_PERIOD_US);
+
+    for (uint8_t period = 0; period < 30; period++) {
+        convert_sequence();
+    }
+    check(task_calls == 10, "task called every 3 HRTIM periods");
+    check(task_fresh, "task sees the latest values");
+
+    /**
+     * The DMA buffer of the next HRTIM period is pending, but the task
+     * is only due 2 periods later.
+     */
+    for (uint8_t period = 0; period < 2; period++) {
+        convert_sequence();
+    }
+    task_slow = true;
+    convert_sequence();
+    check(task_calls == 11, "slow task called once");
+    check(task_deadline_get_stats()->overruns == 0,
+          "no overrun when the task is due after the pending buffer");
+
+    scheduling_stop_uninterruptible_synchronous_task();
+    for (uint8_t period = 0; period < 3; period++) {
+        convert_sequence();
+    }
+    check(task_calls == 11, "stopped task is not called");
+}
+
+static void check_every_period()
+{
+    start_task(HRTIM_PERIOD_US);
+
+    for (uint8_t period = 0; period < 10; period++) {
+        convert_sequence();
+    }
+    check(task_calls == 10, "task called every HRTIM period");
+    check(task_deadline_get_stats()->overruns == 0, "no overrun");
+
+    task_slow = true;
+    convert_sequence();
+    check(task_calls == 12, "pending buffer calls the task again");
+    check(task_fresh, "task sees the latest values after an overrun");
+    check(task_deadline_get_stats()->overruns == 1,
+          "overrun when the next buffer is pending");
+
+    scheduling_stop_uninterruptible_synchronous_task();
+}
+
+int main()
+{
+    check_define();
+    check_repetitions();
+    check_every_period();
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Task profiling check: statistics of the critical task profiling
+ *         sections (owntech_task_api task_profiling.cpp) against a
+ *         reference: power of 2 histogram bins of every duration up to
+ *         2^20 cycles and around every power of 2, min, max, total and
+ *         count, section definitions, invalid sections, and reset.
+ *
+ *         Usage: task_profiling_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "task_profiling.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* Reference bin: index of the most significant bit, saturated */
+static uint8_t reference_bin(uint32_t cycles)
+{
+    uint8_t bin = 0;
+    while (cycles > 1 && bin < TASK_PROFILING_HISTOGRAM_BINS - 1) {
+        cycles >>= 1;
+        bin++;
+    }
+    return bin;
+}
+
+/* Records one duration in a cleared section, checks its bin */
+static bool check_bin(int8_t section, uint32_t cycles)
+{
+    task_profiling_reset();
+    task_profiling_record(section, cycles);
+
+    const task_profiling_section_t* stats = task_profiling_get_section(section);
+    uint8_t expected = reference_bin(cycles);
+    for (uint8_t bin = 0; bin < TASK_PROFILING_HISTOGRAM_BINS; bin++) {
+        if (stats->histogram[bin] != (bin == expected ? 1U : 0U)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void check_sections()
+{
+    check(task_profiling_get_sections_count()
+          == TASK_PROFILING_SECTION_USER_TASK + 1,
+          "critical task proxy sections are defined");
+    check(strcmp(task_profiling_get_section(TASK_PROFILING_SECTION_DISPATCH)
+                 ->name, "dispatch") == 0
+          && strcmp(task_profiling_get_section(TASK_PROFILING_SECTION_SAFETY)
+                    ->name, "safety") == 0
+          && strcmp(task_profiling_get_section(
+                        TASK_PROFILING_SECTION_USER_TASK)->name,
+                    "user_task") == 0,
+          "critical task proxy section names");
+
+    int8_t section = task_profiling_define_section("measures");
+    check(section == TASK_PROFILING_SECTION_USER_TASK + 1,
+          "first user section follows the proxy ones");
+    check(strcmp(task_profiling_get_section(section)->name, "measures") == 0,
+          "user section name");
+
+    while (task_profiling_get_sections_count() < TASK_PROFILING_MAX_SECTIONS) {
+        task_profiling_define_section("filler");
+    }
+    check(task_profiling_define_section("extra") == -1,
+          "no section beyond TASK_PROFILING_MAX_SECTIONS");
+    check(task_profiling_get_section(TASK_PROFILING_MAX_SECTIONS) == nullptr,
+          "undefined section has no statistics");
+}
+
+static void check_histogram()
+{
+    const int8_t section = TASK_PROFILING_SECTION_USER_TASK;
+    uint32_t errors = 0;
+
+    for (uint32_t cycles = 0; cycles <= (1U << 20); cycles++) {
+        if (!check_bin(section, cycles)) {
+            errors++;
+        }
+    }
+    for (uint8_t bit = 1; bit < 32; bit++) {
+        uint32_t power = 1U << bit;
+        if (!check_bin(section, power - 1) || !check_bin(section, power)
+            || !check_bin(section, power + 1)) {
+            errors++;
+        }
+    }
+    if (!check_bin(section, UINT32_MAX)) {
+        errors++;
+    }
+
+    check(errors == 0, "durations are counted in their power of 2 bin");
+}
+
+static void check_statistics()
+{
+    const int8_t section = TASK_PROFILING_SECTION_SAFETY;
+    const uint32_t durations[] = {500, 20, 3000, 0, 70000, 20};
+    const uint8_t count = sizeof(durations) / sizeof(durations[0]);
+
+    task_profiling_reset();
+    uint64_t total = 0;
+    uint32_t bins[TASK_PROFILING_HISTOGRAM_BINS] = {};
+    for (uint8_t index = 0; index < count; index++) {
+        task_profiling_record(section, durations[index]);
+        total += durations[index];
+        bins[reference_bin(durations[index])]++;
+    }
+
+    const task_profiling_section_t* stats = task_profiling_get_section(section);
+    check(stats->count == count, "count");
+    check(stats->min_cycles == 0, "min, including a zero duration");
+    check(stats->max_cycles == 70000, "max");
+    check(stats->total_cycles == total, "total");
+    check(memcmp(stats->histogram, bins, sizeof(bins)) == 0,
+          "histogram of the durations");
+
+    /* Totals must not wrap on long runs */
+    task_profiling_reset();
+    task_profiling_record(section, UINT32_MAX);
+    task_profiling_record(section, UINT32_MAX);
+    check(stats->total_cycles == 2ULL * UINT32_MAX, "64-bit total");
+
+    /* Invalid sections are ignored */
+    task_profiling_reset();
+    task_profiling_record(-1, 100);
+    task_profiling_record(task_profiling_get_sections_count(), 100);
+    bool untouched = true;
+    for (uint8_t index = 0; index < task_profiling_get_sections_count();
+         index++) {
+        untouched = untouched
+                    && task_profiling_get_section(index)->count == 0;
+    }
+    check(untouched, "invalid sections are ignored");
+}
+
+static void check_reset()
+{
+    for (uint8_t section = 0; section < task_profiling_get_sections_count();
+         section++) {
+        task_profiling_record(section, 100 + section);
+        task_profiling_record(section, 5000);
+    }
+
+    task_profiling_reset();
+
+    bool cleared = true;
+    for (uint8_t section = 0; section < task_profiling_get_sections_count();
+         section++) {
+        const task_profiling_section_t* stats =
+            task_profiling_get_section(section);
+        cleared = cleared && stats->count == 0 && stats->min_cycles == 0
+                  && stats->max_cycles == 0 && stats->total_cycles == 0;
+        for (uint8_t bin = 0; bin < TASK_PROFILING_HISTOGRAM_BINS; bin++) {
+            cleared = cleared && stats->histogram[bin] == 0;
+        }
+    }
+    check(cleared, "reset clears every section");
+    check(task_profiling_get_sections_count() == TASK_PROFILING_MAX_SECTIONS
+          && strcmp(task_profiling_get_section(TASK_PROFILING_SECTION_USER_TASK
+                                               + 1)->name, "measures") == 0,
+          "reset keeps the section definitions");
+
+    /* First duration after a reset sets the min */
+    task_profiling_record(TASK_PROFILING_SECTION_DISPATCH, 800);
+    task_profiling_record(TASK_PROFILING_SECTION_DISPATCH, 900);
+    check(task_profiling_get_section(TASK_PROFILING_SECTION_DISPATCH)
+              ->min_cycles == 800,
+          "min after a reset");
+}
+
+static void check_instrumentation()
+{
+    task_profiling_reset();
+
+    TASK_PROFILING_START(TASK_PROFILING_SECTION_USER_TASK);
+    volatile uint32_t sum = 0;
+    for (uint32_t index = 0; index < 1000; index++) {
+        sum = sum + index;
+    }
+    TASK_PROFILING_END(TASK_PROFILING_SECTION_USER_TASK);
+
+    const task_profiling_section_t* stats =
+        task_profiling_get_section(TASK_PROFILING_SECTION_USER_TASK);
+    check(stats->count == 1 && stats->max_cycles > 0,
+          "instrumented section is recorded");
+    check(task_profiling_get_frequency() == 1000000000,
+          "host timestamps are nanoseconds");
+}
+
+int main()
+{
+    task_profiling_init();
+
+    check_sections();
+    check_histogram();
+    check_statistics();
+    check_reset();
+    check_instrumentation();
+
+    printf("%d sections, %d histogram bins\n",
+           task_profiling_get_sections_count(), TASK_PROFILING_HISTOGRAM_BINS);
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,239 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Critical sub-tasks check: phases chosen by the sub-task table
+ *         (owntech_task_api task_subtasks.cpp) against the collisions
+ *         counted over a hyperperiod, calls of each sub-task on the
+ *         periods of its phase and in order, restart, and execution time
+ *         and budget accounting with sub-tasks running for a set time on
+ *         the host clock.
+ *
+ *         Usage: task_subtasks_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+
+#include "task_profiling.h"
+#include "task_subtasks.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+typedef struct {
+    uint16_t divider;
+    uint32_t budget_ns;
+    // execution time of the sub-task
+    uint32_t run_ns;
+} subtask_config_t;
+
+static const subtask_config_t configs[TASK_SUBTASKS_MAX] = {
+    {1,  0,       0},
+    {2,  0,       0},
+    {2,  0,       0},
+    {4,  0,       0},
+    {3,  0,       0},
+    {6,  0,       0},
+    {10, 50000,   100000},
+    {5,  1000000, 0},
+};
+
+/* Least common multiple of the dividers */
+static const uint32_t HYPERPERIOD = 60;
+
+/* Sub-tasks called on the current period, in call order */
+static uint8_t calls[TASK_SUBTASKS_MAX];
+static uint8_t calls_count = 0;
+
+template <uint8_t SUBTASK>
+static void subtask()
+{
+    calls[calls_count++] = SUBTASK;
+
+    uint32_t start = task_profiling_get_timestamp();
+    while (task_profiling_get_timestamp() - start < configs[SUBTASK].run_ns) {
+    }
+}
+
+static const task_subtask_function_t functions[TASK_SUBTASKS_MAX] = {
+    subtask<0>, subtask<1>, subtask<2>, subtask<3>,
+    subtask<4>, subtask<5>, subtask<6>, subtask<7>,
+};
+
+static bool runs_on(uint8_t subtask, uint32_t period)
+{
+    const task_subtask_stats_t* stats = task_subtasks_get_stats(subtask);
+    return period % stats->divider == stats->phase;
+}
+
+/* Runs of the other sub-tasks (divider above 1) on the runs of a new one */
+static uint32_t collisions(uint16_t divider, uint16_t phase, uint8_t others)
+{
+    uint32_t count = 0;
+    for (uint32_t period = phase; period < HYPERPERIOD; period += divider) {
+        for (uint8_t other = 0; other < others; other++) {
+            if (task_subtasks_get_stats(other)->divider > 1
+                && runs_on(other, period)) {
+                count++;
+            }
+        }
+    }
+    return count;
+}
+
+static void check_phases()
+{
+    check(task_subtasks_add(nullptr, 2, 0) == -1, "no function");
+    check(task_subtasks_add(subtask<0>, 0, 0) == -1, "zero divider");
+    check(task_subtasks_get_count() == 0, "invalid sub-tasks are not added");
+
+    uint8_t spread = 0;
+    for (uint8_t index = 0; index < TASK_SUBTASKS_MAX; index++) {
+        const subtask_config_t &config = configs[index];
+        int8_t subtask = task_subtasks_add(functions[index], config.divider,
+                                           config.budget_ns);
+        if (subtask != index) {
+            check(false, "sub-tasks are numbered in order");
+            return;
+        }
+
+        const task_subtask_stats_t* stats = task_subtasks_get_stats(index);
+        uint32_t best = UINT32_MAX;
+        for (uint16_t phase = 0; phase < config.divider; phase++) {
+            uint32_t count = collisions(config.divider, phase, index);
+            best = count < best ? count : best;
+        }
+        if (stats->phase < config.divider
+            && collisions(config.divider, stats->phase, index) == best) {
+            spread++;
+        }
+    }
+
+    check(spread == TASK_SUBTASKS_MAX,
+          "phases minimize the collisions with the previous sub-tasks");
+    check(task_subtasks_get_stats(2)->phase != task_subtasks_get_stats(1)->phase,
+          "sub-tasks of the same divider are spread");
+    check(task_subtasks_add(subtask<0>, 2, 0) == -1, "table is full");
+    check(task_subtasks_get_stats(TASK_SUBTASKS_MAX) == nullptr,
+          "no statistics beyond the table");
+}
+
+/* Runs periods from period 0, checks the calls of each one */
+static bool run_periods(uint32_t periods)
+{
+    bool ok = true;
+    for (uint32_t period = 0; period < periods; period++) {
+        calls_count = 0;
+        task_subtasks_run();
+
+        uint8_t expected = 0;
+        for (uint8_t subtask = 0; subtask < TASK_SUBTASKS_MAX; subtask++) {
+            if (!runs_on(subtask, period)) {
+                continue;
+            }
+            ok = ok && expected < calls_count && calls[expected] == subtask;
+            expected++;
+        }
+        ok = ok && calls_count == expected;
+    }
+    return ok;
+}
+
+static void check_calls()
+{
+    check(run_periods(2 * HYPERPERIOD),
+          "sub-tasks are called in order on the periods of their phase");
+
+    for (uint8_t subtask = 0; subtask < TASK_SUBTASKS_MAX; subtask++) {
+        const task_subtask_stats_t* stats = task_subtasks_get_stats(subtask);
+        if (stats->count != 2 * HYPERPERIOD / stats->divider) {
+            check(false, "call counts");
+            break;
+        }
+    }
+
+    /* Stop in the middle of the periods, phases are kept */
+    run_periods(7);
+    task_subtasks_restart();
+    check(run_periods(HYPERPERIOD), "phases are kept after a restart");
+}
+
+static void check_budgets()
+{
+    task_subtasks_restart();
+    task_subtasks_reset_stats();
+
+    bool cleared = true;
+    for (uint8_t subtask = 0; subtask < TASK_SUBTASKS_MAX; subtask++) {
+        const task_subtask_stats_t* stats = task_subtasks_get_stats(subtask);
+        cleared = cleared && stats->count == 0 && stats->max_cycles == 0
+                  && stats->total_cycles == 0 && stats->budget_overruns == 0
+                  && stats->divider == configs[subtask].divider
+                  && stats->budget_cycles == configs[subtask].budget_ns;
+    }
+    check(cleared, "reset clears the statistics, keeps the configuration");
+
+    run_periods(HYPERPERIOD);
+
+    const task_subtask_stats_t* slow = task_subtasks_get_stats(6);
+    check(slow->count == HYPERPERIOD / configs[6].divider, "slow calls");
+    check(slow->budget_overruns == slow->count,
+          "every call longer than the budget is an overrun");
+    check(slow->max_cycles >= configs[6].run_ns,
+          "max execution time of the slow sub-task");
+    check(slow->total_cycles >= (uint64_t)slow->count * configs[6].run_ns,
+          "total execution time of the slow sub-task");
+
+    const task_subtask_stats_t* fast = task_subtasks_get_stats(7);
+    check(fast->count == HYPERPERIOD / configs[7].divider
+          && fast->budget_overruns == 0,
+          "calls within the budget are not overruns");
+
+    check(task_subtasks_get_stats(0)->budget_overruns == 0,
+          "sub-task without a budget has no overruns");
+}
+
+int main()
+{
+    check_phases();
+    if (task_subtasks_get_count() == TASK_SUBTASKS_MAX) {
+        check_calls();
+        check_budgets();
+    }
+
+    for (uint8_t subtask = 0; subtask < task_subtasks_get_count(); subtask++) {
+        const task_subtask_stats_t* stats = task_subtasks_get_stats(subtask);
+        printf("sub-task %u: divider %2u, phase %2u\n", subtask,
+               stats->divider, stats->phase);
+    }
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,331 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Telemetry buffer check: replays every interleaving of the steps
+ *         of the critical task publishing snapshots and of the background
+ *         task taking them (src/telemetry_buffer.h), then runs the
+ *         critical task, the background task copying the snapshots to
+ *         the ThingSet objects under a lock, and a ThingSet reader in
+ *         concurrent threads. No reader may see a snapshot mixing two
+ *         periods.
+ *
+ *         Usage: telemetry_buffer_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "telemetry_buffer.h"
+#include "user_data_api.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+/* -------------------------------------------------------------------------
+ * Interleavings
+ * ------------------------------------------------------------------------- */
+
+static const uint8_t FIELDS = 8;
+
+typedef struct {
+    uint32_t fields[FIELDS];
+} snapshot_t;
+
+/* Periods published by the writer and updates of the reader replayed */
+static const uint8_t WRITER_PERIODS = 4;
+static const uint8_t READER_UPDATES = 4;
+
+/* Writer: first half of the fields, second half, publish */
+static const uint8_t WRITER_STEPS = 3;
+/* Reader: update, read */
+static const uint8_t READER_STEPS = 2;
+
+typedef struct {
+    TripleBuffer<snapshot_t> buffer;
+    uint32_t writer_step;
+    uint32_t reader_step;
+    // last period published, 0 if none
+    uint32_t published;
+    bool fresh;
+    // period expected from read()
+    uint32_t expected;
+} interleaving_t;
+
+static uint64_t interleavings = 0;
+static uint64_t interleaving_failures = 0;
+
+static void writer_step(interleaving_t &state)
+{
+    uint32_t period = state.writer_step / WRITER_STEPS + 1;
+    snapshot_t &snapshot = state.buffer.write();
+
+    switch (state.writer_step % WRITER_STEPS) {
+        case 0:
+            for (uint8_t field = 0; field < FIELDS / 2; field++) {
+                snapshot.fields[field] = period;
+            }
+            break;
+        case 1:
+            for (uint8_t field = FIELDS / 2; field < FIELDS; field++) {
+                snapshot.fields[field] = period;
+            }
+            break;
+        default:
+            state.buffer.publish();
+            state.published = period;
+            state.fresh = true;
+            break;
+    }
+    state.writer_step++;
+}
+
+static bool reader_step(interleaving_t &state)
+{
+    bool ok = true;
+
+    if (state.reader_step % READER_STEPS == 0) {
+        bool updated = state.buffer.update();
+        ok = updated == state.fresh;
+        if (updated) {
+            state.expected = state.published;
+        }
+        state.fresh = false;
+    } else {
+        const snapshot_t &snapshot = state.buffer.read();
+        for (uint8_t field = 0; field < FIELDS; field++) {
+            ok = ok && snapshot.fields[field] == state.expected;
+        }
+    }
+    state.reader_step++;
+    return ok;
+}
+
+/* Replays the steps given by order, bit n set for a writer step */
+static void replay(uint32_t order, uint8_t steps)
+{
+    interleaving_t state = {};
+    bool ok = true;
+
+    for (uint8_t step = 0; step < steps; step++) {
+        if (order & (1U << step)) {
+            writer_step(state);
+        } else {
+            ok = reader_step(state) && ok;
+        }
+    }
+
+    interleavings++;
+    if (!ok) {
+        interleaving_failures++;
+    }
+}
+
+static void check_interleavings()
+{
+    const uint8_t writer_steps = WRITER_PERIODS * WRITER_STEPS;
+    const uint8_t steps = writer_steps + READER_UPDATES * READER_STEPS;
+
+    for (uint32_t order = 0; order < (1U << steps); order++) {
+        if (__builtin_popcount(order) == writer_steps) {
+            replay(order, steps);
+        }
+    }
+
+    check(interleaving_failures == 0,
+          "reader gets the latest complete snapshot in every interleaving");
+}
+
+/* -------------------------------------------------------------------------
+ * Concurrent tasks
+ * ------------------------------------------------------------------------- */
+
+static const uint32_t PERIODS = 50000;
+
+static const uint8_t MEAS_FIELDS = sizeof(measurements_t) / sizeof(float32_t);
+static const uint8_t INV_FIELDS = sizeof(inverter_debug_t) / sizeof(float32_t);
+
+/* Every field of a snapshot holds its period */
+static void fill(telemetry_t &snapshot, uint32_t period)
+{
+    float32_t *meas = &snapshot.meas.v_low;
+    for (uint8_t field = 0; field < MEAS_FIELDS; field++) {
+        meas[field] = (float32_t)period;
+    }
+    float32_t *inv = &snapshot.inv_dbg.theta;
+    for (uint8_t field = 0; field < INV_FIELDS; field++) {
+        inv[field] = (float32_t)period;
+    }
+    snapshot.boost_dbg.duty_leg1 = (float32_t)period;
+    snapshot.boost_dbg.duty_leg2 = (float32_t)period;
+    snapshot.boost_dbg.dt_rise_ns = (uint16_t)period;
+    snapshot.boost_dbg.dt_fall_ns = (uint16_t)period;
+}
+
+static bool consistent(const measurements_t &meas,
+                       const inverter_debug_t &inv,
+                       const boost_debug_t &boost)
+{
+    float32_t period = meas.v_low;
+    const float32_t *fields = &meas.v_low;
+    for (uint8_t field = 0; field < MEAS_FIELDS; field++) {
+        if (fields[field] != period) {
+            return false;
+        }
+    }
+    fields = &inv.theta;
+    for (uint8_t field = 0; field < INV_FIELDS; field++) {
+        if (fields[field] != period) {
+            return false;
+        }
+    }
+    return boost.duty_leg1 == period && boost.duty_leg2 == period
+           && boost.dt_rise_ns == (uint16_t)period
+           && boost.dt_fall_ns == (uint16_t)period;
+}
+
+/* ThingSet objects and the lock of the ThingSet context */
+measurements_t user_meas = {};
+inverter_debug_t user_inv_dbg = {};
+boost_debug_t user_boost_dbg = {};
+static std::mutex user_data_lock;
+
+static TripleBuffer<telemetry_t> telemetry;
+static std::atomic<uint8_t> started{0};
+static std::atomic<bool> writer_done{false};
+static std::atomic<bool> background_done{false};
+
+static std::atomic<uint32_t> torn_snapshots{0};
+static std::atomic<uint32_t> torn_objects{0};
+static std::atomic<uint32_t> stale_snapshots{0};
+static uint32_t updates = 0;
+static uint32_t thingset_reads = 0;
+
+/* All the tasks run before the first period */
+static void start()
+{
+    started++;
+    while (started.load() < 3) {
+        std::this_thread::yield();
+    }
+}
+
+static void critical_task()
+{
+    start();
+    for (uint32_t period = 1; period <= PERIODS; period++) {
+        fill(telemetry.write(), period);
+        telemetry.publish();
+        // Let the other tasks run, also on a single core
+        if (period % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+    writer_done.store(true);
+}
+
+/* Same as app_update_telemetry() */
+static void background_task()
+{
+    float32_t last = 0.0F;
+    start();
+    for (;;) {
+        bool done = writer_done.load();
+        if (telemetry.update()) {
+            const telemetry_t &snapshot = telemetry.read();
+            if (!consistent(snapshot.meas, snapshot.inv_dbg,
+                            snapshot.boost_dbg)) {
+                torn_snapshots++;
+            }
+            if (snapshot.meas.v_low <= last) {
+                stale_snapshots++;
+            }
+            last = snapshot.meas.v_low;
+            updates++;
+
+            std::lock_guard<std::mutex> lock(user_data_lock);
+            user_meas = snapshot.meas;
+            user_inv_dbg = snapshot.inv_dbg;
+            user_boost_dbg = snapshot.boost_dbg;
+        } else if (done) {
+            break;
+        }
+    }
+    check(last == (float32_t)PERIODS, "last snapshot is taken");
+    background_done.store(true);
+}
+
+static void thingset_reader()
+{
+    start();
+    while (!background_done.load()) {
+        {
+            std::lock_guard<std::mutex> lock(user_data_lock);
+            if (!consistent(user_meas, user_inv_dbg, user_boost_dbg)) {
+                torn_objects++;
+            }
+        }
+        thingset_reads++;
+        if (thingset_reads % 64 == 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+static void check_concurrent_tasks()
+{
+    std::thread reader(thingset_reader);
+    std::thread background(background_task);
+    std::thread critical(critical_task);
+
+    critical.join();
+    background.join();
+    reader.join();
+
+    check(torn_snapshots == 0, "background task never sees a torn snapshot");
+    check(stale_snapshots == 0, "snapshots are taken in publication order");
+    check(torn_objects == 0, "ThingSet never reads torn objects");
+    check(updates > 1, "tasks ran concurrently");
+}
+
+int main()
+{
+    check_interleavings();
+    check_concurrent_tasks();
+
+    printf("%llu interleavings, %u periods, %u updates, %u ThingSet reads\n",
+           (unsigned long long)interleavings, (unsigned int)PERIODS,
+           (unsigned int)updates, (unsigned int)thingset_reads);
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
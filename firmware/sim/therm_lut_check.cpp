@@ -0,0 +1,231 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Thermistor look-up table check: temperatures converted by data
+ *         conversion (owntech_spin_api data_conversion.cpp) through the
+ *         interpolated tables, against the thermistor equation evaluated
+ *         in double precision, for every raw code. Also checks channels
+ *         beyond the tables pool, tables rebuilt when parameters change,
+ *         and parameters retrieved from NVS.
+ *
+ *         Also times the conversion of all 4096 codes through a table and
+ *         through the equation, sweeping the codes a number of times
+ *         (100 by default). As for trig_benchmark, host times only rank
+ *         both conversions: they are not the cycle counts of the board.
+ *
+ *         Usage: therm_lut_check [sweeps]
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "data_conversion.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+typedef struct {
+    double r0;
+    double b;
+    double rdiv;
+    double t0;
+} therm_t;
+
+/* Twist v1.4.1 temperature sensors: 10 kOhm NTC, B = 3450 K */
+static const therm_t twist_ntc = {10000.0, 3450.0, 20000.0, 298.15};
+static const therm_t other_ntc = {100000.0, 4250.0, 100000.0, 298.15};
+
+/**
+ * Error bounds, in degrees Celsius. Tables are less accurate on high
+ * temperatures, where the curve is steeper. Above 150 degC, close to
+ * code 0 where the equation diverges, the temperature must only keep
+ * decreasing with the code.
+ */
+static const double LUT_MAX_ERROR = 0.05;
+static const double LUT_MAX_ERROR_HOT = 0.25;
+static const double EQUATION_MAX_ERROR = 0.01;
+static const double RANGE_MIN = -40.0;
+static const double RANGE_HOT = 100.0;
+static const double RANGE_MAX = 150.0;
+
+/* Equation of data_conversion.cpp: 2.048 V reference, 3.3 V divider */
+static double reference(const therm_t &ntc, uint16_t raw_value)
+{
+    double v_adc = raw_value / 4096.0 * 2.048;
+    double r_t = v_adc / (3.3 - v_adc) * ntc.rdiv;
+    double t = ntc.t0 / (1 + log(r_t / ntc.r0) * (ntc.t0 / ntc.b));
+    return t - 273.15;
+}
+
+static void set_therm(uint8_t adc_number, uint8_t channel,
+                      const therm_t &ntc)
+{
+    data_conversion_set_conversion_parameters_therm(adc_number, channel,
+                                                    (float32_t)ntc.r0,
+                                                    (float32_t)ntc.b,
+                                                    (float32_t)ntc.rdiv,
+                                                    (float32_t)ntc.t0);
+}
+
+/* Largest error on codes converted to temperatures in [min, max] */
+static double max_error(uint8_t adc_number, uint8_t channel,
+                        const therm_t &ntc, double min, double max_temp)
+{
+    double max = 0;
+    for (uint32_t raw = 1; raw <= 4095; raw++) {
+        double expected = reference(ntc, (uint16_t)raw);
+        if (expected < min || expected > max_temp) {
+            continue;
+        }
+        double value = data_conversion_convert_raw_value(adc_number, channel,
+                                                         (uint16_t)raw);
+        double error = fabs(value - expected);
+        if (!(error <= max)) {
+            max = error;
+        }
+    }
+    return max;
+}
+
+static bool decreasing(uint8_t adc_number, uint8_t channel)
+{
+    float32_t previous = data_conversion_convert_raw_value(adc_number,
+                                                           channel, 1);
+    for (uint32_t raw = 2; raw <= 4095; raw++) {
+        float32_t value = data_conversion_convert_raw_value(adc_number,
+                                                            channel,
+                                                            (uint16_t)raw);
+        if (!(value < previous)) {
+            return false;
+        }
+        previous = value;
+    }
+    return true;
+}
+
+static void check_lut(const char* name, uint8_t adc_number,
+                      uint8_t channel, const therm_t &ntc)
+{
+    double error = max_error(adc_number, channel, ntc, RANGE_MIN, RANGE_HOT);
+    double hot = max_error(adc_number, channel, ntc, RANGE_HOT, RANGE_MAX);
+    printf("%s: max error %.4f degC, %.4f degC above %.0f degC\n",
+           name, error, hot, RANGE_HOT);
+
+    check(error <= LUT_MAX_ERROR, "table error");
+    check(hot <= LUT_MAX_ERROR_HOT, "table error on high temperatures");
+    check(decreasing(adc_number, channel),
+          "temperature decreases on all codes");
+}
+
+/* Keeps the compiler from removing the timed conversions */
+static volatile float32_t sink;
+
+/* Host time of one conversion, over all codes */
+static double conversion_ns(uint8_t adc_number, uint8_t channel,
+                            uint32_t sweeps)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t sweep = 0; sweep < sweeps; sweep++) {
+        for (uint32_t raw = 0; raw <= 4095; raw++) {
+            sink = data_conversion_convert_raw_value(adc_number, channel,
+                                                     (uint16_t)raw);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count()
+           / (sweeps * 4096.0);
+}
+
+int main(int argc, char** argv)
+{
+    int sweeps = (argc > 1) ? atoi(argv[1]) : 100;
+    if (sweeps <= 0) {
+        fprintf(stderr, "usage: %s [sweeps]\n", argv[0]);
+        return 1;
+    }
+
+    data_conversion_init();
+
+    /* Two tables: the third thermistor channel uses the equation */
+    set_therm(1, 1, twist_ntc);
+    set_therm(2, 3, twist_ntc);
+    set_therm(4, 5, twist_ntc);
+
+    check_lut("ADC 1 channel 1", 1, 1, twist_ntc);
+    check_lut("ADC 2 channel 3", 2, 3, twist_ntc);
+
+    double equation = max_error(4, 5, twist_ntc, RANGE_MIN, RANGE_MAX);
+    double table = max_error(1, 1, twist_ntc, RANGE_MIN, RANGE_MAX);
+    printf("ADC 4 channel 5: max error %.4f degC (equation)\n", equation);
+    check(equation <= EQUATION_MAX_ERROR, "equation beyond the tables pool");
+    check(equation < table, "channel beyond the tables pool has no table");
+
+    /* First table step: equation */
+    bool first_step = true;
+    for (uint16_t raw = 1; raw < 16; raw++) {
+        first_step = first_step
+                     && data_conversion_convert_raw_value(1, 1, raw)
+                        == data_conversion_convert_raw_value(4, 5, raw);
+    }
+    check(first_step, "equation on the first table step");
+
+    /* Same thermistor through a table and through the equation */
+    double table_ns = conversion_ns(1, 1, sweeps);
+    double equation_ns = conversion_ns(4, 5, sweeps);
+    printf("%d sweeps of 4096 codes: table %.1f ns, equation %.1f ns "
+           "per conversion\n", sweeps, table_ns, equation_ns);
+
+    /* New parameters rebuild the table of the channel */
+    set_therm(1, 1, other_ntc);
+    check_lut("ADC 1 channel 1, new parameters", 1, 1, other_ntc);
+
+    /* Linear again, then thermistor: the table is reused */
+    data_conversion_set_conversion_parameters_linear(2, 3, 2.0f, 1.0f);
+    check(data_conversion_convert_raw_value(2, 3, 100) == 201.0f,
+          "linear conversion after a table");
+    set_therm(2, 3, other_ntc);
+    check_lut("ADC 2 channel 3, thermistor again", 2, 3, other_ntc);
+
+    /* Parameters retrieved from NVS rebuild the table */
+    check(data_conversion_store_channel_parameters_in_nvs(1, 1) == 0,
+          "parameters stored");
+    set_therm(1, 1, twist_ntc);
+    check(data_conversion_retrieve_channel_parameters_from_nvs(1, 1) == 0,
+          "parameters retrieved");
+    check_lut("ADC 1 channel 1, from NVS", 1, 1, other_ntc);
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,309 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+
+/**
+ * @brief  Dispatch timing statistics check: feeds timestamps of a fake
+ *         clock to the timing statistics (owntech_spin_api
+ *         timing_stats.cpp) and checks the period histogram, minimum,
+ *         maximum and latest periods against a reference computed here,
+ *         including across the wrap-around of the clock. Then replays
+ *         ADC conversions through the DMA model of fakes/adc_dma_model.h
+ *         into data dispatch, the fake DWT cycle counter advancing by a
+ *         jittered period between acquisition bursts, and checks the
+ *         statistics of each ADC.
+ *
+ *         Usage: timing_stats_check
+ *
+ *         Exits with an error on any failed check.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include <soc.h>
+
+#include "data_dispatch.h"
+#include "timing_stats.h"
+#include "adc_dma_model.h"
+
+static int failures = 0;
+
+static void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        failures++;
+    }
+}
+
+static const uint32_t PERIOD = 8500;    /* 20 kHz at 170 MHz */
+static const uint32_t BIN_WIDTH = 10;
+
+/* Pseudo-random sequence, the same on every run */
+static uint32_t random_state = 1;
+
+static uint32_t next_random()
+{
+    random_state = random_state * 1103515245 + 12345;
+    return (random_state >> 16) & 0x7FFF;
+}
+
+/* Period with a jitter covering all the bins and beyond */
+static uint32_t jittered_period()
+{
+    int32_t jitter = (int32_t)(next_random() % 201) - 100;
+    return PERIOD + jitter;
+}
+
+/* Reference statistics, computed in 64 bits on signed deviations */
+typedef struct
+{
+    uint32_t count;
+    uint32_t min_period;
+    uint32_t max_period;
+    uint32_t latest_period;
+    uint32_t histogram[TIMING_STATS_HISTOGRAM_BINS];
+} reference_t;
+
+static void reference_reset(reference_t &reference)
+{
+    memset(&reference, 0, sizeof(reference));
+    reference.min_period = UINT32_MAX;
+}
+
+static void reference_add(reference_t &reference, uint32_t period,
+                          uint32_t expected, uint32_t bin_width)
+{
+    reference.count++;
+    reference.latest_period = period;
+    if (period < reference.min_period) {
+        reference.min_period = period;
+    }
+    if (period > reference.max_period) {
+        reference.max_period = period;
+    }
+
+    int64_t deviation = (int64_t)period - (int64_t)expected;
+    int64_t bin = TIMING_STATS_HISTOGRAM_BINS / 2;
+    /* Floor division, for negative deviations too */
+    if (deviation >= 0) {
+        bin += deviation / bin_width;
+    } else {
+        bin -= (-deviation + bin_width - 1) / bin_width;
+    }
+    if (bin < 0) {
+        bin = 0;
+    }
+    if (bin >= TIMING_STATS_HISTOGRAM_BINS) {
+        bin = TIMING_STATS_HISTOGRAM_BINS - 1;
+    }
+    reference.histogram[bin]++;
+}
+
+static bool matches(const timing_stats_t &stats, const reference_t &reference)
+{
+    if (timing_stats_get_periods_count(&stats) != reference.count
+        || stats.latest_period != reference.latest_period
+        || stats.min_period != reference.min_period
+        || stats.max_period != reference.max_period) {
+        return false;
+    }
+    return memcmp(stats.histogram, reference.histogram,
+                  sizeof(stats.histogram)) == 0;
+}
+
+static void check_bins()
+{
+    timing_stats_t stats;
+    timing_stats_reset(&stats, 1000, BIN_WIDTH);
+
+    /* Period and expected bin, on both sides of each bin edge */
+    const struct {
+        uint32_t period;
+        uint8_t bin;
+    } periods[] = {
+        {1000, 8}, {1009, 8}, {1010, 9}, {999, 7}, {990, 7}, {989, 6},
+        {1079, 15}, {1080, 15}, {5000, 15}, {920, 0}, {919, 0}, {1, 0},
+    };
+
+    uint32_t timestamp = 0;
+    timing_stats_add_timestamp(&stats, timestamp);
+    check(timing_stats_get_periods_count(&stats) == 0,
+          "first timestamp is only a reference");
+
+    uint32_t histogram[TIMING_STATS_HISTOGRAM_BINS] = {};
+    bool binned = true;
+    for (const auto &entry : periods) {
+        timestamp += entry.period;
+        timing_stats_add_timestamp(&stats, timestamp);
+        histogram[entry.bin]++;
+        binned = binned && memcmp(stats.histogram, histogram,
+                                  sizeof(histogram)) == 0;
+    }
+    check(binned, "periods binned on both sides of the bin edges");
+    check(stats.min_period == 1 && stats.max_period == 5000
+          && stats.latest_period == 1, "minimum, maximum and latest periods");
+
+    /* Expected period taken from the first period */
+    timing_stats_reset(&stats, 0, BIN_WIDTH);
+    timing_stats_add_timestamp(&stats, 0);
+    timing_stats_add_timestamp(&stats, 700);
+    timing_stats_add_timestamp(&stats, 1389);
+    check(stats.expected_period == 700 && stats.histogram[8] == 1
+          && stats.histogram[6] == 1, "expected period from the first one");
+
+    /* No histogram without a bin width */
+    timing_stats_reset(&stats, 1000, 0);
+    timing_stats_add_timestamp(&stats, 0);
+    timing_stats_add_timestamp(&stats, 1000);
+    uint32_t empty[TIMING_STATS_HISTOGRAM_BINS] = {};
+    check(memcmp(stats.histogram, empty, sizeof(empty)) == 0
+          && stats.latest_period == 1000, "no histogram without bin width");
+}
+
+static void check_fake_clock()
+{
+    timing_stats_t stats;
+    reference_t reference;
+    timing_stats_reset(&stats, PERIOD, BIN_WIDTH);
+    reference_reset(reference);
+
+    /* Clock wraps around after a few hundred periods */
+    uint32_t clock = UINT32_MAX - 300 * PERIOD;
+    timing_stats_add_timestamp(&stats, clock);
+    uint32_t errors = 0;
+    for (uint32_t step = 0; step < 1000; step++) {
+        uint32_t period = jittered_period();
+        clock += period;
+        timing_stats_add_timestamp(&stats, clock);
+        reference_add(reference, period, PERIOD, BIN_WIDTH);
+        if (!matches(stats, reference)) {
+            errors++;
+        }
+    }
+    check(errors == 0, "statistics of a jittered clock across wrap-around");
+}
+
+/* Convert all the channels of an ADC after the clock advanced */
+static void convert_sequence(uint8_t adc_number, uint8_t channels_count)
+{
+    for (uint8_t rank = 0; rank < channels_count; rank++) {
+        adc_dma_model_convert(adc_number, rank, rank);
+    }
+}
+
+static void check_dispatch(bool dual)
+{
+    adc_dma_model_reset();
+    adc_dma_model_set_dual_mode(dual);
+    adc_dma_model_set_channels(1, 3);
+    adc_dma_model_set_channels(2, 3);
+    adc_dma_model_set_channels(4, 2);
+
+    /* Statistics configuration set before start is kept by init */
+    check(data_dispatch_reset_timing_stats(1, PERIOD, BIN_WIDTH) == 0
+          && data_dispatch_reset_timing_stats(2, PERIOD, BIN_WIDTH) == 0
+          && data_dispatch_reset_timing_stats(4, 2 * PERIOD, BIN_WIDTH) == 0,
+          "statistics configured");
+    check(data_dispatch_reset_timing_stats(6, PERIOD, BIN_WIDTH) == -1,
+          "no statistics for an invalid ADC");
+
+    sim_dwt.CYCCNT = UINT32_MAX - 100 * PERIOD;
+    check(data_dispatch_init(interrupt, 0) == 0, "init");
+    check(data_dispatch_get_timestamp(1) == 0,
+          "no timestamp before the first dispatch");
+
+    reference_t reference[3];
+    for (reference_t &entry : reference) {
+        reference_reset(entry);
+    }
+    /* ADC 4 is converted every other period */
+    uint32_t previous_timestamp[3] = {};
+    bool started[3] = {};
+    uint32_t timestamp_errors = 0;
+    for (uint32_t step = 0; step < 1000; step++) {
+        sim_dwt.CYCCNT += jittered_period();
+
+        const uint8_t adcs[] = {1, 2, 4};
+        for (uint8_t index = 0; index < 3; index++) {
+            uint8_t adc_number = adcs[index];
+            if ((adc_number == 2 && dual) || (adc_number == 4 && step % 2)) {
+                continue;
+            }
+            convert_sequence(adc_number, adc_number == 4 ? 2 : 3);
+
+            uint32_t timestamp = sim_dwt.CYCCNT;
+            if (data_dispatch_get_timestamp(adc_number) != timestamp) {
+                timestamp_errors++;
+            }
+            if (started[index]) {
+                reference_add(reference[index],
+                              timestamp - previous_timestamp[index],
+                              adc_number == 4 ? 2 * PERIOD : PERIOD,
+                              BIN_WIDTH);
+            }
+            previous_timestamp[index] = timestamp;
+            started[index] = true;
+        }
+        if (dual && data_dispatch_get_timestamp(2) != sim_dwt.CYCCNT) {
+            timestamp_errors++;
+        }
+    }
+    check(timestamp_errors == 0, dual
+          ? "dispatch timestamps in dual mode"
+          : "dispatch timestamps of independent ADCs");
+
+    timing_stats_t stats;
+    check(data_dispatch_get_timing_stats(1, &stats) == 0
+          && matches(stats, reference[0]), "ADC 1 dispatch statistics");
+    check(data_dispatch_get_timing_stats(4, &stats) == 0
+          && matches(stats, reference[2]), "ADC 4 dispatch statistics");
+    check(data_dispatch_get_timing_stats(2, &stats) == 0
+          && matches(stats, dual ? reference[0] : reference[1]),
+          dual ? "ADC 2 shares ADC 1 statistics in dual mode"
+               : "ADC 2 dispatch statistics");
+    check(data_dispatch_get_timing_stats(6, &stats) == -1,
+          "no statistics copied for an invalid ADC");
+
+    /* Reset keeps counting from the next dispatch */
+    check(data_dispatch_reset_timing_stats(1, PERIOD, BIN_WIDTH) == 0,
+          "statistics reset");
+    for (uint8_t step = 0; step < 3; step++) {
+        sim_dwt.CYCCNT += PERIOD;
+        convert_sequence(1, 3);
+    }
+    check(data_dispatch_get_timing_stats(1, &stats) == 0
+          && timing_stats_get_periods_count(&stats) == 2
+          && stats.histogram[TIMING_STATS_HISTOGRAM_BINS / 2] == 2,
+          "statistics restart after reset");
+}
+
+int main()
+{
+    check_bins();
+    check_fake_clock();
+    check_dispatch(false);
+    check_dispatch(true);
+
+    printf("%d failures\n", failures);
+
+    return failures == 0 ? 0 : 1;
+}
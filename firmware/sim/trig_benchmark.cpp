@@ -0,0 +1,209 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Trigonometry benchmark: compares libm, a lookup table and the
+ *         software CORDIC on sine, cosine and atan2, for maximum error
+ *         against double precision and host time per call.
+ *
+ *         The software CORDIC runs as many iterations as the coprocessor,
+ *         so its errors are of the order expected on the board, not the
+ *         exact ones: the coprocessor rounding is not modelled. Host times
+ *         only rank the software implementations: on the board, one
+ *         CORDIC sine and cosine takes about CORDIC_PRECISION + 10 cycles
+ *         including register accesses.
+ *
+ *         Usage: trig_benchmark [samples]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <chrono>
+
+#include "cordic.h"
+
+static const int LUT_SIZE = 1024;
+static const int ATAN_LUT_SIZE = 256;
+
+static float sin_lut[LUT_SIZE + 1];
+static float atan_lut[ATAN_LUT_SIZE + 1];
+
+/* Keeps the compiler from removing the benchmarked calls */
+static volatile float sink;
+
+typedef struct {
+    double max_sin_error;
+    double max_cos_error;
+    double max_atan2_error;
+    double sincos_ns;
+    double atan2_ns;
+} trig_result_t;
+
+static void init_luts(void)
+{
+    for (int i = 0; i <= LUT_SIZE; i++) {
+        sin_lut[i] = (float)sin(2.0 * M_PI * i / LUT_SIZE);
+    }
+    for (int i = 0; i <= ATAN_LUT_SIZE; i++) {
+        atan_lut[i] = (float)atan((double)i / ATAN_LUT_SIZE);
+    }
+}
+
+/* Sine table over one turn with linear interpolation */
+static float lut_sin(float angle)
+{
+    float turns = angle * (float)(1.0 / (2.0 * M_PI));
+    turns -= floorf(turns);
+    float position = turns * LUT_SIZE;
+    int index = (int)position;
+    if (index >= LUT_SIZE) {
+        index = LUT_SIZE - 1;
+    }
+    float fraction = position - index;
+    return sin_lut[index] + fraction * (sin_lut[index + 1] - sin_lut[index]);
+}
+
+static void lut_sincos(float angle, float* sin_value, float* cos_value)
+{
+    *sin_value = lut_sin(angle);
+    *cos_value = lut_sin(angle + (float)M_PI_2);
+}
+
+/* atan table on [0, 1] with octant reduction */
+static float lut_atan2(float y, float x)
+{
+    float abs_y = fabsf(y);
+    float abs_x = fabsf(x);
+    if (abs_x == 0 && abs_y == 0) {
+        return 0;
+    }
+
+    bool swapped = abs_y > abs_x;
+    float ratio = swapped ? abs_x / abs_y : abs_y / abs_x;
+    float position = ratio * ATAN_LUT_SIZE;
+    int index = (int)position;
+    if (index >= ATAN_LUT_SIZE) {
+        index = ATAN_LUT_SIZE - 1;
+    }
+    float fraction = position - index;
+    float angle = atan_lut[index]
+                  + fraction * (atan_lut[index + 1] - atan_lut[index]);
+
+    if (swapped) {
+        angle = (float)M_PI_2 - angle;
+    }
+    if (x < 0) {
+        angle = (float)M_PI - angle;
+    }
+    return (y < 0) ? -angle : angle;
+}
+
+static void libm_sincos(float angle, float* sin_value, float* cos_value)
+{
+    *sin_value = sinf(angle);
+    *cos_value = cosf(angle);
+}
+
+/* Difference between two angles, brought back to [-pi, pi] */
+static double angle_error(double a, double b)
+{
+    double error = fmod(a - b + M_PI, 2.0 * M_PI);
+    if (error < 0) {
+        error += 2.0 * M_PI;
+    }
+    return fabs(error - M_PI);
+}
+
+template <typename SinCos, typename Atan2>
+static trig_result_t run(SinCos sincos_function, Atan2 atan2_function,
+                         int samples)
+{
+    trig_result_t result = {};
+
+    /* Angles over [-2pi, 2pi] as seen by a PLL */
+    for (int i = 0; i < samples; i++) {
+        /* References are computed on the same rounded inputs */
+        double angle = (float)(-2.0 * M_PI + 4.0 * M_PI * i / samples);
+        float s, c;
+        sincos_function((float)angle, &s, &c);
+        result.max_sin_error = fmax(result.max_sin_error,
+                                    fabs(s - sin(angle)));
+        result.max_cos_error = fmax(result.max_cos_error,
+                                    fabs(c - cos(angle)));
+
+        double radius = 0.001 + 100.0 * i / samples;
+        double y = (float)(radius * sin(angle));
+        double x = (float)(radius * cos(angle));
+        float a = atan2_function((float)y, (float)x);
+        result.max_atan2_error = fmax(result.max_atan2_error,
+                                      angle_error(a, atan2(y, x)));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        float s, c;
+        sincos_function(0.001F * i, &s, &c);
+        sink = s + c;
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int i = 0; i < samples; i++) {
+        sink = atan2_function(0.001F * i - 1.0F, 1.0F - 0.0005F * i);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    result.sincos_ns = std::chrono::duration<double, std::nano>(middle - start)
+                       .count() / samples;
+    result.atan2_ns = std::chrono::duration<double, std::nano>(end - middle)
+                      .count() / samples;
+    return result;
+}
+
+static void print_result(const char* name, const trig_result_t* result)
+{
+    printf("%-8s %12.3e %12.3e %12.3e %10.1f %10.1f\n", name,
+           result->max_sin_error, result->max_cos_error,
+           result->max_atan2_error, result->sincos_ns, result->atan2_ns);
+}
+
+int main(int argc, char** argv)
+{
+    int samples = (argc > 1) ? atoi(argv[1]) : 1000000;
+    if (samples <= 0) {
+        fprintf(stderr, "usage: %s [samples]\n", argv[0]);
+        return 1;
+    }
+
+    init_luts();
+    cordic_init();
+
+    trig_result_t libm = run(libm_sincos, atan2f, samples);
+    trig_result_t lut = run(lut_sincos, lut_atan2, samples);
+    trig_result_t cordic = run(cordic_sincos, cordic_atan2, samples);
+
+    printf("%d samples, CORDIC precision %d\n", samples, CORDIC_PRECISION);
+    printf("%-8s %12s %12s %12s %10s %10s\n", "", "sin error", "cos error",
+           "atan2 error", "sincos ns", "atan2 ns");
+    print_result("libm", &libm);
+    print_result("lut", &lut);
+    print_result("cordic", &cordic);
+
+    return 0;
+}
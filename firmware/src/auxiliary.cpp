@@ -5,7 +5,10 @@
 #include "SpinAPI.h"
 #include "singlePhaseInverter.h"
 #include "user_data_api.h"
+#include "telemetry_buffer.h"
+#include "fault_recorder.h"
 #include <zephyr/sys/printk.h>
+#include <stdio.h>
 
 extern ScopeMimicry scope;
 extern bool is_downloading;
@@ -19,7 +22,10 @@ extern dqo_t Idq_ref_max;
 extern dqo_t Idq_ref_min;
 extern dqo_t Idq_ref;
 extern float32_t Ts;
-extern uint8_t mode_asked;
+extern ModeStateMachine mode_fsm;
+extern TripleBuffer<telemetry_t> telemetry;
+extern uint32_t telemetry_decimation;
+extern FaultRecorder fault_recorder;
 
 bool a_trigger()
 {
@@ -37,20 +43,34 @@ void dump_scope_datas(ScopeMimicry &scope)
     printk("end record\n");
 }
 
+// Mode request of the last command applied, none before the first one
+static uint8_t applied_mode_request = UINT8_MAX;
+
 void app_apply_command(void)
 {
-    switch (user_cmd.mode_request) {
-        case IDLEMODE:
-            mode_asked = IDLEMODE;
-            break;
-        case POWERMODE:
-            if (!is_downloading) {
-                scope.start();
-            }
-            mode_asked = POWERMODE;
-            break;
-        default:
-            break;
+    // Commands also carry references: the mode request is only posted when
+    // it changes, so that a reference write does not restart the scope
+    if (user_cmd.mode_request != applied_mode_request) {
+        applied_mode_request = user_cmd.mode_request;
+        switch (user_cmd.mode_request) {
+            case IDLEMODE:
+                mode_fsm.post(MODE_EVENT_IDLE_REQUEST);
+                break;
+            case POWERMODE:
+                if (!is_downloading) {
+                    scope.start();
+                }
+                mode_fsm.post(MODE_EVENT_POWER_REQUEST);
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Idle acknowledges an overrun trip, even if it was already requested
+    if (user_cmd.mode_request == IDLEMODE && user_timing.overrun_trip) {
+        task.resetCriticalDeadlineStatistics();
+        user_timing.overrun_trip = false;
     }
 
     inverter_on = user_cmd.inverter_on;
@@ -86,6 +106,28 @@ void app_apply_command(void)
         trigger = true;
         user_cmd.scope_trigger = false;
     }
+
+    // 0 keeps the current decimation
+    if (user_cmd.telemetry_decimation > 0) {
+        telemetry_decimation = user_cmd.telemetry_decimation;
+    }
+    user_cmd.telemetry_decimation = telemetry_decimation;
+}
+
+void app_update_telemetry(void)
+{
+    if (!telemetry.update()) {
+        return;
+    }
+
+    // The snapshot stays valid until the next update(), the copy is
+    // serialised against the ThingSet reads
+    const telemetry_t &snapshot = telemetry.read();
+    app_lock_user_data();
+    user_meas = snapshot.meas;
+    user_inv_dbg = snapshot.inv_dbg;
+    user_boost_dbg = snapshot.boost_dbg;
+    app_unlock_user_data();
 }
 
 float32_t saturate(const float32_t x, float32_t min, float32_t max)
@@ -137,3 +179,132 @@ void enableUSolarVerterSensors()
     shield.sensors.enableSensor(VAC, ADC_2);
     shield.sensors.enableSensor(IAC, ADC_2);
 }
+
+void app_apply_profiling_command(void)
+{
+    if (user_profiling.reset) {
+        task.resetProfiling();
+        user_profiling.reset = false;
+    }
+}
+
+static void update_deadline_status()
+{
+    task_deadline_stats_t stats;
+    if (task.getCriticalDeadlineStatistics(stats) != 0) {
+        return;
+    }
+
+    float32_t us_per_unit = 1.0e6F / task.getProfilingFrequency();
+
+    user_timing.overruns = stats.overruns;
+    user_timing.missed_ticks = stats.missed_ticks;
+    user_timing.max_jitter_us = stats.max_jitter_cycles * us_per_unit;
+    user_timing.max_execution_us = stats.max_execution_cycles * us_per_unit;
+    user_timing.overrun_trip = stats.tripped;
+}
+
+void update_timing_status()
+{
+    update_deadline_status();
+
+    timing_stats_t stats;
+    if (spin.data.getDispatchTimingStatistics(ADC_1, stats) != 0) {
+        return;
+    }
+
+    float32_t us_per_unit = 1.0e6F / spin.data.getTimestampFrequency();
+
+    user_timing.periods_count = timing_stats_get_periods_count(&stats);
+    if (user_timing.periods_count == 0) {
+        return;
+    }
+    user_timing.min_period_us = stats.min_period * us_per_unit;
+    user_timing.max_period_us = stats.max_period * us_per_unit;
+    user_timing.latest_period_us = stats.latest_period * us_per_unit;
+    for (uint8_t bin = 0; bin < TIMING_HISTOGRAM_BINS; bin++) {
+        user_timing.histogram[bin] = stats.histogram[bin];
+    }
+}
+
+static_assert(PROFILING_HISTOGRAM_BINS == TASK_PROFILING_HISTOGRAM_BINS,
+              "Profiling histogram size mismatch");
+
+void update_profiling_status()
+{
+    uint8_t sections_count = task.getProfilingSectionsCount();
+    if (sections_count > PROFILING_SECTIONS_MAX) {
+        sections_count = PROFILING_SECTIONS_MAX;
+    }
+
+    float32_t us_per_cycle = 1.0e6F / task.getProfilingFrequency();
+    size_t names_length = 0;
+    user_profiling.section_names[0] = '\0';
+
+    for (uint8_t section = 0; section < sections_count; section++) {
+        task_profiling_section_t stats;
+        if (task.getProfilingStatistics(section, stats) != 0) {
+            continue;
+        }
+
+        names_length += snprintf(user_profiling.section_names + names_length,
+                                 PROFILING_NAMES_SIZE - names_length,
+                                 section == 0 ? "%s" : ",%s",
+                                 stats.name);
+        if (names_length >= PROFILING_NAMES_SIZE) {
+            names_length = PROFILING_NAMES_SIZE - 1;
+        }
+
+        user_profiling.count[section] = stats.count;
+        user_profiling.min_us[section] = stats.min_cycles * us_per_cycle;
+        user_profiling.max_us[section] = stats.max_cycles * us_per_cycle;
+        user_profiling.mean_us[section] = stats.count == 0
+            ? 0.0F
+            : (float32_t)stats.total_cycles / stats.count * us_per_cycle;
+        for (uint8_t bin = 0; bin < PROFILING_HISTOGRAM_BINS; bin++) {
+            user_profiling.histogram[section * PROFILING_HISTOGRAM_BINS + bin]
+                = stats.histogram[bin];
+        }
+    }
+}
+
+void app_apply_fault_command(void)
+{
+    if (user_fault.clear) {
+        if (fault_record_clear(user_fault.record.header.count) == 0) {
+            user_fault.valid = false;
+        }
+        user_fault.clear = false;
+    }
+}
+
+void load_fault_status()
+{
+    int8_t rc = fault_record_retrieve(&user_fault.record);
+    user_fault.valid = rc == 0;
+    if (rc < 0) {
+        // No record, or not readable: counting starts again
+        user_fault.record.header = {};
+    }
+    if (user_fault.valid) {
+        printk("Fault record %u stored before reset, cause %u \n",
+               (unsigned int)user_fault.record.header.count,
+               user_fault.record.header.cause);
+    }
+}
+
+void update_fault_status()
+{
+    static fault_record_t record;
+    if (!fault_recorder.collect(record)) {
+        return;
+    }
+
+    record.header.count = user_fault.record.header.count + 1;
+    if (fault_record_store(&record) != 0) {
+        printk("Fault record not stored \n");
+    }
+
+    user_fault.record = record;
+    user_fault.valid = true;
+}
@@ -2,6 +2,7 @@
 #define AUXILIARY_H
 
 #include "ScopeMimicry.h"
+#include "mode_fsm.h"
 
 /**
  * @brief List of possible modes for the OwnTech converter.
@@ -14,6 +15,20 @@ enum serial_interface_menu_mode
     STARTUPMODE = 4
 };
 
+/**
+ * @brief Events of the mode state machine, see the transition table in
+ * main.cpp.
+ */
+enum mode_event
+{
+    MODE_EVENT_TICK = MODE_FSM_EVENT_TICK,
+    MODE_EVENT_IDLE_REQUEST,
+    MODE_EVENT_POWER_REQUEST,
+    MODE_EVENT_OVERCURRENT,
+    MODE_EVENT_OVERRUN,
+    MODE_EVENT_DESYNCHRONIZED
+};
+
 /**
  * @brief Scope trigger callback used by ScopeMimicry.
  *
@@ -72,4 +87,29 @@ float32_t rate_limiter(const float32_t ref,
  */
 void enableUSolarVerterSensors();
 
+/**
+ * @brief Copy ADC_1 dispatch timing statistics and critical task
+ * deadline statistics to the ThingSet Timing group, converting
+ * times to microseconds.
+ */
+void update_timing_status();
+
+/**
+ * @brief Copy critical task profiling statistics to the ThingSet
+ * Profiling group, converting times to microseconds.
+ */
+void update_profiling_status();
+
+/**
+ * @brief Read the fault record stored before the last reset into the
+ * ThingSet FaultRecord group.
+ */
+void load_fault_status();
+
+/**
+ * @brief Store the fault frozen by the critical task, if any, in flash
+ * and show it in the ThingSet FaultRecord group.
+ */
+void update_fault_status();
+
 #endif // AUXILIARY_H
@@ -0,0 +1,119 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free bounded queue with several writers and one reader.
+ *
+ * Each cell holds a sequence number telling whether it is free for the
+ * writer claiming this position or holds a value for the reader. Writers
+ * claim a position with a compare-and-swap on the tail, so a writer
+ * interrupted by another one (e.g. a thread by the critical task) never
+ * blocks it: the interrupting writer simply claims the next position.
+ * The reader stops at the first cell not published yet and gets it on
+ * its next call.
+ *
+ * push() can be called from any context, pop() only by the reader.
+ */
+template <typename T, uint8_t SIZE>
+class EventQueue
+{
+    static_assert(SIZE != 0 && (SIZE & (SIZE - 1)) == 0,
+                  "queue size must be a power of 2");
+
+public:
+    EventQueue()
+    {
+        for (uint32_t i = 0; i < SIZE; i++) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add a value at the end of the queue: claim() then publish().
+     *
+     * @return false if the queue is full, the value is then dropped.
+     */
+    bool push(const T &value)
+    {
+        uint32_t position;
+        if (!claim(position)) {
+            return false;
+        }
+        publish(position, value);
+        return true;
+    }
+
+    /**
+     * @brief Claim the next position. Until it is published, the reader
+     * does not get the values pushed after it.
+     *
+     * @param position Set to the claimed position.
+     * @return false if the queue is full.
+     */
+    bool claim(uint32_t &position)
+    {
+        position = tail.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell_t &cell = cells[position & MASK];
+            uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+            int32_t difference = (int32_t)(sequence - position);
+            if (difference == 0) {
+                if (tail.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed)) {
+                    return true;
+                }
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Publish the value of a claimed position to the reader.
+     */
+    void publish(uint32_t position, const T &value)
+    {
+        cell_t &cell = cells[position & MASK];
+        cell.value = value;
+        cell.sequence.store(position + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Take the oldest published value.
+     *
+     * @return false if there is no value to take.
+     */
+    bool pop(T &value)
+    {
+        cell_t &cell = cells[head & MASK];
+        uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if ((int32_t)(sequence - (head + 1)) < 0) {
+            return false;
+        }
+
+        value = cell.value;
+        cell.sequence.store(head + SIZE, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+private:
+    static const uint32_t MASK = SIZE - 1;
+
+    typedef struct {
+        std::atomic<uint32_t> sequence;
+        T value;
+    } cell_t;
+
+    cell_t cells[SIZE];
+    std::atomic<uint32_t> tail{0};
+    uint32_t head = 0;
+};
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,140 @@
+#include "fault_recorder.h"
+
+#include <string.h>
+
+#include "nvs_storage.h"
+
+// The record is split in NVS items: the header, then chunks of samples.
+// Each chunk holds the count of its record, so that a record whose store
+// was interrupted is detected instead of mixing two faults.
+static const uint8_t CHUNK_SAMPLES = 16;
+static const uint8_t CHUNKS =
+    FAULT_CHANNELS * FAULT_RECORD_SAMPLES / CHUNK_SAMPLES;
+
+typedef struct {
+    uint32_t count;
+    float32_t samples[CHUNK_SAMPLES];
+} fault_record_chunk_t;
+
+static_assert(FAULT_CHANNELS * FAULT_RECORD_SAMPLES % CHUNK_SAMPLES == 0,
+              "Samples must fill whole chunks");
+static_assert(CHUNKS < 0xFF, "Chunk ids must fit in the FAULT_RECORD category");
+// nvs_storage returns the item sizes as int8_t
+static_assert(sizeof(fault_record_chunk_t) <= INT8_MAX
+              && sizeof(fault_record_header_t) <= INT8_MAX,
+              "NVS items must be at most 127 bytes");
+
+static const uint16_t HEADER_ID = FAULT_RECORD;
+
+static uint16_t chunk_id(uint8_t chunk)
+{
+    return FAULT_RECORD | (chunk + 1);
+}
+
+bool FaultRecorder::trip(uint8_t cause, uint8_t mode, uint32_t tick,
+                         uint32_t sensor_errors)
+{
+    if (frozen.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    uint32_t recorded = head - armed_head;
+
+    header.layout = FAULT_RECORD_LAYOUT;
+    header.cause = cause;
+    header.mode = mode;
+    header.samples = recorded < FAULT_RECORD_SAMPLES
+                     ? (uint8_t)recorded : FAULT_RECORD_SAMPLES;
+    header.count = 0;
+    header.tick = tick;
+    header.sensor_errors = sensor_errors;
+
+    frozen.store(true, std::memory_order_release);
+    return true;
+}
+
+bool FaultRecorder::collect(fault_record_t &record)
+{
+    if (!frozen.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    record.header = header;
+
+    uint8_t missing = FAULT_RECORD_SAMPLES - header.samples;
+    for (uint8_t sample = 0; sample < FAULT_RECORD_SAMPLES; sample++) {
+        const float32_t *slot = ring[(head + sample) & SAMPLES_MASK];
+        for (uint8_t channel = 0; channel < FAULT_CHANNELS; channel++) {
+            record.samples[channel][sample] =
+                sample < missing ? 0.0F : slot[channel];
+        }
+    }
+
+    armed_head = head;
+    frozen.store(false, std::memory_order_release);
+    return true;
+}
+
+int8_t fault_record_store(const fault_record_t *record)
+{
+    const float32_t *samples = &record->samples[0][0];
+    fault_record_chunk_t chunk;
+    chunk.count = record->header.count;
+
+    // Header last: the previous record stays readable until all the
+    // chunks of the new one are written
+    for (uint8_t index = 0; index < CHUNKS; index++) {
+        memcpy(chunk.samples, samples + index * CHUNK_SAMPLES,
+               sizeof(chunk.samples));
+        int8_t rc = nvs_storage_store_data(chunk_id(index), &chunk,
+                                           sizeof(chunk));
+        if (rc < 0) {
+            return rc;
+        }
+    }
+
+    int8_t rc = nvs_storage_store_data(HEADER_ID, &record->header,
+                                       sizeof(record->header));
+    return rc < 0 ? rc : 0;
+}
+
+int8_t fault_record_retrieve(fault_record_t *record)
+{
+    int8_t rc = nvs_storage_retrieve_data(HEADER_ID, &record->header,
+                                          sizeof(record->header));
+    if (rc != sizeof(record->header)) {
+        return -1;
+    }
+    if (record->header.layout != FAULT_RECORD_LAYOUT) {
+        return -2;
+    }
+    if (record->header.cause == FAULT_CAUSE_NONE) {
+        return 1;
+    }
+
+    float32_t *samples = &record->samples[0][0];
+    fault_record_chunk_t chunk;
+
+    for (uint8_t index = 0; index < CHUNKS; index++) {
+        rc = nvs_storage_retrieve_data(chunk_id(index), &chunk,
+                                       sizeof(chunk));
+        if (rc != sizeof(chunk) || chunk.count != record->header.count) {
+            return -3;
+        }
+        memcpy(samples + index * CHUNK_SAMPLES, chunk.samples,
+               sizeof(chunk.samples));
+    }
+
+    return 0;
+}
+
+int8_t fault_record_clear(uint32_t count)
+{
+    fault_record_header_t header = {};
+    header.layout = FAULT_RECORD_LAYOUT;
+    header.cause = FAULT_CAUSE_NONE;
+    header.count = count;
+
+    int8_t rc = nvs_storage_store_data(HEADER_ID, &header, sizeof(header));
+    return rc < 0 ? rc : 0;
+}
@@ -0,0 +1,162 @@
+#ifndef FAULT_RECORDER_H
+#define FAULT_RECORDER_H
+
+#include <stdint.h>
+#include <atomic>
+
+#include <arm_math.h>
+
+/**
+ * @brief Recorded channels, in the order of the samples of a record.
+ */
+enum fault_channel
+{
+    FAULT_CHANNEL_V_DC_BUS = 0,
+    FAULT_CHANNEL_I_GRID,
+    FAULT_CHANNEL_V_GRID,
+    FAULT_CHANNEL_DUTY_LEG1,
+    FAULT_CHANNEL_DUTY_LEG2,
+    FAULT_CHANNEL_DUTY_BOOST,
+    FAULT_CHANNELS
+};
+
+/**
+ * @brief Cause of a recorded fault. `FAULT_CAUSE_NONE` is stored when the
+ * record is cleared.
+ */
+enum fault_cause
+{
+    FAULT_CAUSE_NONE = 0,
+    FAULT_CAUSE_OVERCURRENT,
+    FAULT_CAUSE_OVERRUN,
+    FAULT_CAUSE_SAFETY
+};
+
+// Samples per channel before the trip, must be a power of 2
+static const uint8_t FAULT_RECORD_SAMPLES = 32;
+
+// Layout of the stored record, incremented when it changes
+static const uint8_t FAULT_RECORD_LAYOUT = 1;
+
+typedef struct {
+    uint8_t layout;
+    uint8_t cause;
+    // mode before the trip
+    uint8_t mode;
+    // valid samples, the oldest ones are zeros if less than
+    // FAULT_RECORD_SAMPLES periods were recorded before the trip
+    uint8_t samples;
+    // number of records stored since the storage was erased
+    uint32_t count;
+    // critical task calls since startup, including the one of the trip
+    uint32_t tick;
+    // bit n set if the Safety API reported an error on sensor n
+    uint32_t sensor_errors;
+} fault_record_header_t;
+
+/**
+ * @brief Fault record: samples are in chronological order, the last one
+ * is the period of the trip.
+ */
+typedef struct {
+    fault_record_header_t header;
+    float32_t samples[FAULT_CHANNELS][FAULT_RECORD_SAMPLES];
+} fault_record_t;
+
+/**
+ * @brief Pre-trigger recorder of the key channels.
+ *
+ * The critical task samples the channels every period into a ring, and
+ * freezes it on a trip. The background task then collects the frozen
+ * ring as a record, to store it in flash, which re-arms the recorder.
+ * Trips are ignored until the previous one is collected.
+ */
+class FaultRecorder
+{
+public:
+    /**
+     * @brief Record the channels of the current period, called by the
+     * critical task. Ignored while the ring is frozen.
+     */
+    void sample(float32_t v_dc_bus, float32_t i_grid, float32_t v_grid,
+                float32_t duty_leg1, float32_t duty_leg2,
+                float32_t duty_boost)
+    {
+        if (frozen.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        float32_t *slot = ring[head & SAMPLES_MASK];
+        slot[FAULT_CHANNEL_V_DC_BUS] = v_dc_bus;
+        slot[FAULT_CHANNEL_I_GRID] = i_grid;
+        slot[FAULT_CHANNEL_V_GRID] = v_grid;
+        slot[FAULT_CHANNEL_DUTY_LEG1] = duty_leg1;
+        slot[FAULT_CHANNEL_DUTY_LEG2] = duty_leg2;
+        slot[FAULT_CHANNEL_DUTY_BOOST] = duty_boost;
+        head++;
+    }
+
+    /**
+     * @brief Freeze the ring, called by the critical task.
+     *
+     * @param cause Cause of the fault.
+     * @param mode Mode before the trip.
+     * @param tick Critical task calls since startup.
+     * @param sensor_errors Safety API errors, bit n for sensor n.
+     * @return false if the previous trip was not collected yet, this one
+     * is then ignored.
+     */
+    bool trip(uint8_t cause, uint8_t mode, uint32_t tick,
+              uint32_t sensor_errors);
+
+    /**
+     * @brief Copy the frozen ring, called by the background task. The
+     * recorder is then re-armed.
+     *
+     * @param record Filled with the fault, except its count.
+     * @return false if there was no trip since the last call, record is
+     * then unchanged.
+     */
+    bool collect(fault_record_t &record);
+
+private:
+    static const uint32_t SAMPLES_MASK = FAULT_RECORD_SAMPLES - 1;
+    static_assert((FAULT_RECORD_SAMPLES & SAMPLES_MASK) == 0,
+                  "FAULT_RECORD_SAMPLES must be a power of 2");
+
+    float32_t ring[FAULT_RECORD_SAMPLES][FAULT_CHANNELS] = {};
+    // next slot to write, i.e. the oldest sample
+    uint32_t head = 0;
+    // head when the recorder was armed
+    uint32_t armed_head = 0;
+    fault_record_header_t header = {};
+    std::atomic<bool> frozen{false};
+};
+
+/**
+ * @brief Store a record in the FAULT_RECORD category of the NVS, replacing
+ * the previous one. Slow flash writes: not for the critical task.
+ *
+ * @return 0 on success, negative value on error.
+ */
+int8_t fault_record_store(const fault_record_t *record);
+
+/**
+ * @brief Read the stored record.
+ *
+ * @param record Filled with the record. When cleared, only its header is
+ * valid, with FAULT_CAUSE_NONE.
+ * @return 0 if a record was read, 1 if the record was cleared, negative
+ * value if there is no record or it is invalid (not completely written,
+ * other layout).
+ */
+int8_t fault_record_retrieve(fault_record_t *record);
+
+/**
+ * @brief Clear the stored record, keeping its count.
+ *
+ * @return 0 on success, negative value on error.
+ */
+int8_t fault_record_clear(uint32_t count);
+
+#endif // FAULT_RECORDER_H
@@ -32,6 +32,7 @@
 #include "TaskAPI.h"
 #include "ShieldAPI.h"
 #include "SpinAPI.h"
+#include "SafetyAPI.h"
 #include "auxiliary.h"
 
 // Control library
@@ -42,6 +43,10 @@
 #include "singlePhaseInverter.h"
 #include "sogi.h"
 #include "user_data_api.h"
+#include "telemetry_buffer.h"
+#include "mode_fsm.h"
+#include "fault_recorder.h"
+#include "cordic.h"
 #include <zephyr/console/console.h>
 #include <zephyr/sys/printk.h>
 
@@ -59,6 +64,8 @@ void setup_routine();
 void loop_application_task();
 // Code to be executed in real time in the critical task
 void loop_critical_task();
+// Called in the critical task when it repeatedly overruns its period
+void critical_task_overrun();
 
 //-------------- USER VARIABLES DECLARATIONS ------------------
 // [us] period of the control task
@@ -74,7 +81,7 @@ float32_t Ilow2_value;    // [A]
 float32_t Vdc_bus;        // [V]
 float32_t Iac_value;      // [A]
 float32_t Vdc_bus_filt;   // [V]
-float32_t meas_data;      // holds the measurement for validation
+static sensors_snapshot_t meas_snapshot; // latest measurements of all sensors
 
 // [A] Current offset found experimentally 21/10/2025
 static float32_t I1_current_offset = 0.25F;
@@ -205,9 +212,158 @@ bool trigger = false;
 //---------------------------------------------------------------
 
 static uint8_t mode = IDLEMODE;
-uint8_t mode_asked = IDLEMODE;
 static float32_t spying_mode = 0;
 static const float32_t MAX_CURRENT = 8.0F;
+// [A] hardware trip, above the critical task check to catch faster faults
+static const float32_t HW_TRIP_CURRENT = 10.0F;
+// [bool] the startup phase was done since the inverter was turned on
+static bool startup_done = false;
+
+// Black box: key channels of the last periods, frozen on a trip and
+// stored in flash by the background task
+FaultRecorder fault_recorder;
+// Safety API alerts already recorded
+static uint32_t safety_trips_seen = 0;
+
+/**
+ * Freeze the fault recorder with the Safety API errors, called by the
+ * critical task on a trip.
+ */
+static void record_fault(uint8_t cause)
+{
+    static_assert(SENSORS_COUNT < 32, "Sensor errors must fit in 32 bits");
+
+    uint32_t sensor_errors = 0;
+    for (uint8_t sensor = 1; sensor <= SENSORS_COUNT; sensor++) {
+        if (safety.getChannelError((sensor_t)sensor)) {
+            sensor_errors |= 1UL << sensor;
+        }
+    }
+    fault_recorder.trip(cause, mode, critical_task_counter, sensor_errors);
+}
+
+//-------------- MODE STATE MACHINE ---------------------------
+// Guards and actions are called by the critical task
+
+static bool guard_startup_needed()
+{
+    if (!inverter_on || startup_done || Vdc_bus_filt < UDC_STARTUP) {
+        return false;
+    }
+    return local_mode == FORMING || Vgrid_meas >= 10;
+}
+
+static bool guard_startup_over()
+{
+    if (!inverter_on) {
+        return true;
+    }
+    if (local_mode == FORMING) {
+        return delta_duty_cycle > 0.49F;
+    }
+    return is_net_synchronized;
+}
+
+static void action_startup_over()
+{
+    startup_done = inverter_on;
+}
+
+static void action_stop()
+{
+    startup_done = false;
+}
+
+static bool currents_over_limit()
+{
+    return Ilow1_value > MAX_CURRENT
+           || Ilow1_value < -MAX_CURRENT
+           || Ilow2_value > MAX_CURRENT
+           || Ilow2_value < -MAX_CURRENT;
+}
+
+static bool hw_trip_latched()
+{
+    return safety.getChannelHardwareTrip(ILow1)
+           || safety.getChannelHardwareTrip(ILow2);
+}
+
+// A latched hardware trip is acknowledged by going back to idle, once
+// the currents are back under the limit: the converter stays in error
+// mode otherwise
+static bool guard_idle_allowed()
+{
+    return !hw_trip_latched() || !currents_over_limit();
+}
+
+static void action_idle()
+{
+    action_stop();
+    if (hw_trip_latched()) {
+        safety.clearHardwareTrip();
+    }
+}
+
+// Faults posted again in error mode follow the recorded one
+static void action_overcurrent()
+{
+    action_stop();
+    if (mode != ERRORMODE) {
+        record_fault(FAULT_CAUSE_OVERCURRENT);
+    }
+}
+
+static void action_overrun()
+{
+    action_stop();
+    if (mode != ERRORMODE) {
+        record_fault(FAULT_CAUSE_OVERRUN);
+    }
+}
+
+static void action_desynchronized()
+{
+    desync_counter = 0;
+    sync_counter = 0;
+    startup_done = false;
+    printk("System no longer synchronized \n");
+}
+
+static const mode_transition_t mode_transitions[] = {
+    // from          event                      guard
+    //               to             action
+    {MODE_FSM_ANY,   MODE_EVENT_OVERCURRENT,    nullptr,
+                     ERRORMODE,     action_overcurrent},
+    {MODE_FSM_ANY,   MODE_EVENT_OVERRUN,        nullptr,
+                     ERRORMODE,     action_overrun},
+    {MODE_FSM_ANY,   MODE_EVENT_IDLE_REQUEST,   guard_idle_allowed,
+                     IDLEMODE,      action_idle},
+    {IDLEMODE,       MODE_EVENT_POWER_REQUEST,  nullptr,
+                     POWERMODE,     nullptr},
+    {POWERMODE,      MODE_EVENT_DESYNCHRONIZED, nullptr,
+                     IDLEMODE,      action_desynchronized},
+    {POWERMODE,      MODE_EVENT_TICK,           guard_startup_needed,
+                     STARTUPMODE,   nullptr},
+    {STARTUPMODE,    MODE_EVENT_TICK,           guard_startup_over,
+                     POWERMODE,     action_startup_over},
+};
+
+// Mode requests are posted from any task, and served by the critical task
+// within one control period. Faults detected by the critical task are
+// served at once, without the queue
+ModeStateMachine mode_fsm(IDLEMODE, mode_transitions,
+                          sizeof(mode_transitions)
+                          / sizeof(mode_transitions[0]));
+
+// Telemetry snapshots, published every telemetry_decimation critical periods
+TripleBuffer<telemetry_t> telemetry;
+uint32_t telemetry_decimation = 100;
+
+// Critical task profiling sections
+static int8_t prof_measures;
+static int8_t prof_control;
+static int8_t prof_debug;
+static int8_t prof_scope;
 
 //-------------- SETUP FUNCTIONS ------------------------------
 
@@ -252,6 +408,8 @@ void setup_routine()
     scope.set_trigger(a_trigger);
     scope.start();
 
+    cordic_init();
+
     // PR initialization
     inverter.init(local_mode, Udc, Vgrid_amplitude_ref, w0, Ts);
 
@@ -290,10 +448,37 @@ void setup_routine()
     shield.power.initBuck(LEG1_HIGH);
     shield.power.initBuck(LEG2_HIGH);
 
+    // Hardware overcurrent trip: comparators stop the PWM within
+    // nanoseconds, positive currents only (one comparator per sensor)
+    sensor_t trip_sensors[] = {ILow1, ILow2};
+    float32_t trip_currents[] = {HW_TRIP_CURRENT, HW_TRIP_CURRENT};
+    if (safety.setChannelHardwareTrip(trip_sensors, trip_currents, 2) != 0) {
+        printk("Hardware overcurrent trip not available \n");
+    }
+
+    // Dispatch jitter statistics, 0.25 us bins around the control period
+    spin.data.resetDispatchTimingStatistics(ADC_1, control_task_period, 0.25F);
+
+    // Fault recorded before the last reset, readable through ThingSet
+    load_fault_status();
+
+    // Current telemetry decimation, readable through ThingSet
+    user_cmd.telemetry_decimation = telemetry_decimation;
+
+    // Critical task sections to profile
+    prof_measures = task.defineProfilingSection("measures");
+    prof_control = task.defineProfilingSection("control");
+    prof_debug = task.defineProfilingSection("debug");
+    prof_scope = task.defineProfilingSection("scope");
+
     // Then declare tasks
     uint32_t app_task_number = task.createBackground(loop_application_task);
     task.createCritical(loop_critical_task, control_task_period);
 
+    // Control is not valid anymore if the critical task keeps overrunning
+    task.setCriticalOverrunPolicy(overrun_policy_callback, 3,
+                                  critical_task_overrun);
+
     // Finally, start tasks
     task.startBackground(app_task_number);
     task.startCritical();
@@ -308,58 +493,17 @@ void setup_routine()
  */
 void loop_application_task()
 {
-/* --- STATE MACHINE --------------------------------------------------------*/
-// mode is the STATE variable
-// in each state we compute the transitions
-switch (mode) {
-        case IDLEMODE:
-
-            if (mode_asked == POWERMODE) {
-                mode = POWERMODE;
-            }
-            spin.led.turnOn();
-        break;
-        case STARTUPMODE:
-            if (!inverter_on) {
-                mode = POWERMODE;
-            }
-            if (local_mode == FORMING && delta_duty_cycle > 0.49F)
-            {
-                mode = POWERMODE;
-            } 
-            else if (local_mode == FOLLOWING && is_net_synchronized) 
-            {
-                mode = POWERMODE;
-                if (is_net_synchronized) spin.led.toggle();
-            }
-
-        break;
-        case POWERMODE:
-            if (mode_asked == IDLEMODE) {
-                mode = IDLEMODE;
-            }
-            if (inverter_on) {
-                if (local_mode == FORMING) {
-                    if (Vdc_bus_filt >= UDC_STARTUP) {
-                        mode = STARTUPMODE;
-                    } 
-                } else {
-                    if (Vgrid_meas >= 10 && Vdc_bus_filt >= UDC_STARTUP) {
-                        mode = STARTUPMODE;
-                    }
-                }
-                if (is_net_synchronized) spin.led.toggle();
-            }
-        break;
-        case ERRORMODE:
-        break;
-    }
-    if (mode_asked == IDLEMODE) {
-        mode = IDLEMODE; // global return to idle possible
+    // Mode transitions are done by the critical task, only the LED
+    // blinking depends on the mode here
+    uint8_t current_mode = mode_fsm.getMode();
+    if (current_mode == IDLEMODE) {
+        spin.led.turnOn();
+    } else if (current_mode != ERRORMODE && inverter_on
+               && is_net_synchronized) {
+        spin.led.toggle();
     }
-/* --- END OF STATE MACHINE -------------------------------------------------*/
 
-    if (mode == IDLEMODE)
+    if (current_mode == IDLEMODE)
     {
         if (is_downloading) {
             dump_scope_datas(scope);
@@ -367,7 +511,8 @@ switch (mode) {
         }
     }
 
-    user_live.mode = mode;
+    app_lock_user_data();
+    user_live.mode = current_mode;
     user_live.omega = omega;
     user_live.vgrid_amp_ref = Vgrid_amplitude_ref;
     user_live.power_d = power.d;
@@ -376,9 +521,58 @@ switch (mode) {
     user_live.idq_ref_delta_d = Idq_ref_delta.d;
     user_live.vdq_ref_d = Vdq_ref.d;
     user_live.vdq_ref_q = Vdq_ref.q;
+    app_unlock_user_data();
+
+    app_update_telemetry();
+    update_timing_status();
+    update_profiling_status();
+    update_fault_status();
+
     task.suspendBackgroundMs(100);
 }
 
+/**
+ * Copy measurements and debug values to the telemetry back buffer, then
+ * make it the snapshot read by the background task.
+ */
+static void publish_telemetry()
+{
+    telemetry_t &snapshot = telemetry.write();
+
+    snapshot.meas.v_low = Vlow_value;
+    snapshot.meas.v_ac = Vac_value;
+    snapshot.meas.v_dc_bus = Vdc_bus;
+    snapshot.meas.i_low1 = Ilow1_value;
+    snapshot.meas.i_low2 = Ilow2_value;
+    snapshot.meas.i_ac = Iac_value;
+    snapshot.meas.v_dc_bus_filt = Vdc_bus_filt;
+    snapshot.meas.v_grid = Vgrid_meas;
+    snapshot.meas.v_n = VN_meas;
+    snapshot.meas.i_grid = Igrid_meas;
+
+    snapshot.inv_dbg.theta = theta;
+    snapshot.inv_dbg.vab_alpha = Vab.alpha;
+    snapshot.inv_dbg.vab_beta = Vab.beta;
+    snapshot.inv_dbg.vab_out_alpha = Vab_output.alpha;
+    snapshot.inv_dbg.vab_out_beta = Vab_output.beta;
+    snapshot.inv_dbg.iab_alpha = Iab.alpha;
+    snapshot.inv_dbg.iab_beta = Iab.beta;
+    snapshot.inv_dbg.vdq_d = Vdq.d;
+    snapshot.inv_dbg.vdq_q = Vdq.q;
+    snapshot.inv_dbg.vdq_out_d = Vdq_output.d;
+    snapshot.inv_dbg.vdq_out_q = Vdq_output.q;
+    snapshot.inv_dbg.idq_d = Idq.d;
+    snapshot.inv_dbg.idq_q = Idq.q;
+    snapshot.inv_dbg.vgrid_ref = Vgrid_ref;
+
+    snapshot.boost_dbg.duty_leg1 = boost_duty_cycle;
+    snapshot.boost_dbg.duty_leg2 = boost_duty_cycle;
+    snapshot.boost_dbg.dt_rise_ns = boost_pos_dt;
+    snapshot.boost_dbg.dt_fall_ns = boost_neg_dt;
+
+    telemetry.publish();
+}
+
 /**
  * This is the code loop of the critical task
  * It is executed every 100 micro-seconds defined in the setup_software
@@ -390,24 +584,28 @@ void loop_critical_task()
 {
     critical_task_counter++;
 
+    TASK_PROFILING_START(prof_measures);
+
     // Retrieve measurements
-    meas_data = shield.sensors.getLatestValue(ILow1);
-    if (meas_data != NO_VALUE) Ilow1_value = meas_data - I1_current_offset;
+    shield.sensors.getLatestValues(meas_snapshot);
+
+    if (meas_snapshot.data_valid[ILow1] != DATA_IS_MISSING)
+        Ilow1_value = meas_snapshot.values[ILow1] - I1_current_offset;
 
-    meas_data = shield.sensors.getLatestValue(VLow);
-    if (meas_data != NO_VALUE) Vlow_value = meas_data;
+    if (meas_snapshot.data_valid[VLow] != DATA_IS_MISSING)
+        Vlow_value = meas_snapshot.values[VLow];
 
-    meas_data = shield.sensors.getLatestValue(VAC);
-    if (meas_data != NO_VALUE) Vac_value = meas_data;
+    if (meas_snapshot.data_valid[VAC] != DATA_IS_MISSING)
+        Vac_value = meas_snapshot.values[VAC];
 
-    meas_data = shield.sensors.getLatestValue(ILow2);
-    if (meas_data != NO_VALUE) Ilow2_value = meas_data - I2_current_offset;
+    if (meas_snapshot.data_valid[ILow2] != DATA_IS_MISSING)
+        Ilow2_value = meas_snapshot.values[ILow2] - I2_current_offset;
 
-    meas_data = shield.sensors.getLatestValue(VDCBus);
-    if (meas_data != NO_VALUE) Vdc_bus = meas_data;
+    if (meas_snapshot.data_valid[VDCBus] != DATA_IS_MISSING)
+        Vdc_bus = meas_snapshot.values[VDCBus];
 
-    meas_data = shield.sensors.getLatestValue(IAC);
-    if (meas_data != NO_VALUE) Iac_value = meas_data;
+    if (meas_snapshot.data_valid[IAC] != DATA_IS_MISSING)
+        Iac_value = meas_snapshot.values[IAC];
 
     Vdc_bus_filt = vHighFilter.calculateWithReturn(Vdc_bus);
 
@@ -415,26 +613,31 @@ void loop_critical_task()
     VN_meas = (Vlow_value + Vac_value) / 2;
     Igrid_meas = Ilow1_value;
 
-    user_meas.v_low = Vlow_value;
-    user_meas.v_ac = Vac_value;
-    user_meas.v_dc_bus = Vdc_bus;
-    user_meas.i_low1 = Ilow1_value;
-    user_meas.i_low2 = Ilow2_value;
-    user_meas.i_ac = Iac_value;
-    user_meas.v_dc_bus_filt = Vdc_bus_filt;
-    user_meas.v_grid = Vgrid_meas;
-    user_meas.v_n = VN_meas;
-    user_meas.i_grid = Igrid_meas;
-
-    // Overcurrent protection
-    if (Ilow1_value > MAX_CURRENT
-        || Ilow1_value < -MAX_CURRENT
-        || Ilow2_value > MAX_CURRENT
-        || Ilow2_value < -MAX_CURRENT)
+    // Duty cycles applied while these measurements were sampled
+    fault_recorder.sample(Vdc_bus, Igrid_meas, Vgrid_meas, duty_cycle_1,
+                          duty_cycle_2, boost_duty_cycle);
+
+    TASK_PROFILING_END(prof_measures);
+    TASK_PROFILING_START(prof_control);
+
+    // The Safety API stopped the power: record its alert
+    uint32_t safety_trips = safety.getTripCount();
+    if (safety_trips != safety_trips_seen) {
+        safety_trips_seen = safety_trips;
+        record_fault(FAULT_CAUSE_SAFETY);
+    }
+
+    // Overcurrent protection, served at once: a request being posted by
+    // a preempted task must not delay it
+    if (currents_over_limit() || hw_trip_latched())
     {
-        mode = ERRORMODE;
+        mode_fsm.dispatch(MODE_EVENT_OVERCURRENT);
     }
 
+    // Serve requests and events posted since the previous period
+    mode_fsm.process();
+    mode = mode_fsm.getMode();
+
 
     if (mode == IDLEMODE || mode == ERRORMODE)
     {
@@ -461,8 +664,8 @@ void loop_critical_task()
         );
         shield.power.setDeadTime(LEG1_LOW, boost_pos_dt, boost_neg_dt);
         shield.power.setDeadTime(LEG2_LOW, boost_pos_dt, boost_neg_dt);
-        shield.power.setDutyCycle(LEG1_LOW, boost_duty_cycle);
-        shield.power.setDutyCycle(LEG2_LOW, boost_duty_cycle);
+        shield.power.setDutyCycles({{LEG1_LOW, boost_duty_cycle},
+                                    {LEG2_LOW, boost_duty_cycle}});
         if (!boost_pwm_enable)
         {
             shield.power.start(LEG1_LOW);
@@ -494,8 +697,8 @@ void loop_critical_task()
             if (delta_duty_cycle > 0.5F) {
                 delta_duty_cycle = 0.5F;
             }
-            shield.power.setDutyCycle(LEG2_HIGH, 1 - delta_duty_cycle);
-            shield.power.setDutyCycle(LEG1_HIGH, delta_duty_cycle);
+            shield.power.setDutyCycles({{LEG1_HIGH, delta_duty_cycle},
+                                        {LEG2_HIGH, 1 - delta_duty_cycle}});
             // WE START THE PWM
             if (!pwm_enable)
             {
@@ -538,11 +741,7 @@ void loop_critical_task()
             desync_counter++;
             desync_counter_scope = (float32_t)desync_counter;
             if (desync_counter > 200) {
-                desync_counter = 0;
-                sync_counter = 0;
-                mode_asked = IDLEMODE;
-                mode = IDLEMODE;
-                printk("System no longer synchronized \n");
+                mode_fsm.post(MODE_EVENT_DESYNCHRONIZED);
             }                
         }
 
@@ -587,11 +786,15 @@ void loop_critical_task()
 
 
 
-        shield.power.setDutyCycle(LEG1_HIGH, duty_cycle_1);
-        shield.power.setDutyCycle(LEG2_HIGH, duty_cycle_2);
+        // Both legs of the bridge switch on the same carrier update
+        shield.power.setDutyCycles({{LEG1_HIGH, duty_cycle_1},
+                                    {LEG2_HIGH, duty_cycle_2}});
 
     }
 
+    TASK_PROFILING_END(prof_control);
+    TASK_PROFILING_START(prof_debug);
+
     /* Retrieve multiple data for debugging */
     theta = inverter.getTheta();
     Vdq = inverter.getVdq();
@@ -605,32 +808,37 @@ void loop_critical_task()
     omega = inverter.getw();
     Valpha_in_out = Vab_output.alpha - Vab.alpha; 
 
-    user_inv_dbg.theta = theta;
-    user_inv_dbg.vab_alpha = Vab.alpha;
-    user_inv_dbg.vab_beta = Vab.beta;
-    user_inv_dbg.vab_out_alpha = Vab_output.alpha;
-    user_inv_dbg.vab_out_beta = Vab_output.beta;
-    user_inv_dbg.iab_alpha = Iab.alpha;
-    user_inv_dbg.iab_beta = Iab.beta;
-    user_inv_dbg.vdq_d = Vdq.d;
-    user_inv_dbg.vdq_q = Vdq.q;
-    user_inv_dbg.vdq_out_d = Vdq_output.d;
-    user_inv_dbg.vdq_out_q = Vdq_output.q;
-    user_inv_dbg.idq_d = Idq.d;
-    user_inv_dbg.idq_q = Idq.q;
-
-    user_boost_dbg.duty_leg1 = boost_duty_cycle;
-    user_boost_dbg.duty_leg2 = boost_duty_cycle;
-    user_boost_dbg.dt_rise_ns = boost_pos_dt;
-    user_boost_dbg.dt_fall_ns = boost_neg_dt;
+    // Grid voltage sinewave at the PLL phase, from the CORDIC
+    float32_t sin_theta;
+    float32_t cos_theta;
+    cordic_sincos(theta, &sin_theta, &cos_theta);
+    Vgrid_ref = Vgrid_amplitude * sin_theta;
+
+    if (critical_task_counter % telemetry_decimation == 0) {
+        publish_telemetry();
+    }
 
+    TASK_PROFILING_END(prof_debug);
 
     if (critical_task_counter % decimation == 0) {
+        TASK_PROFILING_START(prof_scope);
         spying_mode = (float32_t) mode;
         scope.acquire();
+        TASK_PROFILING_END(prof_scope);
     }
 }
 
+/**
+ * Called by the deadline monitor, in the critical task context, after
+ * consecutive overruns of the control period: the control is no longer
+ * sampled at the rate it was designed for, so the error mode is entered
+ * at once and power is stopped by the next critical task call.
+ */
+void critical_task_overrun()
+{
+    mode_fsm.dispatch(MODE_EVENT_OVERRUN);
+}
+
 /**
  * This is the main function of this example
  * This function is generic and does not need editing.
@@ -0,0 +1,105 @@
+#include "mode_fsm.h"
+
+ModeStateMachine::ModeStateMachine(uint8_t initial_mode,
+                                   const mode_transition_t *table,
+                                   uint8_t table_size)
+    : table(table), table_size(table_size), mode(initial_mode)
+{
+}
+
+bool ModeStateMachine::post(uint8_t event)
+{
+    posted_event_t posted = {event, tick.load(std::memory_order_relaxed)};
+    if (!queue.push(posted)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void ModeStateMachine::process()
+{
+    uint32_t now = tick.load(std::memory_order_relaxed);
+    posted_event_t posted;
+
+    while (queue.pop(posted)) {
+        serve(posted.event, posted.tick);
+    }
+    serve(MODE_FSM_EVENT_TICK, now);
+
+    tick.store(now + 1, std::memory_order_relaxed);
+}
+
+void ModeStateMachine::dispatch(uint8_t event)
+{
+    serve(event, tick.load(std::memory_order_relaxed));
+}
+
+uint8_t ModeStateMachine::getMode() const
+{
+    return mode.load(std::memory_order_relaxed);
+}
+
+uint32_t ModeStateMachine::getTick() const
+{
+    return tick.load(std::memory_order_relaxed);
+}
+
+uint32_t ModeStateMachine::getDroppedEvents() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+uint32_t ModeStateMachine::getTraceCount() const
+{
+    return trace_count.load(std::memory_order_acquire);
+}
+
+bool ModeStateMachine::getTrace(uint32_t index, mode_trace_t &record) const
+{
+    uint32_t count = trace_count.load(std::memory_order_acquire);
+    if (index >= count || count - index > MODE_FSM_TRACE_SIZE) {
+        return false;
+    }
+
+    record = trace[index % MODE_FSM_TRACE_SIZE];
+
+    // The record may have been overwritten while being copied
+    count = trace_count.load(std::memory_order_acquire);
+    return count - index <= MODE_FSM_TRACE_SIZE;
+}
+
+void ModeStateMachine::serve(uint8_t event, uint32_t posted_tick)
+{
+    uint8_t from = mode.load(std::memory_order_relaxed);
+
+    for (uint8_t row = 0; row < table_size; row++) {
+        const mode_transition_t &transition = table[row];
+        if ((transition.from != from && transition.from != MODE_FSM_ANY)
+            || transition.event != event) {
+            continue;
+        }
+        if (transition.guard != nullptr && !transition.guard()) {
+            continue;
+        }
+
+        mode.store(transition.to, std::memory_order_relaxed);
+
+        if (transition.to != from) {
+            uint32_t now = tick.load(std::memory_order_relaxed);
+            uint32_t count = trace_count.load(std::memory_order_relaxed);
+            mode_trace_t &record = trace[count % MODE_FSM_TRACE_SIZE];
+            record.tick = now;
+            record.latency = (uint16_t)(now - posted_tick);
+            record.event = event;
+            record.from = from;
+            record.to = transition.to;
+            trace_count.store(count + 1, std::memory_order_release);
+        }
+
+        if (transition.action != nullptr) {
+            transition.action();
+        }
+        return;
+    }
+}
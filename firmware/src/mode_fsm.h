@@ -0,0 +1,147 @@
+#ifndef MODE_FSM_H
+#define MODE_FSM_H
+
+#include <stdint.h>
+#include <atomic>
+
+#include "event_queue.h"
+
+/**
+ * @brief Table row matching any current mode.
+ */
+static const uint8_t MODE_FSM_ANY = 0xFF;
+
+/**
+ * @brief Event evaluated by every process() call, after queued events.
+ * Transitions on it depend on guards only.
+ */
+static const uint8_t MODE_FSM_EVENT_TICK = 0;
+
+static const uint8_t MODE_FSM_QUEUE_SIZE = 16;
+static const uint8_t MODE_FSM_TRACE_SIZE = 16;
+
+typedef bool (*mode_guard_t)();
+typedef void (*mode_action_t)();
+
+/**
+ * @brief Row of a transition table. The first row matching the current
+ * mode and the event, and whose guard (if any) returns true, is taken:
+ * the mode becomes `to`, then the action (if any) is called.
+ */
+typedef struct {
+    uint8_t from;
+    uint8_t event;
+    mode_guard_t guard;
+    uint8_t to;
+    mode_action_t action;
+} mode_transition_t;
+
+/**
+ * @brief Record of a mode change. Times are process() calls, i.e.
+ * control periods when processed by the critical task. A latency of 0
+ * means the event was served by the first process() call after it was
+ * posted.
+ */
+typedef struct {
+    uint32_t tick;
+    uint16_t latency;
+    uint8_t event;
+    uint8_t from;
+    uint8_t to;
+} mode_trace_t;
+
+/**
+ * @brief Table-driven mode state machine fed by an event queue.
+ *
+ * Events are posted from any context (background task, ThingSet,
+ * critical task) and served in order by process(), which must always be
+ * called from the same context. Faults detected in that context are
+ * served at once by dispatch(), without going through the queue: a
+ * writer preempted while posting holds back the events queued after its
+ * own. process() and dispatch() are the only places where the mode
+ * changes. The last MODE_FSM_TRACE_SIZE mode changes are kept in a
+ * time-stamped trace.
+ */
+class ModeStateMachine
+{
+public:
+    /**
+     * @param initial_mode Mode before the first transition.
+     * @param table Transition table, must outlive the state machine.
+     * @param table_size Number of rows in the table.
+     */
+    ModeStateMachine(uint8_t initial_mode, const mode_transition_t *table,
+                     uint8_t table_size);
+
+    /**
+     * @brief Queue an event, served at the next process() call.
+     *
+     * @return false if the queue is full, the event is then dropped.
+     */
+    bool post(uint8_t event);
+
+    /**
+     * @brief Serve queued events, then the tick event.
+     */
+    void process();
+
+    /**
+     * @brief Serve an event now, whatever the queued events. Must be
+     * called from the context calling process().
+     */
+    void dispatch(uint8_t event);
+
+    /**
+     * @brief Current mode, can be read from any context.
+     */
+    uint8_t getMode() const;
+
+    /**
+     * @brief Number of process() calls so far.
+     */
+    uint32_t getTick() const;
+
+    /**
+     * @brief Number of events dropped because the queue was full.
+     */
+    uint32_t getDroppedEvents() const;
+
+    /**
+     * @brief Number of mode changes recorded since startup. Only the
+     * last MODE_FSM_TRACE_SIZE ones are kept.
+     */
+    uint32_t getTraceCount() const;
+
+    /**
+     * @brief Get a mode change record.
+     *
+     * @param index Index of the change since startup.
+     * @param record Filled with the mode change.
+     * @return false if the change is not kept anymore (or not yet
+     * recorded), record is then invalid.
+     */
+    bool getTrace(uint32_t index, mode_trace_t &record) const;
+
+protected:
+    typedef struct {
+        uint8_t event;
+        uint32_t tick;
+    } posted_event_t;
+
+    EventQueue<posted_event_t, MODE_FSM_QUEUE_SIZE> queue;
+
+private:
+    void serve(uint8_t event, uint32_t posted_tick);
+
+    const mode_transition_t *table;
+    uint8_t table_size;
+
+    std::atomic<uint8_t> mode;
+    std::atomic<uint32_t> tick{0};
+    std::atomic<uint32_t> dropped{0};
+
+    mode_trace_t trace[MODE_FSM_TRACE_SIZE] = {};
+    std::atomic<uint32_t> trace_count{0};
+};
+
+#endif // MODE_FSM_H
@@ -0,0 +1,74 @@
+#ifndef TELEMETRY_BUFFER_H
+#define TELEMETRY_BUFFER_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * @brief Lock-free triple buffer between one writer and one reader.
+ *
+ * The writer (critical task) fills the back buffer then publishes it by
+ * exchanging it with the middle buffer. The reader (background task)
+ * takes the middle buffer when a new one was published. Neither side
+ * waits for the other, and the reader always sees a complete snapshot.
+ *
+ * publish() must only be called by the writer, update() and read() only
+ * by the reader.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+    /**
+     * @brief Buffer to fill before calling publish(). It does not hold
+     * the previous snapshot: all fields must be written.
+     */
+    T &write()
+    {
+        return buffers[back];
+    }
+
+    /**
+     * @brief Make the back buffer the latest snapshot.
+     */
+    void publish()
+    {
+        uint8_t previous = middle.exchange(back | FRESH,
+                                           std::memory_order_acq_rel);
+        back = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Take the latest published snapshot, if any.
+     *
+     * @return true if read() now returns a new snapshot.
+     */
+    bool update()
+    {
+        if ((middle.load(std::memory_order_acquire) & FRESH) == 0) {
+            return false;
+        }
+        uint8_t previous = middle.exchange(front, std::memory_order_acq_rel);
+        front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Snapshot taken by the last successful update().
+     */
+    const T &read() const
+    {
+        return buffers[front];
+    }
+
+private:
+    static const uint8_t INDEX_MASK = 0x03;
+    static const uint8_t FRESH = 0x04;
+
+    T buffers[3] = {};
+    uint8_t back = 0;
+    std::atomic<uint8_t> middle{1};
+    uint8_t front = 2;
+};
+
+#endif // TELEMETRY_BUFFER_H
@@ -1,6 +1,7 @@
 /* ThingSet callbacks aligned with the command interface. */
 
 #include <thingset.h>
+#include <thingset/sdk.h>
 
 #include "user_data_api.h"
 
@@ -10,3 +11,29 @@ void conf_command_cb(enum thingset_callback_reason reason)
         app_apply_command();
     }
 }
+
+void conf_profiling_cb(enum thingset_callback_reason reason)
+{
+    if (reason == THINGSET_CALLBACK_POST_WRITE) {
+        app_apply_profiling_command();
+    }
+}
+
+void conf_fault_cb(enum thingset_callback_reason reason)
+{
+    if (reason == THINGSET_CALLBACK_POST_WRITE) {
+        app_apply_fault_command();
+    }
+}
+
+/* The context lock of the SDK is held while ThingSet processes a request
+ * or exports a report */
+void app_lock_user_data(void)
+{
+    k_sem_take(&ts.lock, K_FOREVER);
+}
+
+void app_unlock_user_data(void)
+{
+    k_sem_give(&ts.lock);
+}
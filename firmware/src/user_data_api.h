@@ -5,6 +5,7 @@
 #include <stdbool.h>
 
 #include "ShieldAPI.h"
+#include "fault_recorder.h"
 
 typedef struct {
     float32_t v_low;
@@ -33,6 +34,7 @@ typedef struct {
     float32_t vdq_out_q;
     float32_t idq_d;
     float32_t idq_q;
+    float32_t vgrid_ref;
 } inverter_debug_t;
 
 typedef struct {
@@ -42,6 +44,13 @@ typedef struct {
     uint16_t dt_fall_ns;
 } boost_debug_t;
 
+// Snapshot published by the critical task, see telemetry_buffer.h
+typedef struct {
+    measurements_t meas;
+    inverter_debug_t inv_dbg;
+    boost_debug_t boost_dbg;
+} telemetry_t;
+
 typedef struct {
     uint8_t mode_request;
     bool inverter_on;
@@ -49,6 +58,7 @@ typedef struct {
     float32_t id_ref;
     bool scope_dump;
     bool scope_trigger;
+    uint32_t telemetry_decimation;
 } command_t;
 
 typedef struct {
@@ -63,12 +73,65 @@ typedef struct {
     float32_t vdq_ref_q;
 } live_status_t;
 
+#define TIMING_HISTOGRAM_BINS 16
+
+typedef struct {
+    float32_t min_period_us;
+    float32_t max_period_us;
+    float32_t latest_period_us;
+    uint32_t periods_count;
+    uint32_t histogram[TIMING_HISTOGRAM_BINS];
+    // critical task deadline monitor
+    uint32_t overruns;
+    uint32_t missed_ticks;
+    float32_t max_jitter_us;
+    float32_t max_execution_us;
+    bool overrun_trip;
+} timing_status_t;
+
+#define PROFILING_SECTIONS_MAX 8
+#define PROFILING_HISTOGRAM_BINS 16
+#define PROFILING_NAMES_SIZE 96
+
+typedef struct {
+    char section_names[PROFILING_NAMES_SIZE];
+    float32_t min_us[PROFILING_SECTIONS_MAX];
+    float32_t max_us[PROFILING_SECTIONS_MAX];
+    float32_t mean_us[PROFILING_SECTIONS_MAX];
+    uint32_t count[PROFILING_SECTIONS_MAX];
+    /* PROFILING_HISTOGRAM_BINS bins per section, bin i holds
+     * execution times in [2^i, 2^(i+1)) cycles */
+    uint32_t histogram[PROFILING_SECTIONS_MAX * PROFILING_HISTOGRAM_BINS];
+    bool reset;
+} profiling_status_t;
+
+// Last fault record, read from flash at startup then updated on each trip
+typedef struct {
+    bool valid;
+    fault_record_t record;
+    bool clear;
+} fault_status_t;
+
 extern measurements_t user_meas;
 extern inverter_debug_t user_inv_dbg;
 extern boost_debug_t user_boost_dbg;
 extern command_t user_cmd;
 extern live_status_t user_live;
+extern timing_status_t user_timing;
+extern profiling_status_t user_profiling;
+extern fault_status_t user_fault;
 
 void app_apply_command(void);
+void app_apply_profiling_command(void);
+void app_apply_fault_command(void);
+void app_update_telemetry(void);
+
+/**
+ * @brief Lock the objects above against ThingSet: requests and reports
+ * read them under this lock, so that fields updated together are never
+ * seen half updated. Not for the critical task.
+ */
+void app_lock_user_data(void);
+void app_unlock_user_data(void);
 
 #endif // USER_DATA_API_H
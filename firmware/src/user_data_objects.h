@@ -22,12 +22,17 @@ command_t user_cmd = {
     .scope_trigger = false,
 };
 live_status_t user_live = {0};
+timing_status_t user_timing = {0};
+profiling_status_t user_profiling = {0};
+fault_status_t user_fault = {0};
 
 /* =========================================================================
  * Callbacks
  * ========================================================================= */
 
 void conf_command_cb(enum thingset_callback_reason reason);
+void conf_profiling_cb(enum thingset_callback_reason reason);
+void conf_fault_cb(enum thingset_callback_reason reason);
 
 /* =========================================================================
  * ID map
@@ -42,9 +47,13 @@ void conf_command_cb(enum thingset_callback_reason reason);
 
 #define ID_CMD          0x30
 #define ID_LIVE         0x40
+#define ID_TIMING       0x50
+#define ID_PROFILING    0x60
+#define ID_FAULT        0x70
 
 /* =========================================================================
- * Measurements
+ * Measurements (with Debug: latest snapshot published by the critical
+ * task, copied by the background task under the ThingSet context lock)
  * ========================================================================= */
 
 THINGSET_ADD_GROUP(TS_ID_ROOT, ID_MEAS, "Measurements", THINGSET_NO_CALLBACK);
@@ -82,6 +91,7 @@ THINGSET_ADD_ITEM_FLOAT(ID_DBG_INV, 0x210A, "rVdqOut_d",      &user_inv_dbg.vdq_
 THINGSET_ADD_ITEM_FLOAT(ID_DBG_INV, 0x210B, "rVdqOut_q",      &user_inv_dbg.vdq_out_q,     5, THINGSET_ANY_R, TS_SUBSET_LIVE);
 THINGSET_ADD_ITEM_FLOAT(ID_DBG_INV, 0x210C, "rIdq_d",         &user_inv_dbg.idq_d,         5, THINGSET_ANY_R, TS_SUBSET_LIVE);
 THINGSET_ADD_ITEM_FLOAT(ID_DBG_INV, 0x210D, "rIdq_q",         &user_inv_dbg.idq_q,         5, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_FLOAT(ID_DBG_INV, 0x210E, "rVgrid_ref",     &user_inv_dbg.vgrid_ref,     5, THINGSET_ANY_R, 0);
 
 THINGSET_ADD_ITEM_FLOAT(ID_DBG_BOOST, 0x2201, "rDutyLeg1",    &user_boost_dbg.duty_leg1,   5, THINGSET_ANY_R, 0);
 THINGSET_ADD_ITEM_FLOAT(ID_DBG_BOOST, 0x2202, "rDutyLeg2",    &user_boost_dbg.duty_leg2,   5, THINGSET_ANY_R, 0);
@@ -99,6 +109,7 @@ THINGSET_ADD_ITEM_FLOAT(ID_CMD, 0x3003, "wVdRef",      &user_cmd.vd_ref,       3
 THINGSET_ADD_ITEM_FLOAT(ID_CMD, 0x3004, "wIdRef",      &user_cmd.id_ref,       3, THINGSET_ANY_RW, 0);
 THINGSET_ADD_ITEM_BOOL(ID_CMD,  0x3005, "wDump",       &user_cmd.scope_dump,   THINGSET_ANY_RW, 0);
 THINGSET_ADD_ITEM_BOOL(ID_CMD,  0x3006, "wTrig",       &user_cmd.scope_trigger,THINGSET_ANY_RW, 0);
+THINGSET_ADD_ITEM_UINT32(ID_CMD,0x3007, "wTelemetryDecim", &user_cmd.telemetry_decimation, THINGSET_ANY_RW, 0);
 
 /* =========================================================================
  * Live status (mirrors the previously printed loop values)
@@ -115,4 +126,90 @@ THINGSET_ADD_ITEM_FLOAT(ID_LIVE, 0x4007, "rIdDelta",     &user_live.idq_ref_delt
 THINGSET_ADD_ITEM_FLOAT(ID_LIVE, 0x4008, "rVdRef",       &user_live.vdq_ref_d,     3, THINGSET_ANY_R, TS_SUBSET_LIVE);
 THINGSET_ADD_ITEM_FLOAT(ID_LIVE, 0x4009, "rVqRef",       &user_live.vdq_ref_q,     3, THINGSET_ANY_R, TS_SUBSET_LIVE);
 
+/* =========================================================================
+ * Timing (period between ADC_1 dispatches, histogram centered on the
+ * control task period, then critical task deadline monitor)
+ * ========================================================================= */
+
+THINGSET_DEFINE_UINT32_ARRAY(user_timing_histogram, 0, user_timing.histogram,
+                             TIMING_HISTOGRAM_BINS);
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, ID_TIMING, "Timing", THINGSET_NO_CALLBACK);
+THINGSET_ADD_ITEM_FLOAT(ID_TIMING, 0x5001, "rMinPeriod_us",    &user_timing.min_period_us,    3, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_FLOAT(ID_TIMING, 0x5002, "rMaxPeriod_us",    &user_timing.max_period_us,    3, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_FLOAT(ID_TIMING, 0x5003, "rLatestPeriod_us", &user_timing.latest_period_us, 3, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_TIMING,0x5004, "rPeriodsCount",    &user_timing.periods_count,       THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_TIMING, 0x5005, "rHistogram",       &user_timing_histogram,           THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_TIMING,0x5006, "rOverruns",        &user_timing.overruns,            THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_TIMING,0x5007, "rMissedTicks",     &user_timing.missed_ticks,        THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_FLOAT(ID_TIMING, 0x5008, "rMaxJitter_us",    &user_timing.max_jitter_us,    3, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_FLOAT(ID_TIMING, 0x5009, "rMaxExecution_us", &user_timing.max_execution_us, 3, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_BOOL(ID_TIMING,  0x500A, "rOverrunTrip",     &user_timing.overrun_trip,        THINGSET_ANY_R, 0);
+
+/* =========================================================================
+ * Profiling (critical task sections execution times, arrays are indexed
+ * by section number, in the order of the comma-separated names)
+ * ========================================================================= */
+
+THINGSET_DEFINE_FLOAT_ARRAY(user_profiling_min, 2, user_profiling.min_us,
+                            PROFILING_SECTIONS_MAX);
+THINGSET_DEFINE_FLOAT_ARRAY(user_profiling_max, 2, user_profiling.max_us,
+                            PROFILING_SECTIONS_MAX);
+THINGSET_DEFINE_FLOAT_ARRAY(user_profiling_mean, 2, user_profiling.mean_us,
+                            PROFILING_SECTIONS_MAX);
+THINGSET_DEFINE_UINT32_ARRAY(user_profiling_count, 0, user_profiling.count,
+                             PROFILING_SECTIONS_MAX);
+THINGSET_DEFINE_UINT32_ARRAY(user_profiling_histogram, 0,
+                             user_profiling.histogram,
+                             PROFILING_SECTIONS_MAX * PROFILING_HISTOGRAM_BINS);
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, ID_PROFILING, "Profiling", &conf_profiling_cb);
+THINGSET_ADD_ITEM_STRING(ID_PROFILING, 0x6001, "rSections",  user_profiling.section_names, PROFILING_NAMES_SIZE, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_PROFILING,  0x6002, "rMin_us",    &user_profiling_min,       THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_PROFILING,  0x6003, "rMax_us",    &user_profiling_max,       THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_PROFILING,  0x6004, "rMean_us",   &user_profiling_mean,      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_PROFILING,  0x6005, "rCount",     &user_profiling_count,     THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_PROFILING,  0x6006, "rHistogram", &user_profiling_histogram, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_BOOL(ID_PROFILING,   0x6007, "wReset",     &user_profiling.reset,     THINGSET_ANY_RW, 0);
+
+/* =========================================================================
+ * Fault record (kept in flash across resets: samples of the last
+ * FAULT_RECORD_SAMPLES critical periods up to the trip, oldest first)
+ * ========================================================================= */
+
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_vdc, 3,
+                            user_fault.record.samples[FAULT_CHANNEL_V_DC_BUS],
+                            FAULT_RECORD_SAMPLES);
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_igrid, 3,
+                            user_fault.record.samples[FAULT_CHANNEL_I_GRID],
+                            FAULT_RECORD_SAMPLES);
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_vgrid, 3,
+                            user_fault.record.samples[FAULT_CHANNEL_V_GRID],
+                            FAULT_RECORD_SAMPLES);
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_duty1, 4,
+                            user_fault.record.samples[FAULT_CHANNEL_DUTY_LEG1],
+                            FAULT_RECORD_SAMPLES);
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_duty2, 4,
+                            user_fault.record.samples[FAULT_CHANNEL_DUTY_LEG2],
+                            FAULT_RECORD_SAMPLES);
+THINGSET_DEFINE_FLOAT_ARRAY(user_fault_duty_boost, 4,
+                            user_fault.record.samples[FAULT_CHANNEL_DUTY_BOOST],
+                            FAULT_RECORD_SAMPLES);
+
+THINGSET_ADD_GROUP(TS_ID_ROOT, ID_FAULT, "FaultRecord", &conf_fault_cb);
+THINGSET_ADD_ITEM_BOOL(ID_FAULT,   0x7001, "rValid",        &user_fault.valid,                      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_FAULT, 0x7002, "rCount",        &user_fault.record.header.count,        THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT8(ID_FAULT,  0x7003, "rCause",        &user_fault.record.header.cause,        THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT8(ID_FAULT,  0x7004, "rMode",         &user_fault.record.header.mode,         THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_FAULT, 0x7005, "rTick",         &user_fault.record.header.tick,         THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT32(ID_FAULT, 0x7006, "rSensorErrors", &user_fault.record.header.sensor_errors, THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_UINT8(ID_FAULT,  0x7007, "rSamples",      &user_fault.record.header.samples,      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x7008, "rVdc_V",        &user_fault_vdc,                        THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x7009, "rIgrid_A",      &user_fault_igrid,                      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x700A, "rVgrid_V",      &user_fault_vgrid,                      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x700B, "rDutyLeg1",     &user_fault_duty1,                      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x700C, "rDutyLeg2",     &user_fault_duty2,                      THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_ARRAY(ID_FAULT,  0x700D, "rDutyBoost",    &user_fault_duty_boost,                 THINGSET_ANY_R, 0);
+THINGSET_ADD_ITEM_BOOL(ID_FAULT,   0x700E, "wClear",        &user_fault.clear,                      THINGSET_ANY_RW, 0);
+
 #endif /* USER_DATA_OBJECTS_H */
@@ -50,9 +50,36 @@ static uint32_t     adc_discontinuous_mode[NUMBER_OF_ADCS] = {0};
 static uint32_t     enabled_channels_count[NUMBER_OF_ADCS] = {0};
 static bool         enable_dma[NUMBER_OF_ADCS]             = {0};
 
+static uint16_t adc_oversampling_ratio[NUMBER_OF_ADCS]     = {0};
+static uint8_t  adc_oversampling_shift[NUMBER_OF_ADCS]     = {0};
+static bool     adc_oversampling_triggered[NUMBER_OF_ADCS] = {0};
+
+static bool adc_dual_mode = false;
+static bool adc_dual_mode_started = false;
+
+#define NUMBER_OF_INJECTED_RANKS 4
+
+static adc_ev_src_t adc_injected_trigger_sources[NUMBER_OF_ADCS]  = {0};
+static uint8_t      injected_channels_count[NUMBER_OF_ADCS]       = {0};
+static uint8_t
+		injected_channels[NUMBER_OF_ADCS][NUMBER_OF_INJECTED_RANKS] = {0};
+
 static uint32_t
 		enabled_channels[NUMBER_OF_ADCS][NUMBER_OF_CHANNELS_PER_ADC] = {0};
 
+#define NUMBER_OF_ANALOG_WATCHDOGS 3
+
+static uint8_t
+		analog_watchdog_channels[NUMBER_OF_ADCS][NUMBER_OF_ANALOG_WATCHDOGS] = {0};
+static bool
+		analog_watchdog_window_set[NUMBER_OF_ADCS][NUMBER_OF_ANALOG_WATCHDOGS] = {0};
+static uint16_t
+		analog_watchdog_low[NUMBER_OF_ADCS][NUMBER_OF_ANALOG_WATCHDOGS] = {0};
+static uint16_t
+		analog_watchdog_high[NUMBER_OF_ADCS][NUMBER_OF_ANALOG_WATCHDOGS] = {0};
+
+static bool adc_started = false;
+
 
 /* Public API */
 
@@ -75,6 +102,72 @@ void adc_configure_discontinuous_mode(uint8_t adc_number,
 	adc_discontinuous_mode[adc_number-1] = discontinuous_count;
 }
 
+int8_t adc_configure_oversampling(uint8_t adc_number,
+								  uint16_t ratio,
+								  uint8_t shift,
+								  bool triggered_mode)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return -1;
+
+	uint8_t adc_index = adc_number-1;
+
+	/* Ratio must be a power of 2 up to 256 */
+	if ( (ratio == 0) || (ratio > 256) || ((ratio & (ratio - 1)) != 0) )
+		return -1;
+
+	if (shift > 8)
+		return -1;
+
+	/* Make sure result fits in the 16-bit data register */
+	uint8_t ratio_bits = 0;
+	while ((1 << ratio_bits) < ratio)
+	{
+		ratio_bits++;
+	}
+	if (ratio_bits > shift + 4)
+	{
+		shift = ratio_bits - 4;
+	}
+
+	adc_oversampling_ratio[adc_index]     = (ratio > 1) ? ratio : 0;
+	adc_oversampling_shift[adc_index]     = (ratio > 1) ? shift : 0;
+	adc_oversampling_triggered[adc_index] = triggered_mode;
+
+	return 0;
+}
+
+int8_t adc_get_oversampling_extra_bits(uint8_t adc_number)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return 0;
+
+	uint8_t adc_index = adc_number-1;
+
+	if (adc_oversampling_ratio[adc_index] == 0)
+		return 0;
+
+	int8_t ratio_bits = 0;
+	while ((1 << ratio_bits) < adc_oversampling_ratio[adc_index])
+	{
+		ratio_bits++;
+	}
+
+	return ratio_bits - adc_oversampling_shift[adc_index];
+}
+
+void adc_configure_dual_mode(bool enable)
+{
+	adc_dual_mode = enable;
+}
+
+bool adc_is_dual_mode_active()
+{
+	return (adc_dual_mode == true) &&
+		   (enabled_channels_count[0] > 0) &&
+		   (enabled_channels_count[0] == enabled_channels_count[1]);
+}
+
 void adc_add_channel(uint8_t adc_number, uint8_t channel)
 {
 	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
@@ -123,6 +216,51 @@ uint32_t adc_get_enabled_channels_count(uint8_t adc_number)
 	return enabled_channels_count[adc_index];
 }
 
+void adc_configure_injected_trigger_source(uint8_t adc_number,
+										   adc_ev_src_t trigger_source)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return;
+
+	adc_injected_trigger_sources[adc_number-1] = trigger_source;
+}
+
+int8_t adc_add_injected_channel(uint8_t adc_number, uint8_t channel)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return -1;
+
+	uint8_t adc_index = adc_number-1;
+
+	if (injected_channels_count[adc_index] == NUMBER_OF_INJECTED_RANKS)
+		return -1;
+
+	injected_channels[adc_index][injected_channels_count[adc_index]] = channel;
+	injected_channels_count[adc_index]++;
+
+	return injected_channels_count[adc_index];
+}
+
+uint32_t adc_get_injected_channels_count(uint8_t adc_number)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return 0;
+
+	return injected_channels_count[adc_number-1];
+}
+
+const volatile uint32_t* adc_get_injected_data_register(uint8_t adc_number,
+														uint8_t rank)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return NULL;
+
+	if ( (rank == 0) || (rank > injected_channels_count[adc_number-1]) )
+		return NULL;
+
+	return adc_core_get_injected_data_register(adc_number, rank);
+}
+
 void adc_configure_use_dma(uint8_t adc_number, bool use_dma)
 {
 	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
@@ -131,6 +269,63 @@ void adc_configure_use_dma(uint8_t adc_number, bool use_dma)
 	enable_dma[adc_number-1] = use_dma;
 }
 
+int8_t adc_configure_analog_watchdog(uint8_t adc_number,
+									 uint8_t watchdog,
+									 uint8_t channel)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return -1;
+
+	if ( (watchdog == 0) || (watchdog > NUMBER_OF_ANALOG_WATCHDOGS) )
+		return -1;
+
+	analog_watchdog_channels[adc_number-1][watchdog-1] = channel;
+
+	return 0;
+}
+
+void adc_set_analog_watchdog_thresholds(uint8_t adc_number,
+										uint8_t watchdog,
+										uint16_t low,
+										uint16_t high)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return;
+
+	if ( (watchdog == 0) || (watchdog > NUMBER_OF_ANALOG_WATCHDOGS) )
+		return;
+
+	uint8_t adc_index = adc_number-1;
+	uint8_t watchdog_index = watchdog-1;
+
+	analog_watchdog_window_set[adc_index][watchdog_index] = true;
+	analog_watchdog_low[adc_index][watchdog_index]        = low;
+	analog_watchdog_high[adc_index][watchdog_index]       = high;
+
+	/* Registers are not clocked before the ADCs are started */
+	if (adc_started == true)
+	{
+		adc_core_set_analog_watchdog_thresholds(adc_number, watchdog,
+												low, high);
+	}
+}
+
+uint8_t adc_get_analog_watchdog_flags(uint8_t adc_number)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return 0;
+
+	return adc_core_get_analog_watchdog_flags(adc_number);
+}
+
+void adc_clear_analog_watchdog_flags(uint8_t adc_number, uint8_t flags)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return;
+
+	adc_core_clear_analog_watchdog_flags(adc_number, flags);
+}
+
 void adc_start()
 {
 	/* Initialize ADCs */
@@ -138,12 +333,21 @@ void adc_start()
 	adc_core_init();
 
 	/** Pre-enable configuration
-	 * Nothing here for now.
 	 * If some channels have to be set as differential,
-	 * or ADCs have to be set as dual mode,
 	 * this should be done here.
 	 */
 
+	/* Multimode is reset by adc_stop(): apply it on every start. It can
+	 * only be written while ADC 1 and ADC 2 are disabled. */
+	bool dual_mode = adc_is_dual_mode_active();
+	if (dual_mode == true)
+	{
+		adc_core_disable(1);
+		adc_core_disable(2);
+	}
+	adc_core_configure_dual_mode(dual_mode);
+	adc_dual_mode_started = dual_mode;
+
 	/* Enable ADCs */
 
 	for (int adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
@@ -178,7 +382,15 @@ void adc_start()
 		uint8_t adc_index = adc_num-1;
 		if (enabled_channels_count[adc_index] > 0)
 		{
-			adc_core_configure_dma_mode(adc_num, enable_dma[adc_index]);
+			/* In dual mode, DMA requests are issued by the common part */
+			if ( (dual_mode == true) && (adc_num <= 2) )
+			{
+				adc_core_configure_dma_mode(adc_num, false);
+			}
+			else
+			{
+				adc_core_configure_dma_mode(adc_num, enable_dma[adc_index]);
+			}
 		}
 	}
 
@@ -193,6 +405,19 @@ void adc_start()
 		}
 	}
 
+	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+		if (enabled_channels_count[adc_index] > 0)
+		{
+			adc_core_configure_oversampling(
+				adc_num,
+				adc_oversampling_ratio[adc_index],
+				adc_oversampling_shift[adc_index],
+				adc_oversampling_triggered[adc_index]);
+		}
+	}
+
 	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
 	{
 		uint8_t adc_index = adc_num-1;
@@ -241,30 +466,149 @@ void adc_start()
 		}
 	}
 
+	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+		if (injected_channels_count[adc_index] > 0)
+		{
+			/* Convert to LL constants */
+			uint32_t trig;
+			switch (adc_injected_trigger_sources[adc_index])
+			{
+			case hrtim_ev2:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG2;
+				break;
+			case hrtim_ev4:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG4;
+				break;
+			case hrtim_ev5:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG5;
+				break;
+			case hrtim_ev6:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG6;
+				break;
+			case hrtim_ev7:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG7;
+				break;
+			case hrtim_ev8:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG8;
+				break;
+			case hrtim_ev9:
+				trig = LL_ADC_INJ_TRIG_EXT_HRTIM_TRG9;
+				break;
+			case software:
+			default:
+				trig = LL_ADC_INJ_TRIG_SOFTWARE;
+				break;
+			}
+
+			adc_core_configure_injected_sequence(
+				adc_num,
+				LL_ADC_INJ_TRIG_EXT_RISING,
+				trig,
+				injected_channels[adc_index],
+				injected_channels_count[adc_index]);
+		}
+	}
+
+	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+		for (uint8_t watchdog = 1 ;
+			 watchdog <= NUMBER_OF_ANALOG_WATCHDOGS ;
+			 watchdog++)
+		{
+			uint8_t watchdog_index = watchdog-1;
+			if (analog_watchdog_window_set[adc_index][watchdog_index] == true)
+			{
+				adc_core_set_analog_watchdog_thresholds(
+					adc_num,
+					watchdog,
+					analog_watchdog_low[adc_index][watchdog_index],
+					analog_watchdog_high[adc_index][watchdog_index]);
+			}
+
+			adc_core_configure_analog_watchdog(
+				adc_num,
+				watchdog,
+				analog_watchdog_channels[adc_index][watchdog_index]);
+		}
+
+		/* Flags raised by a previous configuration are meaningless */
+		adc_core_clear_analog_watchdog_flags(adc_num, 0x7);
+	}
+
+	adc_started = true;
+
 	/* Start ADCs */
 
 	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
 	{
 		uint8_t adc_index = adc_num-1;
-		if ( (enabled_channels_count[adc_index] > 0) &&
-			 (adc_trigger_sources[adc_index] != software) )
+		if ( (dual_mode == true) && (adc_num == 2) )
+		{
+			/* Slave ADC is started by its master */
+			adc_core_set_sequence_length(adc_num,
+										 enabled_channels_count[adc_index]);
+		}
+		else if ( (enabled_channels_count[adc_index] > 0) &&
+				  (adc_trigger_sources[adc_index] != software) )
 		{
 			adc_core_start(adc_num, enabled_channels_count[adc_index]);
 		}
 	}
+
+	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+		if ( (injected_channels_count[adc_index] > 0) &&
+			 (adc_injected_trigger_sources[adc_index] != software) )
+		{
+			adc_core_start_injected(adc_num);
+		}
+	}
 }
 
 void adc_stop()
 {
+	bool dual_mode = adc_dual_mode_started;
+
+	adc_started = false;
+
+	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+		if ( (injected_channels_count[adc_index] > 0) &&
+			 (adc_injected_trigger_sources[adc_index] != software) )
+		{
+			adc_core_stop_injected(adc_num);
+		}
+	}
+
 	for (uint8_t adc_num = 1 ; adc_num <= NUMBER_OF_ADCS ; adc_num++)
 	{
 		uint8_t adc_index = adc_num-1;
+
+		/* Slave ADC is stopped by its master */
+		if ( (dual_mode == true) && (adc_num == 2) )
+			continue;
+
 		if ( (enabled_channels_count[adc_index] > 0) &&
 			 (adc_trigger_sources[adc_index] != software) )
 		{
 			adc_core_stop(adc_num);
 		}
 	}
+
+	/* Multimode can only be written while ADC 1 and ADC 2 are disabled,
+	 * other ADCs stay enabled */
+	if (dual_mode == true)
+	{
+		adc_core_disable(1);
+		adc_core_disable(2);
+		adc_core_configure_dual_mode(false);
+		adc_dual_mode_started = false;
+	}
 }
 
 void adc_trigger_software_conversion(uint8_t adc_number,
@@ -272,3 +616,11 @@ void adc_trigger_software_conversion(uint8_t adc_number,
 {
 	adc_core_start(adc_number, number_of_acquisitions);
 }
+
+void adc_trigger_software_injected_conversion(uint8_t adc_number)
+{
+	if ( (adc_number == 0) || (adc_number > NUMBER_OF_ADCS) )
+		return;
+
+	adc_core_start_injected(adc_number);
+}
@@ -104,6 +104,72 @@ void adc_configure_trigger_source(uint8_t adc_number,
 void adc_configure_discontinuous_mode(uint8_t adc_number,
 									  uint32_t discontinuous_count);
 
+/**
+ * @brief Registers the oversampling configuration for an ADC.
+ *        Each result is then the sum of ratio conversions,
+ *        right-shifted by shift bits.
+ *
+ *        This will only be applied when ADC is started.
+ *        If ADC is already started, it must be stopped
+ *        then started again.
+ *
+ * @param adc_number Number of the ADC to configure.
+ * @param ratio Oversampling ratio: power of 2 from 2 to 256,
+ *        or 1 to disable oversampling (default).
+ * @param shift Right shift applied to the sum (0 to 8). If
+ *        the result does not fit in 16 bits, shift is
+ *        increased accordingly.
+ * @param triggered_mode Set true to require a trigger for each
+ *        conversion of the oversampling sequence, false to run all
+ *        conversions on a single trigger (default).
+ *
+ * @return 0 if configuration is valid, -1 otherwise.
+ */
+int8_t adc_configure_oversampling(uint8_t adc_number,
+								  uint16_t ratio,
+								  uint8_t shift,
+								  bool triggered_mode);
+
+/**
+ * @brief  Returns the number of bits added to the 12-bit
+ *         resolution by the oversampling configuration of an ADC.
+ *
+ * @param  adc_number Number of the ADC to fetch.
+ * @return Number of extra bits, 0 when oversampling is
+ *         disabled. Negative if shift discards resolution.
+ */
+int8_t adc_get_oversampling_extra_bits(uint8_t adc_number);
+
+/**
+ * @brief Registers ADC 1 and ADC 2 dual simultaneous mode.
+ *        In this mode, ADC 1 is the master: its trigger source
+ *        starts the conversion of the same rank on both ADCs,
+ *        and the two results are transferred in a single
+ *        32-bit DMA word on DMA channel 1 (ADC 1 in the lower
+ *        half-word, ADC 2 in the upper half-word).
+ *
+ *        Dual mode is only applied if both ADCs have the same
+ *        number of enabled channels. Discontinuous mode and
+ *        oversampling should be configured identically on both.
+ *
+ *        This will only be applied when ADC is started.
+ *        If ADC is already started, it must be stopped
+ *        then started again.
+ *
+ * @param enable true to enable dual mode, false for
+ *        independent mode (default).
+ */
+void adc_configure_dual_mode(bool enable);
+
+/**
+ * @brief  Indicates whether ADC 1 and ADC 2 will run in
+ *         dual simultaneous mode with the current configuration.
+ *
+ * @return true if dual mode is requested and both ADCs have
+ *         the same non-null number of enabled channels.
+ */
+bool adc_is_dual_mode_active();
+
 /**
  * @brief Adds a channel to the list of channels to be acquired
  *        for an ADC.
@@ -157,13 +223,129 @@ uint32_t adc_get_enabled_channels_count(uint8_t adc_number);
 void adc_configure_use_dma(uint8_t adc_number, bool use_dma);
 
 
+/**
+ * @brief Registers the trigger source for an ADC injected
+ *        sequence.
+ *
+ *        Only HRTIM events 2, 4, 5, 6, 7, 8 and 9 can trigger
+ *        injected conversions, other values select the
+ *        software trigger.
+ *
+ *        This will only be applied when ADC is started.
+ *        If ADC is already started, it must be stopped
+ *        then started again.
+ *
+ * @param adc_number Number of the ADC to configure.
+ * @param trigger_source Source of the trigger.
+ */
+void adc_configure_injected_trigger_source(uint8_t adc_number,
+										   adc_ev_src_t trigger_source);
+
+/**
+ * @brief Adds a channel to the injected sequence of an ADC.
+ *        Injected conversions are not transferred by DMA:
+ *        results are read directly from the data registers.
+ *
+ *        This will only be applied when ADC is started.
+ *        If ADC is already started, it must be stopped
+ *        then started again.
+ *
+ * @param adc_number Number of the ADC to configure.
+ * @param channel Number of the channel to to be acquired.
+ *
+ * @return Injected rank of the channel (1 to 4), or -1 if
+ *         the injected sequence is full.
+ */
+int8_t adc_add_injected_channel(uint8_t adc_number, uint8_t channel);
+
+/**
+ * @brief  Returns the number of channels in the injected
+ *         sequence of an ADC.
+ *
+ * @param  adc_number Number of the ADC to fetch.
+ * @return Number of injected channels, 0 to 4.
+ */
+uint32_t adc_get_injected_channels_count(uint8_t adc_number);
+
+/**
+ * @brief  Returns the address of the data register holding
+ *         the latest conversion of an injected rank.
+ *
+ * @param  adc_number Number of the ADC.
+ * @param  rank Injected rank (1 to 4).
+ * @return Register address, NULL if parameters are invalid.
+ */
+const volatile uint32_t* adc_get_injected_data_register(uint8_t adc_number,
+														uint8_t rank);
+
+/**
+ * @brief Registers the channel monitored by an analog watchdog
+ *        of an ADC, on both regular and injected conversions.
+ *        Each ADC has 3 analog watchdogs: watchdog 1 compares
+ *        12-bit codes, watchdogs 2 and 3 compare the 8 most
+ *        significant bits of the codes.
+ *
+ *        This will only be applied when ADC is started.
+ *        If ADC is already started, it must be stopped
+ *        then started again.
+ *
+ * @param adc_number Number of the ADC to configure.
+ * @param watchdog Number of the analog watchdog (1 to 3).
+ * @param channel Number of the channel to monitor, 0 to
+ *        disable the watchdog (default).
+ *
+ * @return 0 if configuration is valid, -1 otherwise.
+ */
+int8_t adc_configure_analog_watchdog(uint8_t adc_number,
+									 uint8_t watchdog,
+									 uint8_t channel);
+
+/**
+ * @brief Sets the window of an analog watchdog: a conversion
+ *        of the monitored channel below low or above high sets
+ *        the watchdog flag, which stays set until cleared.
+ *
+ *        Applied immediately if ADC is started, else when
+ *        ADC is started.
+ *
+ * @param adc_number Number of the ADC to configure.
+ * @param watchdog Number of the analog watchdog (1 to 3).
+ * @param low Low threshold, a 12-bit code for watchdog 1,
+ *        the 8 most significant bits of a 12-bit code for
+ *        watchdogs 2 and 3.
+ * @param high High threshold, same format as low.
+ */
+void adc_set_analog_watchdog_thresholds(uint8_t adc_number,
+										uint8_t watchdog,
+										uint16_t low,
+										uint16_t high);
+
+/**
+ * @brief  Returns the analog watchdog flags of an ADC.
+ *
+ * @param  adc_number Number of the ADC to fetch.
+ * @return Bit n-1 set if watchdog n flagged a conversion
+ *         since its flag was cleared.
+ */
+uint8_t adc_get_analog_watchdog_flags(uint8_t adc_number);
+
+/**
+ * @brief Clears analog watchdog flags of an ADC.
+ *
+ * @param adc_number Number of the ADC.
+ * @param flags Bit n-1 set to clear the flag of watchdog n.
+ */
+void adc_clear_analog_watchdog_flags(uint8_t adc_number, uint8_t flags);
+
 /**
  * @brief Starts all configured ADCs.
  */
 void adc_start();
 
 /**
- * @brief Stops all configured ADCs.
+ * @brief Stops all configured ADCs. If dual mode was started, ADC 1 and
+ *        ADC 2 are also disabled and reset to independent mode. The next
+ *        adc_start() applies the configuration again, including dual mode.
  */
 void adc_stop();
 
@@ -179,6 +361,18 @@ void adc_stop();
 void adc_trigger_software_conversion(uint8_t adc_number,
 									 uint8_t number_of_acquisitions);
 
+/**
+ * @brief This function triggers a single conversion of the
+ *        injected sequence in the case of a software
+ *        triggered injected sequence.
+ *
+ *        This function must only be called after
+ *        ADC has been started.
+ *
+ * @param  adc_number Number of the ADC.
+ */
+void adc_trigger_software_injected_conversion(uint8_t adc_number);
+
 
 #ifdef __cplusplus
 }
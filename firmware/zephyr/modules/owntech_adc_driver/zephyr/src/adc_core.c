@@ -33,6 +33,9 @@
 /* STM32 LL */
 #include <stm32_ll_bus.h>
 
+/* Current file header */
+#include "adc_core.h"
+
 
 /** @brief Defines the number of ADCs */
 #define NUMBER_OF_ADCS 5
@@ -167,6 +170,31 @@ uint32_t _adc_decimal_nb_to_rank(uint8_t decimal_rank)
 }
 
 
+/**
+ * @brief Convert a decimal analog watchdog number to the corresponding
+ *        LL constant.
+ *
+ * @param watchdog Analog watchdog number (1 to 3).
+ *
+ * @return The corresponding `LL_ADC_AWDx` constant or 0 if invalid.
+ *
+ */
+static uint32_t _adc_decimal_nb_to_analog_watchdog(uint8_t watchdog)
+{
+	switch (watchdog)
+	{
+		case 1:
+			return LL_ADC_AWD1;
+		case 2:
+			return LL_ADC_AWD2;
+		case 3:
+			return LL_ADC_AWD3;
+		default:
+			return 0;
+	}
+}
+
+
 /* Private functions */
 
 /**
@@ -244,23 +272,48 @@ void adc_core_enable(uint8_t adc_num)
 {
 	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
 
+	/* Still enabled by a previous start */
+	if (LL_ADC_IsEnabled(adc) != 0)
+		return;
+
 	/* Enable ADC and wait for it to be ready */
 	LL_ADC_ClearFlag_ADRDY(adc);
 	LL_ADC_Enable(adc);
 	while (LL_ADC_IsActiveFlag_ADRDY(adc) == 0) { /* Wait */ }
 }
 
+void adc_core_disable(uint8_t adc_num)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	if (LL_ADC_IsEnabled(adc) == 0)
+		return;
+
+	/* Wait for the conversions to end, then disable the ADC */
+	while ( (LL_ADC_REG_IsConversionOngoing(adc) != 0) ||
+			(LL_ADC_INJ_IsConversionOngoing(adc) != 0) ) { /* Wait */ }
+	LL_ADC_Disable(adc);
+	while (LL_ADC_IsEnabled(adc) != 0) { /* Wait */ }
+}
+
 void adc_core_start(uint8_t adc_num, uint8_t sequence_length)
 {
 	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
 
 	/* Set regular sequence length */
-	LL_ADC_REG_SetSequencerLength(adc, sequence_length - 1);
+	adc_core_set_sequence_length(adc_num, sequence_length);
 
 	/* Go */
 	LL_ADC_REG_StartConversion(adc);
 }
 
+void adc_core_set_sequence_length(uint8_t adc_num, uint8_t sequence_length)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	LL_ADC_REG_SetSequencerLength(adc, sequence_length - 1);
+}
+
 void adc_core_stop(uint8_t adc_num)
 {
 	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
@@ -336,6 +389,191 @@ void adc_core_configure_discontinuous_mode(uint8_t adc_num,
 }
 
 
+void adc_core_configure_oversampling(uint8_t adc_num,
+									 uint16_t ratio,
+									 uint8_t shift,
+									 bool triggered_mode)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	uint32_t ll_ratio;
+	switch (ratio)
+	{
+		case 2:
+			ll_ratio = LL_ADC_OVS_RATIO_2;
+			break;
+		case 4:
+			ll_ratio = LL_ADC_OVS_RATIO_4;
+			break;
+		case 8:
+			ll_ratio = LL_ADC_OVS_RATIO_8;
+			break;
+		case 16:
+			ll_ratio = LL_ADC_OVS_RATIO_16;
+			break;
+		case 32:
+			ll_ratio = LL_ADC_OVS_RATIO_32;
+			break;
+		case 64:
+			ll_ratio = LL_ADC_OVS_RATIO_64;
+			break;
+		case 128:
+			ll_ratio = LL_ADC_OVS_RATIO_128;
+			break;
+		case 256:
+			ll_ratio = LL_ADC_OVS_RATIO_256;
+			break;
+		default:
+			LL_ADC_SetOverSamplingScope(adc, LL_ADC_OVS_DISABLE);
+			return;
+	}
+
+	uint32_t ll_shift;
+	switch (shift)
+	{
+		case 0:
+			ll_shift = LL_ADC_OVS_SHIFT_NONE;
+			break;
+		case 1:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_1;
+			break;
+		case 2:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_2;
+			break;
+		case 3:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_3;
+			break;
+		case 4:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_4;
+			break;
+		case 5:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_5;
+			break;
+		case 6:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_6;
+			break;
+		case 7:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_7;
+			break;
+		default:
+			ll_shift = LL_ADC_OVS_SHIFT_RIGHT_8;
+	}
+
+	uint32_t ll_discont = (triggered_mode == true)
+						  ? LL_ADC_OVS_REG_DISCONT
+						  : LL_ADC_OVS_REG_CONT;
+
+	LL_ADC_ConfigOverSamplingRatioShift(adc, ll_ratio, ll_shift);
+	LL_ADC_SetOverSamplingDiscont(adc, ll_discont);
+	LL_ADC_SetOverSamplingScope(adc, LL_ADC_OVS_GRP_REGULAR_CONTINUED);
+}
+
+void adc_core_configure_dual_mode(bool enable)
+{
+	if (enable == true)
+	{
+		LL_ADC_SetMultimode(ADC12_COMMON, LL_ADC_MULTI_DUAL_REG_SIMULT);
+		LL_ADC_SetMultiDMATransfer(ADC12_COMMON,
+								   LL_ADC_MULTI_REG_DMA_UNLMT_RES12_10B);
+	}
+	else
+	{
+		LL_ADC_SetMultimode(ADC12_COMMON, LL_ADC_MULTI_INDEPENDENT);
+		LL_ADC_SetMultiDMATransfer(ADC12_COMMON, LL_ADC_MULTI_REG_DMA_EACH_ADC);
+	}
+}
+
+void adc_core_configure_injected_sequence(uint8_t adc_num,
+										  uint32_t external_trigger_edge,
+										  uint32_t trigger_source,
+										  const uint8_t* channels,
+										  uint8_t sequence_length)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	uint32_t ll_sequence_length;
+	switch (sequence_length)
+	{
+		case 2:
+			ll_sequence_length = LL_ADC_INJ_SEQ_SCAN_ENABLE_2RANKS;
+			break;
+		case 3:
+			ll_sequence_length = LL_ADC_INJ_SEQ_SCAN_ENABLE_3RANKS;
+			break;
+		case 4:
+			ll_sequence_length = LL_ADC_INJ_SEQ_SCAN_ENABLE_4RANKS;
+			break;
+		case 1:
+		default:
+			sequence_length    = 1;
+			ll_sequence_length = LL_ADC_INJ_SEQ_SCAN_DISABLE;
+	}
+
+	/* Unused ranks are ignored by the sequencer */
+	uint32_t ll_channels[4];
+	for (uint8_t rank_index = 0 ; rank_index < 4 ; rank_index++)
+	{
+		uint8_t channel = (rank_index < sequence_length) ? channels[rank_index]
+														 : channels[0];
+		ll_channels[rank_index] = __LL_ADC_DECIMAL_NB_TO_CHANNEL(channel);
+	}
+
+	/* JSQR must be written at once */
+	LL_ADC_INJ_ConfigQueueContext(adc,
+								  trigger_source,
+								  external_trigger_edge,
+								  ll_sequence_length,
+								  ll_channels[0],
+								  ll_channels[1],
+								  ll_channels[2],
+								  ll_channels[3]);
+
+	/* Same sampling time as regular channels */
+	for (uint8_t rank_index = 0 ; rank_index < sequence_length ; rank_index++)
+	{
+		LL_ADC_SetChannelSamplingTime(adc,
+									  ll_channels[rank_index],
+									  LL_ADC_SAMPLINGTIME_12CYCLES_5);
+	}
+}
+
+void adc_core_start_injected(uint8_t adc_num)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	LL_ADC_INJ_StartConversion(adc);
+}
+
+void adc_core_stop_injected(uint8_t adc_num)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	LL_ADC_INJ_StopConversion(adc);
+}
+
+const volatile uint32_t* adc_core_get_injected_data_register(uint8_t adc_num,
+															 uint8_t rank)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	if (adc == NULL)
+		return NULL;
+
+	switch (rank)
+	{
+		case 1:
+			return &adc->JDR1;
+		case 2:
+			return &adc->JDR2;
+		case 3:
+			return &adc->JDR3;
+		case 4:
+			return &adc->JDR4;
+		default:
+			return NULL;
+	}
+}
+
 /*
   ADC differential channel set-up:
   Applies differential mode to specified channel.
@@ -413,6 +651,69 @@ void adc_core_configure_channel(uint8_t adc_num, uint8_t channel, uint8_t rank)
 								  LL_ADC_SAMPLINGTIME_12CYCLES_5);
 }
 
+void adc_core_configure_analog_watchdog(uint8_t adc_num,
+										uint8_t watchdog,
+										uint8_t channel)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+	uint32_t ll_watchdog = _adc_decimal_nb_to_analog_watchdog(watchdog);
+
+	if ( (adc == NULL) || (ll_watchdog == 0) )
+		return;
+
+	uint32_t ll_monitored = LL_ADC_AWD_DISABLE;
+	if (channel != 0)
+	{
+		ll_monitored = __LL_ADC_ANALOGWD_CHANNEL_GROUP(
+			__LL_ADC_DECIMAL_NB_TO_CHANNEL(channel),
+			LL_ADC_GROUP_REGULAR_INJECTED);
+	}
+
+	LL_ADC_SetAnalogWDMonitChannels(adc, ll_watchdog, ll_monitored);
+}
+
+void adc_core_set_analog_watchdog_thresholds(uint8_t adc_num,
+											 uint8_t watchdog,
+											 uint16_t low,
+											 uint16_t high)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+	uint32_t ll_watchdog = _adc_decimal_nb_to_analog_watchdog(watchdog);
+
+	if ( (adc == NULL) || (ll_watchdog == 0) )
+		return;
+
+	LL_ADC_ConfigAnalogWDThresholds(adc, ll_watchdog, high, low);
+}
+
+uint8_t adc_core_get_analog_watchdog_flags(uint8_t adc_num)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	if (adc == NULL)
+		return 0;
+
+	/* Single read of the status register */
+	uint32_t isr = adc->ISR;
+
+	return ( ((isr & ADC_ISR_AWD1) != 0) ? 0x1 : 0 ) |
+		   ( ((isr & ADC_ISR_AWD2) != 0) ? 0x2 : 0 ) |
+		   ( ((isr & ADC_ISR_AWD3) != 0) ? 0x4 : 0 );
+}
+
+void adc_core_clear_analog_watchdog_flags(uint8_t adc_num, uint8_t flags)
+{
+	ADC_TypeDef* adc = _get_adc_by_number(adc_num);
+
+	if (adc == NULL)
+		return;
+
+	/* Flags are cleared by writing 1, other flags are not affected */
+	adc->ISR = ( ((flags & 0x1) != 0) ? ADC_ISR_AWD1 : 0 ) |
+			   ( ((flags & 0x2) != 0) ? ADC_ISR_AWD2 : 0 ) |
+			   ( ((flags & 0x4) != 0) ? ADC_ISR_AWD3 : 0 );
+}
+
 void adc_core_init()
 {
 	static bool initialized = false;
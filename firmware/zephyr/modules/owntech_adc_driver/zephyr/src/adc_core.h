@@ -55,6 +55,16 @@ void adc_core_init();
  */
 void adc_core_enable(uint8_t adc_num);
 
+/**
+ * @brief ADC disable, if enabled. Conversions must have been stopped.
+ *
+ * @note Refer to Reference Manual (RM) section 21.4.9 for details on the
+ *       ADC core disable procedure.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to disable
+ */
+void adc_core_disable(uint8_t adc_num);
+
 /**
  * @brief ADC start.
  * 
@@ -67,6 +77,17 @@ void adc_core_enable(uint8_t adc_num);
  */
 void adc_core_start(uint8_t adc_num, uint8_t sequence_length);
 
+/**
+ * @brief Set the regular sequence length of an ADC without
+ *        starting it. Used for the slave ADC in dual mode,
+ *        which is started along with its master.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to configure.
+ * @param sequence_length Length of the sequence configured
+ *        on that ADC.
+ */
+void adc_core_set_sequence_length(uint8_t adc_num, uint8_t sequence_length);
+
 /**
  * @brief ADC stop.
  *
@@ -112,6 +133,35 @@ void adc_core_configure_trigger_source(uint8_t adc_num,
 void adc_core_configure_discontinuous_mode(uint8_t adc_num,
                                            uint32_t discontinuous_count);
 
+/**
+ * @brief Configures the oversampler of an ADC regular group.
+ * @note Refer to Reference Manual (RM) section 21.4.30 for details on
+ *       the ADC oversampler.
+ * @param adc_num Number of the ADC (`1` to `5`) to configure.
+ * @param ratio Oversampling ratio: power of 2 from 2 to 256.
+ *        Any other value disables oversampling (default).
+ * @param shift Right shift applied to the accumulated result (`0` to `8`).
+ * @param triggered_mode Set true to require a trigger for each
+ *        conversion of the oversampling sequence, false to run all
+ *        conversions on a single trigger (default).
+ */
+void adc_core_configure_oversampling(uint8_t adc_num,
+                                     uint16_t ratio,
+                                     uint8_t shift,
+                                     bool triggered_mode);
+
+/**
+ * @brief Configures ADC 1 and ADC 2 in dual regular simultaneous
+ *        mode, with ADC 1 as master. Both results are packed in
+ *        the common data register, ADC 1 in the lower half-word,
+ *        and transferred by the master DMA request as 32-bit words.
+ * @note Refer to Reference Manual (RM) section 21.4.31 for details on
+ *       dual ADC modes. Must be called while ADCs are disabled.
+ * @param enable true to enable dual mode, false for
+ *        independent mode (default).
+ */
+void adc_core_configure_dual_mode(bool enable);
+
 /**
  * @brief ADC differential channel set-up:
  * 
@@ -130,6 +180,56 @@ void adc_core_set_channel_differential(uint8_t adc_num,
                                        uint8_t channel,
                                        bool enable_differential);
 
+/**
+ * @brief Configures the injected sequence of an ADC.
+ *
+ *        Injected conversions have priority over regular conversions,
+ *        and their results are held in the JDRx registers until the
+ *        next injected sequence, without DMA.
+ *
+ * @note Refer to Reference Manual (RM) section 21.4.21 for details on
+ *       injected channels management.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to configure.
+ * @param external_trigger_edge Trigger edge as LL constant.
+ * @param trigger_source Injected trigger source as LL constant.
+ * @param channels Array of channel numbers, in rank order.
+ * @param sequence_length Number of channels in the sequence (`1` to `4`).
+ */
+void adc_core_configure_injected_sequence(uint8_t adc_num,
+                                          uint32_t external_trigger_edge,
+                                          uint32_t trigger_source,
+                                          const uint8_t* channels,
+                                          uint8_t sequence_length);
+
+/**
+ * @brief ADC injected conversions start.
+ *        With an external trigger, conversions will start on
+ *        each trigger event.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to start.
+ */
+void adc_core_start_injected(uint8_t adc_num);
+
+/**
+ * @brief ADC injected conversions stop.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to stop.
+ */
+void adc_core_stop_injected(uint8_t adc_num);
+
+/**
+ * @brief Get the address of an injected data register.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`).
+ * @param rank Injected rank (`1` to `4`).
+ *
+ * @return Address of the JDRx register holding the rank result,
+ *         NULL if parameters are invalid.
+ */
+const volatile uint32_t* adc_core_get_injected_data_register(uint8_t adc_num,
+                                                             uint8_t rank);
+
 /**
  * @brief Configures an ADC channel acquisition.
  * 
@@ -144,6 +244,56 @@ void adc_core_set_channel_differential(uint8_t adc_num,
  */
 void adc_core_configure_channel(uint8_t adc_num, uint8_t channel, uint8_t rank);
 
+/**
+ * @brief Selects the channel monitored by an analog watchdog,
+ *        on both regular and injected groups.
+ *
+ * @note Refer to Reference Manual (RM) section 21.4.28 for details on
+ *       the analog window watchdogs. Must be called while no
+ *       conversion is ongoing.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to configure.
+ * @param watchdog Number of the analog watchdog (`1` to `3`).
+ * @param channel Number of the channel to monitor,
+ *        0 to disable the watchdog (default).
+ */
+void adc_core_configure_analog_watchdog(uint8_t adc_num,
+                                        uint8_t watchdog,
+                                        uint8_t channel);
+
+/**
+ * @brief Sets the window of an analog watchdog. A conversion of
+ *        the monitored channel below low or above high sets the
+ *        watchdog flag. Can be called while conversions are ongoing.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`) to configure.
+ * @param watchdog Number of the analog watchdog (`1` to `3`).
+ * @param low Low threshold, a 12-bit code for watchdog 1, the 8
+ *        most significant bits of a 12-bit code for watchdogs 2 and 3.
+ * @param high High threshold, same format as low.
+ */
+void adc_core_set_analog_watchdog_thresholds(uint8_t adc_num,
+                                             uint8_t watchdog,
+                                             uint16_t low,
+                                             uint16_t high);
+
+/**
+ * @brief Get the analog watchdog flags of an ADC.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`).
+ *
+ * @return Bit n-1 set if watchdog n flagged a conversion.
+ */
+uint8_t adc_core_get_analog_watchdog_flags(uint8_t adc_num);
+
+/**
+ * @brief Clear analog watchdog flags of an ADC.
+ *
+ * @param adc_num Number of the ADC (`1` to `5`).
+ * @param flags Bit n-1 set to clear the flag of watchdog n.
+ */
+void adc_core_clear_analog_watchdog_flags(uint8_t adc_num, uint8_t flags);
+
 
 #ifdef __cplusplus
 }
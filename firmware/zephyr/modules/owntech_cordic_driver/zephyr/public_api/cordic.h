@@ -0,0 +1,154 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  CORDIC trigonometry: sine, cosine and atan2 computed by the
+ *         STM32 CORDIC coprocessor, in q1.31 fixed point.
+ *
+ *         Angles are fractions of pi: 0x80000000 (-1.0) is -pi and
+ *         0x7FFFFFFF is just below pi, so that integer wrap-around
+ *         matches angle wrap-around.
+ *
+ *         Target builds use the coprocessor (cordic_driver.c). Host builds
+ *         can use a software CORDIC running the same number of iterations
+ *         in the same format (cordic_soft.c), so that errors of the same
+ *         order can be studied without the board. It does not reproduce
+ *         the coprocessor results bit for bit.
+ *
+ *         The coprocessor is shared and calls are not reentrant: only call
+ *         these functions from one context, e.g. the critical task.
+ */
+
+#ifndef CORDIC_H_
+#define CORDIC_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Constants
+ */
+
+/* Cycles of 4 iterations per computation */
+#ifdef CONFIG_OWNTECH_CORDIC_PRECISION
+#define CORDIC_PRECISION CONFIG_OWNTECH_CORDIC_PRECISION
+#else
+#define CORDIC_PRECISION 6
+#endif
+
+/* pi in q1.31 angle format is 2^31: radians to angle factor */
+#define CORDIC_RADIANS_TO_Q31 683565275.576432F
+#define CORDIC_Q31_TO_RADIANS 1.46291807926716e-9F
+#define CORDIC_Q31_TO_FLOAT   4.656612873077393e-10F
+
+/**
+ *  Public API
+ */
+
+/**
+ * @brief Enable the CORDIC coprocessor clock.
+ *        Must be called once before any computation.
+ */
+void cordic_init();
+
+/**
+ * @brief Compute sine and cosine of an angle in a single operation.
+ *
+ * @param angle Angle in q1.31 fraction of pi.
+ * @param sin_value Output parameter: sine in q1.31.
+ * @param cos_value Output parameter: cosine in q1.31.
+ */
+void cordic_sincos_q31(int32_t angle, int32_t* sin_value, int32_t* cos_value);
+
+/**
+ * @brief Compute the angle of a vector.
+ *
+ * @param y Vector ordinate in q1.31.
+ * @param x Vector abscissa in q1.31.
+ *        The vector modulus must be below 1, and close to it for
+ *        best precision: small vectors lose bits in the iterations.
+ * @return Angle of the vector in q1.31 fraction of pi,
+ *         0 for a null vector.
+ */
+int32_t cordic_atan2_q31(int32_t y, int32_t x);
+
+/**
+ *  Floating point helpers
+ */
+
+/**
+ * @brief Convert an angle in radians to q1.31 fraction of pi.
+ *        Any angle is brought back to [-pi, pi).
+ */
+static inline int32_t cordic_radians_to_q31(float angle)
+{
+	return (int32_t)(uint32_t)(int64_t)(angle * CORDIC_RADIANS_TO_Q31);
+}
+
+/**
+ * @brief Compute sine and cosine of an angle in radians.
+ */
+static inline void cordic_sincos(float angle, float* sin_value, float* cos_value)
+{
+	int32_t sin_q31;
+	int32_t cos_q31;
+
+	cordic_sincos_q31(cordic_radians_to_q31(angle), &sin_q31, &cos_q31);
+
+	*sin_value = (float)sin_q31 * CORDIC_Q31_TO_FLOAT;
+	*cos_value = (float)cos_q31 * CORDIC_Q31_TO_FLOAT;
+}
+
+/**
+ * @brief Compute the angle of a vector in radians, in [-pi, pi].
+ *        Coordinates are scaled so that the modulus is below 1.
+ */
+static inline float cordic_atan2(float y, float x)
+{
+	float abs_y = (y < 0) ? -y : y;
+	float abs_x = (x < 0) ? -x : x;
+	float max   = (abs_y > abs_x) ? abs_y : abs_x;
+
+	if (max == 0)
+		return 0;
+
+	/* Largest coordinate becomes 0.5, and modulus at most 0.71 */
+	float scale = 1073741824.0F / max;
+
+	int32_t angle = cordic_atan2_q31((int32_t)(y * scale),
+									 (int32_t)(x * scale));
+
+	return (float)angle * CORDIC_Q31_TO_RADIANS;
+}
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CORDIC_H_ */
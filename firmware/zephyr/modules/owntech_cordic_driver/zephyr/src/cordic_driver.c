@@ -0,0 +1,89 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+/* STM32 LL */
+#include <stm32_ll_bus.h>
+
+/* Current file header */
+#include "cordic.h"
+
+
+/**
+ *  Local constants
+ */
+
+/* CSR function values */
+#define CORDIC_FUNCTION_COSINE 0U
+#define CORDIC_FUNCTION_PHASE  2U
+
+/**
+ * Cosine: angle and modulus in, cosine and sine out.
+ * Modulus is always written, as the coprocessor would otherwise
+ * use the last second argument written, e.g. by a phase operation.
+ */
+static const uint32_t csr_cosine = (CORDIC_FUNCTION_COSINE << CORDIC_CSR_FUNC_Pos) |
+								   (CORDIC_PRECISION << CORDIC_CSR_PRECISION_Pos) |
+								   CORDIC_CSR_NARGS |
+								   CORDIC_CSR_NRES;
+
+/* Phase: x and y in, angle out */
+static const uint32_t csr_phase = (CORDIC_FUNCTION_PHASE << CORDIC_CSR_FUNC_Pos) |
+								  (CORDIC_PRECISION << CORDIC_CSR_PRECISION_Pos) |
+								  CORDIC_CSR_NARGS;
+
+static const uint32_t modulus_one = 0x7FFFFFFF;
+
+
+/**
+ *  Public API
+ */
+
+void cordic_init()
+{
+	LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_CORDIC);
+}
+
+void cordic_sincos_q31(int32_t angle, int32_t* sin_value, int32_t* cos_value)
+{
+	CORDIC->CSR   = csr_cosine;
+	CORDIC->WDATA = (uint32_t)angle;
+	CORDIC->WDATA = modulus_one;
+
+	/* Reading results stalls the bus until computation is done */
+	*cos_value = (int32_t)CORDIC->RDATA;
+	*sin_value = (int32_t)CORDIC->RDATA;
+}
+
+int32_t cordic_atan2_q31(int32_t y, int32_t x)
+{
+	CORDIC->CSR   = csr_phase;
+	CORDIC->WDATA = (uint32_t)x;
+	CORDIC->WDATA = (uint32_t)y;
+
+	return (int32_t)CORDIC->RDATA;
+}
@@ -0,0 +1,160 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  Software CORDIC for host builds: a textbook radix-2 CORDIC
+ *         running as many iterations as the coprocessor, in the same
+ *         q1.31 format, with 64-bit intermediates.
+ *
+ *         It is NOT a model of the coprocessor: its internal iterations
+ *         and rounding are not documented, so results differ from the
+ *         board in the last bits. Errors are of the same order only.
+ */
+
+/* Current file header */
+#include "cordic.h"
+
+
+/**
+ *  Local constants
+ */
+
+/* Iterations run on the host, table holds 32 of them */
+#define CORDIC_ITERATIONS ( (CORDIC_PRECISION * 4 < 32) ? \
+							(CORDIC_PRECISION * 4) : 32 )
+
+/* atan(2^-i) in q1.31 fraction of pi */
+static const int32_t atan_table[32] =
+{
+	0x20000000, 0x12E4051E, 0x09FB385B, 0x051111D4,
+	0x028B0D43, 0x0145D7E1, 0x00A2F61E, 0x00517C55,
+	0x0028BE53, 0x00145F2F, 0x000A2F98, 0x000517CC,
+	0x00028BE6, 0x000145F3, 0x0000A2FA, 0x0000517D,
+	0x000028BE, 0x0000145F, 0x00000A30, 0x00000518,
+	0x0000028C, 0x00000146, 0x000000A3, 0x00000051,
+	0x00000029, 0x00000014, 0x0000000A, 0x00000005,
+	0x00000003, 0x00000001, 0x00000001, 0x00000000,
+};
+
+/* Inverse of the CORDIC gain, prod(1/sqrt(1 + 2^-2i)), in q1.31 */
+static const int64_t gain_inverse = 0x4DBA76D4;
+
+static const int64_t quarter_turn = 0x40000000;
+static const int64_t half_turn    = 0x80000000;
+
+/**
+ *  Private functions
+ */
+
+static int32_t _cordic_saturate(int64_t value)
+{
+	if (value > INT32_MAX)
+		return INT32_MAX;
+	if (value < INT32_MIN)
+		return INT32_MIN;
+
+	return (int32_t)value;
+}
+
+/**
+ *  Public API
+ */
+
+void cordic_init()
+{
+}
+
+void cordic_sincos_q31(int32_t angle, int32_t* sin_value, int32_t* cos_value)
+{
+	/* Iterations converge for angles in [-pi/2, pi/2]: rotate others by pi */
+	int64_t z    = angle;
+	int64_t sign = 1;
+	if ( (z > quarter_turn) || (z < -quarter_turn) )
+	{
+		z    = (int32_t)((uint32_t)angle + (uint32_t)half_turn);
+		sign = -1;
+	}
+
+	/* Rotation mode: rotate (1/gain, 0) by the angle */
+	int64_t x = gain_inverse;
+	int64_t y = 0;
+	for (int i = 0 ; i < CORDIC_ITERATIONS ; i++)
+	{
+		int64_t dx = y >> i;
+		int64_t dy = x >> i;
+		if (z >= 0)
+		{
+			x -= dx;
+			y += dy;
+			z -= atan_table[i];
+		}
+		else
+		{
+			x += dx;
+			y -= dy;
+			z += atan_table[i];
+		}
+	}
+
+	*cos_value = _cordic_saturate(sign * x);
+	*sin_value = _cordic_saturate(sign * y);
+}
+
+int32_t cordic_atan2_q31(int32_t y, int32_t x)
+{
+	if ( (x == 0) && (y == 0) )
+		return 0;
+
+	int64_t vx = x;
+	int64_t vy = y;
+	int64_t z  = 0;
+
+	/* Bring the vector in the right half-plane */
+	if (x < 0)
+	{
+		vx = -vx;
+		vy = -vy;
+		z  = (y >= 0) ? half_turn : -half_turn;
+	}
+
+	/* Vectoring mode: rotate the vector down to the x axis */
+	for (int i = 0 ; i < CORDIC_ITERATIONS ; i++)
+	{
+		int64_t dx = vy >> i;
+		int64_t dy = vx >> i;
+		if (vy > 0)
+		{
+			vx += dx;
+			vy -= dy;
+			z  += atan_table[i];
+		}
+		else
+		{
+			vx -= dx;
+			vy += dy;
+			z  -= atan_table[i];
+		}
+	}
+
+	/* pi and -pi are the same angle */
+	return (int32_t)(uint32_t)z;
+}
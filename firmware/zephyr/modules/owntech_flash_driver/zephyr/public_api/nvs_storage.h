@@ -46,6 +46,8 @@ extern "C" {
  * 
  * - `MEASURE_THRESHOLD` = 0x0300
  * 
+ * - `FAULT_RECORD`     = 0x0400
+ * 
  * 
  * @note Must be on the upper half of the 2-bytes value, hence end with 00
  */
@@ -54,6 +56,7 @@ typedef enum
 	VERSION          = 0x0100,
 	ADC_CALIBRATION  = 0x0200,
 	MEASURE_THRESHOLD = 0x0300,
+	FAULT_RECORD     = 0x0400,
 }nvs_category_t;
 
 /**
@@ -0,0 +1,179 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+
+/* Stdlib */
+#include <math.h>
+
+/* Current file header */
+#include "FmacFilter.h"
+
+
+/**
+ *  Private functions
+ */
+
+static int16_t _to_q15(float32_t value)
+{
+	float32_t scaled = roundf(value * 32768.0F);
+
+	if (scaled > 32767.0F)
+		return 32767;
+	if (scaled < -32768.0F)
+		return -32768;
+
+	return (int16_t)scaled;
+}
+
+/**
+ *  Public API
+ */
+
+int8_t FmacFilter::init(const float32_t* b,
+						uint8_t b_count,
+						const float32_t* a,
+						uint8_t a_count,
+						float32_t full_scale)
+{
+	if ( (b_count == 0) || (b_count > FMAC_FILTER_MAX_FEEDFORWARD) ||
+		 (a_count > FMAC_FILTER_MAX_FEEDBACK) || (full_scale <= 0) )
+		return -1;
+
+	if ( (a_count > 0) && (a == nullptr) )
+		return -1;
+
+	/* Smallest output gain bringing all coefficients below 1 */
+	float32_t largest = 0;
+	for (uint8_t i = 0 ; i < b_count ; i++)
+	{
+		largest = fmaxf(largest, fabsf(b[i]));
+	}
+	for (uint8_t i = 0 ; i < a_count ; i++)
+	{
+		largest = fmaxf(largest, fabsf(a[i]));
+	}
+
+	uint8_t gain_shift = 0;
+	while ( (largest >= 1.0F) && (gain_shift <= FMAC_FILTER_MAX_GAIN_SHIFT) )
+	{
+		largest /= 2;
+		gain_shift++;
+	}
+	if (gain_shift > FMAC_FILTER_MAX_GAIN_SHIFT)
+		return -1;
+
+	float32_t scale = 1.0F / (float32_t)(1 << gain_shift);
+
+	int16_t feedforward[FMAC_FILTER_MAX_FEEDFORWARD];
+	int16_t feedback[FMAC_FILTER_MAX_FEEDBACK];
+	for (uint8_t i = 0 ; i < b_count ; i++)
+	{
+		feedforward[i] = _to_q15(b[i] * scale);
+	}
+	/* FMAC adds feedback terms */
+	for (uint8_t i = 0 ; i < a_count ; i++)
+	{
+		feedback[i] = _to_q15(-a[i] * scale);
+	}
+
+	if (fmac_filter_init(&this->fmac_filter,
+						 feedforward, b_count,
+						 feedback, a_count,
+						 gain_shift) != 0)
+		return -1;
+
+	this->full_scale = full_scale;
+
+	return 0;
+}
+
+int8_t FmacFilter::initLowPassFirstOrder(float32_t Ts,
+										 float32_t tau,
+										 float32_t full_scale)
+{
+	if ( (Ts <= 0) || (tau < 0) )
+		return -1;
+
+	/* y[n] = y[n-1] + k.(x[n] - y[n-1]) */
+	float32_t k = Ts / (tau + Ts);
+	float32_t b[1] = {k};
+	float32_t a[1] = {k - 1.0F};
+
+	return init(b, 1, a, 1, full_scale);
+}
+
+int8_t FmacFilter::initNotch(float32_t Ts,
+							 float32_t f0,
+							 float32_t quality,
+							 float32_t full_scale)
+{
+	if ( (Ts <= 0) || (f0 <= 0) || (f0 >= 0.5F / Ts) || (quality <= 0) )
+		return -1;
+
+	/* Bilinear transform design (RBJ cookbook) */
+	float32_t w0    = 2.0F * PI * f0 * Ts;
+	float32_t alpha = sinf(w0) / (2.0F * quality);
+	float32_t a0    = 1.0F + alpha;
+	float32_t c     = -2.0F * cosf(w0) / a0;
+
+	float32_t b[3] = {1.0F / a0, c, 1.0F / a0};
+	float32_t a[2] = {c, (1.0F - alpha) / a0};
+
+	return init(b, 3, a, 2, full_scale);
+}
+
+void FmacFilter::reset()
+{
+	fmac_filter_reset(&this->fmac_filter);
+}
+
+float32_t FmacFilter::calculateWithReturn(float32_t value)
+{
+	int16_t sample = _to_q15(value / this->full_scale);
+
+	fmac_filter_run(&this->fmac_filter, &sample, &sample, 1);
+
+	if (this->fmac_filter.feedforward_count == 0)
+		return 0;
+
+	return (float32_t)sample * (this->full_scale / 32768.0F);
+}
+
+void FmacFilter::filter(const q15_t* input, q15_t* output, size_t count)
+{
+	fmac_filter_run(&this->fmac_filter, input, output, count);
+}
+
+void FmacFilter::filterRawValues(const uint16_t* raw_values,
+								 q15_t* output,
+								 size_t count)
+{
+	/* Convert in the output buffer, then filter it in place */
+	for (size_t i = 0 ; i < count ; i++)
+	{
+		output[i] = (q15_t)(raw_values[i] << 3);
+	}
+
+	fmac_filter_run(&this->fmac_filter, output, output, count);
+}
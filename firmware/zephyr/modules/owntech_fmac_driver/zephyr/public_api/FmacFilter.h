@@ -0,0 +1,145 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  Filter running on the FMAC accelerator, designed from floating
+ *         point transfer functions, with the same calculateWithReturn()
+ *         interface as the control library filters.
+ *
+ *         Values are converted to q1.15 relative to a full scale value.
+ *         Note that q1.15 coefficients are only 2^-15 accurate: filters
+ *         with poles very close to 1 (time constants of thousands of
+ *         samples) are better run in floating point.
+ */
+
+#ifndef FMACFILTER_H_
+#define FMACFILTER_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stddef.h>
+
+/* ARM lib */
+#include <arm_math.h>
+
+/* Current module header */
+#include "fmac.h"
+
+
+class FmacFilter
+{
+public:
+	/**
+	 * @brief Define the filter from its transfer function:
+	 *
+	 *        H(z) = (b0 + b1.z^-1 + ...) / (1 + a1.z^-1 + ...)
+	 *
+	 *        Coefficients larger than 1 are handled with the FMAC
+	 *        output gain, up to 2^7. The filter history is cleared.
+	 *
+	 * @param b Numerator coefficients b0..bP-1.
+	 * @param b_count Number of numerator coefficients, 1 to 8.
+	 * @param a Denominator coefficients a1..aQ, a0 being 1.
+	 *        May be nullptr if a_count is 0.
+	 * @param a_count Number of denominator coefficients, 0 to 8.
+	 * @param full_scale Value converted to q1.15 full scale:
+	 *        inputs and outputs of calculateWithReturn() are in
+	 *        [-full_scale, full_scale).
+	 * @return 0 if the filter was defined, -1 if a count is out of
+	 *         range or a coefficient is too large.
+	 */
+	int8_t init(const float32_t* b,
+				uint8_t b_count,
+				const float32_t* a,
+				uint8_t a_count,
+				float32_t full_scale);
+
+	/**
+	 * @brief Define a first-order low-pass filter, with the same
+	 *        response as the control library LowPassFirstOrderFilter.
+	 *
+	 * @param Ts Sampling period, in s.
+	 * @param tau Time constant, in s.
+	 * @param full_scale Value converted to q1.15 full scale.
+	 * @return 0 if the filter was defined, -1 otherwise.
+	 */
+	int8_t initLowPassFirstOrder(float32_t Ts,
+								 float32_t tau,
+								 float32_t full_scale);
+
+	/**
+	 * @brief Define a notch biquad filter, e.g. to remove the
+	 *        DC link ripple at twice the grid frequency.
+	 *
+	 * @param Ts Sampling period, in s.
+	 * @param f0 Rejected frequency, in Hz.
+	 * @param quality Quality factor: higher is narrower.
+	 * @param full_scale Value converted to q1.15 full scale.
+	 * @return 0 if the filter was defined, -1 otherwise.
+	 */
+	int8_t initNotch(float32_t Ts,
+					 float32_t f0,
+					 float32_t quality,
+					 float32_t full_scale);
+
+	/**
+	 * @brief Clear the filter history, as if all previous inputs were 0.
+	 */
+	void reset();
+
+	/**
+	 * @brief Filter a single value.
+	 *
+	 * @param value Input value, saturated to the full scale.
+	 * @return Filtered value, 0 if the filter was not defined.
+	 */
+	float32_t calculateWithReturn(float32_t value);
+
+	/**
+	 * @brief Filter a batch of q1.15 samples.
+	 *
+	 * @param input Input samples, oldest first.
+	 * @param output Output samples. May be the same buffer as input.
+	 * @param count Number of samples.
+	 */
+	void filter(const q15_t* input, q15_t* output, size_t count);
+
+	/**
+	 * @brief Filter a batch of 12-bit raw ADC values, as obtained
+	 *        from the DMA buffers with getChannelRawValues().
+	 *        Values are converted to q1.15 by a left shift of 3 bits,
+	 *        4096 being full scale.
+	 *
+	 * @param raw_values Raw ADC values, oldest first.
+	 * @param output Output samples in q1.15.
+	 * @param count Number of samples.
+	 */
+	void filterRawValues(const uint16_t* raw_values, q15_t* output, size_t count);
+
+private:
+	fmac_filter_t fmac_filter = {};
+	float32_t     full_scale  = 1;
+};
+
+
+#endif /* FMACFILTER_H_ */
@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  FMAC filters: FIR and IIR filters computed by the STM32 FMAC
+ *         accelerator, in q1.15 fixed point.
+ *
+ *         A filter computes, for each input sample x[n]:
+ *
+ *           y[n] = 2^R * (b0.x[n] + ... + bP-1.x[n-P+1]
+ *                         + a1.y[n-1] + ... + aQ.y[n-Q])
+ *
+ *         Note that feedback coefficients are added, as in the FMAC: they
+ *         are the opposite of the usual transfer function denominator.
+ *
+ *         The FMAC holds a single filter. Each filter keeps its history
+ *         in RAM, and the FMAC is loaded with the filter coefficients and
+ *         history before a run, so that several filters can share it.
+ *         Loading costs about P + Q register writes: the FMAC pays off on
+ *         batches of samples, e.g. a DMA buffer.
+ *
+ *         Target builds use the accelerator (fmac_driver.c). Host builds
+ *         can use a software model of the FMAC arithmetic (fmac_model.c),
+ *         so that filters can be designed and checked without the board.
+ *
+ *         The FMAC is shared and runs are not reentrant: only run filters
+ *         from one context, e.g. the critical task.
+ */
+
+#ifndef FMAC_H_
+#define FMAC_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+#include <stddef.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ *  Constants
+ */
+
+/* Maximum number of feedforward (P) and feedback (Q) coefficients */
+#define FMAC_FILTER_MAX_FEEDFORWARD 8
+#define FMAC_FILTER_MAX_FEEDBACK    8
+
+/* FMAC requires at least 2 feedforward coefficients */
+#define FMAC_FILTER_MIN_FEEDFORWARD 2
+
+/* Maximum output gain shift (R) */
+#define FMAC_FILTER_MAX_GAIN_SHIFT 7
+
+/**
+ *  Public types
+ */
+
+typedef struct
+{
+	uint8_t feedforward_count; /* P */
+	uint8_t feedback_count;    /* Q, 0 for a FIR filter */
+	uint8_t gain_shift;        /* R */
+	int16_t feedforward[FMAC_FILTER_MAX_FEEDFORWARD]; /* b0..bP-1 */
+	int16_t feedback[FMAC_FILTER_MAX_FEEDBACK];       /* a1..aQ */
+	/* Latest inputs and outputs, oldest first */
+	int16_t x_history[FMAC_FILTER_MAX_FEEDFORWARD - 1];
+	int16_t y_history[FMAC_FILTER_MAX_FEEDBACK];
+} fmac_filter_t;
+
+/**
+ *  Public API
+ */
+
+/**
+ * @brief Enable the FMAC clock.
+ *        Must be called once before running any filter.
+ */
+void fmac_init();
+
+/**
+ * @brief Initialize a filter with q1.15 coefficients and clear its history.
+ *
+ * @param filter Filter to initialize.
+ * @param feedforward Feedforward coefficients b0..bP-1.
+ * @param feedforward_count Number of feedforward coefficients. Filters
+ *        with a single coefficient are padded with a null b1.
+ * @param feedback Feedback coefficients a1..aQ, added to the output.
+ *        May be NULL if feedback_count is 0.
+ * @param feedback_count Number of feedback coefficients, 0 for a FIR filter.
+ * @param gain_shift Output gain as a power of 2, for coefficients
+ *        larger than 1.
+ * @return 0 if the filter was initialized, -1 if a count or the
+ *         gain is out of range.
+ */
+int8_t fmac_filter_init(fmac_filter_t* filter,
+                        const int16_t* feedforward,
+                        uint8_t feedforward_count,
+                        const int16_t* feedback,
+                        uint8_t feedback_count,
+                        uint8_t gain_shift);
+
+/**
+ * @brief Clear the filter history, as if all previous inputs were 0.
+ */
+void fmac_filter_reset(fmac_filter_t* filter);
+
+/**
+ * @brief Filter a batch of q1.15 samples and update the filter history.
+ *        Outputs saturate to the q1.15 range. Nothing is done if the
+ *        filter was not initialized.
+ *
+ * @param filter Filter to run.
+ * @param input Input samples, oldest first.
+ * @param output Output samples. May be the same buffer as input.
+ * @param count Number of samples.
+ */
+void fmac_filter_run(fmac_filter_t* filter,
+                     const int16_t* input,
+                     int16_t* output,
+                     size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMAC_H_ */
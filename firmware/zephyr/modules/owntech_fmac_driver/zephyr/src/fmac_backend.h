@@ -0,0 +1,54 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  Backend of FMAC filters: the FMAC itself on target, or its
+ *         software model on host.
+ */
+
+#ifndef FMAC_BACKEND_H_
+#define FMAC_BACKEND_H_
+
+
+/* Current module public header */
+#include "fmac.h"
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Filter a batch of samples, starting from the history held in
+ *        the filter. The history is not updated.
+ */
+void fmac_backend_compute(const fmac_filter_t* filter,
+                          const int16_t* input,
+                          int16_t* output,
+                          size_t count);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FMAC_BACKEND_H_ */
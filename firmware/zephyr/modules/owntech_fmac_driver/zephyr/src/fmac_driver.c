@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+/* Zephyr */
+#include <zephyr/kernel.h>
+#include <soc.h>
+
+/* STM32 LL */
+#include <stm32_ll_bus.h>
+
+/* Current module private headers */
+#include "fmac_backend.h"
+
+/* Current file header */
+#include "fmac.h"
+
+
+/**
+ *  Local constants
+ */
+
+/* PARAM function values */
+#define FMAC_FUNCTION_LOAD_X1 1U
+#define FMAC_FUNCTION_LOAD_X2 2U
+#define FMAC_FUNCTION_LOAD_Y  3U
+#define FMAC_FUNCTION_FIR     8U
+#define FMAC_FUNCTION_IIR     9U
+
+/* Room for samples in flight in X1 and Y buffers, on top of the history */
+static const uint32_t buffer_headroom = 4;
+
+/**
+ *  Private functions
+ */
+
+static void _fmac_write(const int16_t* values, uint32_t count)
+{
+	for (uint32_t i = 0 ; i < count ; i++)
+	{
+		FMAC->WDATA = (uint16_t)values[i];
+	}
+}
+
+/**
+ * Load functions take P (+ Q for X2) values,
+ * START is cleared once all of them have been written.
+ */
+static void _fmac_start_load(uint32_t function, uint32_t p, uint32_t q)
+{
+	FMAC->PARAM = (function << FMAC_PARAM_FUNC_Pos) |
+				  (p << FMAC_PARAM_P_Pos) |
+				  (q << FMAC_PARAM_Q_Pos) |
+				  FMAC_PARAM_START;
+}
+
+static void _fmac_wait_load()
+{
+	while ( (FMAC->PARAM & FMAC_PARAM_START) != 0 );
+}
+
+/**
+ *  Public API
+ */
+
+void fmac_init()
+{
+	LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_FMAC);
+}
+
+/**
+ *  Backend API
+ */
+
+void fmac_backend_compute(const fmac_filter_t* filter,
+						  const int16_t* input,
+						  int16_t* output,
+						  size_t count)
+{
+	uint32_t p = filter->feedforward_count;
+	uint32_t q = filter->feedback_count;
+
+	/* Stop any previous function and reset buffer pointers */
+	FMAC->CR = FMAC_CR_RESET;
+	while ( (FMAC->CR & FMAC_CR_RESET) != 0 );
+
+	/* Local memory: coefficients, then inputs, then outputs */
+	uint32_t x2_size = p + q;
+	uint32_t x1_size = p + buffer_headroom;
+	uint32_t y_size  = q + buffer_headroom;
+
+	FMAC->X2BUFCFG = (0U << FMAC_X2BUFCFG_X2_BASE_Pos) |
+					 (x2_size << FMAC_X2BUFCFG_X2_BUF_SIZE_Pos);
+	FMAC->X1BUFCFG = (x2_size << FMAC_X1BUFCFG_X1_BASE_Pos) |
+					 (x1_size << FMAC_X1BUFCFG_X1_BUF_SIZE_Pos);
+	FMAC->YBUFCFG  = ((x2_size + x1_size) << FMAC_YBUFCFG_Y_BASE_Pos) |
+					 (y_size << FMAC_YBUFCFG_Y_BUF_SIZE_Pos);
+
+	/* Coefficients, then history of the filter */
+	_fmac_start_load(FMAC_FUNCTION_LOAD_X2, p, q);
+	_fmac_write(filter->feedforward, p);
+	_fmac_write(filter->feedback, q);
+	_fmac_wait_load();
+
+	_fmac_start_load(FMAC_FUNCTION_LOAD_X1, p - 1, 0);
+	_fmac_write(filter->x_history, p - 1);
+	_fmac_wait_load();
+
+	if (q > 0)
+	{
+		_fmac_start_load(FMAC_FUNCTION_LOAD_Y, q, 0);
+		_fmac_write(filter->y_history, q);
+		_fmac_wait_load();
+	}
+
+	/* Saturate outputs instead of wrapping around */
+	FMAC->CR = FMAC_CR_CLIPEN;
+
+	uint32_t function = (q > 0) ? FMAC_FUNCTION_IIR : FMAC_FUNCTION_FIR;
+	FMAC->PARAM = (function << FMAC_PARAM_FUNC_Pos) |
+				  (p << FMAC_PARAM_P_Pos) |
+				  (q << FMAC_PARAM_Q_Pos) |
+				  ((uint32_t)filter->gain_shift << FMAC_PARAM_R_Pos) |
+				  FMAC_PARAM_START;
+
+	/**
+	 * Feed inputs while X1 has room and collect outputs as soon as
+	 * they are available. An input may be overwritten by its output,
+	 * but only once it has been written to the FMAC.
+	 */
+	size_t written = 0;
+	size_t read    = 0;
+	while (read < count)
+	{
+		uint32_t status = FMAC->SR;
+
+		if ( (written < count) && ((status & FMAC_SR_X1FULL) == 0) )
+		{
+			FMAC->WDATA = (uint16_t)input[written];
+			written++;
+		}
+
+		if ((status & FMAC_SR_YEMPTY) == 0)
+		{
+			output[read] = (int16_t)FMAC->RDATA;
+			read++;
+		}
+	}
+
+	FMAC->PARAM = 0;
+}
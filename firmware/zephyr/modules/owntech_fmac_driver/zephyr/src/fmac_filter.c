@@ -0,0 +1,132 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+/* Stdlib */
+#include <string.h>
+
+/* Current module private headers */
+#include "fmac_backend.h"
+
+/* Current file header */
+#include "fmac.h"
+
+
+/**
+ *  Private functions
+ */
+
+/**
+ * Shift the latest values of a run into a history, oldest first.
+ * When the run is shorter than the history, previous values are kept.
+ */
+static void _fmac_filter_push_history(int16_t* history,
+									  size_t history_size,
+									  const int16_t* values,
+									  size_t count)
+{
+	if (history_size == 0)
+		return;
+
+	if (count >= history_size)
+	{
+		memcpy(history, values + count - history_size,
+			   history_size * sizeof(int16_t));
+		return;
+	}
+
+	memmove(history, history + count,
+			(history_size - count) * sizeof(int16_t));
+	memcpy(history + history_size - count, values, count * sizeof(int16_t));
+}
+
+/**
+ *  Public API
+ */
+
+int8_t fmac_filter_init(fmac_filter_t* filter,
+						const int16_t* feedforward,
+						uint8_t feedforward_count,
+						const int16_t* feedback,
+						uint8_t feedback_count,
+						uint8_t gain_shift)
+{
+	if ( (feedforward_count == 0) ||
+		 (feedforward_count > FMAC_FILTER_MAX_FEEDFORWARD) ||
+		 (feedback_count > FMAC_FILTER_MAX_FEEDBACK) ||
+		 (gain_shift > FMAC_FILTER_MAX_GAIN_SHIFT) )
+		return -1;
+
+	if ( (feedback_count > 0) && (feedback == NULL) )
+		return -1;
+
+	memset(filter, 0, sizeof(fmac_filter_t));
+
+	memcpy(filter->feedforward, feedforward, feedforward_count * sizeof(int16_t));
+	if (feedforward_count < FMAC_FILTER_MIN_FEEDFORWARD)
+	{
+		feedforward_count = FMAC_FILTER_MIN_FEEDFORWARD;
+	}
+
+	if (feedback_count > 0)
+	{
+		memcpy(filter->feedback, feedback, feedback_count * sizeof(int16_t));
+	}
+
+	filter->feedforward_count = feedforward_count;
+	filter->feedback_count    = feedback_count;
+	filter->gain_shift        = gain_shift;
+
+	return 0;
+}
+
+void fmac_filter_reset(fmac_filter_t* filter)
+{
+	memset(filter->x_history, 0, sizeof(filter->x_history));
+	memset(filter->y_history, 0, sizeof(filter->y_history));
+}
+
+void fmac_filter_run(fmac_filter_t* filter,
+					 const int16_t* input,
+					 int16_t* output,
+					 size_t count)
+{
+	/* Filter never initialized */
+	if ( (count == 0) || (filter->feedforward_count == 0) )
+		return;
+
+	/* Input history must be taken before output overwrites an input */
+	size_t x_history_size = filter->feedforward_count - 1;
+	int16_t latest_inputs[FMAC_FILTER_MAX_FEEDFORWARD - 1];
+	size_t latest_count = (count < x_history_size) ? count : x_history_size;
+
+	memcpy(latest_inputs, input + count - latest_count,
+		   latest_count * sizeof(int16_t));
+
+	fmac_backend_compute(filter, input, output, count);
+
+	_fmac_filter_push_history(filter->x_history, x_history_size,
+							  latest_inputs, latest_count);
+	_fmac_filter_push_history(filter->y_history, filter->feedback_count,
+							  output, count);
+}
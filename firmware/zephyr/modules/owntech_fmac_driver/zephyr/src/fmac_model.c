@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief  Software model of the FMAC for host builds. It follows the
+ *         FMAC datapath described in the reference manual (RM0440):
+ *
+ *         - Coefficients and samples are q1.15, products are q2.30.
+ *         - Products are truncated to the 26-bit q4.22 accumulator,
+ *           which wraps around on overflow.
+ *         - The accumulator is shifted left by R and truncated to q1.15,
+ *           saturating as the driver enables clipping.
+ *         - Feedback uses the saturated outputs.
+ */
+
+/* Current module private headers */
+#include "fmac_backend.h"
+
+
+/**
+ *  Local constants
+ */
+
+static const int     accumulator_bits   = 26;
+static const int     product_truncation = 30 - 22;
+static const int     output_truncation  = 22 - 15;
+static const int32_t q15_max            = 32767;
+static const int32_t q15_min            = -32768;
+
+/**
+ *  Private functions
+ */
+
+static int32_t _fmac_wrap_accumulator(int64_t value)
+{
+	/* Sign-extend the 26 low bits */
+	uint64_t mask = (1ULL << accumulator_bits) - 1;
+	uint64_t sign = 1ULL << (accumulator_bits - 1);
+	uint64_t bits = (uint64_t)value & mask;
+
+	return (int32_t)((int64_t)(bits ^ sign) - (int64_t)sign);
+}
+
+static int16_t _fmac_output(int32_t accumulator, uint8_t gain_shift)
+{
+	int64_t value = ((int64_t)accumulator << gain_shift) >> output_truncation;
+
+	if (value > q15_max)
+		return (int16_t)q15_max;
+	if (value < q15_min)
+		return (int16_t)q15_min;
+
+	return (int16_t)value;
+}
+
+/**
+ *  Backend API
+ */
+
+void fmac_backend_compute(const fmac_filter_t* filter,
+						  const int16_t* input,
+						  int16_t* output,
+						  size_t count)
+{
+	uint8_t p = filter->feedforward_count;
+	uint8_t q = filter->feedback_count;
+
+	/* Working histories, most recent first */
+	int16_t x[FMAC_FILTER_MAX_FEEDFORWARD];
+	int16_t y[FMAC_FILTER_MAX_FEEDBACK];
+
+	for (uint8_t k = 1 ; k < p ; k++)
+	{
+		x[k] = filter->x_history[p - 1 - k];
+	}
+	for (uint8_t k = 0 ; k < q ; k++)
+	{
+		y[k] = filter->y_history[q - 1 - k];
+	}
+
+	for (size_t n = 0 ; n < count ; n++)
+	{
+		x[0] = input[n];
+
+		int64_t accumulator = 0;
+		for (uint8_t k = 0 ; k < p ; k++)
+		{
+			int32_t product = (int32_t)filter->feedforward[k] * x[k];
+			accumulator += product >> product_truncation;
+		}
+		for (uint8_t k = 0 ; k < q ; k++)
+		{
+			int32_t product = (int32_t)filter->feedback[k] * y[k];
+			accumulator += product >> product_truncation;
+		}
+
+		int16_t value = _fmac_output(_fmac_wrap_accumulator(accumulator),
+									 filter->gain_shift);
+
+		/* Input may be overwritten by output: shift before storing */
+		for (uint8_t k = p - 1 ; k > 0 ; k--)
+		{
+			x[k] = x[k - 1];
+		}
+		for (uint8_t k = (q > 0) ? q - 1 : 0 ; k > 0 ; k--)
+		{
+			y[k] = y[k - 1];
+		}
+		if (q > 0)
+		{
+			y[0] = value;
+		}
+
+		output[n] = value;
+	}
+}
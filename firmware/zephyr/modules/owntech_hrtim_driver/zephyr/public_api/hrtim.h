@@ -526,6 +526,17 @@ void hrtim_PeriodicEvent_SetRep(hrtim_tu_t tu, uint32_t repetition);
  */
 uint32_t hrtim_PeriodicEvent_GetRep(hrtim_tu_t tu);
 
+/**
+ * @brief Checks if a periodic event is waiting to be handled.
+ *        When called at the end of the periodic event callback, a pending
+ *        event means the callback lasted longer than the event period.
+ * @param tu timing unit which is the source for the ISR
+ *                  `MSTR`, `TIMA`, `TIMB`, `TIMC`, `TIMD`, `TIME`, `TIMF`
+ *
+ * @return 1 if an event is pending, 0 otherwise.
+ */
+uint32_t hrtim_PeriodicEvent_is_pending(hrtim_tu_t tu);
+
 /**
  * @brief   Initializes dual DAC reset and trigger. The selected timing unit CMP2
  *          will trigger the step (Decrement/Increment of sawtooth) and the reset
@@ -605,6 +616,28 @@ void hrtim_change_frequency(uint32_t new_frequency);
  */
 void hrtim_output_hot_swap(hrtim_tu_number_t tu_number);
 
+/**
+ * @brief Disables the register update of timing units: preload registers
+ *        (e.g. compares) are not transferred to the active ones on update
+ *        events until hrtim_update_en() is called.
+ * @param[in] timers OR of timing units: `TIMA`, `TIMB`, ...
+ */
+void hrtim_update_dis(uint32_t timers);
+
+/**
+ * @brief Enables back the register update of timing units, all at once:
+ *        values written while it was disabled are transferred together
+ *        at the next update event.
+ * @param[in] timers OR of timing units: `TIMA`, `TIMB`, ...
+ */
+void hrtim_update_en(uint32_t timers);
+
+/**
+ * @brief Disables the outputs of all timing units with a single register
+ *        write, e.g. to stop all converters on a fault.
+ */
+void hrtim_out_dis_all();
+
 #ifdef __cplusplus
 }
 #endif
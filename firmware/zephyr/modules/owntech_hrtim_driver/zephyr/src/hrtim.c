@@ -108,6 +108,16 @@ static hrtim_adc_event_t tu_adc_events[HRTIM_STU_NUMOF] =
 static hrtim_adc_source_t tu_adc_source[HRTIM_STU_NUMOF] =
     {TIMA_CMP3, TIMB_CMP3, TIMC_CMP3, TIMD_CMP3, TIME_CMP3, TIMF_CMP3};
 
+/**
+ * @brief Sets the ADC trigger source linked to each timing unit
+ *        for ADC triggers 2 and 4, which use a different
+ *        register layout than ADC triggers 1 and 3.
+ */
+static uint32_t tu_adc_source_24[HRTIM_STU_NUMOF] =
+    {LL_HRTIM_ADCTRIG_SRC24_TIMACMP3, LL_HRTIM_ADCTRIG_SRC24_TIMBCMP3,
+     LL_HRTIM_ADCTRIG_SRC24_TIMCCMP3, LL_HRTIM_ADCTRIG_SRC24_TIMDCMP3,
+     LL_HRTIM_ADCTRIG_SRC24_TIMECMP3, LL_HRTIM_ADCTRIG_SRC24_TIMFCMP3};
+
 /** @brief Sets the external event trigger for each timing unit*/
 static hrtim_external_trigger_t tu_external_trig[HRTIM_STU_NUMOF] =
     {EEV4, EEV1, EEV5, EEV1, EEV1, EEV1};
@@ -1375,13 +1385,30 @@ void hrtim_adc_trigger_set_postscaler(hrtim_tu_number_t tu_number, uint32_t ps_r
                               ps_ratio);
 }
 
+/**
+ * @brief Returns the ADC trigger source of a timing unit, encoded
+ *        for the ADC trigger it is linked to.
+ */
+static uint32_t _hrtim_adc_trigger_source_get(hrtim_tu_number_t tu_number)
+{
+    hrtim_adc_trigger_t adc_trigger =
+                            tu_channel[tu_number]->adc_hrtim.adc_trigger;
+
+    if ( (adc_trigger == ADCTRIG_2) || (adc_trigger == ADCTRIG_4) )
+    {
+        return tu_adc_source_24[tu_number];
+    }
+
+    return tu_channel[tu_number]->adc_hrtim.adc_source;
+}
+
 void hrtim_adc_trigger_en(hrtim_tu_number_t tu_number)
 {
     if (tu_channel[tu_number]->adc_hrtim.adc_trigger != ADCTRIG_NONE)
     {
         LL_HRTIM_SetADCTrigSrc(HRTIM1,
                                tu_channel[tu_number]->adc_hrtim.adc_trigger,
-                               tu_channel[tu_number]->adc_hrtim.adc_source);
+                               _hrtim_adc_trigger_source_get(tu_number));
         LL_HRTIM_SetADCTrigUpdate(HRTIM1,
                                tu_channel[tu_number]->adc_hrtim.adc_trigger,
                                tu_channel[tu_number]->adc_hrtim.adc_event);
@@ -1396,7 +1423,7 @@ void hrtim_adc_trigger_dis(hrtim_tu_number_t tu_number)
                     LL_HRTIM_GetADCTrigSrc(
                             HRTIM1,
                             tu_channel[tu_number]->adc_hrtim.adc_trigger)
-                    & ~tu_channel[tu_number]->adc_hrtim.adc_source);
+                    & ~_hrtim_adc_trigger_source_get(tu_number));
 }
 
 void hrtim_adc_trigger_set(hrtim_tu_number_t tu_number,
@@ -1477,6 +1504,16 @@ uint32_t hrtim_PeriodicEvent_GetRep(hrtim_tu_t tu)
     return LL_HRTIM_TIM_GetRepetition(HRTIM1, tu) + 1;
 }
 
+uint32_t hrtim_PeriodicEvent_is_pending(hrtim_tu_t tu)
+{
+    if (LL_HRTIM_GetSyncInSrc(HRTIM1) == LL_HRTIM_SYNCIN_SRC_EXTERNAL_EVENT)
+    {
+        return LL_HRTIM_IsActiveFlag_SYNC(HRTIM1);
+    }
+
+    return LL_HRTIM_IsActiveFlag_REP(HRTIM1, tu);
+}
+
 void DualDAC_init(hrtim_tu_number_t tu_number)
 {
     LL_HRTIM_TIM_SetDualDacResetTrigger(HRTIM1,
@@ -1596,6 +1633,23 @@ void hrtim_output_hot_swap(hrtim_tu_number_t tu_number){
     }
 }
 
+void hrtim_update_dis(uint32_t timers)
+{
+    LL_HRTIM_DisableUpdate(HRTIM1, timers);
+}
+
+void hrtim_update_en(uint32_t timers)
+{
+    LL_HRTIM_EnableUpdate(HRTIM1, timers);
+}
+
+void hrtim_out_dis_all()
+{
+    LL_HRTIM_DisableOutput(HRTIM1, PWMA1 | PWMA2 | PWMB1 | PWMB2 |
+                                   PWMC1 | PWMC2 | PWMD1 | PWMD2 |
+                                   PWME1 | PWME2 | PWMF1 | PWMF2);
+}
+
 uint32_t hrtim_get_resolution_ps(hrtim_tu_number_t tu_number)
 {
     return tu_channel[tu_number]->pwm_conf.resolution;
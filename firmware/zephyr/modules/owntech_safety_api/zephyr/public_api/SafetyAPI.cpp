@@ -113,6 +113,44 @@ bool SafetyAPI::getChannelError(sensor_t sensors_error)
     return error_status;
 }
 
+uint32_t SafetyAPI::getTripLatency()
+{
+    return safety_get_trip_latency();
+}
+
+uint32_t SafetyAPI::getTripCount()
+{
+    return safety_get_trip_count();
+}
+
+int8_t SafetyAPI::setChannelHardwareTrip(sensor_t* sensors_trip,
+                                         float32_t* threshold_max,
+                                         uint8_t sensors_trip_number)
+{
+    return safety_set_hw_trip(sensors_trip, threshold_max,
+                              sensors_trip_number);
+}
+
+bool SafetyAPI::getChannelHardwareTrip(sensor_t sensor_trip)
+{
+    return safety_get_hw_trip_error(sensor_trip);
+}
+
+void SafetyAPI::clearHardwareTrip()
+{
+    safety_clear_hw_trip_errors();
+}
+
+int8_t SafetyAPI::setAdcWatchdogOffload(bool enable)
+{
+    return safety_set_adc_watchdog(enable);
+}
+
+bool SafetyAPI::getChannelAdcWatchdog(sensor_t sensor_watchdog)
+{
+    return safety_get_adc_watchdog(sensor_watchdog);
+}
+
 void SafetyAPI::enableSafetyApi()
 {
     safety_enable_task();
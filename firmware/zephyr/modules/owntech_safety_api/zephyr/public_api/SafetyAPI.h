@@ -220,6 +220,95 @@ class SafetyAPI{
      */
     bool getChannelError(sensor_t sensors_error);
 
+    /**
+     * @brief Get the latency of the last safety reaction, from the fault
+     *        detection to all the switches being in the safe state.
+     *
+     * @return Latency in CPU cycles, `0` if no reaction happened yet.
+     */
+    uint32_t getTripLatency();
+
+    /**
+     * @brief Get the number of safety alerts since startup, i.e. of faults
+     *        detected by the safety task. Can be polled by the critical
+     *        task to react to a new alert.
+     *
+     * @return Number of alerts, `0` if no fault was detected yet.
+     */
+    uint32_t getTripCount();
+
+    /**
+     * @brief Set the hardware overcurrent trip of sensors: a comparator
+     *        and a DAC threshold stop all the outputs within nanoseconds
+     *        through the HRTIM fault inputs.
+     *
+     * @note  Only `I1_LOW` and `I2_LOW` are wired to comparators. Must be
+     *        called before starting the legs, or after stopping them.
+     *
+     * @param sensors_trip A list of the sensors to protect.
+     *
+     * @param threshold_max A list of the maximum values, in the sensor
+     *                      unit (Amperes) with its current calibration.
+     *
+     * @param sensors_trip_number The number of sensors in the lists.
+     *
+     * @return `0` if successful, or `-1` if not, including when a leg
+     *         is running.
+     */
+    int8_t setChannelHardwareTrip(sensor_t* sensors_trip,
+                                  float32_t* threshold_max,
+                                  uint8_t sensors_trip_number);
+
+    /**
+     * @brief Check if the hardware trip of a sensor fired. The fault is
+     *        latched until clearHardwareTrip() is called.
+     *
+     * @param sensor_trip The protected sensor.
+     *
+     * @return True if the hardware trip fired, false if not
+     */
+    bool getChannelHardwareTrip(sensor_t sensor_trip);
+
+    /**
+     * @brief Clear the latched hardware trips. If the current is still
+     *        above the threshold, the trip fires again. Legs are
+     *        restarted by starting them again.
+     */
+    void clearHardwareTrip();
+
+    /**
+     * @brief Offload the monitoring of the watched sensors to the ADC
+     *        analog watchdogs: conversions out of the thresholds are
+     *        flagged by the ADCs without any CPU load, and the safety
+     *        task only checks the sensors whose watchdog flagged one.
+     *
+     * @note  Each ADC has 3 watchdogs. Other sensors of the ADC, sensors
+     *        of an ADC with oversampling, and sensors watched after this
+     *        call are monitored by software. Must be called after the
+     *        sensors are enabled and watched, before the data acquisition
+     *        is started.
+     *
+     * @param enable true to offload, false to monitor all the sensors by
+     *               software (default).
+     *
+     * @return The number of sensors with a watchdog, or `-1` if the data
+     *         acquisition is already started.
+     */
+    int8_t setAdcWatchdogOffload(bool enable);
+
+    /**
+     * @brief Check if a sensor is monitored by an ADC analog watchdog.
+     *
+     * @param sensor_watchdog the sensor to check within the possible names:
+     *
+     * `V1_LOW`,`V2_LOW`, `V_HIGH`, `I1_LOW`,`I2_LOW`,`I_HIGH`, `TEMP_SENSOR`,
+     * `EXTRA_MEAS`, `ANALOG_COMM`
+     *
+     * @return True if the sensor has a watchdog, false if it is monitored
+     *         by software
+     */
+    bool getChannelAdcWatchdog(sensor_t sensor_watchdog);
+
 
     /**
      * @brief Enables the safety API fault detection task
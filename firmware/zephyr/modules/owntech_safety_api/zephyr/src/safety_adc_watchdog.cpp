@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Allocation of the ADC analog watchdogs and window computation
+ */
+
+#include "safety_adc_watchdog.h"
+
+int8_t safety_awd_allocate(uint8_t adc,
+                           uint8_t channel,
+                           safety_awd_allocation_t* allocation)
+{
+    if (adc == 0 || adc > SAFETY_AWD_ADCS || channel == 0) return -1;
+
+    for (uint8_t watchdog = 1; watchdog <= SAFETY_AWD_WATCHDOGS; watchdog++)
+    {
+        if (allocation->channel[adc][watchdog] != 0) continue;
+
+        allocation->channel[adc][watchdog] = channel;
+        return watchdog;
+    }
+
+    return -1;
+}
+
+void safety_awd_compute_window(uint8_t watchdog,
+                               const safety_raw_limits_t* limits,
+                               safety_awd_window_t* window)
+{
+    int32_t low = limits->low;
+    int32_t high = limits->high > SAFETY_AWD_CODE_MAX ? SAFETY_AWD_CODE_MAX
+                                                      : limits->high;
+    if (low < 0) low = 0;
+
+    /**
+     * Watchdog 1 compares the codes themselves. Code 0 is always below a
+     * low limit, which starts at 1.
+     */
+    if (watchdog == 1)
+    {
+        if (high >= low)
+        {
+            window->low = (uint16_t)low;
+            window->high = (uint16_t)high;
+            return;
+        }
+    }
+    else
+    {
+        /**
+         * Watchdogs 2 and 3 compare code >> 4: the window is rounded
+         * inwards, so that codes out of the limits are always flagged.
+         */
+        int32_t msb_low = (low + (1 << SAFETY_AWD_MSB_SHIFT) - 1)
+                          >> SAFETY_AWD_MSB_SHIFT;
+        int32_t msb_high = ((high + 1) >> SAFETY_AWD_MSB_SHIFT) - 1;
+
+        if (high >= low && msb_low <= SAFETY_AWD_MSB_MAX && msb_high >= 0)
+        {
+            window->low = (uint16_t)msb_low;
+            window->high = (uint16_t)msb_high;
+            return;
+        }
+    }
+
+    /* No window fits: every conversion is flagged */
+    window->low = watchdog == 1 ? SAFETY_AWD_CODE_MAX : SAFETY_AWD_MSB_MAX;
+    window->high = 0;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief ADC analog watchdogs offload of the safety watch: each ADC has
+ *        3 window watchdogs, which flag conversions of a channel out of
+ *        a window without any CPU load. This file allocates them and
+ *        translates raw limits into windows, it does not depend on the
+ *        hardware and is also built for the host.
+ */
+
+#ifndef SAFETY_ADC_WATCHDOG_H_
+#define SAFETY_ADC_WATCHDOG_H_
+
+#include <stdint.h>
+
+#include "safety_raw_limits.h"
+
+/* ADCs and watchdogs per ADC, numbered from 1 */
+const uint8_t SAFETY_AWD_ADCS = 5;
+const uint8_t SAFETY_AWD_WATCHDOGS = 3;
+
+/* Largest code of watchdog 1 (12-bit codes) and 2, 3 (8 MSBs) */
+const uint16_t SAFETY_AWD_CODE_MAX = 4095;
+const uint16_t SAFETY_AWD_MSB_MAX = 255;
+const uint8_t SAFETY_AWD_MSB_SHIFT = 4;
+
+/**
+ * Channel monitored by each watchdog, 0 if unused. Index 0 is not used.
+ */
+typedef struct
+{
+    uint8_t channel[SAFETY_AWD_ADCS + 1][SAFETY_AWD_WATCHDOGS + 1];
+} safety_awd_allocation_t;
+
+/**
+ * Window of a watchdog, in its format: a conversion below low or above
+ * high sets the watchdog flag.
+ */
+typedef struct
+{
+    uint16_t low;
+    uint16_t high;
+} safety_awd_window_t;
+
+/**
+ * @brief Allocates a watchdog to a channel. Watchdog 1, which compares
+ *        full codes, is allocated first.
+ *
+ * @param adc Number of the ADC of the channel.
+ * @param channel Channel number.
+ * @param[in,out] allocation Watchdogs allocation, zeroed before the first
+ *        channel.
+ *
+ * @return Watchdog number, or -1 if all the watchdogs of the ADC are used
+ *         (the channel is then watched by software).
+ */
+int8_t safety_awd_allocate(uint8_t adc,
+                           uint8_t channel,
+                           safety_awd_allocation_t* allocation);
+
+/**
+ * @brief Computes the window of a watchdog from raw limits: every code out
+ *        of the limits is flagged. Watchdogs 2 and 3 only compare the most
+ *        significant bits, so that they may also flag codes up to 15 codes
+ *        within the limits, as does watchdog 1 with code 0. A flag is thus
+ *        a request to check the sensor value, not an error.
+ *
+ * @param watchdog Watchdog number.
+ * @param limits Raw codes within thresholds, of a 12-bit channel.
+ * @param[out] window Window of the watchdog.
+ */
+void safety_awd_compute_window(uint8_t watchdog,
+                               const safety_raw_limits_t* limits,
+                               safety_awd_window_t* window);
+
+#endif /* SAFETY_ADC_WATCHDOG_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Computation of the hardware overcurrent trip configuration
+ */
+
+#include <math.h>
+
+#include "gpio_pin_map.h"
+#include "safety_hw_trip.h"
+
+/**
+ * Sensor pins wired to a comparator positive input. Fault inputs 4 and 5
+ * have COMP1 and COMP3 outputs as internal source.
+ */
+typedef struct
+{
+    uint8_t port;
+    uint8_t pin_number;
+    safety_hw_trip_route_t route;
+} safety_hw_trip_pin_t;
+
+static const safety_hw_trip_pin_t hw_trip_pins[] =
+{
+    /* PA1 ------> COMP1_INP, DAC3_CH1 ------> COMP1_INM */
+    { GPIO_PIN_MAP_PORT_A, 1, { 1, 3, 4 } },
+    /* PC1 ------> COMP3_INP, DAC1_CH1 ------> COMP3_INM */
+    { GPIO_PIN_MAP_PORT_C, 1, { 3, 1, 5 } },
+};
+
+int8_t safety_hw_trip_get_route(uint8_t port,
+                                uint8_t pin_number,
+                                safety_hw_trip_route_t* route)
+{
+    for (const safety_hw_trip_pin_t& pin : hw_trip_pins)
+    {
+        if (pin.port == port && pin.pin_number == pin_number)
+        {
+            *route = pin.route;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int8_t safety_hw_trip_compute_dac_code(safety_raw_conversion_t conversion,
+                                       const void* context,
+                                       float32_t threshold_max,
+                                       uint16_t* dac_code,
+                                       bool* inverted)
+{
+    safety_raw_limits_t limits;
+    safety_compute_raw_limits(conversion, context, SAFETY_HW_TRIP_CODE_MAX,
+                              -INFINITY, threshold_max, &limits);
+
+    *inverted = conversion(SAFETY_HW_TRIP_CODE_MAX, context) <
+                conversion(0, context);
+
+    /**
+     * The DAC code is the last code within threshold: the comparator trips
+     * at most half a code before the converted value goes above it. A
+     * threshold that would never or always trip is rejected.
+     */
+    if (*inverted)
+    {
+        bool never = limits.low == 1 && limits.zero_within;
+        bool always = limits.low > SAFETY_HW_TRIP_CODE_MAX;
+        if (never || always) return -1;
+
+        *dac_code = (uint16_t)limits.low;
+    }
+    else
+    {
+        bool never = limits.high >= SAFETY_HW_TRIP_CODE_MAX;
+        bool always = limits.high < limits.low;
+        if (never || always) return -1;
+
+        *dac_code = (uint16_t)limits.high;
+    }
+
+    return 0;
+}
+
+int8_t safety_hw_trip_add_sensor(const safety_hw_trip_route_t* route,
+                                 uint16_t dac_code,
+                                 bool inverted,
+                                 safety_hw_trip_registers_t* registers)
+{
+    if (registers->comparator_enabled[route->comparator] ||
+        registers->dac_enabled[route->dac] ||
+        registers->fault_enabled[route->fault])
+    {
+        return -1;
+    }
+
+    registers->comparator_enabled[route->comparator] = true;
+    registers->comparator_inverted[route->comparator] = inverted;
+    registers->dac_enabled[route->dac] = true;
+    registers->dac_code[route->dac] = dac_code;
+    registers->fault_enabled[route->fault] = true;
+    registers->timer_faults |= 1 << (route->fault - 1);
+
+    return 0;
+}
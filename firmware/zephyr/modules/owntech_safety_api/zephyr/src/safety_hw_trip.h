@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Hardware overcurrent trip: a comparator compares the sensor pin
+ *        to a DAC threshold, and its output is an HRTIM fault input which
+ *        forces all outputs inactive without any software. This file
+ *        computes the configuration as a register map, it does not depend
+ *        on the hardware and is also built for the host.
+ */
+
+#ifndef SAFETY_HW_TRIP_H_
+#define SAFETY_HW_TRIP_H_
+
+#include <stdint.h>
+
+#include "safety_raw_limits.h"
+
+/* Largest DAC and comparator input code, same reference as the ADC */
+const uint16_t SAFETY_HW_TRIP_CODE_MAX = 4095;
+
+/* Comparators, DACs and HRTIM fault inputs are numbered from 1 */
+const uint8_t SAFETY_HW_TRIP_COMPARATORS = 7;
+const uint8_t SAFETY_HW_TRIP_DACS = 4;
+const uint8_t SAFETY_HW_TRIP_FAULTS = 6;
+
+/**
+ * Analog path of a sensor pin: the comparator having the pin as positive
+ * input, the DAC on its negative input and the HRTIM fault input
+ * internally connected to its output.
+ */
+typedef struct
+{
+    uint8_t comparator;
+    uint8_t dac;
+    uint8_t fault;
+} safety_hw_trip_route_t;
+
+/**
+ * Configuration of the hardware trip, as register fields. Indexes are
+ * peripheral numbers, index 0 is not used.
+ */
+typedef struct
+{
+    /* Comparators enabled, with inverted output (trip below threshold) */
+    bool      comparator_enabled[SAFETY_HW_TRIP_COMPARATORS + 1];
+    bool      comparator_inverted[SAFETY_HW_TRIP_COMPARATORS + 1];
+    /* Constant value of channel 1 of each DAC */
+    bool      dac_enabled[SAFETY_HW_TRIP_DACS + 1];
+    uint16_t  dac_code[SAFETY_HW_TRIP_DACS + 1];
+    /* HRTIM fault inputs enabled on their internal (comparator) source */
+    bool      fault_enabled[SAFETY_HW_TRIP_FAULTS + 1];
+    /* Fault inputs stopping each timing unit, bit n-1 for fault n */
+    uint8_t   timer_faults;
+} safety_hw_trip_registers_t;
+
+/**
+ * @brief Gets the analog path of a GPIO pin.
+ *
+ * @param port GPIO port index (GPIO_PIN_MAP_PORT_A...).
+ * @param pin_number GPIO pin number.
+ * @param[out] route Comparator, DAC and fault input of the pin.
+ *
+ * @return 0 if the pin can be protected, -1 else.
+ */
+int8_t safety_hw_trip_get_route(uint8_t port,
+                                uint8_t pin_number,
+                                safety_hw_trip_route_t* route);
+
+/**
+ * @brief Computes the DAC code of a threshold: the comparator trips on
+ *        the codes whose converted value is above threshold_max, at most
+ *        half a code early.
+ *
+ * @param conversion Conversion of the 12-bit analog code, monotonic.
+ * @param context Passed to conversion.
+ * @param threshold_max Maximum converted value.
+ * @param[out] dac_code DAC code.
+ * @param[out] inverted true if the conversion is decreasing: the
+ *        comparator then trips below the DAC code.
+ *
+ * @return 0 if successful, -1 if the threshold is out of the
+ *         measurement range (it would never or always trip).
+ */
+int8_t safety_hw_trip_compute_dac_code(safety_raw_conversion_t conversion,
+                                       const void* context,
+                                       float32_t threshold_max,
+                                       uint16_t* dac_code,
+                                       bool* inverted);
+
+/**
+ * @brief Adds a protected sensor to the register map. All timing units
+ *        are stopped by the fault inputs of all protected sensors.
+ *
+ * @param route Analog path of the sensor pin.
+ * @param dac_code DAC code of the threshold.
+ * @param inverted Comparator trips below the DAC code.
+ * @param[in,out] registers Register map, zeroed before the first sensor.
+ *
+ * @return 0 if successful, -1 if the path is already used by another
+ *         sensor.
+ */
+int8_t safety_hw_trip_add_sensor(const safety_hw_trip_route_t* route,
+                                 uint16_t dac_code,
+                                 bool inverted,
+                                 safety_hw_trip_registers_t* registers);
+
+#endif /* SAFETY_HW_TRIP_H_ */
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Conversion of safety thresholds into raw ADC codes
+ */
+
+#include "safety_raw_limits.h"
+
+typedef enum
+{
+    value_above_or_equal,
+    value_above,
+    value_below_or_equal,
+    value_below,
+} raw_predicate_t;
+
+static bool _safety_raw_predicate(safety_raw_conversion_t conversion,
+                                  const void* context,
+                                  uint16_t raw_value,
+                                  raw_predicate_t predicate,
+                                  float32_t limit)
+{
+    float32_t value = conversion(raw_value, context);
+
+    switch (predicate)
+    {
+        case value_above_or_equal:
+            return value >= limit;
+        case value_above:
+            return value > limit;
+        case value_below_or_equal:
+            return value <= limit;
+        case value_below:
+            return value < limit;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the first raw code of [1, raw_max] for which the predicate is
+ * true, raw_max + 1 if there is none. The predicate must be false then
+ * true as the raw code increases.
+ */
+static int32_t _safety_first_raw_code(safety_raw_conversion_t conversion,
+                                      const void* context,
+                                      uint16_t raw_max,
+                                      raw_predicate_t predicate,
+                                      float32_t limit)
+{
+    int32_t low = 1;
+    int32_t high = (int32_t)raw_max + 1;
+
+    while (low < high)
+    {
+        int32_t middle = low + (high - low) / 2;
+        if (_safety_raw_predicate(conversion, context, (uint16_t)middle,
+                                  predicate, limit))
+        {
+            high = middle;
+        }
+        else
+        {
+            low = middle + 1;
+        }
+    }
+
+    return low;
+}
+
+void safety_compute_raw_limits(safety_raw_conversion_t conversion,
+                               const void* context,
+                               uint16_t raw_max,
+                               float32_t threshold_min,
+                               float32_t threshold_max,
+                               safety_raw_limits_t* limits)
+{
+    /* Direction away from the ends, where some conversions diverge */
+    float32_t quarter = conversion(raw_max / 4, context);
+    float32_t three_quarters = conversion(raw_max - raw_max / 4, context);
+    bool increasing = three_quarters >= quarter;
+
+    /* Code 0 is left out of the search, see safety_raw_limits_t */
+    if (increasing)
+    {
+        limits->low = _safety_first_raw_code(conversion, context, raw_max,
+                                             value_above_or_equal,
+                                             threshold_min);
+        limits->high = _safety_first_raw_code(conversion, context, raw_max,
+                                              value_above,
+                                              threshold_max) - 1;
+    }
+    else
+    {
+        limits->low = _safety_first_raw_code(conversion, context, raw_max,
+                                             value_below_or_equal,
+                                             threshold_max);
+        limits->high = _safety_first_raw_code(conversion, context, raw_max,
+                                              value_below,
+                                              threshold_min) - 1;
+    }
+
+    float32_t value = conversion(0, context);
+    limits->zero_within = !(value > threshold_max || value < threshold_min);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Safety thresholds in the raw ADC domain. Thresholds are converted
+ *        once into the range of raw codes whose converted value is within
+ *        them, so that the watch only compares integers. This file does
+ *        not depend on the hardware, and is also built for the host.
+ */
+
+#ifndef SAFETY_RAW_LIMITS_H_
+#define SAFETY_RAW_LIMITS_H_
+
+#include <stdint.h>
+#include "arm_math.h"
+
+/* Raw value of a DMA buffer word that has not been written yet */
+const uint16_t SAFETY_RAW_NO_VALUE = 0xFFFF;
+
+/**
+ * Raw codes within thresholds are the ones in [low, high], plus code 0 when
+ * zero_within is true. Code 0 is kept apart since conversions such as the
+ * thermistor equation are not continuous there. When no other code is
+ * within thresholds, high < low.
+ */
+typedef struct
+{
+    int32_t low;
+    int32_t high;
+    bool zero_within;
+} safety_raw_limits_t;
+
+/**
+ * @brief Conversion of a raw code into a physical value.
+ *
+ * @param raw_value Raw code.
+ * @param context Context given to safety_compute_raw_limits().
+ */
+typedef float32_t (*safety_raw_conversion_t)(uint16_t raw_value,
+                                             const void* context);
+
+/**
+ * @brief Computes the raw codes whose converted value is within thresholds,
+ *        i.e. for which `value > threshold_max || value < threshold_min`
+ *        is false, by binary search on the conversion itself: decisions
+ *        are the same as comparing the converted values, including at
+ *        the boundaries.
+ *
+ * @param conversion Conversion of the channel, monotonic (increasing or
+ *        decreasing) over [1, raw_max]. Code 0 is checked on its own.
+ * @param context Passed to conversion.
+ * @param raw_max Largest raw code of the channel.
+ * @param threshold_min Minimum converted value.
+ * @param threshold_max Maximum converted value.
+ * @param[out] limits Raw codes within thresholds.
+ */
+void safety_compute_raw_limits(safety_raw_conversion_t conversion,
+                               const void* context,
+                               uint16_t raw_max,
+                               float32_t threshold_min,
+                               float32_t threshold_max,
+                               safety_raw_limits_t* limits);
+
+/**
+ * @brief Checks a raw code against limits.
+ *
+ * @return true if the converted value of raw_value is outside thresholds.
+ */
+static inline bool safety_raw_is_outside(const safety_raw_limits_t* limits,
+                                         uint16_t raw_value)
+{
+    if (raw_value == 0)
+    {
+        return !limits->zero_within;
+    }
+
+    return ((int32_t)raw_value < limits->low) ||
+           ((int32_t)raw_value > limits->high);
+}
+
+#endif /* SAFETY_RAW_LIMITS_H_ */
@@ -26,12 +26,25 @@
 /* Header */
 #include "safety_setting.h"
 #include "safety_internal.h"
+#include "safety_raw_limits.h"
+#include "safety_shutdown.h"
+#include "safety_hw_trip.h"
+#include "safety_adc_watchdog.h"
 
 /* Includes */
+#include <string.h>
 
 /* LL libraries */
 #include "stm32_ll_gpio.h"
 #include "stm32_ll_bus.h"
+#include "stm32_ll_comp.h"
+#include "stm32_ll_hrtim.h"
+
+/* HRTIM driver */
+#include "hrtim.h"
+
+/* ADC driver */
+#include "adc.h"
 
 /* OWNTECH APIs */
 #include "nvs_storage.h"
@@ -40,6 +53,7 @@
 
 /* Zephyr */
 #include "zephyr/kernel.h"
+#include <soc.h>
 
 /* Defines */
 
@@ -63,6 +77,17 @@
 #define LEG_PWM_PIN_HIGH(node_id)	DT_PROP_BY_IDX(node_id, pwm_pin_num, 0),
 #define LEG_PWM_PIN_LOW(node_id)	DT_PROP_BY_IDX(node_id, pwm_pin_num, 1),
 
+/**
+ * Number of latest raw values views needed to watch all sensors
+ */
+#define WATCH_VIEWS_NUMBER \
+        ((DT_SENSORS_NUMBER + LATEST_VIEW_MAX_CHANNELS - 1) / LATEST_VIEW_MAX_CHANNELS)
+
+/**
+ * Largest raw code of an ADC without oversampling
+ */
+#define ADC_RAW_MAX 4095
+
 /* Global variables */
 
 /* sensors that need to be watched (true) / ignored (false) */
@@ -88,6 +113,48 @@ static uint8_t dt_pin_high_side[] =
 static uint8_t dt_pin_low_side[] =
         { DT_FOREACH_CHILD_STATUS_OKAY(POWER_SHIELD_ID, LEG_PWM_PIN_LOW) };
 
+/* GPIO ports, in the order of the shutdown masks */
+static GPIO_TypeDef* const shutdown_ports[GPIO_PIN_MAP_PORTS] =
+        { GPIOA, GPIOB, GPIOC, GPIOD };
+
+/* GPIO register values forcing all legs in the reaction state */
+static safety_shutdown_masks_t shutdown_masks;
+static bool shutdown_armed = false;
+
+/* Cycles from the trip to all legs being safe, 0 before the first trip */
+static uint32_t trip_latency_cycles = 0;
+
+/* Hardware trip configuration and sensor protected by each fault input */
+static safety_hw_trip_registers_t hw_trip_registers;
+static sensor_t hw_trip_fault_sensors[SAFETY_HW_TRIP_FAULTS + 1];
+
+/* sensor that tripped the hardware protection (true), latched */
+static bool hw_trip_errors[DT_SENSORS_NUMBER + 1];
+
+static COMP_TypeDef* const hw_trip_comparators[SAFETY_HW_TRIP_COMPARATORS + 1] =
+        { nullptr, COMP1, COMP2, COMP3, COMP4, COMP5, COMP6, COMP7 };
+
+static const uint32_t hw_trip_faults[SAFETY_HW_TRIP_FAULTS + 1] =
+        { 0, LL_HRTIM_FAULT_1, LL_HRTIM_FAULT_2, LL_HRTIM_FAULT_3,
+          LL_HRTIM_FAULT_4, LL_HRTIM_FAULT_5, LL_HRTIM_FAULT_6 };
+
+static const uint32_t hw_trip_timers[] =
+        { LL_HRTIM_TIMER_A, LL_HRTIM_TIMER_B, LL_HRTIM_TIMER_C,
+          LL_HRTIM_TIMER_D, LL_HRTIM_TIMER_E, LL_HRTIM_TIMER_F };
+
+static const uint32_t hw_trip_outputs[] =
+        { LL_HRTIM_OUTPUT_TA1, LL_HRTIM_OUTPUT_TA2, LL_HRTIM_OUTPUT_TB1,
+          LL_HRTIM_OUTPUT_TB2, LL_HRTIM_OUTPUT_TC1, LL_HRTIM_OUTPUT_TC2,
+          LL_HRTIM_OUTPUT_TD1, LL_HRTIM_OUTPUT_TD2, LL_HRTIM_OUTPUT_TE1,
+          LL_HRTIM_OUTPUT_TE2, LL_HRTIM_OUTPUT_TF1, LL_HRTIM_OUTPUT_TF2 };
+
+/* Context of the conversion of a 12-bit analog code */
+typedef struct
+{
+    sensor_t sensor;
+    float32_t raw_scale;
+} hw_trip_conversion_t;
+
 /**
  * The purpose of safety_alert_counter is to have a delay when we detect a problem.
  * For example here we wait that safety_alert_counter = 5 before triggering
@@ -101,47 +168,304 @@ static uint8_t safety_alert_counter = 0;
 /* enable the safety API watch and action task */
 static bool safety_enable = true;
 
+/* Alerts reported by safety_task() since startup, and current one */
+static uint32_t trip_count = 0;
+static bool alert_active = false;
+
+/**
+ * Compacted watch list: only the watched sensors, with their thresholds
+ * converted into raw codes. It is rebuilt by safety_watch() when the
+ * watched sensors, their thresholds or the conversion parameters change,
+ * so that each watch only reads and compares raw codes.
+ */
+static bool watch_list_dirty = true;
+static uint32_t watch_list_revision = 0;
+static uint8_t watch_count = 0;
+static sensor_t watch_sensors[DT_SENSORS_NUMBER];
+static safety_raw_limits_t watch_limits[DT_SENSORS_NUMBER];
+static latest_raw_view_t watch_views[WATCH_VIEWS_NUMBER];
+
+/**
+ * ADC analog watchdogs offload: the channels of the watchdogs are fixed
+ * when the offload is enabled, and their windows are set with the watch
+ * list. Each watched sensor has its ADC and watchdog (0 if watched by
+ * software): a view is only read when it has a sensor watched by
+ * software, or one whose watchdog flagged a conversion.
+ */
+static bool awd_enabled = false;
+static safety_awd_allocation_t awd_allocation;
+static sensor_t awd_sensors[SAFETY_AWD_ADCS + 1][SAFETY_AWD_WATCHDOGS + 1];
+static bool awd_adc_used[SAFETY_AWD_ADCS + 1];
+static uint8_t watch_adc[DT_SENSORS_NUMBER];
+static uint8_t watch_awd[DT_SENSORS_NUMBER];
+static bool sensor_awd[DT_SENSORS_NUMBER + 1];
+
 /**
  * Private Functions
  */
 
 /**
- * @brief This function enables the short-circuit mode
- *        i.e. the high-side switch is left open and
- *        the low-side switch is closed. Can be used to
- *        brake DC motor for example.
+ * @brief Forces all legs in the armed safe state: high-side switches are
+ *        opened, low-side switches are opened (open-circuit mode) or
+ *        closed (short-circuit mode, can be used to brake DC motor for
+ *        example). Each port takes the output levels first, then the
+ *        output mode, so that pins never drive the previous level.
+ */
+static inline void _safety_shutdown(void)
+{
+    for (uint8_t port = 0; port < GPIO_PIN_MAP_PORTS; port++)
+    {
+        const safety_port_shutdown_t& masks = shutdown_masks.ports[port];
+        if (masks.moder_mask == 0) continue;
+
+        GPIO_TypeDef* gpio = shutdown_ports[port];
+        gpio->BSRR = masks.bsrr;
+        gpio->MODER = (gpio->MODER & ~masks.moder_mask) | masks.moder_output;
+    }
+}
+
+/**
+ * @brief Conversion of a raw code of the sensor given as context.
+ */
+static float32_t _sensor_conversion(uint16_t raw_value, const void* context)
+{
+    return shield.sensors.convertRawValue(*(const sensor_t*)context,
+                                          raw_value);
+}
+
+/**
+ * @brief Gets the watchdog allocated to a sensor, if its window can be
+ *        set from its raw limits.
+ *
+ * @return Watchdog number, `0` if the sensor is watched by software.
+ */
+static uint8_t _safety_sensor_watchdog(sensor_t sensor, uint8_t adc,
+                                       float32_t raw_scale)
+{
+    if (!awd_enabled || adc > SAFETY_AWD_ADCS) return 0;
+
+    /* Windows are 12-bit codes, oversampled values are not */
+    if (raw_scale != 1.0F) return 0;
+
+    for (uint8_t w = 1; w <= SAFETY_AWD_WATCHDOGS; w++)
+    {
+        if (awd_allocation.channel[adc][w] != 0 &&
+            awd_sensors[adc][w] == sensor)
+        {
+            return w;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Builds the compacted watch list from the watched sensors and
+ *        converts their thresholds into raw codes, and into the windows
+ *        of their watchdogs.
+ */
+static void _safety_build_watch_list()
+{
+    watch_list_revision = data_conversion_get_parameters_revision();
+    watch_list_dirty = false;
+
+    watch_count = 0;
+    for (uint8_t v = 0; v < WATCH_VIEWS_NUMBER; v++)
+    {
+        memset(&watch_views[v], 0, sizeof(latest_raw_view_t));
+    }
+    memset(sensor_awd, 0, sizeof(sensor_awd));
+
+    /* Watchdogs of sensors not watched anymore never flag */
+    bool awd_used[SAFETY_AWD_ADCS + 1][SAFETY_AWD_WATCHDOGS + 1] = {};
+
+    for (uint8_t i = 1; i <= DT_SENSORS_NUMBER; i++)
+    {
+        if (!sensor_watch[i]) continue;
+
+        sensor_t sensor = static_cast<sensor_t>(i);
+        latest_raw_view_t& view =
+                watch_views[watch_count / LATEST_VIEW_MAX_CHANNELS];
+
+        /* Sensors not enabled have no value to watch */
+        int8_t slot = shield.sensors.addSensorToLatestView(view, sensor);
+        if (slot < 0) continue;
+
+        float32_t raw_scale =
+                data_conversion_get_raw_scale(view.adc_numbers[slot]);
+        float32_t raw_max = ADC_RAW_MAX / raw_scale;
+        if (raw_max > SAFETY_RAW_NO_VALUE - 1)
+        {
+            raw_max = SAFETY_RAW_NO_VALUE - 1;
+        }
+
+        watch_sensors[watch_count] = sensor;
+        safety_compute_raw_limits(_sensor_conversion,
+                                  &watch_sensors[watch_count],
+                                  (uint16_t)raw_max,
+                                  sensor_threshold_min[i],
+                                  sensor_threshold_max[i],
+                                  &watch_limits[watch_count]);
+
+        uint8_t adc = view.adc_numbers[slot];
+        uint8_t watchdog = _safety_sensor_watchdog(sensor, adc, raw_scale);
+        if (watchdog != 0)
+        {
+            safety_awd_window_t window;
+            safety_awd_compute_window(watchdog, &watch_limits[watch_count],
+                                      &window);
+            adc_set_analog_watchdog_thresholds(adc, watchdog,
+                                               window.low, window.high);
+            awd_used[adc][watchdog] = true;
+            sensor_awd[i] = true;
+        }
+        watch_adc[watch_count] = adc;
+        watch_awd[watch_count] = watchdog;
+        watch_count++;
+    }
+
+    const safety_raw_limits_t no_limits = { 0, ADC_RAW_MAX, true };
+    for (uint8_t adc = 1; adc <= SAFETY_AWD_ADCS; adc++)
+    {
+        for (uint8_t w = 1; w <= SAFETY_AWD_WATCHDOGS; w++)
+        {
+            if (awd_allocation.channel[adc][w] == 0 || awd_used[adc][w])
+                continue;
+
+            safety_awd_window_t window;
+            safety_awd_compute_window(w, &no_limits, &window);
+            adc_set_analog_watchdog_thresholds(adc, w,
+                                               window.low, window.high);
+        }
+    }
+}
+
+/**
+ * @brief Conversion of a 12-bit analog code (DAC and comparator inputs)
+ *        of the sensor given as context: the ADC raw code may have
+ *        oversampling bits.
+ */
+static float32_t _sensor_analog_conversion(uint16_t code, const void* context)
+{
+    const hw_trip_conversion_t* conversion =
+            (const hw_trip_conversion_t*)context;
+
+    return shield.sensors.convertRawValue(
+                conversion->sensor,
+                (uint16_t)(code / conversion->raw_scale));
+}
+
+/**
+ * @brief Writes the hardware trip register map: DAC thresholds, then
+ *        comparators, then HRTIM fault inputs. Outputs fault state can
+ *        only be written while outputs are disabled.
  */
-void _short_circuit(void)
+static void _safety_apply_hw_trip()
 {
-    if(DT_LEG_NUMBER == 0) return;
+    for (uint8_t dac = 1; dac <= SAFETY_HW_TRIP_DACS; dac++)
+    {
+        if (!hw_trip_registers.dac_enabled[dac]) continue;
+
+        spin.dac.initConstValue(dac);
+        spin.dac.setConstValue(dac, 1, hw_trip_registers.dac_code[dac]);
+    }
 
-    for(uint8_t i = 0; i < DT_LEG_NUMBER; i++)
+    for (uint8_t comp = 1; comp <= SAFETY_HW_TRIP_COMPARATORS; comp++)
     {
-        spin.gpio.configurePin(dt_pin_high_side[i], OUTPUT);
-        spin.gpio.configurePin(dt_pin_low_side[i], OUTPUT);
-        spin.gpio.resetPin(dt_pin_high_side[i]);
-        spin.gpio.setPin(dt_pin_low_side[i]);
+        if (!hw_trip_registers.comparator_enabled[comp]) continue;
 
+        spin.comp.initialize(comp);
+        LL_COMP_SetOutputPolarity(hw_trip_comparators[comp],
+                                  hw_trip_registers.comparator_inverted[comp]
+                                  ? LL_COMP_OUTPUTPOL_INVERTED
+                                  : LL_COMP_OUTPUTPOL_NONINVERTED);
+    }
+
+    uint32_t timer_faults = 0;
+    for (uint8_t fault = 1; fault <= SAFETY_HW_TRIP_FAULTS; fault++)
+    {
+        if (!hw_trip_registers.fault_enabled[fault]) continue;
+
+        LL_HRTIM_FLT_SetSrc(HRTIM1, hw_trip_faults[fault],
+                            LL_HRTIM_FLT_SRC_INTERNAL);
+        LL_HRTIM_FLT_SetPolarity(HRTIM1, hw_trip_faults[fault],
+                                 LL_HRTIM_FLT_POLARITY_HIGH);
+        LL_HRTIM_FLT_SetFilter(HRTIM1, hw_trip_faults[fault],
+                               LL_HRTIM_FLT_FILTER_NONE);
+        LL_HRTIM_FLT_Enable(HRTIM1, hw_trip_faults[fault]);
+
+        timer_faults |= hw_trip_faults[fault];
+    }
+
+    for (uint32_t timer : hw_trip_timers)
+    {
+        LL_HRTIM_TIM_EnableFault(HRTIM1, timer, timer_faults);
+    }
+
+    for (uint32_t output : hw_trip_outputs)
+    {
+        LL_HRTIM_OUT_SetFaultState(HRTIM1, output,
+                                   LL_HRTIM_OUT_FAULTSTATE_INACTIVE);
+    }
+}
+
+/**
+ * @brief Returns if an HRTIM fault input has been triggered
+ */
+static bool _safety_hw_fault_active(uint8_t fault)
+{
+    switch (fault)
+    {
+        case 1: return LL_HRTIM_IsActiveFlag_FLT1(HRTIM1);
+        case 2: return LL_HRTIM_IsActiveFlag_FLT2(HRTIM1);
+        case 3: return LL_HRTIM_IsActiveFlag_FLT3(HRTIM1);
+        case 4: return LL_HRTIM_IsActiveFlag_FLT4(HRTIM1);
+        case 5: return LL_HRTIM_IsActiveFlag_FLT5(HRTIM1);
+        case 6: return LL_HRTIM_IsActiveFlag_FLT6(HRTIM1);
+        default: return false;
+    }
+}
+
+/**
+ * @brief Clears an HRTIM fault input flag
+ */
+static void _safety_hw_fault_clear(uint8_t fault)
+{
+    switch (fault)
+    {
+        case 1: LL_HRTIM_ClearFlag_FLT1(HRTIM1); break;
+        case 2: LL_HRTIM_ClearFlag_FLT2(HRTIM1); break;
+        case 3: LL_HRTIM_ClearFlag_FLT3(HRTIM1); break;
+        case 4: LL_HRTIM_ClearFlag_FLT4(HRTIM1); break;
+        case 5: LL_HRTIM_ClearFlag_FLT5(HRTIM1); break;
+        case 6: LL_HRTIM_ClearFlag_FLT6(HRTIM1); break;
+        default: break;
     }
 }
 
 /**
- * @brief This function enables the open-circuit mode
- *        i.e. the high-side switch is opened and
- *        the low-side switch is opened.
+ * @brief Latches the sensors whose hardware trip fired
+ *
+ * @return `0` if no hardware trip fired, `-1` else.
  */
-void _open_circuit(void)
+static int8_t _safety_watch_hw_trip()
 {
-    if(DT_LEG_NUMBER == 0) return;
+    int8_t status = 0;
 
-    for(uint8_t i = 0; i < DT_LEG_NUMBER; i++)
+    for (uint8_t fault = 1; fault <= SAFETY_HW_TRIP_FAULTS; fault++)
     {
-        spin.gpio.configurePin(dt_pin_high_side[i], OUTPUT);
-        spin.gpio.configurePin(dt_pin_low_side[i], OUTPUT);
-        spin.gpio.resetPin(dt_pin_high_side[i]);
-        spin.gpio.resetPin(dt_pin_low_side[i]);
+        if (!hw_trip_registers.fault_enabled[fault]) continue;
 
+        if (_safety_hw_fault_active(fault))
+        {
+            sensor_t sensor = hw_trip_fault_sensors[fault];
+            hw_trip_errors[sensor] = true;
+            sensor_errors[sensor] = true;
+            status = -1;
+        }
     }
+
+    return status;
 }
 
 /**
@@ -166,6 +490,7 @@ int8_t safety_set_sensor_watch(sensor_t * safety_sensors,
     {
         sensor_watch[safety_sensors[i]] = true;
     }
+    watch_list_dirty = true;
 
     return 0;
 }
@@ -196,6 +521,7 @@ int8_t safety_unset_sensor_watch(sensor_t * safety_sensors,
     {
         sensor_watch[safety_sensors[i]] = false;
     }
+    watch_list_dirty = true;
 
     return 0;
 }
@@ -207,6 +533,7 @@ void safety_set_sensor_reaction(safety_reaction_t reaction)
 {
 
     sensor_reaction = reaction;
+    safety_arm_shutdown();
 }
 
 /**
@@ -237,6 +564,7 @@ int8_t safety_set_sensor_threshold_max(sensor_t *safety_sensors,
     {
         sensor_threshold_max[safety_sensors[i]] = threshold[i];
     }
+    watch_list_dirty = true;
 
     return 0;
 }
@@ -260,6 +588,7 @@ int8_t safety_set_sensor_threshold_min(sensor_t *safety_sensors,
     {
         sensor_threshold_min[safety_sensors[i]] = threshold[i];
     }
+    watch_list_dirty = true;
 
     return 0;
 }
@@ -293,23 +622,68 @@ bool safety_get_sensor_error(sensor_t safety_sensor)
  */
 int8_t safety_watch()
 {
-    uint8_t status = 0;
+    int8_t status = 0;
 
-    for (uint8_t i = 0; i < DT_SENSORS_NUMBER; i++)
+    if ( (watch_list_dirty) ||
+         (watch_list_revision != data_conversion_get_parameters_revision()) )
     {
-        if (sensor_watch[i])
+        _safety_build_watch_list();
+    }
+
+    /* Conversions flagged by the watchdogs since the last watch */
+    uint8_t awd_flags[SAFETY_AWD_ADCS + 1] = {};
+    if (awd_enabled)
+    {
+        for (uint8_t adc = 1; adc <= SAFETY_AWD_ADCS; adc++)
+        {
+            if (!awd_adc_used[adc]) continue;
+
+            awd_flags[adc] = adc_get_analog_watchdog_flags(adc);
+            if (awd_flags[adc] != 0)
+                adc_clear_analog_watchdog_flags(adc, awd_flags[adc]);
+        }
+    }
+
+    for (uint8_t v = 0; v < WATCH_VIEWS_NUMBER; v++)
+    {
+        latest_raw_view_t& view = watch_views[v];
+        if (view.count == 0) break;
+
+        bool check[LATEST_VIEW_MAX_CHANNELS];
+        bool any_check = false;
+        for (uint8_t slot = 0; slot < view.count; slot++)
         {
-            float32_t measure =
-                    shield.sensors.peekLatestValue(static_cast<sensor_t>(i));
-
-            if (measure != -10000){
-                sensor_errors[i] =
-                    (measure > sensor_threshold_max[i] ||
-                     measure < sensor_threshold_min[i])
-                     ? true
-                     : false;
+            uint8_t index = v * LATEST_VIEW_MAX_CHANNELS + slot;
+            uint8_t watchdog = watch_awd[index];
+            check[slot] = (watchdog == 0) ||
+                          (awd_flags[watch_adc[index]] & (1 << (watchdog - 1)));
+            any_check |= check[slot];
+        }
+
+        /* DataAPI not started yet: no value to watch */
+        if (any_check && shield.sensors.updateLatestView(view) != 0) continue;
+
+        for (uint8_t slot = 0; slot < view.count; slot++)
+        {
+            uint8_t index = v * LATEST_VIEW_MAX_CHANNELS + slot;
+            sensor_t sensor = watch_sensors[index];
+
+            if (!check[slot])
+            {
+                /* No conversion out of the window since the last watch */
+                sensor_errors[sensor] = false;
+                continue;
             }
-            if (sensor_errors[i])
+
+            uint16_t raw_value = *view.raw_values[slot];
+
+            /* Keep the previous decision until a value is acquired */
+            if (raw_value != SAFETY_RAW_NO_VALUE)
+            {
+                sensor_errors[sensor] =
+                        safety_raw_is_outside(&watch_limits[index], raw_value);
+            }
+            if (sensor_errors[sensor])
                 status = -1;
         }
     }
@@ -322,16 +696,52 @@ int8_t safety_watch()
  */
 void safety_action()
 {
-    /* shield.power.stopAll(); */
+    uint32_t trip_start = DWT->CYCCNT;
+
+    if (!shutdown_armed) safety_arm_shutdown();
+
+    hrtim_out_dis_all();
+    _safety_shutdown();
+
+    trip_latency_cycles = DWT->CYCCNT - trip_start;
+
+    /* Keeps the Power API state consistent, legs are already safe */
     shield.power.stop(ALL);
-    if (sensor_reaction == Open_Circuit)
-    {
-        _open_circuit();
-    }
-    else if (sensor_reaction == Short_Circuit)
-    {
-        _short_circuit();
-    }
+}
+
+/**
+ * @brief Precomputes the GPIO register values of the safety action
+ */
+int8_t safety_arm_shutdown()
+{
+    /* Enable cycle counter used to measure the trip latency */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    int8_t status = safety_compute_shutdown_masks(dt_pin_high_side,
+                                                  dt_pin_low_side,
+                                                  DT_LEG_NUMBER,
+                                                  sensor_reaction,
+                                                  &shutdown_masks);
+    shutdown_armed = true;
+
+    return status;
+}
+
+/**
+ * @brief Returns the latency of the last safety action
+ */
+uint32_t safety_get_trip_latency()
+{
+    return trip_latency_cycles;
+}
+
+/**
+ * @brief Returns the number of alerts since startup
+ */
+uint32_t safety_get_trip_count()
+{
+    return trip_count;
 }
 
 /**
@@ -350,6 +760,18 @@ void safety_disable_task()
     safety_enable = false;
 }
 
+/**
+ * @brief Counts the alerts: the task reports a fault on every call until
+ *        it disappears, only its first report is a new alert.
+ */
+static int8_t _safety_count_alert(int8_t status)
+{
+    if (status != 0 && !alert_active) trip_count++;
+    alert_active = (status != 0);
+
+    return status;
+}
+
 /**
  * @brief Function that need to be put in the fast uninterruptible task.
  *        It monitors the measures from the ADC, and trigger safety warning.
@@ -360,6 +782,13 @@ int8_t safety_task()
 {
     int8_t status = 0;
 
+    /* Outputs are already stopped by the hardware, no delay here */
+    if (_safety_watch_hw_trip() != 0)
+    {
+        if (safety_enable) safety_action();
+        return _safety_count_alert(-1);
+    }
+
     if(safety_enable){
         status = safety_watch();
 
@@ -372,10 +801,158 @@ int8_t safety_task()
         else safety_alert_counter = 0;
     }
 
-    return status;
+    return _safety_count_alert(status);
 }
 
 
+/**
+ * @brief Offloads the watch to the ADC analog watchdogs
+ */
+int8_t safety_set_adc_watchdog(bool enable)
+{
+    if (spin.data.started())
+    {
+        printk("ERROR: ADC watchdogs must be set before data acquisition\n");
+        return -1;
+    }
+
+    memset(&awd_allocation, 0, sizeof(awd_allocation));
+    memset(awd_adc_used, 0, sizeof(awd_adc_used));
+
+    int8_t offloaded = 0;
+    for (uint8_t i = 1; enable && i <= DT_SENSORS_NUMBER; i++)
+    {
+        if (!sensor_watch[i]) continue;
+
+        sensor_t sensor = static_cast<sensor_t>(i);
+        sensor_info_t info = shield.sensors.getEnabledSensorInfo(sensor);
+        if (info.pin_num == 0) continue;
+
+        /* Other sensors of a full ADC are watched by software */
+        int8_t watchdog = safety_awd_allocate(info.adc_num, info.channel_num,
+                                              &awd_allocation);
+        if (watchdog < 0) continue;
+
+        awd_sensors[info.adc_num][watchdog] = sensor;
+        awd_adc_used[info.adc_num] = true;
+        offloaded++;
+    }
+
+    for (uint8_t adc = 1; adc <= SAFETY_AWD_ADCS; adc++)
+    {
+        for (uint8_t w = 1; w <= SAFETY_AWD_WATCHDOGS; w++)
+        {
+            adc_configure_analog_watchdog(adc, w,
+                                          awd_allocation.channel[adc][w]);
+        }
+    }
+
+    awd_enabled = enable;
+    watch_list_dirty = true;
+
+    return offloaded;
+}
+
+/**
+ * @brief Returns if a sensor has an ADC analog watchdog
+ */
+bool safety_get_adc_watchdog(sensor_t safety_sensor)
+{
+    return sensor_awd[safety_sensor];
+}
+
+/**
+ * @brief Sets the hardware overcurrent trip of sensors
+ */
+int8_t safety_set_hw_trip(sensor_t* safety_sensors,
+                          float32_t* threshold,
+                          uint8_t sensors_number)
+{
+    /* Outputs fault state is ignored while they are enabled */
+    for (uint32_t output : hw_trip_outputs)
+    {
+        if (LL_HRTIM_IsEnabledOutput(HRTIM1, output))
+        {
+            printk("ERROR: hardware trip must be set while outputs are stopped
+");
+            return -1;
+        }
+    }
+
+    safety_hw_trip_registers_t registers;
+    memset(&registers, 0, sizeof(registers));
+
+    for (uint8_t i = 0; i < sensors_number; i++)
+    {
+        sensor_info_t info =
+                shield.sensors.getEnabledSensorInfo(safety_sensors[i]);
+        if (info.pin_num == 0)
+        {
+            printk("ERROR: hardware trip sensor is not enabled\n");
+            return -1;
+        }
+
+        safety_hw_trip_route_t route;
+        if (safety_hw_trip_get_route(gpio_pin_map_get_port(info.pin_num),
+                                     gpio_pin_map_get_pin_number(info.pin_num),
+                                     &route) != 0)
+        {
+            printk("ERROR: hardware trip sensor pin has no comparator\n");
+            return -1;
+        }
+
+        hw_trip_conversion_t conversion;
+        conversion.sensor = safety_sensors[i];
+        conversion.raw_scale = data_conversion_get_raw_scale(info.adc_num);
+        uint16_t dac_code;
+        bool inverted;
+        if (safety_hw_trip_compute_dac_code(_sensor_analog_conversion,
+                                            &conversion, threshold[i],
+                                            &dac_code, &inverted) != 0)
+        {
+            printk("ERROR: hardware trip threshold out of sensor range\n");
+            return -1;
+        }
+
+        if (safety_hw_trip_add_sensor(&route, dac_code, inverted,
+                                      &registers) != 0)
+        {
+            printk("ERROR: hardware trip comparator already used\n");
+            return -1;
+        }
+        hw_trip_fault_sensors[route.fault] = safety_sensors[i];
+    }
+
+    hw_trip_registers = registers;
+    _safety_apply_hw_trip();
+
+    return 0;
+}
+
+/**
+ * @brief Returns if the hardware trip of a sensor fired
+ */
+bool safety_get_hw_trip_error(sensor_t safety_sensor)
+{
+    return hw_trip_errors[safety_sensor];
+}
+
+/**
+ * @brief Clears the latched hardware trips
+ */
+void safety_clear_hw_trip_errors()
+{
+    for (uint8_t fault = 1; fault <= SAFETY_HW_TRIP_FAULTS; fault++)
+    {
+        if (!hw_trip_registers.fault_enabled[fault]) continue;
+
+        _safety_hw_fault_clear(fault);
+        sensor_t sensor = hw_trip_fault_sensors[fault];
+        hw_trip_errors[sensor] = false;
+        sensor_errors[sensor] = false;
+    }
+}
+
 /**
  * @brief Stores threshold value in the NVS
  */
@@ -450,6 +1027,8 @@ int8_t  safety_retrieve_threshold_in_nvs(sensor_t sensor)
 
             sensor_threshold_max[sensor] =
                                     *((float32_t*)&buffer[string_len + 2 + 4]);
+
+            watch_list_dirty = true;
 		}
 	}
 	else
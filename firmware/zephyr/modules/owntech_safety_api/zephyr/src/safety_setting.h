@@ -179,6 +179,11 @@ bool safety_get_sensor_error(sensor_t safety_sensor);
  * @brief Monitors all the sensor set as watchable and compare them
  *        with the chosen thresholds.
  *
+ * @note  Thresholds are converted into raw ADC codes when they, the
+ *        watched sensors or the conversion parameters change: the watch
+ *        itself only compares the latest raw values, with the same
+ *        decisions as comparing converted values.
+ *
  * @return `0` if all the sensors are within their threshold, 
  *        `-1` if any one of them went under/over the threshold.
  */
@@ -188,10 +193,110 @@ int8_t safety_watch();
  * @brief Enables the open-circuit or the short-circuit mode
  *        if an error has been detected.
  *
+ * @note  All HRTIM outputs are disabled, then each GPIO port with a
+ *        switch pin gets its pre-armed BSRR and MODER values, see
+ *        safety_arm_shutdown().
+ *
  * @return none
  */
 void safety_action();
 
+/**
+ * @brief Precomputes the GPIO register values forcing all legs in the
+ *        reaction state, from the devicetree pin tables. Called when
+ *        initializing the shield and when the reaction changes.
+ *
+ * @return `0` if all the switch pins are known, `-1` else.
+ */
+int8_t safety_arm_shutdown();
+
+/**
+ * @brief Gets the latency of the last safety action, from the trip to
+ *        all legs being safe.
+ *
+ * @return Latency in CPU cycles, `0` if no safety action happened.
+ */
+uint32_t safety_get_trip_latency();
+
+/**
+ * @brief Gets the number of safety alerts since startup. An alert starts
+ *        when safety_task() reports a fault and lasts as long as it keeps
+ *        reporting it.
+ *
+ * @return Number of alerts.
+ */
+uint32_t safety_get_trip_count();
+
+/**
+ * @brief Sets the hardware overcurrent trip of sensors: a comparator
+ *        compares the sensor pin to a DAC threshold, and its output is an
+ *        HRTIM fault input forcing all outputs inactive within
+ *        nanoseconds, without waiting for the control task.
+ *
+ * @note  Only sensors on a comparator input can be protected (`PA1` and
+ *        `PC1`). Must be called while the outputs are stopped: their
+ *        fault state can not be written otherwise.
+ *
+ * @param safety_sensors List of sensors to protect.
+ * @param threshold List of maximum values, converted with the current
+ *        sensor calibration.
+ * @param sensors_number Number of sensors in the lists.
+ *
+ * @return `0` if successful, `-1` if an output is running, if a sensor
+ *         is not enabled, has no comparator, shares it with another one,
+ *         or if its threshold is out of the measurement range.
+ */
+int8_t safety_set_hw_trip(sensor_t* safety_sensors,
+                          float32_t* threshold,
+                          uint8_t sensors_number);
+
+/**
+ * @brief Returns if the hardware trip of a sensor fired. The fault stays
+ *        latched until safety_clear_hw_trip_errors() is called.
+ *
+ * @param safety_sensor Protected sensor.
+ *
+ * @return true if the hardware trip fired, false if not
+ */
+bool safety_get_hw_trip_error(sensor_t safety_sensor);
+
+/**
+ * @brief Clears the latched hardware trips. Outputs are restarted by
+ *        starting the legs again.
+ */
+void safety_clear_hw_trip_errors();
+
+/**
+ * @brief Offloads the watch of the watched sensors to the ADC analog
+ *        watchdogs: the watch then only reads their flags, and checks
+ *        the value of a sensor when its watchdog flagged a conversion.
+ *        Sensors beyond the 3 watchdogs of their ADC, on an ADC with
+ *        oversampling, or watched after this call are watched by
+ *        software.
+ *
+ * @note  Must be called after the sensors are enabled and watched, and
+ *        before the data acquisition is started: channels of the
+ *        watchdogs can not be changed during conversions.
+ *
+ * @param enable true to offload the watch, false to watch all the
+ *        sensors by software (default).
+ *
+ * @return Number of sensors with a watchdog, `-1` if the data
+ *         acquisition is already started.
+ */
+int8_t safety_set_adc_watchdog(bool enable);
+
+/**
+ * @brief Returns if a sensor was watched by an ADC analog watchdog at
+ *        the last watch.
+ *
+ * @param safety_sensor Watched sensor.
+ *
+ * @return true if the sensor has a watchdog, false if it is watched by
+ *         software
+ */
+bool safety_get_adc_watchdog(sensor_t safety_sensor);
+
 /**
  * @brief Enable the safety API fault detection task
  *
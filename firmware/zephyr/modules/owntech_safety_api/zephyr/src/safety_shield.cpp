@@ -97,4 +97,6 @@ void safety_init_shield(bool watch_all)
             safety_set_sensor_watch(&( dt_threshold_props[i].sensor ), 1);
         }
     }
+
+    safety_arm_shutdown();
 }
@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Computation of the emergency shutdown GPIO register masks
+ */
+
+#include <string.h>
+
+#include "safety_shutdown.h"
+
+/* MODER value of a general purpose output */
+#define GPIO_MODER_OUTPUT 0x1UL
+
+/* BSRR reset bits are above set bits */
+#define GPIO_BSRR_RESET_SHIFT 16
+
+/**
+ * @brief Adds a pin and its safe level to the masks.
+ *
+ * @return 0 if the pin is known, -1 else.
+ */
+static int8_t _safety_add_pin(uint8_t pin,
+                              bool level,
+                              safety_shutdown_masks_t* masks)
+{
+    uint8_t port = gpio_pin_map_get_port(pin);
+    uint8_t pin_number = gpio_pin_map_get_pin_number(pin);
+
+    if (port == GPIO_PIN_MAP_INVALID || pin_number == GPIO_PIN_MAP_INVALID)
+    {
+        return -1;
+    }
+
+    safety_port_shutdown_t& port_masks = masks->ports[port];
+
+    port_masks.moder_mask |= 0x3UL << (2 * pin_number);
+    port_masks.moder_output |= GPIO_MODER_OUTPUT << (2 * pin_number);
+    port_masks.bsrr |= level ? (1UL << pin_number)
+                             : (1UL << (pin_number + GPIO_BSRR_RESET_SHIFT));
+
+    return 0;
+}
+
+int8_t safety_compute_shutdown_masks(const uint8_t* pins_high,
+                                     const uint8_t* pins_low,
+                                     uint8_t leg_number,
+                                     safety_reaction_t reaction,
+                                     safety_shutdown_masks_t* masks)
+{
+    int8_t status = 0;
+
+    memset(masks, 0, sizeof(safety_shutdown_masks_t));
+
+    for (uint8_t i = 0; i < leg_number; i++)
+    {
+        if (_safety_add_pin(pins_high[i], false, masks) != 0)
+        {
+            status = -1;
+        }
+        if (_safety_add_pin(pins_low[i], reaction == Short_Circuit,
+                            masks) != 0)
+        {
+            status = -1;
+        }
+    }
+
+    return status;
+}
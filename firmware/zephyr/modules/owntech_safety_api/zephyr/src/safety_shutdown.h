@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2024-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date 2024
+ *
+ * @brief Pre-armed emergency shutdown: GPIO register masks forcing the
+ *        switches of all legs to their safe state. Masks are computed
+ *        once from the devicetree pin tables, so that a trip only writes
+ *        BSRR and MODER of each port. This file does not depend on the
+ *        hardware, and is also built for the host.
+ */
+
+#ifndef SAFETY_SHUTDOWN_H_
+#define SAFETY_SHUTDOWN_H_
+
+#include <stdint.h>
+
+#include "safety_enum.h"
+#include "gpio_pin_map.h"
+
+/**
+ * Register values of a GPIO port for the shutdown. A port with an empty
+ * moder_mask has no switch pin and is left untouched.
+ */
+typedef struct
+{
+    uint32_t moder_mask;    /* MODER bits of the switch pins */
+    uint32_t moder_output;  /* General purpose output mode of these pins */
+    uint32_t bsrr;          /* Safe level of these pins */
+} safety_port_shutdown_t;
+
+typedef struct
+{
+    safety_port_shutdown_t ports[GPIO_PIN_MAP_PORTS];
+} safety_shutdown_masks_t;
+
+/**
+ * @brief Computes the GPIO register values forcing all legs in the
+ *        reaction state: high-side switches are always opened, low-side
+ *        switches are opened in Open_Circuit and closed in Short_Circuit.
+ *
+ * @param pins_high Spin pin numbers of the high-side switches.
+ * @param pins_low Spin pin numbers of the low-side switches.
+ * @param leg_number Number of legs in both tables.
+ * @param reaction Safe state of the legs.
+ * @param[out] masks Register values for each port.
+ *
+ * @return 0 if all pins are known, -1 else. Unknown pins are left out.
+ */
+int8_t safety_compute_shutdown_masks(const uint8_t* pins_high,
+                                     const uint8_t* pins_low,
+                                     uint8_t leg_number,
+                                     safety_reaction_t reaction,
+                                     safety_shutdown_masks_t* masks);
+
+#endif /* SAFETY_SHUTDOWN_H_ */
@@ -87,6 +87,9 @@ void PowerAPI::initMode(leg_t leg,
 
     for (int8_t i = startIndex; i < endIndex; i++)
     {
+        leg_tu_number[i] = spinNumberToTu(dt_pwm_pin[i]);
+        leg_initialized[i] = true;
+
         /* Configure PWM frequency */
         spin.pwm.initVariableFrequency(timer_frequency, timer_min_frequency);
 
@@ -214,16 +217,54 @@ void PowerAPI::setDutyCycle(leg_t leg, float32_t duty_value)
     setDutyCycleRaw(leg, value);
 }
 
-void PowerAPI::setDutyCycleRaw(leg_t leg, uint16_t duty_value)
+void PowerAPI::writeDutyCycleRaw(hrtim_tu_number_t leg_tu,
+                                 uint16_t duty_value)
 {
     uint16_t period;
     uint8_t swap_state;
-    hrtim_tu_number_t leg_tu;
     uint16_t duty_cycle_max_raw;
     uint16_t duty_cycle_min_raw;
 
+    duty_cycle_max_raw = tu_channel[leg_tu]->pwm_conf.duty_max_user;
+    duty_cycle_min_raw = tu_channel[leg_tu]->pwm_conf.duty_min_user;
+
+    /* Clamp the duty cycle to be within the range min to max */
+    if (duty_value > duty_cycle_max_raw)
+    {
+        duty_value = duty_cycle_max_raw;
+    }
+    else if (duty_value < duty_cycle_min_raw)
+    {
+        duty_value = duty_cycle_min_raw;
+    }
+
+    period = tu_channel[leg_tu]->pwm_conf.period;
+    swap_state = tu_channel[leg_tu]->pwm_conf.duty_swap;
+
+    /* Implements a logic that allows for a duty cycle of 100% */
+    if (duty_value >= period-3){
+        duty_value = 0;
+        hrtim_duty_cycle_set(leg_tu, duty_value);
+
+        if(swap_state == false){
+            hrtim_output_hot_swap(leg_tu);
+        }
+    }
+    else
+    {
+        if(swap_state == true) {
+            hrtim_duty_cycle_set(leg_tu, duty_value);
+            hrtim_output_hot_swap(leg_tu);
+        }else{
+            hrtim_duty_cycle_set(leg_tu, duty_value);
+        }
+    }
+}
+
+void PowerAPI::setDutyCycleRaw(leg_t leg, uint16_t duty_value)
+{
     int8_t startIndex = 0;
-    int8_t endIndex = 0;    
+    int8_t endIndex = 0;
 
     /*  If ALL is selected, loop through all legs */
     if (leg == ALL)
@@ -240,43 +281,45 @@ void PowerAPI::setDutyCycleRaw(leg_t leg, uint16_t duty_value)
 
     for (int8_t i = startIndex; i < endIndex; i++)
     {
-        leg_tu = spinNumberToTu(dt_pwm_pin[i]);
+        writeDutyCycleRaw(spinNumberToTu(dt_pwm_pin[i]), duty_value);
+    }
+}
+
+bool PowerAPI::isLegInitialized(leg_t leg)
+{
+    return leg < ALL && leg_initialized[leg];
+}
 
-        duty_cycle_max_raw = tu_channel[leg_tu]->pwm_conf.duty_max_user;
-        duty_cycle_min_raw = tu_channel[leg_tu]->pwm_conf.duty_min_user;
+void PowerAPI::setDutyCycles(const leg_duty_cycle_t* duty_cycles,
+                             uint8_t count)
+{
+    uint32_t timers = 0;
 
-        /* Clamp the duty cycle to be within the range min to max */
-        if (duty_value > duty_cycle_max_raw)
-        {
-            duty_value = duty_cycle_max_raw;
-        }
-        else if (duty_value < duty_cycle_min_raw)
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (isLegInitialized(duty_cycles[i].leg))
         {
-            duty_value = duty_cycle_min_raw;
+            hrtim_tu_number_t tu = leg_tu_number[duty_cycles[i].leg];
+            timers |= tu_channel[tu]->pwm_conf.pwm_tu;
         }
-        
-        period = tu_channel[leg_tu]->pwm_conf.period;
-        swap_state = tu_channel[leg_tu]->pwm_conf.duty_swap;
+    }
 
-        /* Implements a logic that allows for a duty cycle of 100% */
-        if (duty_value >= period-3){
-            duty_value = 0;
-            hrtim_duty_cycle_set(leg_tu, duty_value);
-        
-            if(swap_state == false){ 
-                hrtim_output_hot_swap(leg_tu);
-            }        
-        }
-        else
-        {    
-            if(swap_state == true) {
-                hrtim_duty_cycle_set(leg_tu, duty_value);
-                hrtim_output_hot_swap(leg_tu);
-            }else{
-                hrtim_duty_cycle_set(leg_tu, duty_value);
-            }
+    /* Compares written from now on are held in the preload registers */
+    hrtim_update_dis(timers);
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!isLegInitialized(duty_cycles[i].leg))
+        {
+            continue;
         }
+        hrtim_tu_number_t tu = leg_tu_number[duty_cycles[i].leg];
+        uint16_t period = tu_channel[tu]->pwm_conf.period;
+        writeDutyCycleRaw(tu, duty_cycles[i].duty_value * period);
     }
+
+    /* All the legs take their new duty cycle at the same update event */
+    hrtim_update_en(timers);
 }
 
 void PowerAPI::start(leg_t leg)
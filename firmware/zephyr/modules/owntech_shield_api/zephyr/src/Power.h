@@ -50,12 +50,31 @@ typedef enum
 	ALL
 } leg_t;
 
+/**
+ * @brief Duty cycle of a leg, as given to `PowerAPI::setDutyCycles()`
+ */
+typedef struct
+{
+	leg_t leg;
+	float32_t duty_value;
+} leg_duty_cycle_t;
+
 class PowerAPI
 {
 private:
 	/* return timing unit from spin pin number */
 	hrtim_tu_number_t spinNumberToTu(uint16_t spin_number);
 
+	/* clamp and write a raw duty cycle, with the 100% hot swap logic */
+	void writeDutyCycleRaw(hrtim_tu_number_t leg_tu, uint16_t duty_value);
+
+	/* timing unit of each leg, set by initMode() */
+	hrtim_tu_number_t leg_tu_number[ALL];
+	bool leg_initialized[ALL] = {};
+
+	/* true if initMode() was called for the leg, false for ALL */
+	bool isLegInitialized(leg_t leg);
+
 
 public:
 	/**
@@ -103,6 +122,36 @@ public:
 	 */
 	void setDutyCycleRaw(leg_t leg, uint16_t duty_value);
 
+	/**
+	 * @brief Set the duty cycles of several legs at once.
+	 *
+	 * Register update of the legs timing units is disabled while their
+	 * compares are written, then enabled again in a single write: all the
+	 * legs switch to their new duty cycle on the same carrier update,
+	 * where separate `setDutyCycle()` calls may be split by an update
+	 * event, e.g. for the two legs of an H-bridge.
+	 *
+	 * @param duty_cycles Legs and duty cycles, as in `setDutyCycle()`.
+	 * 					  `ALL` is NOT supported.
+	 * @param count Number of legs in duty_cycles.
+	 *
+	 * @note Legs not initialized by `initMode()` are ignored.
+	 */
+	void setDutyCycles(const leg_duty_cycle_t* duty_cycles, uint8_t count);
+
+	/**
+	 * @brief Set the duty cycles of several legs at once, e.g.
+	 * 		  `setDutyCycles({{LEG1, duty_1}, {LEG2, duty_2}})`
+	 *
+	 * @param duty_cycles Legs and duty cycles, as in `setDutyCycle()`.
+	 * 					  `ALL` is NOT supported.
+	 */
+	template <size_t N>
+	void setDutyCycles(const leg_duty_cycle_t (&duty_cycles)[N])
+	{
+		setDutyCycles(duty_cycles, N);
+	}
+
 
 	/**
 	 * @brief Start power output for a specific leg.
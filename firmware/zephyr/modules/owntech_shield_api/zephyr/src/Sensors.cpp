@@ -136,12 +136,24 @@ SensorsAPI::sensor_dt_data_t* SensorsAPI::enabled_sensors[DT_SENSORS_COUNT] = {0
 
 bool SensorsAPI::initialized = false;
 
+uint32_t  SensorsAPI::snapshot_plan_revision = 0;
+bool      SensorsAPI::snapshot_plan_built = false;
+uint8_t   SensorsAPI::snapshot_linear_count = 0;
+sensor_t  SensorsAPI::snapshot_linear_sensors[SENSORS_COUNT] = {UNDEFINED_SENSOR};
+float32_t SensorsAPI::snapshot_linear_gains[SENSORS_COUNT] = {0};
+float32_t SensorsAPI::snapshot_linear_offsets[SENSORS_COUNT] = {0};
+uint8_t   SensorsAPI::snapshot_other_count = 0;
+sensor_t  SensorsAPI::snapshot_other_sensors[SENSORS_COUNT] = {UNDEFINED_SENSOR};
+
 
 /**
  *  Public functions accessible only when using a power shield
  */
 
-int8_t SensorsAPI::enableSensor(sensor_t sensor_name, adc_t adc_num)
+int8_t SensorsAPI::enableSensor(sensor_t sensor_name,
+								adc_t adc_num,
+								uint16_t oversampling_ratio,
+								uint8_t oversampling_shift)
 {
 	if (initialized == false)
 	{
@@ -176,6 +188,17 @@ int8_t SensorsAPI::enableSensor(sensor_t sensor_name, adc_t adc_num)
 	enabled_sensors[sensor_index] = sensor_prop;
 
 
+	/* Oversampling applies to all channels of the ADC */
+	if (oversampling_ratio != 0)
+	{
+		if (spin.data.configureOversampling(adc_num,
+											oversampling_ratio,
+											oversampling_shift) != 0)
+		{
+			return -1;
+		}
+	}
+
 	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
 	return DataAPI::enableChannel(sensor_info.adc_num, sensor_info.channel_num);
 }
@@ -200,6 +223,16 @@ float32_t* SensorsAPI::getValues(sensor_t sensor_name,
 									 number_of_values_acquired);
 }
 
+q15_t* SensorsAPI::getValuesQ15(sensor_t sensor_name,
+								uint32_t& number_of_values_acquired)
+{
+	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
+
+	return DataAPI::getChannelValuesQ15(sensor_info.adc_num,
+										sensor_info.channel_num,
+										number_of_values_acquired);
+}
+
 float32_t SensorsAPI::peekLatestValue(sensor_t sensor_name)
 {
 	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
@@ -208,13 +241,101 @@ float32_t SensorsAPI::peekLatestValue(sensor_t sensor_name)
 								sensor_info.channel_num);
 }
 
-float32_t SensorsAPI::getLatestValue(sensor_t sensor_name, uint8_t* dataValid)
+float32_t SensorsAPI::getLatestValue(sensor_t sensor_name,
+									 uint8_t* dataValid,
+									 uint32_t* timestamp)
 {
 	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
 
 	return DataAPI::getChannelLatest(sensor_info.adc_num,
 									 sensor_info.channel_num,
-									 dataValid);
+									 dataValid,
+									 timestamp);
+}
+
+void SensorsAPI::getLatestValues(sensors_snapshot_t& snapshot)
+{
+	if ( (snapshot_plan_built == false) ||
+		 (snapshot_plan_revision != data_conversion_get_parameters_revision()) )
+	{
+		buildSnapshotPlan();
+	}
+
+	snapshot.sequence = DataAPI::getDispatchSequence();
+
+	for (uint8_t sensor = 0 ; sensor <= SENSORS_COUNT ; sensor++)
+	{
+		snapshot.values[sensor]     = NO_VALUE;
+		snapshot.data_valid[sensor] = DATA_IS_MISSING;
+	}
+
+	/* Linear sensors: gather raw values, then convert them as a batch */
+	float32_t raw_values[SENSORS_COUNT];
+	float32_t converted_values[SENSORS_COUNT];
+
+	for (uint8_t i = 0 ; i < snapshot_linear_count ; i++)
+	{
+		sensor_t sensor = snapshot_linear_sensors[i];
+		sensor_dt_data_t* sensor_prop = enabled_sensors[sensor-1];
+
+		raw_values[i] =
+			DataAPI::getChannelLatestRaw((adc_t)sensor_prop->adc_number,
+										 sensor_prop->channel_number,
+										 &snapshot.data_valid[sensor]);
+	}
+
+	arm_mult_f32(raw_values,
+				 snapshot_linear_gains,
+				 converted_values,
+				 snapshot_linear_count);
+	arm_add_f32(converted_values,
+				snapshot_linear_offsets,
+				converted_values,
+				snapshot_linear_count);
+
+	for (uint8_t i = 0 ; i < snapshot_linear_count ; i++)
+	{
+		sensor_t sensor = snapshot_linear_sensors[i];
+		if (snapshot.data_valid[sensor] != DATA_IS_MISSING)
+		{
+			snapshot.values[sensor] = converted_values[i];
+		}
+	}
+
+	/* Other sensors are converted one by one */
+	for (uint8_t i = 0 ; i < snapshot_other_count ; i++)
+	{
+		sensor_t sensor = snapshot_other_sensors[i];
+		sensor_dt_data_t* sensor_prop = enabled_sensors[sensor-1];
+
+		uint16_t raw_value =
+			DataAPI::getChannelLatestRaw((adc_t)sensor_prop->adc_number,
+										 sensor_prop->channel_number,
+										 &snapshot.data_valid[sensor]);
+
+		if (snapshot.data_valid[sensor] != DATA_IS_MISSING)
+		{
+			snapshot.values[sensor] =
+				data_conversion_convert_raw_value(sensor_prop->adc_number,
+												  sensor_prop->channel_number,
+												  raw_value);
+		}
+	}
+}
+
+int8_t SensorsAPI::addSensorToLatestView(latest_raw_view_t& view,
+										 sensor_t sensor_name)
+{
+	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
+
+	return DataAPI::addChannelToLatestView(view,
+										   sensor_info.adc_num,
+										   sensor_info.channel_num);
+}
+
+int8_t SensorsAPI::updateLatestView(latest_raw_view_t& view)
+{
+	return DataAPI::refreshLatestView(view);
 }
 
 float32_t SensorsAPI::convertRawValue(sensor_t sensor_name, uint16_t raw_value)
@@ -245,6 +366,20 @@ void SensorsAPI::setConversionParametersLinear(sensor_t sensor_name,
 	}
 }
 
+int8_t SensorsAPI::enableFixedPointConversion(sensor_t sensor_name,
+											  float32_t full_scale)
+{
+	sensor_info_t sensor_info = getEnabledSensorInfo(sensor_name);
+	if (sensor_info.channel_num == 0)
+	{
+		return -1;
+	}
+
+	return data_conversion_set_q15_full_scale(sensor_info.adc_num,
+											  sensor_info.channel_num,
+											  full_scale);
+}
+
 void SensorsAPI::setConversionParametersNtcThermistor(sensor_t sensor_name,
 													  float32_t r0,
 													  float32_t b,
@@ -620,6 +755,52 @@ void SensorsAPI::setTwistSensorsUserCalibrationFactors()
 
 
 
+void SensorsAPI::buildSnapshotPlan()
+{
+	if (initialized == false)
+	{
+		buildSensorListFromDeviceTree();
+	}
+
+	snapshot_linear_count = 0;
+	snapshot_other_count  = 0;
+
+	for (uint8_t sensor = 1 ; sensor <= SENSORS_COUNT ; sensor++)
+	{
+		sensor_dt_data_t* sensor_prop = enabled_sensors[sensor-1];
+		if (sensor_prop == nullptr)
+			continue;
+
+		conversion_type_t conversion_type =
+			data_conversion_get_conversion_type(sensor_prop->adc_number,
+												sensor_prop->channel_number);
+
+		if (conversion_type == conversion_linear)
+		{
+			uint8_t i = snapshot_linear_count;
+			snapshot_linear_sensors[i] = (sensor_t)sensor;
+			snapshot_linear_gains[i]   =
+				data_conversion_get_parameter(sensor_prop->adc_number,
+											  sensor_prop->channel_number,
+											  1) *
+				data_conversion_get_raw_scale(sensor_prop->adc_number);
+			snapshot_linear_offsets[i] =
+				data_conversion_get_parameter(sensor_prop->adc_number,
+											  sensor_prop->channel_number,
+											  2);
+			snapshot_linear_count++;
+		}
+		else
+		{
+			snapshot_other_sensors[snapshot_other_count] = (sensor_t)sensor;
+			snapshot_other_count++;
+		}
+	}
+
+	snapshot_plan_revision = data_conversion_get_parameters_revision();
+	snapshot_plan_built    = true;
+}
+
 sensor_info_t SensorsAPI::getEnabledSensorInfo(sensor_t sensor_name)
 {
 	if (initialized == false)
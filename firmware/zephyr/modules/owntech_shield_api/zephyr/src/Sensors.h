@@ -49,6 +49,7 @@
 /* Device-tree related macro */
 
 #define SENSOR_TOKEN(node_id) DT_STRING_TOKEN(node_id, sensor_name),
+#define SENSOR_COUNTER(node_id) +1
 
 
 /* Type definitions */
@@ -59,6 +60,22 @@ typedef enum
 	DT_FOREACH_STATUS_OKAY(shield_sensors, SENSOR_TOKEN)
 } sensor_t;
 
+/* Number of sensors defined by the shield */
+const uint8_t SENSORS_COUNT =
+				0 DT_FOREACH_STATUS_OKAY(shield_sensors, SENSOR_COUNTER);
+
+/**
+ * Snapshot of the latest values of all enabled sensors.
+ * Arrays are indexed by sensor name, e.g. values[V1_LOW].
+ * Sensors that are not enabled are always DATA_IS_MISSING.
+ */
+typedef struct
+{
+	float32_t values[SENSORS_COUNT + 1];
+	uint8_t   data_valid[SENSORS_COUNT + 1];
+	uint32_t  sequence;
+} sensors_snapshot_t;
+
 struct sensor_info_t
 {
 	sensor_info_t(adc_t adc_num, uint8_t channel_num, uint8_t pin_num)
@@ -136,11 +153,20 @@ public:
 	 *
 	 * @param[in] sensor_name Name of the sensor using enumeration sensor_t.
 	 * @param[in] adc_number The ADC which should be used for acquisition.
+	 * @param[in] oversampling_ratio Hardware oversampling ratio of the
+	 *            ADC, power of 2 from 1 to 256. As oversampling applies
+	 *            to all channels of the ADC, 0 (default) leaves the ADC
+	 *            configuration unchanged.
+	 * @param[in] oversampling_shift Right shift applied to the
+	 *            oversampled sum, from 0 to 8.
 	 *
 	 * @return 0 if the sensor was correctly enabled, negative value
 	 * 		   if there was an error.
 	 */
-	int8_t enableSensor(sensor_t sensor_name, adc_t adc_number);
+	int8_t enableSensor(sensor_t sensor_name,
+						adc_t adc_number,
+						uint16_t oversampling_ratio = 0,
+						uint8_t oversampling_shift = 0);
 
 	/**
 	 * @brief Function to access the acquired data for specified sensor.
@@ -240,6 +266,29 @@ public:
 	float32_t* getValues(sensor_t sensor_name,
 						 uint32_t& number_of_values_acquired);
 
+	/**
+	 * @brief Function to access the acquired data for specified sensor as
+	 *        fixed-point values. Works as getValues(), but values are
+	 *        expressed in Q15 format relative to the sensor full scale:
+	 *        a value v represents v * full_scale / 32768 in the relevant
+	 *        unit for the sensor.
+	 *
+	 * @note  Fixed-point conversion must have been enabled for the sensor
+	 *        using enableFixedPointConversion().
+	 *
+	 * @param[in]  sensor_name Name of the shield sensor from which to
+	 *             obtain values.
+	 * @param[out] number_of_values_acquired Pass an `uint32_t` variable.
+	 *             This variable will be updated with the number of values
+	 *             that are present in the returned buffer.
+	 *
+	 * @return Pointer to an array in which the acquired values are stored.
+	 *         If `number_of_values_acquired` is 0, do not try to access the
+	 *         buffer as it may be nullptr.
+	 */
+	q15_t* getValuesQ15(sensor_t sensor_name,
+						uint32_t& number_of_values_acquired);
+
 	/**
 	 * @brief Function to access the latest value available from the sensor.
 	 * 			
@@ -292,12 +341,81 @@ public:
 	 * 
 	 * - `DATA_IS_MISSING` if returned data is `NO_VALUE`.
 	 *
+	 * @param timestamp Pointer to an `uint32_t` variable.
+	 *
+	 * This parameter is optional.
+	 *
+	 * If this parameter is provided, it will be updated with the
+	 * timestamp of the latest dispatch of the sensor ADC, see
+	 * spin.data.getTimestampFrequency().
+	 *
 	 * @return Latest measure acquired by the sensor.
 	 * 
 	 * If no value was acquired by this sensor yet, return value is `NO_VALUE`.
 	 *
 	 */
-	float32_t getLatestValue(sensor_t sensor_name, uint8_t* dataValid = nullptr);
+	float32_t getLatestValue(sensor_t sensor_name,
+							 uint8_t* dataValid = nullptr,
+							 uint32_t* timestamp = nullptr);
+
+	/**
+	 * @brief This function fills a snapshot with the latest acquired
+	 *        measure of every enabled sensor, in a single pass. Measures
+	 *        are expressed in the relevant unit for each sensor.
+	 *
+	 * @note  This function can NOT be called before the DataAPI module is
+	 *        started, either explicitly or by starting the Uninterruptible
+	 *        task.
+	 *
+	 * @note  As for getLatestValue(), this function clears the buffers of
+	 *        the enabled sensors.
+	 *
+	 * @param[out] snapshot Snapshot to fill. For each sensor,
+	 *        `data_valid` is `DATA_IS_OK`, `DATA_IS_OLD` or
+	 *        `DATA_IS_MISSING` as for getLatestValue(), and the value is
+	 *        `NO_VALUE` when missing. `sequence` is the data dispatch
+	 *        sequence number: when it is called from the Uninterruptible
+	 *        task, all values come from the same dispatch, and two
+	 *        snapshots with the same sequence number hold the same data.
+	 */
+	void getLatestValues(sensors_snapshot_t& snapshot);
+
+	/**
+	 * @brief Add a sensor to a latest raw values view. Views allow getting
+	 *        the latest raw values of a set of sensors straight from the
+	 *        DMA buffers, without copy nor per-call lookup. Sensors are
+	 *        typically added in the setup routine, and the view updated
+	 *        in the critical task.
+	 *
+	 * @note  This function can NOT be called before the sensor is enabled.
+	 *
+	 * @param[in,out] view View to add the sensor to. It must be zeroed
+	 *        before the first sensor is added.
+	 * @param[in] sensor_name Name of the shield sensor to add.
+	 *
+	 * @return Index of the sensor in the view, or -1 if the sensor is not
+	 *         enabled or the view is full.
+	 */
+	int8_t addSensorToLatestView(latest_raw_view_t& view, sensor_t sensor_name);
+
+	/**
+	 * @brief Update a latest raw values view: after this call, each
+	 *        `view.raw_values[i]` points to the latest raw value of the
+	 *        matching sensor, which can then be converted using
+	 *        convertRawValue().
+	 *
+	 * @note  The DataAPI must have been started, either explicitly
+	 *        or by starting the Uninterruptible task.
+	 *
+	 * @note  Pointed values keep being written by the DMA: they must be
+	 *        read right after calling this function. If no value has
+	 *        been acquired for a sensor yet, its value is 0xFFFF.
+	 *
+	 * @param[in,out] view View to update.
+	 *
+	 * @return 0 if the view has been updated, -1 otherwise.
+	 */
+	int8_t updateLatestView(latest_raw_view_t& view);
 
 	/**
 	 * @brief Use this function to convert values obtained using matching
@@ -317,6 +435,28 @@ public:
 	 */
 	float32_t convertRawValue(sensor_t sensor_name, uint16_t raw_value);
 
+	/**
+	 * @brief  This function returns a structure containing information about
+	 *         an enabled sensor from a sensor name.
+	 *
+	 * @param[in] sensor_name Name of the sensor as defined in the device tree.
+	 *
+	 * @return Structure for the given sensor name containing : 
+	 * 			
+	 * 		   - the ADC number 
+	 * 
+	 *         - channel number 
+	 * 
+	 *         - pin number 
+	 * 
+	 * 		   or: 
+	 * 
+	 * 			- `(0, 0, 0)` if sensor name does not exist or has not been 
+	 * 		   configured.
+	 *
+	 */
+	sensor_info_t getEnabledSensorInfo(sensor_t sensor_name);
+
 	/**
 	 * @brief Use this function to tweak the conversion values for any linear
 	 *        sensor if default values are not accurate enough.
@@ -335,6 +475,25 @@ public:
 									   float32_t gain,
 									   float32_t offset);
 
+	/**
+	 * @brief Use this function to enable fixed-point (Q15) conversion for
+	 *        a linear sensor. Values can then be obtained using
+	 *        getValuesQ15().
+	 *
+	 * @note  This function can NOT be called before the sensor is enabled.
+	 *
+	 * @param[in] sensor_name Name of the shield sensor.
+	 * @param[in] full_scale Value, in the relevant unit for the sensor,
+	 *        matching Q15 full scale. It must be greater than any
+	 *        converted value, before and after offset is applied.
+	 *        Set to 0 to disable fixed-point conversion.
+	 *
+	 * @return 0 if fixed-point conversion has been configured, -1 if the
+	 *         sensor is not enabled or does not use linear conversion.
+	 */
+	int8_t enableFixedPointConversion(sensor_t sensor_name,
+									  float32_t full_scale);
+
 	/**
 	 * @brief Use this function to set the conversion values for any NTC
 	 * 		  thermistor sensor if default values are not accurate enough.
@@ -529,31 +688,16 @@ private:
 
 
 	/**
-	 * @brief  This function returns a structure containing information about
-	 *         an enabled sensor from a sensor name.
-	 *
-	 * @param[in] sensor_name Name of the sensor as defined in the device tree.
-	 *
-	 * @return Structure for the given sensor name containing : 
-	 * 			
-	 * 		   - the ADC number 
-	 * 
-	 *         - channel number 
-	 * 
-	 *         - pin number 
-	 * 
-	 * 		   or: 
-	 * 
-	 * 			- `(0, 0, 0)` if sensor name does not exist or has not been 
-	 * 		   configured.
-	 *
+	 * @brief    Builds the list of device-tree defined sensors for each ADC.
 	 */
-	sensor_info_t getEnabledSensorInfo(sensor_t sensor_name);
+	void buildSensorListFromDeviceTree();
 
 	/**
-	 * @brief    Builds the list of device-tree defined sensors for each ADC.
+	 * @brief    Builds the lists of enabled sensors used by
+	 *           getLatestValues(), along with a copy of the linear
+	 *           conversion parameters.
 	 */
-	void buildSensorListFromDeviceTree();
+	void buildSnapshotPlan();
 
 	/**
 	 * @brief Function to retrieve a line from console.
@@ -573,6 +717,16 @@ private:
 	static sensor_dt_data_t* enabled_sensors[];
 	static bool initialized;
 
+	/* getLatestValues() plan: linear sensors are converted as a batch */
+	static uint32_t  snapshot_plan_revision;
+	static bool      snapshot_plan_built;
+	static uint8_t   snapshot_linear_count;
+	static sensor_t  snapshot_linear_sensors[SENSORS_COUNT];
+	static float32_t snapshot_linear_gains[SENSORS_COUNT];
+	static float32_t snapshot_linear_offsets[SENSORS_COUNT];
+	static uint8_t   snapshot_other_count;
+	static sensor_t  snapshot_other_sensors[SENSORS_COUNT];
+
 	#ifdef CONFIG_SHIELD_OWNVERTER
 	static uint8_t   temp_mux_in_1;
 	static uint8_t   temp_mux_in_2;
@@ -50,9 +50,14 @@ uint8_t DataAPI::current_rank[ADC_COUNT] = {0};
 DispatchMethod_t DataAPI::dispatch_method = DispatchMethod_t::on_dma_interrupt;
 uint32_t DataAPI::repetition_count_between_dispatches = 0;
 float32_t*** DataAPI::converted_values_buffer = nullptr;
+q15_t*** DataAPI::converted_values_buffer_q15 = nullptr;
 
 
 adc_t DataAPI::current_adc[PIN_COUNT] = {DEFAULT_ADC};
+adc_t DataAPI::injected_adc[PIN_COUNT] = {DEFAULT_ADC};
+uint8_t DataAPI::injected_channel[PIN_COUNT] = {0};
+const volatile uint32_t* DataAPI::injected_data_registers[PIN_COUNT] = {nullptr};
+int8_t DataAPI::oversampling_extra_bits[ADC_COUNT] = {0};
 
 /**
  *  Public functions accessible only when using a power shield
@@ -87,6 +92,50 @@ int8_t DataAPI::enableAcquisition(uint8_t pin_num, adc_t adc_num)
 	return err;
 }
 
+int8_t DataAPI::enableInjectedAcquisition(uint8_t pin_num, adc_t adc_num)
+{
+	if (DataAPI::is_started == true)
+		return -1;
+
+	if ( (pin_num == 0) || (pin_num > PIN_COUNT) )
+		return -1;
+
+	if (adc_num == DEFAULT_ADC)
+	{
+		adc_num = DataAPI::getDefaultAdcForPin(pin_num);
+	}
+
+	if (adc_num == UNKNOWN_ADC)
+	{
+		return -1;
+	}
+
+	uint8_t channel_num = this->getChannelNumber(adc_num, pin_num);
+	if (channel_num == 0)
+	{
+		return -1;
+	}
+
+	/* Make sure module is initialized */
+	if (adcInitialized == false)
+	{
+		initializeAllAdcs();
+	}
+
+	int8_t rank = adc_add_injected_channel(adc_num, channel_num);
+	if (rank < 0)
+	{
+		return -1;
+	}
+
+	DataAPI::injected_adc[pin_num-1]     = adc_num;
+	DataAPI::injected_channel[pin_num-1] = channel_num;
+	DataAPI::injected_data_registers[pin_num-1] =
+		adc_get_injected_data_register(adc_num, rank);
+
+	return 0;
+}
+
 int8_t DataAPI::start()
 {
 	if (DataAPI::is_started == true)
@@ -94,20 +143,32 @@ int8_t DataAPI::start()
 
 	/* Initialize conversion */
 	data_conversion_init();
+	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
+	{
+		oversampling_extra_bits[adc_num-1] =
+			adc_get_oversampling_extra_bits(adc_num);
+
+		data_conversion_set_adc_extra_bits(
+			adc_num,
+			oversampling_extra_bits[adc_num-1]);
+	}
 
 	/* Initialize data dispatch */
 	switch (this->dispatch_method)
 	{
 		case DispatchMethod_t::on_dma_interrupt:
 			/* Dispatch is handled automatically by Data Dispatch on interrupt */
-			data_dispatch_init(interrupt, 0);
+			if (data_dispatch_init(interrupt, 0) != 0)
+				return -1;
 			break;
 		case DispatchMethod_t::externally_triggered:
 			/* Dispatch is triggered by an external call */
 			if (this->repetition_count_between_dispatches == 0)
 				return -1;
 
-			data_dispatch_init(task, this->repetition_count_between_dispatches);
+			if (data_dispatch_init(task,
+								   this->repetition_count_between_dispatches) != 0)
+				return -1;
 	}
 
 	/* Make sure module is initialized */
@@ -156,6 +217,25 @@ int8_t DataAPI::stop()
 		DataAPI::converted_values_buffer = nullptr;
 	}
 
+	if (DataAPI::converted_values_buffer_q15 != nullptr)
+	{
+		for (int adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
+		{
+			if (DataAPI::converted_values_buffer_q15[adc_index] != nullptr)
+			{
+				for (int channel_index = 0 ;
+					 channel_index < CHANNELS_PER_ADC ;
+					 channel_index++)
+				{
+					delete DataAPI::converted_values_buffer_q15[adc_index][channel_index];
+				}
+				delete DataAPI::converted_values_buffer_q15[adc_index];
+			}
+		}
+		delete DataAPI::converted_values_buffer_q15;
+		DataAPI::converted_values_buffer_q15 = nullptr;
+	}
+
 	DataAPI::is_started = false;
 
 	return 0;
@@ -175,6 +255,73 @@ void DataAPI::triggerAcquisition(adc_t adc_num)
 	adc_trigger_software_conversion(adc_num, enabled_channels);
 }
 
+void DataAPI::triggerInjectedAcquisition(adc_t adc_num)
+{
+	if ( (adc_num == UNKNOWN_ADC) || (adc_num == DEFAULT_ADC) ) return;
+
+	adc_trigger_software_injected_conversion(adc_num);
+}
+
+uint16_t DataAPI::getInjectedRawValue(uint8_t pin_num, uint8_t* dataValid)
+{
+	const volatile uint32_t* data_register = nullptr;
+	if ( (pin_num > 0) && (pin_num <= PIN_COUNT) )
+	{
+		data_register = DataAPI::injected_data_registers[pin_num-1];
+	}
+
+	if (data_register == nullptr)
+	{
+		if (dataValid != nullptr)
+		{
+			*dataValid = DATA_IS_MISSING;
+		}
+		return 0;
+	}
+
+	if (dataValid != nullptr)
+	{
+		*dataValid = DATA_IS_OK;
+	}
+
+	return (uint16_t)(*data_register);
+}
+
+float32_t DataAPI::getInjectedValue(uint8_t pin_num, uint8_t* dataValid)
+{
+	uint8_t data_valid;
+	uint16_t raw_value = DataAPI::getInjectedRawValue(pin_num, &data_valid);
+
+	if (dataValid != nullptr)
+	{
+		*dataValid = data_valid;
+	}
+
+	if (data_valid == DATA_IS_MISSING)
+	{
+		return NO_VALUE;
+	}
+
+	/**
+	 * Injected values are not oversampled: bring them to the
+	 * resolution expected by conversion.
+	 */
+	adc_t adc_num = DataAPI::injected_adc[pin_num-1];
+	int8_t extra_bits = DataAPI::oversampling_extra_bits[adc_num-1];
+	if (extra_bits > 0)
+	{
+		raw_value <<= extra_bits;
+	}
+	else if (extra_bits < 0)
+	{
+		raw_value >>= -extra_bits;
+	}
+
+	return data_conversion_convert_raw_value(adc_num,
+											 DataAPI::injected_channel[pin_num-1],
+											 raw_value);
+}
+
 uint16_t* DataAPI::getRawValues(uint8_t pin_num,
 								uint32_t& number_of_values_acquired)
 {
@@ -219,6 +366,28 @@ float32_t* DataAPI::getValues(uint8_t pin_number,
 								  number_of_values_acquired);
 }
 
+q15_t* DataAPI::getValuesQ15(uint8_t pin_number,
+							 uint32_t& number_of_values_acquired)
+{
+	adc_t adc_number = DataAPI::getCurrentAdcForPin(pin_number);
+	if (adc_number == UNKNOWN_ADC)
+	{
+		number_of_values_acquired = 0;
+		return nullptr;
+	}
+
+	uint8_t channel_num = this->getChannelNumber(adc_number, pin_number);
+	if (channel_num == 0)
+	{
+		number_of_values_acquired = 0;
+		return nullptr;
+	}
+
+	return this->getChannelValuesQ15(adc_number,
+									 channel_num,
+									 number_of_values_acquired);
+}
+
 float32_t DataAPI::peekLatestValue(uint8_t pin_num)
 {
 	adc_t adc_num = DataAPI::getCurrentAdcForPin(pin_num);
@@ -236,7 +405,9 @@ float32_t DataAPI::peekLatestValue(uint8_t pin_num)
 	return this->peekChannel(adc_num, channel_num);
 }
 
-float32_t DataAPI::getLatestValue(uint8_t pin_num, uint8_t* dataValid)
+float32_t DataAPI::getLatestValue(uint8_t pin_num,
+								  uint8_t* dataValid,
+								  uint32_t* timestamp)
 {
 	adc_t adc_num = DataAPI::getCurrentAdcForPin(pin_num);
 	if (adc_num == UNKNOWN_ADC)
@@ -258,7 +429,29 @@ float32_t DataAPI::getLatestValue(uint8_t pin_num, uint8_t* dataValid)
 		return NO_VALUE;
 	}
 
-	return this->getChannelLatest(adc_num, channel_num, dataValid);
+	return this->getChannelLatest(adc_num, channel_num, dataValid, timestamp);
+}
+
+int8_t DataAPI::addPinToLatestView(latest_raw_view_t& view, uint8_t pin_num)
+{
+	adc_t adc_num = DataAPI::getCurrentAdcForPin(pin_num);
+	if (adc_num == UNKNOWN_ADC)
+	{
+		return -1;
+	}
+
+	uint8_t channel_num = this->getChannelNumber(adc_num, pin_num);
+	if (channel_num == 0)
+	{
+		return -1;
+	}
+
+	return this->addChannelToLatestView(view, adc_num, channel_num);
+}
+
+int8_t DataAPI::updateLatestView(latest_raw_view_t& view)
+{
+	return this->refreshLatestView(view);
 }
 
 float32_t DataAPI::convertValue(uint8_t pin_num, uint16_t raw_value)
@@ -300,6 +493,26 @@ void DataAPI::setConversionParametersLinear(uint8_t pin_num,
 													 offset);
 }
 
+int8_t DataAPI::enableFixedPointConversion(uint8_t pin_num,
+										   float32_t full_scale)
+{
+	adc_t adc_num = DataAPI::getCurrentAdcForPin(pin_num);
+	if (adc_num == UNKNOWN_ADC)
+	{
+		return -1;
+	}
+
+	uint8_t channel_num = this->getChannelNumber(adc_num, pin_num);
+	if (channel_num == 0)
+	{
+		return -1;
+	}
+
+	return data_conversion_set_q15_full_scale(adc_num,
+											  channel_num,
+											  full_scale);
+}
+
 void DataAPI::setConversionParametersNtcThermistor(uint8_t pin_num,
 												   float32_t r0,
 												   float32_t b,
@@ -411,6 +624,108 @@ void DataAPI::configureDiscontinuousMode(adc_t adc_number,
 	adc_configure_discontinuous_mode(adc_number, discontinuous_count);
 }
 
+int8_t DataAPI::configureOversampling(adc_t adc_number,
+									 uint16_t ratio,
+									 uint8_t shift,
+									 bool triggered_mode)
+{
+	if ( (adc_number == UNKNOWN_ADC) || (adc_number == DEFAULT_ADC) )
+		return -1;
+
+	/* Make sure module is initialized */
+	if (adcInitialized == false)
+	{
+		initializeAllAdcs();
+	}
+
+	/* Proceed */
+	return adc_configure_oversampling(adc_number,
+									  ratio,
+									  shift,
+									  triggered_mode);
+}
+
+void DataAPI::configureDualSimultaneousMode(bool enable)
+{
+	/* Make sure module is initialized */
+	if (adcInitialized == false)
+	{
+		initializeAllAdcs();
+	}
+
+	/* Proceed */
+	adc_configure_dual_mode(enable);
+}
+
+uint32_t DataAPI::getTimestampFrequency()
+{
+	return data_dispatch_get_timestamp_frequency();
+}
+
+int8_t DataAPI::getDispatchTimingStatistics(adc_t adc_number,
+											timing_stats_t& stats)
+{
+	if ( (adc_number == UNKNOWN_ADC) || (adc_number == DEFAULT_ADC) )
+		return -1;
+
+	return data_dispatch_get_timing_stats(adc_number, &stats);
+}
+
+int8_t DataAPI::resetDispatchTimingStatistics(adc_t adc_number,
+											  float32_t expected_period_us,
+											  float32_t bin_width_us)
+{
+	if ( (adc_number == UNKNOWN_ADC) || (adc_number == DEFAULT_ADC) )
+		return -1;
+
+	if ( (expected_period_us < 0) || (bin_width_us < 0) )
+		return -1;
+
+	float32_t units_per_us = (float32_t)getTimestampFrequency() / 1000000;
+
+	return data_dispatch_reset_timing_stats(adc_number,
+											expected_period_us*units_per_us,
+											bin_width_us*units_per_us);
+}
+
+int8_t DataAPI::configureInjectedTriggerSource(adc_t adc_number,
+											  trigger_source_t trigger_source)
+{
+	if ( (adc_number == UNKNOWN_ADC) || (adc_number == DEFAULT_ADC) )
+		return -1;
+
+	/* Make sure module is initialized */
+	if (adcInitialized == false)
+	{
+		initializeAllAdcs();
+	}
+
+	/* Proceed */
+
+	if (trigger_source == TRIG_SOFTWARE)
+	{
+		adc_configure_injected_trigger_source(adc_number, software);
+		return 0;
+	}
+
+	/* (trigger_source == TRIG_PWM) */
+	adc_ev_src_t event;
+	switch(adc_number)
+	{
+		case ADC_1:
+			event = hrtim_ev2;
+			break;
+		case ADC_2:
+			event = hrtim_ev4;
+			break;
+		default:
+			return -1;
+	}
+	adc_configure_injected_trigger_source(adc_number, event);
+
+	return 0;
+}
+
 void DataAPI::configureTriggerSource(adc_t adc_number,
 									 trigger_source_t trigger_source)
 {
@@ -609,6 +924,69 @@ float32_t* DataAPI::getChannelValues(adc_t adc_number,
 	return DataAPI::converted_values_buffer[adc_index][channel_index];
 }
 
+q15_t* DataAPI::getChannelValuesQ15(adc_t adc_number,
+									uint8_t channel_num,
+									uint32_t& number_of_values_acquired)
+{
+	/* Check that API is started and channel uses fixed-point */
+	if ( (DataAPI::is_started == false) ||
+		 (data_conversion_get_q15_full_scale(adc_number, channel_num) == 0) )
+	{
+		number_of_values_acquired = 0;
+		return nullptr;
+	}
+
+	/* Get raw values */
+	uint16_t* raw_values =
+				DataAPI::getChannelRawValues(adc_number,
+											 channel_num,
+											 number_of_values_acquired);
+
+	if (number_of_values_acquired == 0)
+	{
+		return nullptr;
+	}
+
+	/* At least one value to convert: make sure a buffer is available */
+	uint8_t adc_index = (uint8_t)adc_number - 1;
+	uint8_t channel_index = channel_num - 1;
+	if (DataAPI::converted_values_buffer_q15 == nullptr)
+	{
+		DataAPI::converted_values_buffer_q15 = new q15_t**[ADC_COUNT];
+		for (int i = 0 ; i < ADC_COUNT ; i++)
+		{
+			DataAPI::converted_values_buffer_q15[i] = nullptr;
+		}
+	}
+	if (DataAPI::converted_values_buffer_q15[adc_index] == nullptr)
+	{
+		DataAPI::converted_values_buffer_q15[adc_index] =
+										new q15_t*[CHANNELS_PER_ADC];
+
+		for (int i = 0 ; i < CHANNELS_PER_ADC ; i++)
+		{
+			DataAPI::converted_values_buffer_q15[adc_index][i] = nullptr;
+		}
+	}
+	if (DataAPI::converted_values_buffer_q15[adc_index][channel_index] == nullptr)
+	{
+		DataAPI::converted_values_buffer_q15[adc_index][channel_index] =
+										new q15_t[CHANNELS_BUFFERS_SIZE];
+	}
+
+	/* Proceed to conversion */
+	data_conversion_convert_raw_values_q15(
+		adc_number,
+		channel_num,
+		raw_values,
+		DataAPI::converted_values_buffer_q15[adc_index][channel_index],
+		number_of_values_acquired
+	);
+
+	/* Return converted values buffer */
+	return DataAPI::converted_values_buffer_q15[adc_index][channel_index];
+}
+
 float32_t DataAPI::peekChannel(adc_t adc_num, uint8_t channel_num)
 {
 	if (DataAPI::is_started == false)
@@ -634,25 +1012,47 @@ float32_t DataAPI::peekChannel(adc_t adc_num, uint8_t channel_num)
 
 float32_t DataAPI::getChannelLatest(adc_t adc_num,
 									uint8_t channel_num,
-									uint8_t* dataValid)
+									uint8_t* dataValid,
+									uint32_t* timestamp)
 {
-	if (DataAPI::is_started == false)
+	uint8_t data_valid;
+	uint16_t raw_value = DataAPI::getChannelLatestRaw(adc_num,
+													  channel_num,
+													  &data_valid);
+
+	if (dataValid != nullptr)
+	{
+		*dataValid = data_valid;
+	}
+
+	if (timestamp != nullptr)
+	{
+		*timestamp = data_dispatch_get_timestamp(adc_num);
+	}
+
+	if (data_valid == DATA_IS_MISSING)
 	{
-		if (dataValid != nullptr)
-		{
-			*dataValid = DATA_IS_MISSING;
-		}
 		return NO_VALUE;
 	}
 
+	return data_conversion_convert_raw_value(adc_num, channel_num, raw_value);
+}
+
+uint16_t DataAPI::getChannelLatestRaw(adc_t adc_num,
+									  uint8_t channel_num,
+									  uint8_t* dataValid)
+{
+	*dataValid = DATA_IS_MISSING;
+
+	if (DataAPI::is_started == false)
+	{
+		return 0;
+	}
+
 	uint8_t channel_rank = DataAPI::getChannelRank(adc_num, channel_num);
 	if (channel_rank == 0)
 	{
-		if (dataValid != nullptr)
-		{
-			*dataValid = DATA_IS_MISSING;
-		}
-		return NO_VALUE;
+		return 0;
 	}
 
 	uint32_t data_count;
@@ -662,50 +1062,72 @@ float32_t DataAPI::getChannelLatest(adc_t adc_num,
 
 	if (data_count > 0)
 	{
-		uint16_t raw_value = buffer[data_count - 1];
-		if (dataValid != nullptr)
-		{
-			*dataValid = DATA_IS_OK;
-		}
-		return data_conversion_convert_raw_value(adc_num,
-												 channel_num,
-												 raw_value);
+		*dataValid = DATA_IS_OK;
+		return buffer[data_count - 1];
 	}
-	else
+
+	uint16_t raw_value = data_dispatch_peek_acquired_value(adc_num,
+														   channel_rank);
+	if (raw_value == PEEK_NO_VALUE)
 	{
-		uint16_t raw_value = data_dispatch_peek_acquired_value(adc_num,
-															   channel_rank);
+		return 0;
+	}
 
-		float32_t peekValue;
-		if (raw_value != PEEK_NO_VALUE)
-		{
-			peekValue = data_conversion_convert_raw_value(adc_num,
-														  channel_num,
-														  raw_value);
-		}
-		else
-		{
-			peekValue = NO_VALUE;
-		}
+	*dataValid = DATA_IS_OLD;
+	return raw_value;
+}
 
-		if (dataValid != nullptr)
+int8_t DataAPI::addChannelToLatestView(latest_raw_view_t& view,
+									   adc_t adc_num,
+									   uint8_t channel_num)
+{
+	if (view.count >= LATEST_VIEW_MAX_CHANNELS)
+	{
+		return -1;
+	}
+
+	uint8_t channel_rank = DataAPI::getChannelRank(adc_num, channel_num);
+	if (channel_rank == 0)
+	{
+		return -1;
+	}
+
+	uint8_t view_index = view.count;
+	view.adc_numbers[view_index]   = adc_num;
+	view.channel_ranks[view_index] = channel_rank;
+	view.raw_values[view_index]    = nullptr;
+	view.count++;
+
+	return view_index;
+}
+
+int8_t DataAPI::refreshLatestView(latest_raw_view_t& view)
+{
+	if (DataAPI::is_started == false)
+	{
+		return -1;
+	}
+
+	int8_t result = 0;
+	for (uint8_t i = 0 ; i < view.count ; i++)
+	{
+		view.raw_values[i] =
+			data_dispatch_get_latest_dma_word(view.adc_numbers[i],
+											  view.channel_ranks[i]);
+
+		if (view.raw_values[i] == nullptr)
 		{
-			if (peekValue != NO_VALUE)
-			{
-				*dataValid = DATA_IS_OLD;
-			}
-			else
-			{
-				*dataValid = DATA_IS_MISSING;
-			}
+			result = -1;
 		}
-		return peekValue;
 	}
+
+	return result;
 }
 
 uint8_t DataAPI::getChannelRank(adc_t adc_num, uint8_t channel_num)
 {
-	if ( (adc_num > ADC_COUNT) || (channel_num > CHANNELS_PER_ADC) )
+	if ( (adc_num < ADC_1) || (adc_num > ADC_COUNT) ||
+		 (channel_num == 0) || (channel_num > CHANNELS_PER_ADC) )
 		return 0;
 
 	uint8_t adc_index = adc_num-1;
@@ -947,7 +1369,26 @@ void DataAPI::setDispatchMethod(DispatchMethod_t dispatch_method)
 	DataAPI::dispatch_method = dispatch_method;
 }
 
+uint32_t DataAPI::getDispatchSequence()
+{
+	return data_dispatch_get_sequence();
+}
+
 void DataAPI::doFullDispatch()
 {
 	data_dispatch_do_full_dispatch();
 }
+
+int8_t DataAPI::setDispatchCallback(adc_t adc_number,
+									void (*callback)(),
+									uint32_t repetition)
+{
+	return data_dispatch_set_dispatch_callback(adc_number,
+											   callback,
+											   repetition);
+}
+
+bool DataAPI::isDispatchCallbackPending()
+{
+	return data_dispatch_is_callback_dispatch_pending();
+}
@@ -40,6 +40,7 @@
 
 /* Current module private functions */
 #include "./data/data_conversion.h"
+#include "./data/timing_stats.h"
 
 /**
  *  Type definitions
@@ -95,6 +96,23 @@ const uint8_t DATA_IS_OK      = 0;
 const uint8_t DATA_IS_OLD     = 1;
 const uint8_t DATA_IS_MISSING = 2;
 
+/* Maximum number of channels in a latest raw values view */
+const uint8_t LATEST_VIEW_MAX_CHANNELS = 8;
+
+/**
+ *  Latest raw values view: set of channels chosen at setup for which the
+ *  latest raw values are read directly in the DMA buffers.
+ *  raw_values[i] points to the DMA word holding the latest value of the
+ *  i-th channel added to the view, and is updated by updateLatestView().
+ */
+typedef struct
+{
+	uint8_t                  count;
+	uint8_t                  adc_numbers[LATEST_VIEW_MAX_CHANNELS];
+	uint8_t                  channel_ranks[LATEST_VIEW_MAX_CHANNELS];
+	const volatile uint16_t* raw_values[LATEST_VIEW_MAX_CHANNELS];
+} latest_raw_view_t;
+
 /**
  *  Static class definition
  */
@@ -140,6 +158,35 @@ public:
 	 */
 	int8_t enableAcquisition(uint8_t pin_number, adc_t adc_number = DEFAULT_ADC);
 
+	/**
+	 * @brief This function is used to enable injected acquisition on a Spin
+	 *        PIN with a given ADC.
+	 *
+	 *        Injected conversions take priority over the regular sequence
+	 *        and are not transferred by DMA: the latest value is read
+	 *        directly from the ADC data register with getInjectedValue().
+	 *        This gives the lowest latency between sampling and use of the
+	 *        value, e.g. for an inner current loop, while slower channels
+	 *        keep using regular acquisition.
+	 *
+	 * @note  Up to 4 pins can be acquired as injected on each ADC.
+	 *
+	 * @note  Injected conversions are not oversampled. Conversion parameters
+	 *        are shared with regular acquisition of the same channel.
+	 *
+	 * @note  This function must be called *before* Data API is started.
+	 *
+	 * @param[in] pin_number Number of the Spin pin on which to enable
+	 *            injected acquisition.
+	 * @param[in] adc_number Number of the ADC on which acquisition is to be
+	 *            done. Same as enableAcquisition() if omitted.
+	 *
+	 * @return `0` if injected acquisition was correctly enabled,
+	 * 		   `-1` if there was an error.
+	 */
+	int8_t enableInjectedAcquisition(uint8_t pin_number,
+									 adc_t adc_number = DEFAULT_ADC);
+
 	/**
 	 * @brief This functions manually starts the acquisition chain.
 	 *
@@ -231,6 +278,50 @@ public:
 	 */
 	void triggerAcquisition(adc_t adc_number);
 
+	/**
+	 * @brief Triggers an acquisition of the injected channels of a given ADC.
+	 *
+	 * @note  This function can NOT be called before the DataAPI module
+	 * 		  is started.
+	 *
+	 * @param[in] adc_number Number of the ADC on which to acquire
+	 *            injected channels.
+	 */
+	void triggerInjectedAcquisition(adc_t adc_number);
+
+	/**
+	 * @brief Function to access the latest injected value of a pin,
+	 *        read directly from the ADC data register.
+	 *
+	 *        This function is intended to be called from the control task,
+	 *        with injected conversions triggered by the PWM at a fixed
+	 *        instant of the period.
+	 *
+	 * @param[in]  pin_number Number of the pin.
+	 * @param[out] dataValid Pointer to an uint8_t variable. This parameter is
+	 *             facultative. If this parameter is provided, it will be
+	 *             updated to indicate information about data. Possible values
+	 *             for this parameter are `DATA_IS_OK` or `DATA_IS_MISSING`
+	 *             if injected acquisition is not enabled on this pin.
+	 *
+	 * @return Latest converted injected value, or `NO_VALUE` if injected
+	 *         acquisition is not enabled on this pin.
+	 */
+	float32_t getInjectedValue(uint8_t pin_number, uint8_t* dataValid = nullptr);
+
+	/**
+	 * @brief Function to access the latest raw injected value of a pin,
+	 *        read directly from the ADC data register.
+	 *
+	 * @param[in]  pin_number Number of the pin.
+	 * @param[out] dataValid Pointer to an uint8_t variable. This parameter is
+	 *             facultative. Updated to `DATA_IS_OK` or `DATA_IS_MISSING`.
+	 *
+	 * @return Latest raw injected value, or `0` if injected acquisition
+	 *         is not enabled on this pin.
+	 */
+	uint16_t getInjectedRawValue(uint8_t pin_number, uint8_t* dataValid = nullptr);
+
 	/**
 	 * @brief Function to access the acquired data for specified pin.
 	 * 
@@ -328,6 +419,32 @@ public:
 	float32_t* getValues(uint8_t pin_number,
 						 uint32_t& number_of_values_acquired);
 
+	/**
+	 * @brief Function to access the acquired data for specified pin as
+	 *        fixed-point values. Works as getValues(), but values are
+	 *        expressed in Q15 format relative to the pin full scale:
+	 *        a value v represents v * full_scale / 32768 in the relevant
+	 *        unit for the data.
+	 *
+	 * @note  Fixed-point conversion must have been enabled for the pin
+	 *        using enableFixedPointConversion().
+	 *
+	 * @note  When calling this function, it invalidates the array
+	 *        returned by a previous call to the same function.
+	 *
+	 * @param[in]  pin_number Number of the pin from which to obtain values.
+	 * @param[out] number_of_values_acquired Pass an uint32_t variable.
+	 *        This variable will be updated with the number of values that
+	 *        are present in the returned buffer.
+	 *
+	 * @return Pointer to an array in which the acquired values are stored.
+	 *
+	 *         If number_of_values_acquired is 0, do not try to access the
+	 *         buffer as it may be nullptr.
+	 */
+	q15_t* getValuesQ15(uint8_t pin_number,
+						uint32_t& number_of_values_acquired);
+
 	/**
 	 * @brief Function to access the latest value available from a pin.
 	 * 	
@@ -384,12 +501,63 @@ public:
 	 * 
 	 *        - `DATA_IS_MISSING` if returned data is NO_VALUE.
 	 *
+	 * @param[out] timestamp Pointer to an uint32_t variable.
+	 *
+	 * 		  This parameter is facultative.
+	 *
+	 * 		  If this parameter is provided, it will be updated with the
+	 *        timestamp of the latest dispatch of the ADC acquiring the pin.
+	 *        Timestamps unit is given by getTimestampFrequency().
+	 *
 	 * @return Latest acquired measure for the channel.
 	 * 
 	 *         If no value was acquired in this channel yet, return value is NO_VALUE.
 	 *
 	 */
-	float32_t getLatestValue(uint8_t pin_number, uint8_t* dataValid = nullptr);
+	float32_t getLatestValue(uint8_t pin_number,
+							 uint8_t* dataValid = nullptr,
+							 uint32_t* timestamp = nullptr);
+
+	/**
+	 * @brief Add a pin to a latest raw values view. Views allow getting
+	 *        the latest raw values of a set of pins straight from the DMA
+	 *        buffers, without copy nor per-call lookup, which suits the
+	 *        critical task.
+	 *
+	 * @note  This function can NOT be called before the pin is enabled.
+	 *
+	 * @param[in,out] view View to add the pin to. It must be zeroed before
+	 *        the first pin is added.
+	 * @param[in] pin_number Number of the pin to add to the view.
+	 *
+	 * @return Index of the pin in the view, or -1 if the pin is not
+	 *         enabled or the view is full.
+	 */
+	int8_t addPinToLatestView(latest_raw_view_t& view, uint8_t pin_number);
+
+	/**
+	 * @brief Update a latest raw values view: after this call, each
+	 *        `view.raw_values[i]` points to the latest raw value of the
+	 *        matching pin, which can then be converted using
+	 *        convertValue().
+	 *
+	 * @note  The DataAPI module must have been started, either
+	 *        explicitly or by starting the Uninterruptible task.
+	 *
+	 * @note  Pointed values keep being written by the DMA: they must be
+	 *        read right after calling this function. If no value has
+	 *        been acquired for a pin yet, its value is 0xFFFF.
+	 *
+	 *        Unlike getLatestValue(), this function does not touch the
+	 *        per-channel buffers.
+	 *
+	 * @param[in,out] view View to update.
+	 *
+	 * @return 0 if the view has been updated, -1 if the module is not
+	 *         started or a pin is no longer enabled. In the latter
+	 *         case, the matching pointer is nullptr.
+	 */
+	int8_t updateLatestView(latest_raw_view_t& view);
 
 	/**
 	 * @brief Use this function to convert values obtained using matching
@@ -425,6 +593,27 @@ public:
 									   float32_t gain,
 									   float32_t offset);
 
+	/**
+	 * @brief Use this function to enable fixed-point (Q15) conversion for
+	 *        a pin using linear conversion. Values can then be obtained
+	 *        using getValuesQ15(). Floating-point functions remain
+	 *        available.
+	 *
+	 * @note  This function can NOT be called before the pin is enabled.
+	 *
+	 * @param[in] pin_number Number of the pin.
+	 * @param[in] full_scale Value, in the relevant unit for the data,
+	 *        matching Q15 full scale. It must be greater than any
+	 *        converted value, before and after offset is applied.
+	 *        Set to 0 to disable fixed-point conversion.
+	 *
+	 * @return 0 if fixed-point conversion has been configured,
+	 *         -1 if the pin is not enabled or does not use linear
+	 *         conversion.
+	 */
+	int8_t enableFixedPointConversion(uint8_t pin_number,
+									  float32_t full_scale);
+
 	/**
 	 * @brief Use this function to set the conversion values for any NTC
 	 * 		  thermistor sensor if default values are not accurate enough.
@@ -532,6 +721,84 @@ public:
 	void configureDiscontinuousMode(adc_t adc_number,
 									uint32_t dicontinuous_count);
 
+	/**
+	 * @brief Configure the hardware oversampling of an ADC.
+	 *
+	 *        Each acquired value is the sum of `ratio` conversions,
+	 *        right-shifted by `shift` bits. The result gains up to
+	 *        log2(ratio) - shift bits of resolution, and is scaled
+	 *        back before conversion: conversion parameters remain
+	 *        relative to 12-bit raw values. Raw values read from the
+	 *        buffers keep the extended resolution.
+	 *
+	 *        By default, ADCs are NOT oversampled.
+	 *
+	 *        Applied configuration will only be set when ADC is started.
+	 *        If ADC is already started, it must be stopped then started again.
+	 *
+	 * @note Oversampling lengthens the conversion time of every channel
+	 *       of the ADC by the ratio. Make sure all conversions still
+	 *       fit in the control period.
+	 *
+	 * @param[in] adc_number Number of the ADC to configure.
+	 * @param[in] ratio Oversampling ratio: power of 2 from 2 to 256,
+	 *            or 1 to disable oversampling (default).
+	 * @param[in] shift Right shift applied to the sum, from 0 to 8.
+	 *            Increased if needed to fit the result in 16 bits.
+	 * @param[in] triggered_mode Set to true to require a trigger event
+	 *            for each conversion of the oversampling sequence.
+	 *            Default is false: a single trigger runs the whole
+	 *            sequence.
+	 *
+	 * @return 0 if configuration is valid, -1 otherwise.
+	 */
+	int8_t configureOversampling(adc_t adc_number,
+								 uint16_t ratio,
+								 uint8_t shift,
+								 bool triggered_mode = false);
+
+	/**
+	 * @brief Set ADC 1 and ADC 2 in dual simultaneous mode.
+	 *
+	 *        In this mode, each trigger of ADC 1 converts the same rank
+	 *        on both ADCs at the same instant: channel n of ADC 1 and
+	 *        channel n of ADC 2 are sampled together, and transferred
+	 *        in a single DMA transaction. ADC 2 trigger source is
+	 *        ignored.
+	 *
+	 *        Dual mode only applies when both ADCs have the same
+	 *        number of enabled channels, otherwise ADCs stay
+	 *        independent. Discontinuous mode and oversampling should
+	 *        be configured identically on both ADCs.
+	 *
+	 *        By default, ADCs are independent.
+	 *
+	 *        Applied configuration will only be set when ADC is started.
+	 *        If ADC is already started, it must be stopped then started again.
+	 *
+	 * @param[in] enable true to enable dual simultaneous mode,
+	 *            false to use independent ADCs.
+	 */
+	void configureDualSimultaneousMode(bool enable);
+
+	/**
+	 * @brief Change the trigger source of the injected channels of an ADC.
+	 *
+	 *        By default, injected channels are triggered by software.
+	 *        `TRIG_PWM` is available for `ADC_1` and `ADC_2`: the PWM unit
+	 *        must then be configured with PwmHAL::setAdcInjectedTrigger().
+	 *
+	 *        Applied configuration will only be set when ADC is started.
+	 *        If ADC is already started, it must be stopped then started again.
+	 *
+	 * @param[in] adc_number Number of the ADC to configure
+	 * @param[in] trigger_source Source of the trigger
+	 *
+	 * @return 0 if the trigger source was set, -1 otherwise.
+	 */
+	int8_t configureInjectedTriggerSource(adc_t adc_number,
+										  trigger_source_t trigger_source);
+
 	/**
 	 * @brief Change the trigger source of an ADC.
 	 * 
@@ -550,6 +817,47 @@ public:
 	 */
 	void configureTriggerSource(adc_t adc_number, trigger_source_t trigger_source);
 
+	/**
+	 * @brief Obtain the frequency of the counter used to timestamp
+	 *        data dispatches.
+	 *
+	 * @return Number of timestamp units per second.
+	 */
+	static uint32_t getTimestampFrequency();
+
+	/**
+	 * @brief Obtain statistics on the period between two data dispatches
+	 *        of an ADC: minimum, maximum and latest period, and histogram
+	 *        of the periods around the expected period.
+	 *
+	 *        Periods are expressed in timestamp units, see
+	 *        getTimestampFrequency().
+	 *
+	 * @param[in]  adc_number Number of the ADC.
+	 * @param[out] stats Copy of the statistics.
+	 *
+	 * @return 0 if statistics were copied, -1 otherwise.
+	 */
+	int8_t getDispatchTimingStatistics(adc_t adc_number, timing_stats_t& stats);
+
+	/**
+	 * @brief Reset the statistics on the period between two data
+	 *        dispatches of an ADC, and configure the histogram.
+	 *
+	 *        By default, histogram is disabled.
+	 *
+	 * @param[in] adc_number Number of the ADC.
+	 * @param[in] expected_period_us Nominal period in µs, centered in the
+	 *            histogram. If 0, the first measured period is used.
+	 * @param[in] bin_width_us Width of the histogram bins in µs.
+	 *            If 0, the histogram is disabled.
+	 *
+	 * @return 0 if statistics were reset, -1 otherwise.
+	 */
+	int8_t resetDispatchTimingStatistics(adc_t adc_number,
+										 float32_t expected_period_us = 0,
+										 float32_t bin_width_us = 0);
+
 private:
 	/**
 	 * @brief Initialize all available ADC peripherals if not already initialized.
@@ -618,6 +926,21 @@ private:
 									   uint8_t channel_num,
 									   uint32_t& number_of_values_acquired);
 
+	/**
+	 * @brief Retrieve Q15 converted values for a specific ADC channel.
+	 *
+	 * Same as getChannelValues(), for channels with fixed-point
+	 * conversion enabled.
+	 *
+	 * @param adc_number ADC index (1–5).
+	 * @param channel_num Channel number.
+	 * @param[out] number_of_values_acquired Reference to output number of samples.
+	 * @return Pointer to converted q15_t values or nullptr on error.
+	 */
+	static q15_t* getChannelValuesQ15(adc_t adc_number,
+									  uint8_t channel_num,
+									  uint32_t& number_of_values_acquired);
+
     /**
 	 * @brief Peek at the latest value sampled for the specified channel.
 	 *
@@ -642,11 +965,52 @@ private:
 	 * @param adc_number ADC index.
 	 * @param channel_num Channel number.
 	 * @param[out] dataValid Pointer to validity flag (optional).
+	 * @param[out] timestamp Pointer to dispatch timestamp (optional).
 	 * @return Latest converted value or NO_VALUE.
 	 */
 	static float32_t getChannelLatest(adc_t adc_number,
 									  uint8_t channel_num,
-									  uint8_t* dataValid = nullptr);
+									  uint8_t* dataValid = nullptr,
+									  uint32_t* timestamp = nullptr);
+
+	/**
+	 * @brief Retrieve the latest raw value for a channel and its validity
+	 * status.
+	 *
+	 * Same as getChannelLatest(), without conversion.
+	 *
+	 * @param adc_number ADC index.
+	 * @param channel_num Channel number.
+	 * @param[out] dataValid Pointer to validity flag (mandatory).
+	 * @return Latest raw value, meaningless if dataValid is
+	 *         DATA_IS_MISSING.
+	 */
+	static uint16_t getChannelLatestRaw(adc_t adc_number,
+										uint8_t channel_num,
+										uint8_t* dataValid);
+
+	/**
+	 * @brief Add an ADC channel to a latest raw values view.
+	 *
+	 * @param[in,out] view View to add the channel to.
+	 * @param adc_number ADC index.
+	 * @param channel_num Channel number.
+	 * @return Index of the channel in the view, or -1 if the channel is
+	 *         not enabled or the view is full.
+	 */
+	static int8_t addChannelToLatestView(latest_raw_view_t& view,
+										 adc_t adc_number,
+										 uint8_t channel_num);
+
+	/**
+	 * @brief Point each entry of a latest raw values view to the DMA word
+	 *        holding the latest value of the matching channel.
+	 *
+	 * @param[in,out] view View to update.
+	 * @return 0 on success, -1 if the module is not started or
+	 *         a channel could not be located.
+	 */
+	static int8_t refreshLatestView(latest_raw_view_t& view);
 
 	/**
 	 * @brief Get the conversion rank of a given ADC channel.
@@ -711,6 +1075,16 @@ private:
 	 */
 	static void setDispatchMethod(DispatchMethod_t dispatch_method);
 
+	/**
+	 * @brief Get the data dispatch sequence number.
+	 *
+	 * Values obtained with the same sequence number come from the same
+	 * dispatch.
+	 *
+	 * @return Current dispatch sequence number.
+	 */
+	static uint32_t getDispatchSequence();
+
 	/**
 	 * @brief Force a full data dispatch cycle immediately.
 	 *
@@ -718,6 +1092,31 @@ private:
 	 */
 	static void doFullDispatch();
 
+	/**
+	 * @brief Call a function each time an ADC has been dispatched a
+	 * given number of times on DMA interrupt.
+	 *
+	 * Used by the internal scheduler to run the critical task as soon as
+	 * acquisitions are available. Only effective when the dispatch method
+	 * is on_dma_interrupt, and must be called after start().
+	 *
+	 * @param adc_number ADC which dispatches trigger the callback.
+	 * @param callback Function to call, or nullptr to remove the callback.
+	 * @param repetition Number of dispatches between two calls.
+	 * @return 0 if the callback was registered, -1 otherwise.
+	 */
+	static int8_t setDispatchCallback(adc_t adc_number,
+									  void (*callback)(),
+									  uint32_t repetition);
+
+	/**
+	 * @brief Check whether the ADC triggering the dispatch callback has
+	 * already filled its next DMA buffer.
+	 *
+	 * @return true if a dispatch is pending, false otherwise.
+	 */
+	static bool isDispatchCallbackPending();
+
 private:
 	static bool is_started;
 	static bool adcInitialized;
@@ -726,7 +1125,12 @@ private:
 	static DispatchMethod_t dispatch_method;
 	static uint32_t repetition_count_between_dispatches;
 	static adc_t current_adc[PIN_COUNT];
+	static adc_t injected_adc[PIN_COUNT];
+	static uint8_t injected_channel[PIN_COUNT];
+	static const volatile uint32_t* injected_data_registers[PIN_COUNT];
+	static int8_t oversampling_extra_bits[ADC_COUNT];
 	static float32_t*** converted_values_buffer;
+	static q15_t*** converted_values_buffer_q15;
 
 };
 
@@ -426,6 +426,31 @@ void PwmHAL::setAdcTrigger(hrtim_tu_number_t pwmX, adc_t adc)
 	hrtim_adc_trigger_set(pwmX, adc_trig);
 }
 
+void PwmHAL::setAdcInjectedTrigger(hrtim_tu_number_t pwmX, adc_t adc)
+{
+	// Get injected trigger depending on ADC number,
+	// and make sure the ADC is correct.
+	hrtim_adc_trigger_t adc_trig;
+	switch(adc)
+	{
+		case ADC_1:
+			adc_trig = ADCTRIG_2;
+			break;
+		case ADC_2:
+			adc_trig = ADCTRIG_4;
+			break;
+		default:
+			return;
+	}
+
+	if (!hrtim_get_status(pwmX))
+	{
+		hrtim_init_default_all(); /* Initialize default parameters before */
+	}
+
+	hrtim_adc_trigger_set(pwmX, adc_trig);
+}
+
 adc_t PwmHAL::getAdcTrigger(hrtim_tu_number_t pwmX)
 {
 	hrtim_adc_trigger_t adc_trig = hrtim_adc_trigger_get(pwmX);
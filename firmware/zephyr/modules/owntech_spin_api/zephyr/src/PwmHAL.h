@@ -323,6 +323,25 @@ public:
       */
      void setAdcTrigger(hrtim_tu_number_t pwmX, adc_t adc);
 
+     /**
+      * @brief This function sets the adc injected trigger linked to a timer
+      *        unit. Injected conversions are then triggered at the instant
+      *        set by setAdcTriggerInstant(), e.g. 0.5 for the middle of the
+      *        PWM period in center-aligned mode.
+      *
+      * @param[in] pwmX  PWM Unit: `PWMA`,`PWMB`,`PWMC`,`PWMD`,`PWME`,`PWMF`
+      * @param[in] adc   ADC number: `ADC_1`,`ADC_2`
+      * @warning Call this function:
+      *
+      *          - BEFORE enabling the adc trigger
+      *
+      *          - AFTER initializing the selected timer
+      *
+      *          A timer unit can trigger either the regular or the
+      *          injected conversions of an ADC, not both.
+      */
+     void setAdcInjectedTrigger(hrtim_tu_number_t pwmX, adc_t adc);
+
      /**
       * @brief This function returns the adc trigger linked to a timer unit
       *
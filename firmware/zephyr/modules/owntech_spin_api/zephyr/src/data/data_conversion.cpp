@@ -41,11 +41,33 @@
  *  Local Variables
  */
 
-static const uint8_t max_parameters_count = 2;
+static const uint8_t max_parameters_count = 4;
 
 static conversion_type_t conversion_types[ADC_COUNT][CHANNELS_PER_ADC];
 static float32_t* conversion_parameters[ADC_COUNT][CHANNELS_PER_ADC];
 
+/**
+ * Scale applied to raw values before conversion, bringing
+ * oversampled values back to the 12-bit range so that
+ * conversion parameters do not depend on oversampling.
+ */
+static float32_t raw_scales[ADC_COUNT] = {1, 1, 1, 1, 1};
+static int8_t    raw_extra_bits[ADC_COUNT] = {0};
+
+/* Incremented each time conversion parameters are modified */
+static uint32_t parameters_revision = 0;
+
+/**
+ * Fixed-point conversion: a Q15 value v is v * full_scale / 32768.
+ * A null full scale means fixed-point is disabled for the channel.
+ * Gain is split as expected by arm_scale_q15(): a Q15 fractional
+ * part and a left shift.
+ */
+static float32_t q15_full_scales[ADC_COUNT][CHANNELS_PER_ADC] = {0};
+static q15_t     q15_gains[ADC_COUNT][CHANNELS_PER_ADC]       = {0};
+static int8_t    q15_gain_shifts[ADC_COUNT][CHANNELS_PER_ADC] = {0};
+static q15_t     q15_offsets[ADC_COUNT][CHANNELS_PER_ADC]     = {0};
+
 /* voltage reference from ADC */
 #define VREF 2.048f
 /* ADC resolution */
@@ -53,6 +75,24 @@ static float32_t* conversion_parameters[ADC_COUNT][CHANNELS_PER_ADC];
 /* Input voltage in the voltage divider */
 #define Vin_divider 3.3f
 
+#if CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT > 0
+/**
+ * Thermistor channels conversion look-up tables.
+ * Each table holds the temperature for raw values 0, 16, 32... 4096,
+ * values in between are linearly interpolated.
+ * therm_lut_slots[x][y] is 0 if ADC x+1 channel y has no table,
+ * or the table index plus one.
+ */
+#define THERM_LUT_SHIFT 4
+#define THERM_LUT_STEP  (1 << THERM_LUT_SHIFT)
+#define THERM_LUT_SIZE  ((4096 >> THERM_LUT_SHIFT) + 1)
+
+static float32_t therm_luts[CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT]
+						  [THERM_LUT_SIZE];
+static uint8_t therm_lut_slots[ADC_COUNT][CHANNELS_PER_ADC] = {0};
+static uint8_t therm_luts_used = 0;
+#endif
+
 /**
  * Private functions
  */
@@ -81,10 +121,125 @@ static uint8_t _data_conversion_get_parameters_count(conversion_type_t type)
 	return parameters_count;
 }
 
+static float32_t _data_conversion_convert_therm(const float32_t* parameters,
+												float32_t raw_value)
+{
+	/* Retrieves the parameters for the thermo resistor */
+	float32_t local_r0   = parameters[0];
+	float32_t local_b    = parameters[1];
+	float32_t local_rdiv = parameters[2];
+	float32_t local_t0   = parameters[3];
+
+	/* converts raw values into voltage */
+	float32_t V_adc = (raw_value/QUANTUM_MAX)*VREF;
+
+	/* uses a bridge divider equation
+	 * to estimate the sensor resistance */
+	float32_t R_t = (V_adc/(Vin_divider - V_adc)) * local_rdiv;
+
+	/* original equation R = exp(B*(1/T - 1/T0)) */
+	float32_t T =
+		local_t0 /
+		( 1 + (float32_t)log(R_t/local_r0) * (local_t0/local_b));
+
+	/* returns value in degree Celsius */
+	return (T - 273.15f);
+}
+
+static q15_t _data_conversion_saturate_q15(float32_t value)
+{
+	if (value >= 32767.0f)
+	{
+		return 32767;
+	}
+	else if (value <= -32768.0f)
+	{
+		return -32768;
+	}
+
+	return (q15_t)roundf(value);
+}
+
+static void _data_conversion_update_q15_parameters(uint8_t adc_index,
+												   uint8_t channel_index)
+{
+	float32_t full_scale = q15_full_scales[adc_index][channel_index];
+	if (full_scale == 0)
+		return;
+
+	float32_t gain   = conversion_parameters[adc_index][channel_index][0];
+	float32_t offset = conversion_parameters[adc_index][channel_index][1];
+
+	/**
+	 * Raw value r is converted to r * scale * gain * 32768 / full_scale.
+	 * Find the shift that brings this factor in [-1, 1) with
+	 * as much precision as possible.
+	 */
+	float32_t factor = gain * raw_scales[adc_index] * 32768.0f / full_scale;
+	int8_t    shift  = 0;
+
+	if (factor != 0)
+	{
+		while ( (fabsf(factor) >= 1.0f) && (shift < 15) )
+		{
+			factor /= 2;
+			shift++;
+		}
+		while ( (fabsf(factor) < 0.5f) && (shift > -16) )
+		{
+			factor *= 2;
+			shift--;
+		}
+		/* Make sure rounding does not overflow */
+		if ( (roundf(factor * 32768.0f) >= 32768.0f) && (shift < 15) )
+		{
+			factor /= 2;
+			shift++;
+		}
+	}
+
+	q15_gains[adc_index][channel_index]       =
+							_data_conversion_saturate_q15(factor * 32768.0f);
+	q15_gain_shifts[adc_index][channel_index] = shift;
+	q15_offsets[adc_index][channel_index]     =
+							_data_conversion_saturate_q15(offset * 32768.0f /
+														  full_scale);
+}
+
+#if CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT > 0
+static void _data_conversion_build_therm_lut(uint8_t adc_index,
+											 uint8_t channel_index)
+{
+	uint8_t slot = therm_lut_slots[adc_index][channel_index];
+	if (slot == 0)
+	{
+		/* No more table available: channel will use the equation */
+		if (therm_luts_used >= CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT)
+			return;
+
+		therm_luts_used++;
+		slot = therm_luts_used;
+	}
+
+	float32_t* lut = therm_luts[slot-1];
+	for (uint16_t i = 0 ; i < THERM_LUT_SIZE ; i++)
+	{
+		lut[i] = _data_conversion_convert_therm(
+					conversion_parameters[adc_index][channel_index],
+					(float32_t)(i << THERM_LUT_SHIFT)
+				 );
+	}
+
+	therm_lut_slots[adc_index][channel_index] = slot;
+}
+#endif
+
 /* Public functions */
 
 void data_conversion_init()
 {
+	parameters_revision++;
+
 	/* Make sure all channels have conversion parameters */
 	for (int adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
 	{
@@ -109,6 +264,8 @@ void data_conversion_init()
 						 * and default offset to 0 */
 						conversion_parameters[adc_index][channel_index][0]= 1;
 						conversion_parameters[adc_index][channel_index][1]= 0;
+						_data_conversion_update_q15_parameters(adc_index,
+															   channel_index);
 						break;
 					case conversion_therm:
 						/* For therm conversion, set all parameters to 1
@@ -133,44 +290,42 @@ float32_t data_conversion_convert_raw_value(uint8_t adc_num,
 	uint8_t adc_index     = adc_num - 1;
 	uint8_t channel_index = channel_num - 1;
 
+	float32_t scaled_value = raw_value * raw_scales[adc_index];
+
 	switch(conversion_types[adc_index][channel_index])
 	{
 		case conversion_linear:
-			return (raw_value *
+			return (scaled_value *
 					conversion_parameters[adc_index][channel_index][0]) +
 					(conversion_parameters[adc_index][channel_index][1]);
 			break;
 		case conversion_therm:
 		{
-			/* Retrieves the parameters for the thermo resistor */
-			float32_t local_r0 =
-					conversion_parameters[adc_index][channel_index][0];
-
-			float32_t local_b =
-					conversion_parameters[adc_index][channel_index][1];
-
-			float32_t local_rdiv =
-					conversion_parameters[adc_index][channel_index][2];
-
-			float32_t local_t0 =
-					conversion_parameters[adc_index][channel_index][3];
-
-			/* converts raw values into voltage */
-			float32_t V_adc = (raw_value/QUANTUM_MAX)*VREF;
-
-			/* uses a bridge divider equation
-			 * to estimate the sensor resistance */
-			float32_t R_t = (V_adc/(Vin_divider - V_adc)) * local_rdiv;
-
-			/* original equation R = exp(B*(1/T - 1/T0)) */
-			float32_t T =
-				local_t0 /
-				( 1 + (float32_t)log(R_t/local_r0) * (local_t0/local_b));
+#if CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT > 0
+			/**
+			 * The equation diverges close to 0, so the first segment
+			 * is not interpolated
+			 */
+			uint8_t slot = therm_lut_slots[adc_index][channel_index];
+			if ( (slot != 0) &&
+				 (scaled_value >= THERM_LUT_STEP) &&
+				 (scaled_value < QUANTUM_MAX) )
+			{
+				const float32_t* lut = therm_luts[slot-1];
+				float32_t position  = scaled_value * (1.0f/THERM_LUT_STEP);
+				uint16_t  lut_index = (uint16_t)position;
+				float32_t fraction  = position - lut_index;
 
-			/* returns value in degree Celsius */
-			return (T - 273.15f);
+				return lut[lut_index] +
+					   (lut[lut_index+1] - lut[lut_index]) * fraction;
+			}
+#endif
+			return _data_conversion_convert_therm(
+						conversion_parameters[adc_index][channel_index],
+						scaled_value
+				   );
 			break;
-		}			break;
+		}
 		case no_channel_error:
 			return ERROR_CHANNEL_NOT_FOUND;
 			break;
@@ -200,6 +355,10 @@ void data_conversion_set_conversion_parameters_linear(
 
 	conversion_parameters[adc_index][channel_index][0] = gain;
 	conversion_parameters[adc_index][channel_index][1] = offset;
+
+	_data_conversion_update_q15_parameters(adc_index, channel_index);
+
+	parameters_revision++;
 }
 
 void data_conversion_set_conversion_parameters_therm(
@@ -226,6 +385,12 @@ void data_conversion_set_conversion_parameters_therm(
 	conversion_parameters[adc_index][channel_index][1] = b;
 	conversion_parameters[adc_index][channel_index][2] = rdiv;
 	conversion_parameters[adc_index][channel_index][3] = t0;
+
+#if CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT > 0
+	_data_conversion_build_therm_lut(adc_index, channel_index);
+#endif
+
+	parameters_revision++;
 }
 
 conversion_type_t data_conversion_get_conversion_type(
@@ -264,6 +429,113 @@ float32_t data_conversion_get_parameter(
 	return 0;
 }
 
+int8_t data_conversion_set_q15_full_scale(uint8_t adc_num,
+										  uint8_t channel_num,
+										  float32_t full_scale)
+{
+	uint8_t adc_index     = adc_num - 1;
+	uint8_t channel_index = channel_num - 1;
+
+	if (conversion_types[adc_index][channel_index] != conversion_linear)
+	{
+		return -1;
+	}
+
+	q15_full_scales[adc_index][channel_index] = fabsf(full_scale);
+
+	/* Otherwise, this is done when default parameters are set */
+	if (conversion_parameters[adc_index][channel_index] != nullptr)
+	{
+		_data_conversion_update_q15_parameters(adc_index, channel_index);
+	}
+
+	parameters_revision++;
+
+	return 0;
+}
+
+float32_t data_conversion_get_q15_full_scale(uint8_t adc_num,
+											 uint8_t channel_num)
+{
+	uint8_t adc_index     = adc_num - 1;
+	uint8_t channel_index = channel_num - 1;
+
+	if (conversion_types[adc_index][channel_index] != conversion_linear)
+	{
+		return 0;
+	}
+
+	return q15_full_scales[adc_index][channel_index];
+}
+
+int8_t data_conversion_convert_raw_values_q15(uint8_t adc_num,
+											  uint8_t channel_num,
+											  const uint16_t* raw_values,
+											  q15_t* q15_values,
+											  uint32_t count)
+{
+	uint8_t adc_index     = adc_num - 1;
+	uint8_t channel_index = channel_num - 1;
+
+	if ( (conversion_types[adc_index][channel_index] != conversion_linear) ||
+		 (q15_full_scales[adc_index][channel_index] == 0) ||
+		 (raw_extra_bits[adc_index] > 3) )
+	{
+		return -1;
+	}
+
+	/**
+	 * Raw values are below 32768 with at most 3 extra bits,
+	 * so they are valid positive Q15 values
+	 */
+	arm_scale_q15((const q15_t*)raw_values,
+				  q15_gains[adc_index][channel_index],
+				  q15_gain_shifts[adc_index][channel_index],
+				  q15_values,
+				  count);
+
+	arm_offset_q15(q15_values,
+				   q15_offsets[adc_index][channel_index],
+				   q15_values,
+				   count);
+
+	return 0;
+}
+
+void data_conversion_set_adc_extra_bits(uint8_t adc_num, int8_t extra_bits)
+{
+	uint8_t adc_index = adc_num - 1;
+
+	raw_extra_bits[adc_index] = extra_bits;
+	raw_scales[adc_index]     = ldexpf(1.0f, -extra_bits);
+
+	/* Fixed-point factors include the raw scale */
+	for (int channel_index = 0 ;
+		 channel_index < CHANNELS_PER_ADC ;
+		 channel_index++)
+	{
+		if ( (conversion_types[adc_index][channel_index] == conversion_linear) &&
+			 (conversion_parameters[adc_index][channel_index] != nullptr) )
+		{
+			_data_conversion_update_q15_parameters(adc_index, channel_index);
+		}
+	}
+
+	parameters_revision++;
+}
+
+float32_t data_conversion_get_raw_scale(uint8_t adc_num)
+{
+	uint8_t adc_index = adc_num - 1;
+
+	return raw_scales[adc_index];
+}
+
+uint32_t data_conversion_get_parameters_revision()
+{
+	return parameters_revision;
+}
+
 int8_t data_conversion_store_channel_parameters_in_nvs(uint8_t adc_num,
 													   uint8_t channel_num)
 {
@@ -394,6 +666,21 @@ int8_t data_conversion_retrieve_channel_parameters_from_nvs(uint8_t adc_num,
 				conversion_parameters[adc_index][channel_index][i] =
 								*((float32_t*)&buffer[string_len + 4 + 4*i]);
 			}
+
+			if (conversion_type == conversion_linear)
+			{
+				_data_conversion_update_q15_parameters(adc_index,
+													   channel_index);
+			}
+
+#if CONFIG_OWNTECH_DATA_CONVERSION_THERM_LUT_COUNT > 0
+			if (conversion_type == conversion_therm)
+			{
+				_data_conversion_build_therm_lut(adc_index, channel_index);
+			}
+#endif
+
+			parameters_revision++;
 		}
 	}
 	else
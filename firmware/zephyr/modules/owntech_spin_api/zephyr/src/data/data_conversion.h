@@ -124,6 +124,90 @@ float32_t data_conversion_get_parameter(uint8_t adc_num,
 										uint8_t channel_num,
 										uint8_t parameter_num);
 
+/**
+ * @brief Enable fixed-point conversion for a channel with linear
+ *        conversion. Converted values are expressed in Q15 format,
+ *        relative to full_scale: a Q15 value v represents
+ *        v * full_scale / 32768 in the channel unit.
+ *        Q15 gain and offset are computed from the current linear
+ *        parameters, and updated when these parameters change.
+ *        As gain is applied before offset, full_scale must be
+ *        greater than both the converted values and the values
+ *        before offset is added.
+ *
+ * @param[in] adc_num     ADC number
+ * @param[in] channel_num Channel number
+ * @param[in] full_scale  Absolute value of the physical value matching
+ *                        Q15 full scale, 0 to disable fixed-point.
+ *
+ * @return 0 if fixed-point conversion has been configured,
+ *         -1 if the channel does not use linear conversion.
+ */
+int8_t data_conversion_set_q15_full_scale(uint8_t adc_num,
+										  uint8_t channel_num,
+										  float32_t full_scale);
+
+/**
+ * @brief Get the Q15 full scale of a channel.
+ *
+ * @param[in] adc_num     ADC number
+ * @param[in] channel_num Channel number
+ *
+ * @return Full scale of the channel, 0 if fixed-point is disabled.
+ */
+float32_t data_conversion_get_q15_full_scale(uint8_t adc_num,
+											 uint8_t channel_num);
+
+/**
+ * @brief Converts raw values into Q15 values, relative to the channel
+ *        full scale. Results are saturated.
+ *
+ * @param[in]  adc_num     ADC number
+ * @param[in]  channel_num Channel number
+ * @param[in]  raw_values  Values to convert. Must be below 32768.
+ * @param[out] q15_values  Buffer to store converted values, can be the
+ *                         same as raw_values.
+ * @param[in]  count       Number of values to convert.
+ *
+ * @return 0 if values have been converted, -1 if fixed-point conversion
+ *         is not enabled for the channel or if the ADC oversampling
+ *         adds more than 3 bits.
+ */
+int8_t data_conversion_convert_raw_values_q15(uint8_t adc_num,
+											  uint8_t channel_num,
+											  const uint16_t* raw_values,
+											  q15_t* q15_values,
+											  uint32_t count);
+
+/**
+ * @brief Set the number of bits added to the 12-bit resolution
+ *        of an ADC by oversampling. Raw values of this ADC are
+ *        then scaled by 2^-extra_bits before conversion, so that
+ *        conversion parameters stay relative to 12-bit values.
+ *
+ * @param adc_num Number of the ADC
+ * @param extra_bits Number of extra bits, may be negative.
+ */
+void data_conversion_set_adc_extra_bits(uint8_t adc_num, int8_t extra_bits);
+
+/**
+ * @brief Get the scale applied to raw values of an ADC before
+ *        conversion.
+ *
+ * @param adc_num Number of the ADC
+ * @return 2^-extra_bits, 1 when oversampling is disabled.
+ */
+float32_t data_conversion_get_raw_scale(uint8_t adc_num);
+
+/**
+ * @brief Get the conversion parameters revision. The revision
+ *        changes each time the conversion parameters of any
+ *        channel are modified, which allows caching them.
+ *
+ * @return Current revision of the conversion parameters.
+ */
+uint32_t data_conversion_get_parameters_revision();
+
 /**
  * @brief Store the currently configured conversion parameters
  * 		  of a given channel in NVS.
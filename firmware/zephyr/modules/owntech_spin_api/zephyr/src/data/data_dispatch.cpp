@@ -30,6 +30,7 @@
 
 /* Zephyr */
 #include <zephyr/kernel.h>
+#include <soc.h>
 
 /* OwnTech API */
 #include "adc.h"
@@ -37,6 +38,7 @@
 
 /* Current module header */
 #include "dma.h"
+#include "timing_stats.h"
 
 /* Current file header */
 #include "data_dispatch.h"
@@ -46,35 +48,44 @@
  */
 
 /* Number of channels in each ADC (cell i is ADC number i+1) */
-static uint8_t* enabled_channels_count = nullptr;
+static uint8_t enabled_channels_count[ADC_COUNT] = {0};
 
 /**
- * Array of per-adc/per-channel buffers.
- * adc_channel_buffers[x][y][z][] is ADC x+1 channel y buffer z
+ * Position of the first channel of each ADC in the arena below
+ * (cell i is ADC number i+1). Channels of an ADC are contiguous,
+ * so ADC x+1 channel y is stored in slot channels_offset[x]+y.
+ */
+static uint8_t channels_offset[ADC_COUNT] = {0};
+
+/**
+ * Per-channel buffers arena, shared by all ADCs.
+ * adc_channel_buffers[s][z][] is slot s buffer z,
  * with z either 0 or 1 as there are two buffers per channel (double buffering)
  */
-static uint16_t**** adc_channel_buffers = nullptr;
+static uint16_t adc_channel_buffers[DATA_DISPATCH_MAX_CHANNELS]
+								   [2]
+								   [CHANNELS_BUFFERS_SIZE];
 
 /**
  * Number of readings stored in each channel.
- * buffers_data_count[x][y] is the current number of
- * values stored in the currently written buffer of ADC x+1 Channel y
+ * buffers_data_count[s] is the current number of
+ * values stored in the currently written buffer of slot s
  */
-static uint32_t** buffers_data_count = nullptr;
+static uint32_t buffers_data_count[DATA_DISPATCH_MAX_CHANNELS] = {0};
 
 /**
  * Currently written buffer for each channel.
  * Either 0 or 1.
- * If current_buffer[x][y] is 0, the currently written buffer
- * for ADC x+1 Channel y is buffer 0 and the user buffer is buffer 1
+ * If current_buffer[s] is 0, the currently written buffer
+ * for slot s is buffer 0 and the user buffer is buffer 1
  */
-static uint8_t** current_buffer = nullptr;
+static uint8_t current_buffer[DATA_DISPATCH_MAX_CHANNELS] = {0};
 
 /**
  * Small memory to retain latest value available to
  * the peek() function after a buffer swap.
  */
-static uint16_t** peek_memory = nullptr;
+static uint16_t peek_memory[DATA_DISPATCH_MAX_CHANNELS] = {0};
 
 /**
  * DMA buffers: data from the ADC 1/2 are stored in these
@@ -89,71 +100,313 @@ static uint16_t* dma_secondary_buffers[ADC_COUNT] = {0};
 static uint8_t   current_dma_buffer[ADC_COUNT]    = {0};
 static size_t    dma_buffer_sizes[ADC_COUNT]      = {0};
 
+/**
+ * Number of ADC values held in each DMA transfer (cell i is ADC number i+1).
+ * This is 1 for independent ADCs. In dual mode, ADC 1 transfers are
+ * 32-bit words packing ADC 1 and ADC 2 values, so this is 2 for ADC 1
+ * and 0 for ADC 2, which is dispatched along with ADC 1.
+ */
+static uint8_t dma_values_per_transfer[ADC_COUNT] = {0};
+
+/**
+ * Task mode only: position in the circular DMA buffer
+ * of the first value that has not been dispatched yet.
+ */
+static size_t next_dma_buffer_index[ADC_COUNT] = {0};
+
 /* Dispatch method */
 static dispatch_t dispatch_type;
 
+/**
+ * Dispatch sequence number, incremented once per acquisition cycle.
+ * In interrupt mode, ADCs are dispatched one by one: the cycle is
+ * counted on the dispatches of the first ADC with a DMA.
+ */
+static uint32_t dispatch_sequence  = 0;
+static uint8_t  sequence_adc_index = 0;
+
+/**
+ * Timestamp of the latest dispatch of each ADC, and statistics
+ * on the period between dispatches (cell i is ADC number i+1).
+ * Timestamps are CPU cycles counts.
+ */
+static uint32_t       dispatch_timestamps[ADC_COUNT] = {0};
+static timing_stats_t dispatch_timing_stats[ADC_COUNT];
+
+/* Dispatch kernel matching the dispatch method */
+typedef void (*dispatch_kernel_t)(uint8_t adc_index);
+static dispatch_kernel_t dispatch_kernel = nullptr;
+
+/**
+ * Interrupt mode only: function called every
+ * callback_repetitions dispatches of ADC callback_adc_index.
+ */
+static dispatch_callback_t dispatch_callback    = nullptr;
+static uint8_t             callback_adc_index   = 0;
+static uint32_t            callback_repetitions = 1;
+static uint32_t            callback_countdown   = 1;
+
 /**
  * Private Functions
  */
 
-__STATIC_INLINE uint16_t* _data_dispatch_get_buffer(uint8_t adc_index,
-													uint8_t channel_index)
+__STATIC_INLINE uint32_t _data_dispatch_get_timestamp()
 {
-	uint8_t active_buffer = current_buffer[adc_index][channel_index];
-	return adc_channel_buffers[adc_index][channel_index][active_buffer];
+	return DWT->CYCCNT;
+}
+
+/* In dual mode, slave ADC is dispatched along with its master */
+__STATIC_INLINE uint8_t _data_dispatch_get_dispatching_adc(uint8_t adc_index)
+{
+	if ( (adc_index > 0) && (dma_values_per_transfer[adc_index-1] == 2) )
+		return adc_index-1;
+
+	return adc_index;
 }
 
-__STATIC_INLINE uint32_t _data_dispatch_get_count(uint8_t adc_index,
-												  uint8_t channel_index)
+__STATIC_INLINE uint8_t _data_dispatch_get_slot(uint8_t adc_index,
+												uint8_t channel_index)
 {
-	return buffers_data_count[adc_index][channel_index];
+	return channels_offset[adc_index] + channel_index;
 }
 
-__STATIC_INLINE void _data_dispatch_increment_count(uint8_t adc_index,
-													uint8_t channel_index)
+__STATIC_INLINE uint16_t* _data_dispatch_get_buffer(uint8_t slot)
 {
-	uint32_t* current_count = &buffers_data_count[adc_index][channel_index];
-	if ( (*current_count) < CHANNELS_BUFFERS_SIZE)
+	return adc_channel_buffers[slot][current_buffer[slot]];
+}
+
+__STATIC_INLINE void _data_dispatch_swap_buffers(uint8_t slot)
+{
+	current_buffer[slot] ^= 1;
+	buffers_data_count[slot] = 0;
+}
+
+/**
+ * De-interleave a contiguous run of DMA data to the channel buffers.
+ * dma_data[0] belongs to channel first_channel_index, and channels
+ * follow each other in rank order every data_stride half-words, so each
+ * channel is copied with a fixed stride equal to the channels count
+ * times data_stride.
+ * When a channel buffer is full, its last value is overwritten so
+ * that the latest acquired value is always retained.
+ */
+__STATIC_INLINE void _data_dispatch_deinterleave(uint8_t         adc_index,
+												 const uint16_t* dma_data,
+												 size_t          data_count,
+												 uint8_t         first_channel_index,
+												 uint8_t         data_stride)
+{
+	uint8_t channels_count = enabled_channels_count[adc_index];
+	uint8_t first_slot     = channels_offset[adc_index];
+	size_t  channel_stride = channels_count * data_stride;
+
+	for (uint8_t i = 0 ; (i < channels_count) && (i < data_count) ; i++)
 	{
-		(*current_count)++;
+		uint8_t channel_index = first_channel_index + i;
+		if (channel_index >= channels_count)
+		{
+			channel_index -= channels_count;
+		}
+
+		uint8_t   slot          = first_slot + channel_index;
+		uint16_t* active_buffer = _data_dispatch_get_buffer(slot);
+		uint32_t  current_count = buffers_data_count[slot];
+
+		/* Number of values for this channel in the run */
+		size_t values_count = (data_count - i + channels_count - 1) /
+							  channels_count;
+		size_t room         = CHANNELS_BUFFERS_SIZE - current_count;
+		size_t copy_count   = (values_count < room) ? values_count : room;
+
+		const uint16_t* source = dma_data + i * data_stride;
+		for (size_t j = 0 ; j < copy_count ; j++)
+		{
+			active_buffer[current_count + j] = *source;
+			source += channel_stride;
+		}
+		current_count += copy_count;
+
+		if (values_count > copy_count)
+		{
+			size_t last_index = i * data_stride +
+								(values_count - 1) * channel_stride;
+			active_buffer[CHANNELS_BUFFERS_SIZE - 1] = dma_data[last_index];
+		}
+
+		buffers_data_count[slot] = current_count;
 	}
 }
 
-__STATIC_INLINE void _data_dispatch_swap_buffers(uint8_t adc_index,
-												 uint8_t channel_index)
+/**
+ * Dispatch a contiguous run of DMA transfers.
+ * In dual mode, each transfer is a 32-bit word packing the master value
+ * in its lower half-word and the slave value in its upper half-word.
+ * In memory, this is the master value followed by the slave value, so
+ * both ADCs are de-interleaved from the same data with a stride of 2.
+ */
+__STATIC_INLINE void _data_dispatch_unpack(uint8_t         adc_index,
+										   const uint16_t* dma_data,
+										   size_t          transfers_count,
+										   uint8_t         first_channel_index)
 {
-	uint8_t* active_buffer = &current_buffer[adc_index][channel_index];
+	if (dma_values_per_transfer[adc_index] == 2)
+	{
+		_data_dispatch_deinterleave(adc_index,
+									dma_data,
+									transfers_count,
+									first_channel_index,
+									2);
+		_data_dispatch_deinterleave(adc_index + 1,
+									dma_data + 1,
+									transfers_count,
+									first_channel_index,
+									2);
+	}
+	else
+	{
+		_data_dispatch_deinterleave(adc_index,
+									dma_data,
+									transfers_count,
+									first_channel_index,
+									1);
+	}
+}
 
-	*active_buffer = ((*active_buffer) == 0) ? 1 : 0;
-	buffers_data_count[adc_index][channel_index] = 0;
+/**
+ * Free the DMA buffers of the previous initialization.
+ */
+static void _data_dispatch_free_dma_buffers()
+{
+	for (uint8_t adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
+	{
+		k_free(dma_main_buffers[adc_index]);
+		dma_main_buffers[adc_index]      = nullptr;
+		dma_secondary_buffers[adc_index] = nullptr;
+	}
+}
+
+/**
+ * Failed initialization: no channel is dispatched.
+ */
+static int8_t _data_dispatch_init_error()
+{
+	_data_dispatch_free_dma_buffers();
+	for (uint8_t adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
+	{
+		enabled_channels_count[adc_index] = 0;
+	}
+	return -1;
+}
+
+/**
+ * Dispatch kernels, one per dispatch method.
+ */
+
+template <dispatch_t method>
+static void _data_dispatch_kernel(uint8_t adc_index);
+
+/**
+ * Interrupt mode: DMA buffer is split in two halves, each
+ * holding exactly one value per channel starting with rank 1.
+ * The callback is called each time a half has been filled.
+ */
+template <>
+void _data_dispatch_kernel<interrupt>(uint8_t adc_index)
+{
+	uint16_t* dma_buffer = dma_main_buffers[adc_index];
+	if (current_dma_buffer[adc_index] == 0)
+	{
+		current_dma_buffer[adc_index] = 1;
+	}
+	else
+	{
+		dma_buffer = dma_secondary_buffers[adc_index];
+		current_dma_buffer[adc_index] = 0;
+	}
+
+	_data_dispatch_unpack(adc_index,
+						  dma_buffer,
+						  enabled_channels_count[adc_index],
+						  0);
+}
+
+/**
+ * Task mode: DMA buffer is circular, and its size is a multiple
+ * of the channels count. New data is dispatched as at most two
+ * contiguous runs: up to the end of the buffer, then from its start.
+ */
+template <>
+void _data_dispatch_kernel<task>(uint8_t adc_index)
+{
+	uint16_t* dma_buffer      = dma_main_buffers[adc_index];
+	size_t    dma_buffer_size = dma_buffer_sizes[adc_index];
+	size_t    start_index     = next_dma_buffer_index[adc_index];
+	size_t    data_count      = dma_get_retrieved_data_count(adc_index+1);
+	uint8_t   values_count    = dma_values_per_transfer[adc_index];
+
+	size_t first_run_count = dma_buffer_size - start_index;
+	if (data_count < first_run_count)
+	{
+		first_run_count = data_count;
+	}
+
+	_data_dispatch_unpack(adc_index,
+						  dma_buffer + start_index * values_count,
+						  first_run_count,
+						  start_index % enabled_channels_count[adc_index]);
+
+	if (data_count > first_run_count)
+	{
+		_data_dispatch_unpack(adc_index,
+							  dma_buffer,
+							  data_count - first_run_count,
+							  0);
+	}
+
+	start_index += data_count;
+	if (start_index >= dma_buffer_size)
+	{
+		start_index -= dma_buffer_size;
+	}
+	next_dma_buffer_index[adc_index] = start_index;
 }
 
 /**
  * Public API
  */
 
-void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
+int8_t data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
 {
 	/* Store dispatch method */
 	dispatch_type = dispatch_method;
 
-	/* Prepare arrays for each ADC */
-	enabled_channels_count =
-				(uint8_t*)    k_malloc(ADC_COUNT * sizeof(uint8_t));
+	/* Buffers are about to move: user must register callback again */
+	dispatch_callback = nullptr;
 
-	adc_channel_buffers    =
-				(uint16_t****)k_calloc(ADC_COUNT,  sizeof(uint16_t***));
+	/* Enable cycle counter used for timestamps */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 
-	buffers_data_count     =
-				(uint32_t**)  k_calloc(ADC_COUNT,  sizeof(uint32_t*));
+	/* Restart statistics, keeping configuration set before start */
+	for (uint8_t adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
+	{
+		timing_stats_t* stats = &dispatch_timing_stats[adc_index];
 
-	current_buffer         =
-				(uint8_t**)   k_calloc(ADC_COUNT,  sizeof(uint8_t*));
+		dispatch_timestamps[adc_index] = 0;
+		timing_stats_reset(stats, stats->expected_period, stats->bin_width);
+	}
 
-	peek_memory            =
-				(uint16_t**)  k_calloc(ADC_COUNT,  sizeof(uint16_t*));
+	if (dispatch_type == interrupt)
+	{
+		dispatch_kernel = _data_dispatch_kernel<interrupt>;
+	}
+	else
+	{
+		dispatch_kernel = _data_dispatch_kernel<task>;
+	}
 
-	/* Configure DMA 1 channels */
+	/* Lay out channels of all ADCs in the arena */
+	uint8_t total_channels_count = 0;
 	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
 	{
 		uint8_t adc_index = adc_num-1;
@@ -161,8 +414,56 @@ void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
 		enabled_channels_count[adc_index] =
 						adc_get_enabled_channels_count(adc_num);
 
-		/* Ignore this ADC if it has no enabled channel */
-		if (enabled_channels_count[adc_index] > 0)
+		channels_offset[adc_index] = total_channels_count;
+		total_channels_count += enabled_channels_count[adc_index];
+	}
+
+	/* Conversions are stopped: DMA buffers are no longer written */
+	_data_dispatch_free_dma_buffers();
+
+	if (total_channels_count > DATA_DISPATCH_MAX_CHANNELS)
+	{
+		return _data_dispatch_init_error();
+	}
+
+	for (uint8_t slot = 0 ; slot < total_channels_count ; slot++)
+	{
+		buffers_data_count[slot] = 0;
+		current_buffer[slot]     = 0;
+		peek_memory[slot]        = PEEK_NO_VALUE;
+	}
+
+	/* ADC 2 data comes packed with ADC 1 data in dual mode */
+	bool dual_mode = adc_is_dual_mode_active();
+	for (uint8_t adc_index = 0 ; adc_index < ADC_COUNT ; adc_index++)
+	{
+		dma_values_per_transfer[adc_index] = 1;
+	}
+	if (dual_mode == true)
+	{
+		dma_values_per_transfer[0] = 2;
+		dma_values_per_transfer[1] = 0;
+	}
+
+	/* First ADC with a DMA counts the acquisition cycles on interrupt */
+	sequence_adc_index = ADC_COUNT;
+	for (uint8_t adc_index = ADC_COUNT ; adc_index > 0 ; adc_index--)
+	{
+		if ( (enabled_channels_count[adc_index-1] > 0) &&
+			 (dma_values_per_transfer[adc_index-1] > 0) )
+		{
+			sequence_adc_index = adc_index-1;
+		}
+	}
+
+	/* Configure DMA 1 channels */
+	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
+	{
+		uint8_t adc_index = adc_num-1;
+
+		/* Ignore this ADC if it has no enabled channel or no DMA */
+		if ( (enabled_channels_count[adc_index] > 0) &&
+			 (dma_values_per_transfer[adc_index] > 0) )
 		{
 			/* Prepare buffers for DMA */
 			size_t dma_buffer_size;
@@ -200,15 +501,31 @@ void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
 				}
 			}
 
-			dma_buffer_sizes[adc_index] = dma_buffer_size;
+			/* Buffer size in half-words */
+			uint8_t values_count   = dma_values_per_transfer[adc_index];
+			size_t  dma_words_size = dma_buffer_size * values_count;
+
+			dma_buffer_sizes[adc_index]      = dma_buffer_size;
+			current_dma_buffer[adc_index]    = 0;
+			next_dma_buffer_index[adc_index] = 0;
 			dma_main_buffers[adc_index] =
-					(uint16_t*)k_malloc(dma_buffer_size * sizeof(uint16_t));
+					(uint16_t*)k_malloc(dma_words_size * sizeof(uint16_t));
+			if (dma_main_buffers[adc_index] == nullptr)
+			{
+				return _data_dispatch_init_error();
+			}
+
+			/* Mark buffer as empty for data_dispatch_get_latest_dma_word() */
+			for (size_t i = 0 ; i < dma_words_size ; i++)
+			{
+				dma_main_buffers[adc_index][i] = PEEK_NO_VALUE;
+			}
 
 			if (dispatch_type == interrupt)
 			{
 				dma_secondary_buffers[adc_index] =
 						dma_main_buffers[adc_index] +
-						enabled_channels_count[adc_index];
+						enabled_channels_count[adc_index] * values_count;
 			}
 
 			/* Initialize DMA */
@@ -217,141 +534,160 @@ void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions)
 			{
 				disable_interrupts = true;
 			}
-			dma_configure_adc_acquisition(adc_num,
-										  disable_interrupts,
-										  dma_main_buffers[adc_index],
-										  dma_buffer_size);
-
-			/* Prepare arrays for each channel */
-			adc_channel_buffers[adc_index] =
-					(uint16_t***)k_malloc(
-						enabled_channels_count[adc_index] * sizeof(uint16_t**)
-					);
-
-			buffers_data_count[adc_index] =
-					(uint32_t*)k_calloc(
-						enabled_channels_count[adc_index],
-						sizeof(uint32_t)
-					);
-
-			current_buffer[adc_index]     =
-					(uint8_t*) k_calloc(
-						enabled_channels_count[adc_index],
-						sizeof(uint8_t)
-					);
-
-			peek_memory[adc_index]        =
-					(uint16_t*)k_calloc(
-						enabled_channels_count[adc_index],
-						sizeof(uint16_t)
-					);
-
-			for (int channel_index = 0 ;
-				 channel_index < enabled_channels_count[adc_index] ;
-				 channel_index++)
+			if (values_count == 2)
 			{
-				/* Prepare double buffer */
-				adc_channel_buffers[adc_index][channel_index] =
-					(uint16_t**)k_malloc(
-									sizeof(uint16_t*) * 2
-								);
-
-				adc_channel_buffers[adc_index][channel_index][0] =
-					(uint16_t*)k_malloc(
-									sizeof(uint16_t) * CHANNELS_BUFFERS_SIZE
-							   );
-
-				adc_channel_buffers[adc_index][channel_index][1] =
-					(uint16_t*)k_malloc(
-									sizeof(uint16_t) * CHANNELS_BUFFERS_SIZE
-							   );
-
-				peek_memory[adc_index][channel_index] = PEEK_NO_VALUE;
+				dma_configure_adc12_dual_acquisition(
+						disable_interrupts,
+						(uint32_t*)dma_main_buffers[adc_index],
+						dma_buffer_size);
+			}
+			else
+			{
+				dma_configure_adc_acquisition(adc_num,
+											  disable_interrupts,
+											  dma_main_buffers[adc_index],
+											  dma_buffer_size);
 			}
 		}
 	}
+
+	return 0;
 }
 
 void data_dispatch_do_dispatch(uint8_t adc_num)
 {
 	uint8_t adc_index = adc_num - 1;
 
-	if (enabled_channels_count[adc_index] == 0)
+	/* ADC without own DMA is dispatched along with its master */
+	if ( (enabled_channels_count[adc_index] == 0) ||
+		 (dma_values_per_transfer[adc_index] == 0) )
 		return;
 
-	uint16_t* dma_buffer = dma_main_buffers[adc_index];
-	if (dma_secondary_buffers[adc_index] != nullptr)
+	uint32_t timestamp = _data_dispatch_get_timestamp();
+
+	dispatch_kernel(adc_index);
+
+	dispatch_timestamps[adc_index] = timestamp;
+	timing_stats_add_timestamp(&dispatch_timing_stats[adc_index], timestamp);
+
+	if (dma_values_per_transfer[adc_index] == 2)
 	{
-		if (current_dma_buffer[adc_index] == 0)
-		{
-			current_dma_buffer[adc_index] = 1;
-		}
-		else
+		dispatch_timestamps[adc_index+1] = timestamp;
+	}
+
+	/* At task start, the full dispatch counts the cycle */
+	if ( (dispatch_type == interrupt) && (adc_index == sequence_adc_index) )
+	{
+		dispatch_sequence++;
+	}
+
+	if ( (dispatch_callback != nullptr) && (adc_index == callback_adc_index) )
+	{
+		callback_countdown--;
+		if (callback_countdown == 0)
 		{
-			dma_buffer = dma_secondary_buffers[adc_index];
-			current_dma_buffer[adc_index] = 0;
+			callback_countdown = callback_repetitions;
+			dispatch_callback();
 		}
 	}
+}
 
-	size_t data_count_in_dma_buffer;
-	if (dispatch_type == interrupt)
+void data_dispatch_do_full_dispatch()
+{
+	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
 	{
-		data_count_in_dma_buffer = enabled_channels_count[adc_index];
+		data_dispatch_do_dispatch(adc_num);
 	}
-	else
+
+	dispatch_sequence++;
+}
+
+int8_t data_dispatch_set_dispatch_callback(uint8_t adc_number,
+										   dispatch_callback_t callback,
+										   uint32_t repetitions)
+{
+	if (callback == nullptr)
 	{
-		data_count_in_dma_buffer = dma_get_retrieved_data_count(adc_num);
+		dispatch_callback = nullptr;
+		return 0;
 	}
 
-	for (size_t dma_index = 0 ;
-		 dma_index < data_count_in_dma_buffer ;
-		 dma_index++)
-	{
-		/* Copy data */
-		size_t dma_buffer_index;
-		if (dispatch_type == interrupt)
-		{
-			dma_buffer_index = dma_index % enabled_channels_count[adc_index];
-		}
-		else
-		{
-			static size_t next_dma_buffer_index[ADC_COUNT] = {0};
+	uint8_t adc_index = adc_number-1;
+	if ( (dispatch_type != interrupt) || (adc_index >= ADC_COUNT) ||
+		 (repetitions == 0) )
+		return -1;
+
+	if ( (enabled_channels_count[adc_index] == 0) ||
+		 (dma_values_per_transfer[adc_index] == 0) )
+		return -1;
+
+	unsigned int key = irq_lock();
+	callback_adc_index   = adc_index;
+	callback_repetitions = repetitions;
+	callback_countdown   = repetitions;
+	dispatch_callback    = callback;
+	irq_unlock(key);
+
+	return 0;
+}
 
-			dma_buffer_index = next_dma_buffer_index[adc_index];
+bool data_dispatch_is_callback_dispatch_pending()
+{
+	return dma_is_transfer_pending(callback_adc_index+1);
+}
 
-			if (next_dma_buffer_index[adc_index] < dma_buffer_sizes[adc_index] - 1)
-			{
-				next_dma_buffer_index[adc_index]++;
-			}
-			else
-			{
-				next_dma_buffer_index[adc_index] = 0;
-			}
-		}
+uint32_t data_dispatch_get_sequence()
+{
+	return dispatch_sequence;
+}
 
-		/* Get info on buffer */
-		size_t channel_index =
-					dma_buffer_index % enabled_channels_count[adc_index];
+uint32_t data_dispatch_get_timestamp(uint8_t adc_number)
+{
+	uint8_t adc_index = adc_number-1;
+	if (adc_index >= ADC_COUNT)
+		return 0;
 
-		uint16_t* active_buffer =
-					_data_dispatch_get_buffer(adc_index, channel_index);
+	return dispatch_timestamps[adc_index];
+}
 
-		uint32_t  current_count =
-					_data_dispatch_get_count(adc_index, channel_index);
+uint32_t data_dispatch_get_timestamp_frequency()
+{
+	return SystemCoreClock;
+}
 
-		active_buffer[current_count] = dma_buffer[dma_buffer_index];
+int8_t data_dispatch_get_timing_stats(uint8_t adc_number,
+									  timing_stats_t* stats)
+{
+	uint8_t adc_index = adc_number-1;
+	if (adc_index >= ADC_COUNT)
+		return -1;
 
-		/* Increment count */
-		_data_dispatch_increment_count(adc_index, channel_index);
-	}
+	adc_index = _data_dispatch_get_dispatching_adc(adc_index);
+
+	unsigned int key = irq_lock();
+	*stats = dispatch_timing_stats[adc_index];
+	irq_unlock(key);
+
+	return 0;
 }
 
-void data_dispatch_do_full_dispatch()
+int8_t data_dispatch_reset_timing_stats(uint8_t adc_number,
+										uint32_t expected_period,
+										uint32_t bin_width)
 {
-	for (uint8_t adc_num = 1 ; adc_num <= ADC_COUNT ; adc_num++)
-	{
-		data_dispatch_do_dispatch(adc_num);
-	}
+	uint8_t adc_index = adc_number-1;
+	if (adc_index >= ADC_COUNT)
+		return -1;
+
+	adc_index = _data_dispatch_get_dispatching_adc(adc_index);
+
+	unsigned int key = irq_lock();
+	timing_stats_reset(&dispatch_timing_stats[adc_index],
+					   expected_period,
+					   bin_width);
+	irq_unlock(key);
+
+	return 0;
 }
 
 /**
@@ -370,25 +706,24 @@ uint16_t* data_dispatch_get_acquired_values(uint8_t adc_number,
 	if (adc_index >= ADC_COUNT)
 		return nullptr;
 
-	/* Get and check data count */
 	uint8_t channel_index = channel_rank-1;
-	uint32_t current_count =
-				_data_dispatch_get_count(adc_index, channel_index);
+	if (channel_index >= enabled_channels_count[adc_index])
+		return nullptr;
+
+	/* Get and check data count */
+	uint8_t slot = _data_dispatch_get_slot(adc_index, channel_index);
+	uint32_t current_count = buffers_data_count[slot];
 
 	if (current_count == 0)
 		return nullptr;
 
 	/* Get and swap buffer */
-	uint16_t* active_buffer =
-				_data_dispatch_get_buffer(adc_index, channel_index);
+	uint16_t* active_buffer = _data_dispatch_get_buffer(slot);
 
-	_data_dispatch_swap_buffers(adc_index, channel_index);
+	_data_dispatch_swap_buffers(slot);
 
 	/* Retain latest value for peek() functions */
-	if (current_count > 0)
-	{
-		peek_memory[adc_index][channel_index] = active_buffer[current_count-1];
-	}
+	peek_memory[slot] = active_buffer[current_count-1];
 
 	/* Return data */
 	number_of_values_acquired = current_count;
@@ -400,14 +735,14 @@ uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
 {
 	uint8_t adc_index = adc_number-1;
 	uint8_t channel_index = channel_rank-1;
-	if (adc_index < ADC_COUNT)
+	if ( (adc_index < ADC_COUNT) &&
+		 (channel_index < enabled_channels_count[adc_index]) )
 	{
 		/* Get info on buffer */
-		uint16_t* active_buffer =
-						_data_dispatch_get_buffer(adc_index, channel_index);
-
-		uint32_t  current_count =
-						_data_dispatch_get_count(adc_index, channel_index);
+		uint8_t   slot          = _data_dispatch_get_slot(adc_index,
+														  channel_index);
+		uint16_t* active_buffer = _data_dispatch_get_buffer(slot);
+		uint32_t  current_count = buffers_data_count[slot];
 
 		/* Return data */
 		if (current_count > 0)
@@ -416,7 +751,7 @@ uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
 		}
 		else
 		{
-			return peek_memory[adc_index][channel_index];
+			return peek_memory[slot];
 		}
 	}
 	else
@@ -424,3 +759,61 @@ uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
 		return 0;
 	}
 }
+
+const volatile uint16_t* data_dispatch_get_latest_dma_word(uint8_t adc_number,
+														   uint8_t channel_rank)
+{
+	uint8_t adc_index = adc_number-1;
+	uint8_t channel_index = channel_rank-1;
+	if ( (adc_index >= ADC_COUNT) ||
+		 (channel_index >= enabled_channels_count[adc_index]) )
+	{
+		return nullptr;
+	}
+
+	/* In dual mode, slave data is the upper half of master transfers */
+	uint8_t dma_adc_index = adc_index;
+	uint8_t half_offset   = 0;
+	if (dma_values_per_transfer[adc_index] == 0)
+	{
+		dma_adc_index = adc_index - 1;
+		half_offset   = 1;
+	}
+
+	/**
+	 * Each position of the DMA buffer always holds the same channel,
+	 * as the buffer size is a multiple of the channels count.
+	 * Walk back from the latest written word to the latest word
+	 * of the requested channel.
+	 */
+	size_t  dma_buffer_size = dma_buffer_sizes[dma_adc_index];
+	uint8_t channels_count  = enabled_channels_count[adc_index];
+	uint8_t values_count    = dma_values_per_transfer[dma_adc_index];
+
+	size_t latest_index = dma_get_next_write_index(dma_adc_index+1);
+	if (latest_index == 0)
+	{
+		latest_index = dma_buffer_size;
+	}
+	latest_index--;
+
+	int16_t distance = (int16_t)(latest_index % channels_count) -
+					   (int16_t)channel_index;
+	if (distance < 0)
+	{
+		distance += channels_count;
+	}
+
+	size_t channel_latest_index;
+	if (latest_index >= (size_t)distance)
+	{
+		channel_latest_index = latest_index - distance;
+	}
+	else
+	{
+		channel_latest_index = latest_index + dma_buffer_size - distance;
+	}
+
+	return &dma_main_buffers[dma_adc_index]
+							[channel_latest_index * values_count + half_offset];
+}
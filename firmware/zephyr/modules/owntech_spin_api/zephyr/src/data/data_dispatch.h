@@ -38,17 +38,29 @@
 /* Stdlib */
 #include <stdint.h>
 
+/* Current module headers */
+#include "timing_stats.h"
+
 
 /* Constants */
 
 const uint16_t PEEK_NO_VALUE = 0xFFFF;
 const uint8_t CHANNELS_BUFFERS_SIZE = 32;
 
+/* Maximum number of channels, all ADCs included */
+const uint8_t DATA_DISPATCH_MAX_CHANNELS =
+				CONFIG_OWNTECH_DATA_DISPATCH_MAX_CHANNELS;
+
 /**
  * Dispatch method
  */
 typedef enum {task, interrupt} dispatch_t;
 
+/**
+ * Function called after an interrupt dispatch
+ */
+typedef void (*dispatch_callback_t)();
+
 /**
  * @brief Init function to be called first.
  *
@@ -58,8 +70,14 @@ typedef enum {task, interrupt} dispatch_t;
  *        this value represents the number of acquisitions
  *        that are done between two execution of the
  *        task. Ignored if dispatch is done on interrupt.
+ *        DMA buffers of a previous call are freed: ADC
+ *        conversions must be stopped.
+ * @return 0 if everything went well, -1 if the total count
+ *         of enabled channels exceeds DATA_DISPATCH_MAX_CHANNELS
+ *         or if DMA buffers could not be allocated. No channel
+ *         is then dispatched.
  */
-void data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions);
+int8_t data_dispatch_init(dispatch_t dispatch_method, uint32_t repetitions);
 
 /**
  * @brief Dispatch function: gets the readings and store them
@@ -76,6 +94,92 @@ void data_dispatch_do_dispatch(uint8_t adc_number);
  */
 void data_dispatch_do_full_dispatch();
 
+/**
+ * @brief Register a function to be called by the DMA interrupt
+ *        right after an ADC has been dispatched, so that data
+ *        is processed as soon as it is available.
+ *        Only effective when dispatch is done on interrupt.
+ *        Must be called after data_dispatch_init(), which
+ *        clears any registered callback.
+ *
+ * @param adc_number Number of the ADC which dispatch triggers
+ *        the callback. In dual mode, use ADC 1 for both ADCs.
+ * @param callback Function to call, or nullptr to remove
+ *        the current callback.
+ * @param repetitions Number of dispatches of the ADC between
+ *        two calls to the callback.
+ * @return 0 if the callback was registered, -1 if dispatch is
+ *         not done on interrupt, the ADC has no DMA or
+ *         repetitions is 0.
+ */
+int8_t data_dispatch_set_dispatch_callback(uint8_t adc_number,
+                                           dispatch_callback_t callback,
+                                           uint32_t repetitions);
+
+/**
+ * @brief  Check whether the next buffer of the ADC triggering the
+ *         dispatch callback is already filled. When called from
+ *         the callback, this means it did not complete before the
+ *         next acquisition.
+ *
+ * @return true if a dispatch is pending, false otherwise.
+ */
+bool data_dispatch_is_callback_dispatch_pending();
+
+/**
+ * @brief  Obtain the dispatch sequence number. It is incremented
+ *         once per acquisition cycle: on each full dispatch when
+ *         dispatch is done at task start, and on each dispatch of
+ *         the first ADC with a DMA when it is done on interrupt,
+ *         before its callback is called.
+ *
+ * @return Current sequence number.
+ */
+uint32_t data_dispatch_get_sequence();
+
+/**
+ * @brief  Obtain the timestamp of the latest dispatch of an ADC,
+ *         taken when the dispatch started. In interrupt mode, this
+ *         is right after the end of the acquired burst.
+ *
+ * @param  adc_number Number of the ADC.
+ * @return Timestamp in CPU cycles, 0 if the ADC was never dispatched.
+ */
+uint32_t data_dispatch_get_timestamp(uint8_t adc_number);
+
+/**
+ * @brief  Obtain the frequency of the timestamps counter.
+ *
+ * @return Number of timestamp units per second.
+ */
+uint32_t data_dispatch_get_timestamp_frequency();
+
+/**
+ * @brief  Obtain a copy of the statistics on the period between
+ *         two dispatches of an ADC.
+ *
+ * @param  adc_number Number of the ADC.
+ * @param  stats Output parameter: statistics copy.
+ * @return 0 if statistics were copied, -1 if ADC number is invalid.
+ */
+int8_t data_dispatch_get_timing_stats(uint8_t adc_number,
+                                      timing_stats_t* stats);
+
+/**
+ * @brief  Reset the statistics on the period between two
+ *         dispatches of an ADC.
+ *
+ * @param  adc_number Number of the ADC.
+ * @param  expected_period Nominal period, in timestamp units.
+ *         If 0, the first measured period is used.
+ * @param  bin_width Width of histogram bins, in timestamp units.
+ *         If 0, the histogram is not filled.
+ * @return 0 if statistics were reset, -1 if ADC number is invalid.
+ */
+int8_t data_dispatch_reset_timing_stats(uint8_t adc_number,
+                                        uint32_t expected_period,
+                                        uint32_t bin_width);
+
 /**
  * @brief  Obtain data for a specific channel.
  *         The data is provided as an array of values
@@ -114,5 +218,23 @@ uint16_t* data_dispatch_get_acquired_values(uint8_t adc_number,
 uint16_t data_dispatch_peek_acquired_value(uint8_t adc_number,
                                            uint8_t channel_rank);
 
+/**
+ * @brief  Locate the latest value acquired for a specific
+ *         channel directly in the DMA buffer, without
+ *         going through the per-channel buffers.
+ *
+ * @param  adc_number Number of the ADC from which to
+ *         obtain data.
+ * @param  channel_rank Rank of the channel from which
+ *         to obtain data.
+ * @return Pointer to the DMA buffer word holding the latest
+ *         value, or nullptr if the channel is not enabled.
+ *         Note that the word keeps being written by the DMA:
+ *         it must be read right away. Until a first value is
+ *         acquired, the word holds PEEK_NO_VALUE.
+ */
+const volatile uint16_t* data_dispatch_get_latest_dma_word(uint8_t adc_number,
+                                                           uint8_t channel_rank);
+
 
 #endif /* DATA_DISPATCH_H_ */
@@ -116,31 +116,36 @@ static void _dma_callback(const struct device* dev,
 	}
 }
 
-/* Public API */
-
-void dma_configure_adc_acquisition(uint8_t adc_number,
-								   bool disable_interrupts,
-								   uint16_t* buffer,
-								   size_t buffer_size)
+/**
+ * Configure and start DMA 1 channel x for ADC x.
+ * data_size is the size in bytes of each transfer,
+ * buffer_size the number of transfers the buffer can contain.
+ */
+static void _dma_configure_acquisition(uint8_t adc_number,
+									   uint32_t source_register,
+									   uint8_t data_size,
+									   bool disable_interrupts,
+									   void* buffer,
+									   size_t buffer_size)
 {
 	/* Check environment */
 	if (device_is_ready(dma1) == false)
 		return;
 
 	uint8_t dma_index = adc_number - 1;
-	uint32_t buffer_size_bytes = (uint32_t) buffer_size * sizeof(uint16_t);
+	uint32_t buffer_size_bytes = (uint32_t) buffer_size * data_size;
 	buffers_sizes[dma_index] = buffer_size;
 
 	/* Private data for DMA channel */
 	user_data[dma_index].has_interrupt = !disable_interrupts;
-	user_data[dma_index].src           = source_registers[dma_index];
+	user_data[dma_index].src           = source_register;
 	user_data[dma_index].dst           = (uint32_t)buffer;
 	user_data[dma_index].size          = buffer_size_bytes;
 	user_data[dma_index].channel       = adc_number;
 
 	/* Configure DMA */
 	struct dma_block_config dma_block_config_s = {0};
-	/* Source: ADC DR register */
+	/* Source: ADC data register */
 	dma_block_config_s.source_address   = user_data[dma_index].src;
 	/* Destination: buffer in memory */
 	dma_block_config_s.dest_address     = user_data[dma_index].dst;
@@ -163,10 +168,10 @@ void dma_configure_adc_acquisition(uint8_t adc_number,
 	dma_config_s.dma_slot            = source_triggers[dma_index];
 	/* From peripheral to memory */
 	dma_config_s.channel_direction   = PERIPHERAL_TO_MEMORY;
-	/* Source: 2 bytes (uint16_t) */
-	dma_config_s.source_data_size    = 2;
-	/* Destination: 2 bytes (uint16_t) */
-	dma_config_s.dest_data_size      = 2;
+	/* Source: 2 bytes (uint16_t) or 4 bytes (packed dual mode) */
+	dma_config_s.source_data_size    = data_size;
+	/* Destination: same as source */
+	dma_config_s.dest_data_size      = data_size;
 	/* Source: No burst */
 	dma_config_s.source_burst_length = 1;
 	/* Destination: No burst */
@@ -192,6 +197,34 @@ void dma_configure_adc_acquisition(uint8_t adc_number,
 	dma_start(dma1, user_data[dma_index].channel);
 }
 
+/* Public API */
+
+void dma_configure_adc_acquisition(uint8_t adc_number,
+								   bool disable_interrupts,
+								   uint16_t* buffer,
+								   size_t buffer_size)
+{
+	_dma_configure_acquisition(adc_number,
+							   source_registers[adc_number - 1],
+							   sizeof(uint16_t),
+							   disable_interrupts,
+							   buffer,
+							   buffer_size);
+}
+
+void dma_configure_adc12_dual_acquisition(bool disable_interrupts,
+										  uint32_t* buffer,
+										  size_t buffer_size)
+{
+	/* Master ADC 1 issues the DMA requests for both ADCs */
+	_dma_configure_acquisition(1,
+							   (uint32_t)(&(ADC12_COMMON->CDR)),
+							   sizeof(uint32_t),
+							   disable_interrupts,
+							   buffer,
+							   buffer_size);
+}
+
 uint32_t dma_get_retrieved_data_count(uint8_t adc_number)
 {
 	/**
@@ -227,3 +260,28 @@ uint32_t dma_get_retrieved_data_count(uint8_t adc_number)
 
 	return retrieved_data;
 }
+
+uint32_t dma_get_next_write_index(uint8_t adc_number)
+{
+	uint32_t dma_index = adc_number - 1;
+	uint32_t dma_remaining_data = LL_DMA_GetDataLength(DMA1, dma_index);
+
+	/* Remaining data is 0 while the DMA is being reloaded */
+	if ( (dma_remaining_data == 0) ||
+		 (dma_remaining_data > buffers_sizes[dma_index]) )
+	{
+		return 0;
+	}
+
+	return buffers_sizes[dma_index] - dma_remaining_data;
+}
+
+bool dma_is_transfer_pending(uint8_t adc_number)
+{
+	uint32_t dma_index = adc_number - 1;
+
+	/* Each channel owns 4 consecutive flags in DMA ISR register */
+	uint32_t pending_flags = (DMA_ISR_HTIF1 | DMA_ISR_TCIF1) << (dma_index * 4);
+
+	return (DMA1->ISR & pending_flags) != 0;
+}
@@ -56,6 +56,23 @@ void dma_configure_adc_acquisition(uint8_t adc_number,
                                    uint16_t* buffer,
                                    size_t buffer_size);
 
+/**
+ * @brief This function configures DMA 1 channel 1 to transfer
+ * measures from ADC 1 and ADC 2 in dual mode to a buffer,
+ * then starts the channel. Each 32-bit word holds ADC 1
+ * value in its lower half-word and ADC 2 value in its upper
+ * half-word.
+ *
+ * @param disable_interrupts Boolean indicating whether interrupts
+ *        should be disabled. Warning: this override Zephyr DMA
+ *        driver default behavior.
+ * @param buffer Pointer to buffer.
+ * @param buffer_size Number of uint32_t words the buffer can contain.
+ */
+void dma_configure_adc12_dual_acquisition(bool disable_interrupts,
+                                          uint32_t* buffer,
+                                          size_t buffer_size);
+
 /**
  * @brief Obtain the number of acquired data since
  *        last time this function was called.
@@ -66,5 +83,28 @@ void dma_configure_adc_acquisition(uint8_t adc_number,
  */
 uint32_t dma_get_retrieved_data_count(uint8_t adc_number);
 
+/**
+ * @brief Obtain the position in the buffer where the DMA
+ *        will write its next data. Unlike
+ *        dma_get_retrieved_data_count(), this function has
+ *        no side effect and can be called at any time.
+ *
+ * @param adc_number Number of the ADC.
+ *
+ * @return Index of the next word written in the buffer.
+ */
+uint32_t dma_get_next_write_index(uint8_t adc_number);
+
+/**
+ * @brief Check whether a half-transfer or transfer-complete
+ *        event of an ADC DMA channel is waiting to be serviced.
+ *        Called from the DMA callback, this indicates that the
+ *        next buffer half was filled before the current one
+ *        was handled.
+ * @param adc_number Number of the ADC.
+ * @return true if an event is pending, false otherwise.
+ */
+bool dma_is_transfer_pending(uint8_t adc_number);
+
 
 #endif /* DMA_H_ */
@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2021-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+
+/* Current file header */
+#include "timing_stats.h"
+
+
+/**
+ * Public API
+ */
+
+void timing_stats_reset(timing_stats_t* stats,
+						uint32_t expected_period,
+						uint32_t bin_width)
+{
+	stats->expected_period    = expected_period;
+	stats->bin_width          = bin_width;
+	stats->previous_timestamp = 0;
+	stats->timestamps_count   = 0;
+	stats->min_period         = UINT32_MAX;
+	stats->max_period         = 0;
+	stats->latest_period      = 0;
+
+	for (uint8_t bin = 0 ; bin < TIMING_STATS_HISTOGRAM_BINS ; bin++)
+	{
+		stats->histogram[bin] = 0;
+	}
+}
+
+void timing_stats_add_timestamp(timing_stats_t* stats, uint32_t timestamp)
+{
+	/* Unsigned difference is correct across timestamp wrap-around */
+	uint32_t period = timestamp - stats->previous_timestamp;
+
+	stats->previous_timestamp = timestamp;
+	stats->timestamps_count++;
+
+	if (stats->timestamps_count == 1)
+		return;
+
+	stats->latest_period = period;
+
+	if (period < stats->min_period)
+	{
+		stats->min_period = period;
+	}
+	if (period > stats->max_period)
+	{
+		stats->max_period = period;
+	}
+
+	if (stats->bin_width == 0)
+		return;
+
+	if (stats->expected_period == 0)
+	{
+		stats->expected_period = period;
+	}
+
+	/* Bin index relative to the expected period bin */
+	int32_t deviation = (int32_t)(period - stats->expected_period);
+	int32_t bin;
+	if (deviation >= 0)
+	{
+		bin = deviation / (int32_t)stats->bin_width;
+	}
+	else
+	{
+		bin = -1 - ((-1 - deviation) / (int32_t)stats->bin_width);
+	}
+	bin += TIMING_STATS_HISTOGRAM_BINS/2;
+
+	if (bin < 0)
+	{
+		bin = 0;
+	}
+	else if (bin >= TIMING_STATS_HISTOGRAM_BINS)
+	{
+		bin = TIMING_STATS_HISTOGRAM_BINS - 1;
+	}
+
+	stats->histogram[bin]++;
+}
+
+uint32_t timing_stats_get_periods_count(const timing_stats_t* stats)
+{
+	if (stats->timestamps_count == 0)
+		return 0;
+
+	return stats->timestamps_count - 1;
+}
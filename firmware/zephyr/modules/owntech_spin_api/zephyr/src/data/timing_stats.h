@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2021-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief Timing statistics are intended at characterizing
+ * the period between periodic events, such as data
+ * dispatches, from timestamps provided by the caller.
+ *
+ * This module has no dependency on the hardware: the
+ * timestamp unit is defined by the caller, and must
+ * wrap around modulo 2^32.
+ */
+
+#ifndef TIMING_STATS_H_
+#define TIMING_STATS_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/* Constants */
+
+const uint8_t TIMING_STATS_HISTOGRAM_BINS = 16;
+
+/**
+ * Timing statistics.
+ * Histogram bin TIMING_STATS_HISTOGRAM_BINS/2 holds the periods
+ * in [expected_period, expected_period + bin_width), bins below
+ * and above hold shorter and longer periods. First and last bins
+ * also hold all periods out of the histogram range.
+ */
+typedef struct
+{
+	uint32_t expected_period;
+	uint32_t bin_width;
+	uint32_t previous_timestamp;
+	uint32_t timestamps_count;
+	uint32_t min_period;
+	uint32_t max_period;
+	uint32_t latest_period;
+	uint32_t histogram[TIMING_STATS_HISTOGRAM_BINS];
+} timing_stats_t;
+
+/**
+ * @brief Reset statistics.
+ *
+ * @param stats Statistics to reset.
+ * @param expected_period Nominal period, in timestamp units.
+ *        If 0, the first measured period is used.
+ * @param bin_width Width of histogram bins, in timestamp units.
+ *        If 0, the histogram is not filled.
+ */
+void timing_stats_reset(timing_stats_t* stats,
+                        uint32_t expected_period,
+                        uint32_t bin_width);
+
+/**
+ * @brief Add an event timestamp to statistics.
+ *        The first timestamp after a reset only serves
+ *        as a reference for the next one.
+ *
+ * @param stats Statistics to update.
+ * @param timestamp Event timestamp.
+ */
+void timing_stats_add_timestamp(timing_stats_t* stats, uint32_t timestamp);
+
+/**
+ * @brief  Obtain the number of periods measured since last reset.
+ *
+ * @param  stats Statistics to read.
+ * @return Number of periods taken into account in statistics.
+ */
+uint32_t timing_stats_get_periods_count(const timing_stats_t* stats);
+
+
+#endif /* TIMING_STATS_H_ */
@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) 2023-present LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/**
+ * @brief  Mapping of Spin pin numbers and STM32-style pin names to GPIO
+ *         ports and pin numbers. This file does not depend on Zephyr, so
+ *         that pin tables can also be checked on the host.
+ * @date   2024
+ */
+
+#ifndef GPIO_PIN_MAP_H_
+#define GPIO_PIN_MAP_H_
+
+#include <stdint.h>
+
+
+/**
+ *  Public constants
+ */
+
+/* Port indexes */
+static const uint8_t GPIO_PIN_MAP_PORT_A   = 0;
+static const uint8_t GPIO_PIN_MAP_PORT_B   = 1;
+static const uint8_t GPIO_PIN_MAP_PORT_C   = 2;
+static const uint8_t GPIO_PIN_MAP_PORT_D   = 3;
+static const uint8_t GPIO_PIN_MAP_PORTS    = 4;
+
+/* Returned for unknown pins */
+static const uint8_t GPIO_PIN_MAP_INVALID  = 0xFF;
+
+
+/**
+ *  Public functions
+ */
+
+/**
+ * @brief Get the GPIO pin number of a pin (e.g., `PA11` → `11`).
+ *
+ * @param pin Spin pin number from 1 to 58 or STM32-style pin name.
+ *
+ * @return GPIO pin number (0–15) or GPIO_PIN_MAP_INVALID if unknown
+ *         or unsupported.
+ */
+uint8_t gpio_pin_map_get_pin_number(uint8_t pin);
+
+/**
+ * @brief Get the GPIO port index of a pin (e.g., `PA11` → port A).
+ *
+ * @param pin Spin pin number from 1 to 58 or STM32-style pin name.
+ *
+ * @return GPIO_PIN_MAP_PORT_A to GPIO_PIN_MAP_PORT_D, or
+ *         GPIO_PIN_MAP_INVALID if unknown or unsupported.
+ */
+uint8_t gpio_pin_map_get_port(uint8_t pin);
+
+#endif /* GPIO_PIN_MAP_H_ */
@@ -66,6 +66,52 @@ void TaskAPI::stopCritical()
 	scheduling_stop_uninterruptible_synchronous_task();
 }
 
+int8_t TaskAPI::createCriticalSubTask(task_function_t sub_task,
+									  uint16_t divider,
+									  uint32_t budget_ns)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS
+	uint32_t budget_cycles =
+		(uint32_t)(((uint64_t)budget_ns * SystemCoreClock) / 1000000000);
+
+	unsigned int key = irq_lock();
+	int8_t result = task_subtasks_add(sub_task, divider, budget_cycles);
+	irq_unlock(key);
+
+	return result;
+#else
+	return -1;
+#endif
+}
+
+int8_t TaskAPI::getCriticalSubTaskStatistics(uint8_t sub_task,
+											 task_subtask_stats_t& stats)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS
+	const task_subtask_stats_t* sub_task_stats =
+		task_subtasks_get_stats(sub_task);
+	if (sub_task_stats == nullptr)
+		return -1;
+
+	unsigned int key = irq_lock();
+	stats = *sub_task_stats;
+	irq_unlock(key);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+void TaskAPI::resetCriticalSubTaskStatistics()
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS
+	unsigned int key = irq_lock();
+	task_subtasks_reset_stats();
+	irq_unlock(key);
+#endif
+}
+
 
 /* Asynchronous tasks */
 
@@ -99,3 +145,101 @@ void TaskAPI::suspendBackgroundUs(uint32_t duration_us)
 }
 
 #endif /* CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS */
+
+
+/* Profiling */
+
+int8_t TaskAPI::defineProfilingSection(const char* name)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_PROFILING
+	task_profiling_init();
+
+	return task_profiling_define_section(name);
+#else
+	return -1;
+#endif
+}
+
+uint8_t TaskAPI::getProfilingSectionsCount()
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_PROFILING
+	return task_profiling_get_sections_count();
+#else
+	return 0;
+#endif
+}
+
+int8_t TaskAPI::getProfilingStatistics(uint8_t section,
+									   task_profiling_section_t& stats)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_PROFILING
+	const task_profiling_section_t* section_stats =
+		task_profiling_get_section(section);
+	if (section_stats == nullptr)
+		return -1;
+
+	unsigned int key = irq_lock();
+	stats = *section_stats;
+	irq_unlock(key);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+void TaskAPI::resetProfiling()
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_PROFILING
+	unsigned int key = irq_lock();
+	task_profiling_reset();
+	irq_unlock(key);
+#endif
+}
+
+uint32_t TaskAPI::getProfilingFrequency()
+{
+	return SystemCoreClock;
+}
+
+
+/* Deadline monitor */
+
+int8_t TaskAPI::setCriticalOverrunPolicy(task_overrun_policy_t policy,
+										 uint8_t consecutive_overruns,
+										 task_overrun_callback_t callback)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	unsigned int key = irq_lock();
+	int8_t result = task_deadline_set_policy(policy,
+											 consecutive_overruns,
+											 callback);
+	irq_unlock(key);
+
+	return result;
+#else
+	return -1;
+#endif
+}
+
+int8_t TaskAPI::getCriticalDeadlineStatistics(task_deadline_stats_t& stats)
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	unsigned int key = irq_lock();
+	stats = *task_deadline_get_stats();
+	irq_unlock(key);
+
+	return 0;
+#else
+	return -1;
+#endif
+}
+
+void TaskAPI::resetCriticalDeadlineStatistics()
+{
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	unsigned int key = irq_lock();
+	task_deadline_reset();
+	irq_unlock(key);
+#endif
+}
@@ -32,6 +32,11 @@
 /* Zephyr */
 #include <zephyr/kernel.h>
 
+/* Current module */
+#include "../src/task_profiling.h"
+#include "../src/task_deadline.h"
+#include "../src/task_subtasks.h"
+
 /**
  *  Public types
  */
@@ -40,7 +45,8 @@ typedef void (*task_function_t)();
 
 typedef enum { source_uninitialized,
 			   source_hrtim,
-			   source_tim6 }
+			   source_tim6,
+			   source_adc_dma }
 			   scheduling_interrupt_source_t;
 
 /**
@@ -76,15 +82,21 @@ public:
 	 * 
 	 * @param task_period_us Period of the function in µs.
 	 *        Allowed range: 1 to 6553 µs.
-	 *        If interrupt source is `HRTIM`, this value *must* be an
-	 *        integer multiple of the `HRTIM` period.
+	 *        If interrupt source is `HRTIM` or ADC DMA, this value
+	 *        *must* be an integer multiple of the `HRTIM` period.
 	 * 
 	 * @param int_source Interrupt source that triggers the task.
 	 *        By default, the `HRTIM` is the source, but this optional
 	 *        parameter can be provided to set TIM6 as the source in
 	 *        case the `HRTIM` is not used or if the task can't be
 	 *        correlated to an `HRTIM` event.
-	 *        Allowed values are source_hrtim and source_tim6.
+	 *        source_adc_dma runs the task from the DMA interrupt, as
+	 *        soon as ADC 1 acquisitions have been dispatched, which
+	 *        removes the delay between the end of the conversions and
+	 *        the task. ADC 1 must be triggered once per `HRTIM` period,
+	 *        and Data Acquisition dispatch must be done on DMA interrupt.
+	 *        Allowed values are source_hrtim, source_tim6 and
+	 *        source_adc_dma.
 	 * 
 	 * @return `0` if everything went well,
 	 *         `-1` if there was an error defining the task.
@@ -110,6 +122,9 @@ public:
 	 *        yet, Scheduling will automatically start Data Acquisition.
 	 *        Thus, make sure all ADC configuration has been carried
 	 *        out before starting the uninterruptible task.
+	 *        With source_adc_dma, Data Acquisition is started with
+	 *        dispatch on DMA interrupt, and the task won't start if it
+	 *        was started with another dispatch method.
 	 *
 	 * @param manage_data_acquisition Set to false if you want
 	 *        the Scheduling module to not be in charge of Data
@@ -127,6 +142,54 @@ public:
 	 */
 	void stopCritical();
 
+	/**
+	 * @brief Add a sub-task to the critical task.
+	 *
+	 *        A sub-task is run by the critical task, right after the
+	 *        periodic task, every `divider` critical task periods. This
+	 *        allows running slower loops in the same uninterruptible
+	 *        context as a fast control loop. Sub-tasks are given different
+	 *        phases when possible, so that slow sub-tasks are spread across
+	 *        periods instead of all running on the same one.
+	 *
+	 * @note  Sub-tasks are enabled with
+	 *        CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS, and their number
+	 *        is limited by CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS.
+	 *
+	 * @param sub_task Pointer to the void(void) function to run.
+	 * @param divider Number of critical task periods between two runs.
+	 * @param budget_ns Allowed execution time of the sub-task in ns.
+	 *        Longer executions are counted in the sub-task statistics.
+	 *        0 (default) for no budget.
+	 *
+	 * @return Sub-task number, or -1 if sub-tasks are disabled, the
+	 *         maximum number of sub-tasks has been reached or the
+	 *         divider is 0.
+	 */
+	int8_t createCriticalSubTask(task_function_t sub_task,
+								 uint16_t divider,
+								 uint32_t budget_ns = 0);
+
+	/**
+	 * @brief Get a copy of a critical sub-task statistics: divider and
+	 *        phase, number of runs, maximum and total execution time,
+	 *        and number of runs exceeding the budget.
+	 *
+	 *        Times are expressed in cycles, see getProfilingFrequency().
+	 *
+	 * @param sub_task Sub-task number.
+	 * @param stats Copy of the statistics.
+	 *
+	 * @return 0 if statistics were copied, -1 otherwise.
+	 */
+	int8_t getCriticalSubTaskStatistics(uint8_t sub_task,
+										task_subtask_stats_t& stats);
+
+	/**
+	 * @brief Clear the execution statistics of all critical sub-tasks.
+	 */
+	void resetCriticalSubTaskStatistics();
+
 
 #ifdef CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS
 
@@ -195,6 +258,105 @@ public:
 
 #endif /* CONFIG_OWNTECH_TASK_ENABLE_ASYNCHRONOUS_TASKS */
 
+	/**
+	 * @brief Define a profiling section. Code between
+	 *        TASK_PROFILING_START(section) and TASK_PROFILING_END(section)
+	 *        will have its execution time measured.
+	 *
+	 *        Data dispatch, safety and user task of the critical task are
+	 *        always profiled, as sections 0 to 2.
+	 *
+	 * @note  Profiling is enabled with CONFIG_OWNTECH_TASK_ENABLE_PROFILING.
+	 *        When disabled, this function returns -1 and profiling points
+	 *        are removed at compile time.
+	 *
+	 * @param name Name of the section, must remain valid.
+	 *
+	 * @return Section number, or -1 if profiling is disabled or the
+	 *         maximum number of sections has been reached.
+	 */
+	int8_t defineProfilingSection(const char* name);
+
+	/**
+	 * @brief Get the number of profiling sections, including
+	 *        the critical task ones.
+	 *
+	 * @return Number of sections, 0 if profiling is disabled.
+	 */
+	uint8_t getProfilingSectionsCount();
+
+	/**
+	 * @brief Get a copy of a profiling section statistics: min, max and
+	 *        total execution time, and log2 histogram of execution times.
+	 *
+	 *        Times are expressed in cycles, see getProfilingFrequency().
+	 *
+	 * @param section Section number.
+	 * @param stats Copy of the statistics.
+	 *
+	 * @return 0 if statistics were copied, -1 otherwise.
+	 */
+	int8_t getProfilingStatistics(uint8_t section,
+								  task_profiling_section_t& stats);
+
+	/**
+	 * @brief Clear the statistics of all profiling sections.
+	 */
+	void resetProfiling();
+
+	/**
+	 * @brief Get the frequency of the profiling cycles counter.
+	 *
+	 * @return Number of cycles per second.
+	 */
+	static uint32_t getProfilingFrequency();
+
+	/**
+	 * @brief Define the action taken when the critical task lasts
+	 *        longer than its period.
+	 *
+	 *        By default, overruns are only counted. The decimate policy
+	 *        runs the critical task less often (data dispatch and safety
+	 *        still run every period): the task can read the current
+	 *        decimation in the deadline statistics to adapt its time step.
+	 *        The callback policy calls a function once, from the critical
+	 *        task context, e.g. to switch the application to an error mode.
+	 *
+	 * @note  The deadline monitor is enabled with
+	 *        CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR.
+	 *
+	 * @param policy overrun_policy_count, overrun_policy_decimate or
+	 *        overrun_policy_callback.
+	 * @param consecutive_overruns Number of consecutive overruns that
+	 *        trigger the action.
+	 * @param callback Function called by the callback policy.
+	 *
+	 * @return 0 if the policy was set, -1 if the monitor is disabled or
+	 *         the callback policy has no callback.
+	 */
+	int8_t setCriticalOverrunPolicy(task_overrun_policy_t policy,
+									uint8_t consecutive_overruns = 1,
+									task_overrun_callback_t callback = NULL);
+
+	/**
+	 * @brief Get a copy of the critical task deadline statistics: overruns,
+	 *        missed ticks, worst start jitter and execution time, and
+	 *        current decimation.
+	 *
+	 *        Times are expressed in cycles, see getProfilingFrequency().
+	 *
+	 * @param stats Copy of the statistics.
+	 *
+	 * @return 0 if statistics were copied, -1 if the monitor is disabled.
+	 */
+	int8_t getCriticalDeadlineStatistics(task_deadline_stats_t& stats);
+
+	/**
+	 * @brief Clear the critical task deadline statistics. This also
+	 *        cancels the decimation and re-arms the overrun callback.
+	 */
+	void resetCriticalDeadlineStatistics();
+
 private:
 	static const int DEFAULT_PRIORITY;
 
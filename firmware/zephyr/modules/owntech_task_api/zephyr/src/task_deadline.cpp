@@ -0,0 +1,214 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+
+
+/* Current file header */
+#include "task_deadline.h"
+
+
+/**
+ *  Local variables
+ */
+
+static task_deadline_stats_t stats = { .decimation = 1 };
+
+/* Policy */
+static task_overrun_policy_t overrun_policy = overrun_policy_count;
+static uint8_t overruns_before_action = 1;
+static task_overrun_callback_t overrun_callback = nullptr;
+
+/* Current period */
+static bool     has_started = false;
+static uint32_t tick_timestamp = 0;
+static uint32_t start_timestamp = 0;
+static bool     previous_overrun = false;
+static uint8_t  consecutive_overruns = 0;
+static uint8_t  decimation_counter = 0;
+
+
+/**
+ * Private functions
+ */
+
+static void _task_deadline_apply_policy()
+{
+	switch (overrun_policy)
+	{
+		case overrun_policy_decimate:
+			if (stats.decimation < TASK_DEADLINE_MAX_DECIMATION)
+			{
+				stats.decimation *= 2;
+				decimation_counter = 0;
+			}
+			break;
+		case overrun_policy_callback:
+			if ( (stats.tripped == false) && (overrun_callback != nullptr) )
+			{
+				stats.tripped = true;
+				overrun_callback();
+			}
+			break;
+		case overrun_policy_count:
+		default:
+			break;
+	}
+}
+
+
+/**
+ * Public API
+ */
+
+void task_deadline_init(uint32_t period_cycles)
+{
+	task_deadline_reset();
+
+	stats.period_cycles = period_cycles;
+}
+
+int8_t task_deadline_set_policy(task_overrun_policy_t policy,
+								uint8_t consecutive_overruns,
+								task_overrun_callback_t callback)
+{
+	if ( (policy == overrun_policy_callback) && (callback == nullptr) )
+		return -1;
+
+	overrun_policy = policy;
+	overruns_before_action = (consecutive_overruns > 0) ?
+							 consecutive_overruns : 1;
+	overrun_callback = callback;
+
+	return 0;
+}
+
+bool task_deadline_start(uint32_t timestamp)
+{
+	uint32_t period = stats.period_cycles;
+
+	stats.ticks++;
+	start_timestamp = timestamp;
+
+	if ( (has_started == true) && (period != 0) )
+	{
+		/* Deviation from the expected tick, wrap-around safe */
+		int32_t delay = (int32_t)(timestamp - (tick_timestamp + period));
+
+		if (previous_overrun == true)
+		{
+			/**
+			 * Start was delayed by the previous execution: the interrupt
+			 * source kept one pending event, any other tick elapsed
+			 * meanwhile is lost. Expected ticks stay on the period grid.
+			 */
+			uint32_t lost = (delay > 0) ? (uint32_t)delay / period : 0;
+
+			stats.missed_ticks += lost;
+			tick_timestamp += (lost + 1) * period;
+		}
+		else
+		{
+			/* Ticks can also be lost while the interrupt is masked */
+			if (delay > (int32_t)(period / 2))
+			{
+				uint32_t lost = ((uint32_t)delay + period / 2) / period;
+
+				stats.missed_ticks += lost;
+				delay -= (int32_t)(lost * period);
+			}
+
+			uint32_t jitter = (delay < 0) ? (uint32_t)(-delay) :
+											(uint32_t)delay;
+			if (jitter > stats.max_jitter_cycles)
+			{
+				stats.max_jitter_cycles = jitter;
+			}
+
+			tick_timestamp = timestamp;
+		}
+	}
+	else
+	{
+		tick_timestamp = timestamp;
+		has_started = true;
+	}
+
+	bool run_user_task = (decimation_counter == 0);
+
+	decimation_counter++;
+	if (decimation_counter >= stats.decimation)
+	{
+		decimation_counter = 0;
+	}
+
+	return run_user_task;
+}
+
+void task_deadline_end(uint32_t timestamp, bool next_tick_pending)
+{
+	uint32_t execution = timestamp - start_timestamp;
+
+	if (execution > stats.max_execution_cycles)
+	{
+		stats.max_execution_cycles = execution;
+	}
+
+	previous_overrun = next_tick_pending || (execution > stats.period_cycles);
+
+	if (previous_overrun == false)
+	{
+		consecutive_overruns = 0;
+		return;
+	}
+
+	stats.overruns++;
+	consecutive_overruns++;
+
+	if (consecutive_overruns >= overruns_before_action)
+	{
+		consecutive_overruns = 0;
+		_task_deadline_apply_policy();
+	}
+}
+
+void task_deadline_reset()
+{
+	stats.ticks                = 0;
+	stats.overruns             = 0;
+	stats.missed_ticks         = 0;
+	stats.max_jitter_cycles    = 0;
+	stats.max_execution_cycles = 0;
+	stats.decimation           = 1;
+	stats.tripped              = false;
+
+	has_started          = false;
+	previous_overrun     = false;
+	consecutive_overruns = 0;
+	decimation_counter   = 0;
+}
+
+const task_deadline_stats_t* task_deadline_get_stats()
+{
+	return &stats;
+}
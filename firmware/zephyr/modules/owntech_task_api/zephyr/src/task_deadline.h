@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief Critical task deadline monitor: detects executions lasting longer
+ * than the task period, ticks lost because of them, and measures the start
+ * jitter of the task.
+ *
+ * The monitor only relies on timestamps and on the pending state of the
+ * interrupt source given by the caller, so that it does not depend on the
+ * hardware.
+ */
+
+#ifndef TASK_DEADLINE_H_
+#define TASK_DEADLINE_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/* Constants */
+
+/* Largest decimation applied by the decimate policy */
+const uint8_t TASK_DEADLINE_MAX_DECIMATION = 16;
+
+
+/* Types */
+
+/**
+ * Action taken when the user task overruns its period
+ * a given number of consecutive times:
+ * - count: only update the statistics.
+ * - decimate: double the number of periods between two user task calls,
+ *   up to TASK_DEADLINE_MAX_DECIMATION. Data dispatch and safety still
+ *   run every period.
+ * - callback: call a user function once, in the critical task context,
+ *   typically to switch the application to an error mode.
+ */
+typedef enum
+{
+	overrun_policy_count,
+	overrun_policy_decimate,
+	overrun_policy_callback
+} task_overrun_policy_t;
+
+typedef void (*task_overrun_callback_t)();
+
+typedef struct
+{
+	uint32_t period_cycles;        /* Expected period between task starts */
+	uint32_t ticks;                /* Number of task starts */
+	uint32_t overruns;             /* Executions ending after the next tick */
+	uint32_t missed_ticks;         /* Ticks lost because of overruns */
+	uint32_t max_jitter_cycles;    /* Worst start deviation from a tick */
+	uint32_t max_execution_cycles; /* Worst duration from start to end */
+	uint8_t  decimation;           /* Periods between two user task calls */
+	bool     tripped;              /* Callback policy was triggered */
+} task_deadline_stats_t;
+
+
+/* API */
+
+/**
+ * @brief Clear the statistics and set the expected period.
+ *        Escalation policy is kept.
+ *
+ * @param period_cycles Task period in timestamp units.
+ */
+void task_deadline_init(uint32_t period_cycles);
+
+/**
+ * @brief Define the action taken on overruns.
+ *
+ * @param policy Action to take.
+ * @param consecutive_overruns Number of consecutive overruns that
+ *        trigger the action, 0 is treated as 1.
+ * @param callback Function called by the callback policy.
+ *
+ * @return 0 if the policy was set, -1 if callback policy has no callback.
+ */
+int8_t task_deadline_set_policy(task_overrun_policy_t policy,
+								uint8_t consecutive_overruns,
+								task_overrun_callback_t callback);
+
+/**
+ * @brief  Record the start of a task period.
+ *
+ * @param  timestamp Start time in timestamp units.
+ * @return true if the user task must be run during this period,
+ *         false if it is skipped because of decimation.
+ */
+bool task_deadline_start(uint32_t timestamp);
+
+/**
+ * @brief Record the end of a task period and apply the policy on overrun.
+ *
+ * @param timestamp End time in timestamp units.
+ * @param next_tick_pending true if the interrupt source already signaled
+ *        the next period, i.e. the task lasted longer than its period.
+ */
+void task_deadline_end(uint32_t timestamp, bool next_tick_pending);
+
+/**
+ * @brief Clear the statistics, return to no decimation and clear trip.
+ */
+void task_deadline_reset();
+
+/**
+ * @brief  Obtain a pointer to the statistics.
+ *         Copies must be done with the critical task masked.
+ */
+const task_deadline_stats_t* task_deadline_get_stats();
+
+
+#endif /* TASK_DEADLINE_H_ */
@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+
+/* Current file header */
+#include "task_profiling.h"
+
+
+/**
+ *  Local variables
+ */
+
+/* First sections are the critical task proxy ones */
+static task_profiling_section_t sections[TASK_PROFILING_MAX_SECTIONS] =
+{
+	{ .name = "dispatch" },
+	{ .name = "safety" },
+	{ .name = "user_task" },
+};
+
+static uint8_t sections_count = TASK_PROFILING_SECTION_USER_TASK + 1;
+
+
+/**
+ * Public API
+ */
+
+void task_profiling_init()
+{
+#ifndef TASK_PROFILING_HOST_CLOCK
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+}
+
+int8_t task_profiling_define_section(const char* name)
+{
+	if (sections_count >= TASK_PROFILING_MAX_SECTIONS)
+		return -1;
+
+	sections[sections_count].name = name;
+
+	return sections_count++;
+}
+
+void task_profiling_record(int8_t section, uint32_t cycles)
+{
+	if ( (section < 0) || (section >= sections_count) )
+		return;
+
+	task_profiling_section_t* stats = &sections[section];
+
+	if ( (stats->count == 0) || (cycles < stats->min_cycles) )
+	{
+		stats->min_cycles = cycles;
+	}
+	if (cycles > stats->max_cycles)
+	{
+		stats->max_cycles = cycles;
+	}
+	stats->total_cycles += cycles;
+	stats->count++;
+
+	/* Bin is the index of the most significant bit */
+	uint8_t bin = 0;
+	if (cycles != 0)
+	{
+		bin = 31 - __builtin_clz(cycles);
+	}
+	if (bin >= TASK_PROFILING_HISTOGRAM_BINS)
+	{
+		bin = TASK_PROFILING_HISTOGRAM_BINS - 1;
+	}
+	stats->histogram[bin]++;
+}
+
+void task_profiling_reset()
+{
+	for (uint8_t section = 0 ; section < sections_count ; section++)
+	{
+		task_profiling_section_t* stats = &sections[section];
+
+		stats->count        = 0;
+		stats->min_cycles   = 0;
+		stats->max_cycles   = 0;
+		stats->total_cycles = 0;
+		for (uint8_t bin = 0 ; bin < TASK_PROFILING_HISTOGRAM_BINS ; bin++)
+		{
+			stats->histogram[bin] = 0;
+		}
+	}
+}
+
+uint8_t task_profiling_get_sections_count()
+{
+	return sections_count;
+}
+
+const task_profiling_section_t* task_profiling_get_section(uint8_t section)
+{
+	if (section >= sections_count)
+		return nullptr;
+
+	return &sections[section];
+}
+
+uint32_t task_profiling_get_frequency()
+{
+#ifdef TASK_PROFILING_HOST_CLOCK
+	return 1000000000;
+#else
+	return SystemCoreClock;
+#endif
+}
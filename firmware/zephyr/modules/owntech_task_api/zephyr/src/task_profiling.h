@@ -0,0 +1,177 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief Critical task profiling: execution time statistics of code
+ * sections, measured with the DWT cycle counter.
+ *
+ * Sections are delimited with TASK_PROFILING_START() and
+ * TASK_PROFILING_END(), which expand to nothing when profiling is
+ * disabled in Kconfig. Statistics functions themselves do not depend
+ * on the hardware: defining TASK_PROFILING_HOST_CLOCK uses a host
+ * steady clock instead of the cycle counter.
+ */
+
+#ifndef TASK_PROFILING_H_
+#define TASK_PROFILING_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+#ifdef TASK_PROFILING_HOST_CLOCK
+#include <chrono>
+#else
+#include <soc.h>
+#endif
+
+
+/* Constants */
+
+#ifdef CONFIG_OWNTECH_TASK_PROFILING_MAX_SECTIONS
+const uint8_t TASK_PROFILING_MAX_SECTIONS =
+									CONFIG_OWNTECH_TASK_PROFILING_MAX_SECTIONS;
+#else
+const uint8_t TASK_PROFILING_MAX_SECTIONS = 8;
+#endif
+
+/**
+ * Histogram bin i holds the durations in [2^i, 2^(i+1)) cycles,
+ * except first bin which also holds 0 and last bin which holds
+ * all longer durations.
+ */
+const uint8_t TASK_PROFILING_HISTOGRAM_BINS = 16;
+
+/* Sections wrapped by the critical task proxy */
+const int8_t TASK_PROFILING_SECTION_DISPATCH  = 0;
+const int8_t TASK_PROFILING_SECTION_SAFETY    = 1;
+const int8_t TASK_PROFILING_SECTION_USER_TASK = 2;
+
+
+/* Types */
+
+typedef struct
+{
+	const char* name;
+	uint32_t    count;
+	uint32_t    min_cycles;
+	uint32_t    max_cycles;
+	uint64_t    total_cycles;
+	uint32_t    histogram[TASK_PROFILING_HISTOGRAM_BINS];
+} task_profiling_section_t;
+
+
+/* Timestamps */
+
+#ifdef TASK_PROFILING_HOST_CLOCK
+
+/* Host timestamps are nanoseconds */
+inline uint32_t task_profiling_get_timestamp()
+{
+	auto now = std::chrono::steady_clock::now().time_since_epoch();
+	return (uint32_t)
+		std::chrono::duration_cast<std::chrono::nanoseconds>(now).count();
+}
+
+#else
+
+__STATIC_INLINE uint32_t task_profiling_get_timestamp()
+{
+	return DWT->CYCCNT;
+}
+
+#endif
+
+
+/* Instrumentation points */
+
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_PROFILING
+
+#define TASK_PROFILING_START(section) \
+	uint32_t task_profiling_start_##section = task_profiling_get_timestamp()
+
+#define TASK_PROFILING_END(section) \
+	task_profiling_record(section, \
+						  task_profiling_get_timestamp() - \
+						  task_profiling_start_##section)
+
+#else
+
+#define TASK_PROFILING_START(section)
+#define TASK_PROFILING_END(section)
+
+#endif
+
+
+/* API */
+
+/**
+ * @brief Start the counter used for timestamps.
+ */
+void task_profiling_init();
+
+/**
+ * @brief  Define a new profiling section.
+ *
+ * @param  name Name of the section, must remain valid.
+ * @return Section number, or -1 if all sections are used.
+ */
+int8_t task_profiling_define_section(const char* name);
+
+/**
+ * @brief  Add a section execution duration to statistics.
+ *         Invalid section numbers are ignored.
+ *
+ * @param  section Section number.
+ * @param  cycles Duration in timestamp units.
+ */
+void task_profiling_record(int8_t section, uint32_t cycles);
+
+/**
+ * @brief Clear the statistics of all sections.
+ */
+void task_profiling_reset();
+
+/**
+ * @brief  Obtain the number of defined sections, including
+ *         the critical task proxy ones.
+ */
+uint8_t task_profiling_get_sections_count();
+
+/**
+ * @brief  Obtain a pointer to a section statistics.
+ *         Copies must be done with the critical task masked.
+ *
+ * @param  section Section number.
+ * @return Section statistics or nullptr if section is not defined.
+ */
+const task_profiling_section_t* task_profiling_get_section(uint8_t section);
+
+/**
+ * @brief  Obtain the frequency of the timestamps.
+ *
+ * @return Number of timestamp units per second.
+ */
+uint32_t task_profiling_get_frequency();
+
+
+#endif /* TASK_PROFILING_H_ */
@@ -0,0 +1,192 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ */
+
+
+
+/* Current file header */
+#include "task_subtasks.h"
+
+/* Current module */
+#include "task_profiling.h"
+
+
+/**
+ *  Local variables
+ */
+
+static task_subtask_function_t functions[TASK_SUBTASKS_MAX] = {nullptr};
+static task_subtask_stats_t stats[TASK_SUBTASKS_MAX] = {};
+
+/* Periods left before next call of each sub-task */
+static uint16_t countdowns[TASK_SUBTASKS_MAX] = {0};
+
+static uint8_t subtasks_count = 0;
+
+
+/**
+ * Private functions
+ */
+
+static uint16_t _task_subtasks_gcd(uint16_t a, uint16_t b)
+{
+	while (b != 0)
+	{
+		uint16_t remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+
+	return a;
+}
+
+/**
+ * Two sub-tasks (d1, p1) and (d2, p2) run on the same period whenever
+ * p1 and p2 are congruent modulo gcd(d1, d2). In that case, a fraction
+ * gcd(d1, d2) / d2 of the runs of the first one collides with the
+ * second one: the phase with the lowest sum of these fractions is kept.
+ */
+static uint16_t _task_subtasks_choose_phase(uint16_t divider)
+{
+	uint16_t best_phase = 0;
+	uint32_t best_cost = UINT32_MAX;
+
+	for (uint16_t phase = 0 ; phase < divider ; phase++)
+	{
+		uint32_t cost = 0;
+
+		for (uint8_t other = 0 ; other < subtasks_count ; other++)
+		{
+			uint16_t other_divider = stats[other].divider;
+			if (other_divider == 1)
+				continue;
+
+			uint16_t gcd = _task_subtasks_gcd(divider, other_divider);
+			if ( (phase % gcd) == (stats[other].phase % gcd) )
+			{
+				cost += ((uint32_t)gcd << 16) / other_divider;
+			}
+		}
+
+		if (cost < best_cost)
+		{
+			best_cost = cost;
+			best_phase = phase;
+		}
+	}
+
+	return best_phase;
+}
+
+
+/**
+ * Public API
+ */
+
+int8_t task_subtasks_add(task_subtask_function_t function,
+						 uint16_t divider,
+						 uint32_t budget_cycles)
+{
+	if ( (function == nullptr) || (divider == 0) )
+		return -1;
+
+	if (subtasks_count >= TASK_SUBTASKS_MAX)
+		return -1;
+
+	uint8_t sub_task = subtasks_count;
+
+	stats[sub_task] = {};
+	stats[sub_task].divider       = divider;
+	stats[sub_task].phase         = _task_subtasks_choose_phase(divider);
+	stats[sub_task].budget_cycles = budget_cycles;
+
+	countdowns[sub_task] = stats[sub_task].phase;
+	functions[sub_task]  = function;
+
+	subtasks_count++;
+
+	return sub_task;
+}
+
+void task_subtasks_run()
+{
+	for (uint8_t sub_task = 0 ; sub_task < subtasks_count ; sub_task++)
+	{
+		if (countdowns[sub_task] != 0)
+		{
+			countdowns[sub_task]--;
+			continue;
+		}
+
+		task_subtask_stats_t* sub_task_stats = &stats[sub_task];
+		countdowns[sub_task] = sub_task_stats->divider - 1;
+
+		uint32_t start = task_profiling_get_timestamp();
+		functions[sub_task]();
+		uint32_t cycles = task_profiling_get_timestamp() - start;
+
+		sub_task_stats->count++;
+		sub_task_stats->total_cycles += cycles;
+		if (cycles > sub_task_stats->max_cycles)
+		{
+			sub_task_stats->max_cycles = cycles;
+		}
+		if ( (sub_task_stats->budget_cycles != 0) &&
+			 (cycles > sub_task_stats->budget_cycles) )
+		{
+			sub_task_stats->budget_overruns++;
+		}
+	}
+}
+
+void task_subtasks_restart()
+{
+	for (uint8_t sub_task = 0 ; sub_task < subtasks_count ; sub_task++)
+	{
+		countdowns[sub_task] = stats[sub_task].phase;
+	}
+}
+
+void task_subtasks_reset_stats()
+{
+	for (uint8_t sub_task = 0 ; sub_task < subtasks_count ; sub_task++)
+	{
+		stats[sub_task].count           = 0;
+		stats[sub_task].max_cycles      = 0;
+		stats[sub_task].total_cycles    = 0;
+		stats[sub_task].budget_overruns = 0;
+	}
+}
+
+uint8_t task_subtasks_get_count()
+{
+	return subtasks_count;
+}
+
+const task_subtask_stats_t* task_subtasks_get_stats(uint8_t sub_task)
+{
+	if (sub_task >= subtasks_count)
+		return nullptr;
+
+	return &stats[sub_task];
+}
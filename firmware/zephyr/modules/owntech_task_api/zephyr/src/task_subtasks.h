@@ -0,0 +1,121 @@
+/*
+ *
+ * Copyright (c) 2021-2024 LAAS-CNRS
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 2.1 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * SPDX-License-Identifier: LGPL-2.1
+ */
+
+/*
+ * @date   2024
+ *
+ * @brief Critical sub-tasks: functions run by the critical task every
+ * N periods, N being an integer divider of the critical task period.
+ *
+ * Each sub-task is given a phase when it is added, so that sub-tasks
+ * with the same or related dividers run on different periods when
+ * possible instead of all on the first one. Execution time of each
+ * sub-task is compared to an optional budget.
+ *
+ * The table does not depend on the hardware: timestamps are provided
+ * by task_profiling_get_timestamp().
+ */
+
+#ifndef TASK_SUBTASKS_H_
+#define TASK_SUBTASKS_H_
+
+
+/* Stdlib */
+#include <stdint.h>
+
+
+/* Constants */
+
+#ifdef CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS
+const uint8_t TASK_SUBTASKS_MAX = CONFIG_OWNTECH_TASK_MAX_CRITICAL_SUBTASKS;
+#else
+const uint8_t TASK_SUBTASKS_MAX = 4;
+#endif
+
+
+/* Types */
+
+typedef void (*task_subtask_function_t)();
+
+typedef struct
+{
+	uint16_t divider;         /* Run every divider critical periods */
+	uint16_t phase;           /* Run on periods where count % divider == phase */
+	uint32_t count;           /* Number of executions */
+	uint32_t max_cycles;      /* Worst execution time */
+	uint64_t total_cycles;    /* Sum of execution times */
+	uint32_t budget_cycles;   /* Allowed execution time, 0 if none */
+	uint32_t budget_overruns; /* Executions longer than the budget */
+} task_subtask_stats_t;
+
+
+/* API */
+
+/**
+ * @brief  Add a sub-task to the table.
+ *
+ *         The phase is chosen to minimize the number of other sub-tasks
+ *         run on the same periods. Sub-tasks with a divider of 1 run on
+ *         every period and are not considered.
+ *
+ * @param  function Function to call.
+ * @param  divider Number of critical periods between two calls, at least 1.
+ * @param  budget_cycles Allowed execution time in timestamp units,
+ *         0 for no budget.
+ * @return Sub-task number, or -1 if the table is full or a parameter
+ *         is invalid.
+ */
+int8_t task_subtasks_add(task_subtask_function_t function,
+						 uint16_t divider,
+						 uint32_t budget_cycles);
+
+/**
+ * @brief Call the sub-tasks due on this period, in the order they were
+ *        added, then move to the next period.
+ */
+void task_subtasks_run();
+
+/**
+ * @brief Restart the periods count, so that phases are kept
+ *        relative to the next call to task_subtasks_run().
+ */
+void task_subtasks_restart();
+
+/**
+ * @brief Clear the execution statistics of all sub-tasks.
+ */
+void task_subtasks_reset_stats();
+
+/**
+ * @brief  Obtain the number of sub-tasks.
+ */
+uint8_t task_subtasks_get_count();
+
+/**
+ * @brief  Obtain a pointer to a sub-task statistics.
+ *         Copies must be done with the critical task masked.
+ *
+ * @param  sub_task Sub-task number.
+ * @return Statistics or nullptr if the sub-task does not exist.
+ */
+const task_subtask_stats_t* task_subtasks_get_stats(uint8_t sub_task);
+
+
+#endif /* TASK_SUBTASKS_H_ */
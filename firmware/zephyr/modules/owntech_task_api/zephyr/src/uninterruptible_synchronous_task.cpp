@@ -26,6 +26,9 @@
 
 /* Current module */
 #include "scheduling_common.h"
+#include "task_profiling.h"
+#include "task_deadline.h"
+#include "task_subtasks.h"
 
 /* OwnTech Power API */
 #include "timer.h"
@@ -67,11 +70,30 @@ static task_function_t user_periodic_task = NULL;
 static bool do_data_dispatch = false;
 static uint32_t task_period = 0;
 
+/* For ADC DMA interrupts: ADC 1 dispatches between two task calls */
+static uint32_t dma_repetition = 0;
+
 /* Safety */
 static bool safety_alert = false;
 
 /* Private API */
 
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+/**
+ * Interrupt flags are cleared before calling the proxy: a flag set again
+ * at the end of the proxy means the next period has already started.
+ */
+static bool _is_next_tick_pending()
+{
+	if (interrupt_source == source_tim6)
+	{
+		return timer_is_pending(timer6) != 0;
+	}
+
+	return hrtim_PeriodicEvent_is_pending(MSTR) != 0;
+}
+#endif
+
 #ifdef CONFIG_OWNTECH_SAFETY_API
 void thread_error(void *, void *, void *)
 {
@@ -106,9 +128,17 @@ void thread_error(void *, void *, void *)
 
 void user_task_proxy()
 {
+	bool run_user_task = true;
+
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	run_user_task = task_deadline_start(task_profiling_get_timestamp());
+#endif
+
 #ifdef CONFIG_OWNTECH_SAFETY_API
 
+	TASK_PROFILING_START(TASK_PROFILING_SECTION_SAFETY);
 	if (safety_task() != 0) safety_alert = true;
+	TASK_PROFILING_END(TASK_PROFILING_SECTION_SAFETY);
 
 #endif
 
@@ -116,10 +146,40 @@ void user_task_proxy()
 
 	if (do_data_dispatch == true)
 	{
+		TASK_PROFILING_START(TASK_PROFILING_SECTION_DISPATCH);
 		spin.data.doFullDispatch();
+		TASK_PROFILING_END(TASK_PROFILING_SECTION_DISPATCH);
+	}
+
+	if (run_user_task == true)
+	{
+		TASK_PROFILING_START(TASK_PROFILING_SECTION_USER_TASK);
+		user_periodic_task();
+		TASK_PROFILING_END(TASK_PROFILING_SECTION_USER_TASK);
+
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS
+		task_subtasks_run();
+#endif
 	}
 
-	user_periodic_task();
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	bool next_tick_pending;
+	if (interrupt_source == source_adc_dma)
+	{
+		/**
+		 * DMA flags are also cleared before the dispatch, but a pending
+		 * buffer only means a missed tick when each one calls the task.
+		 */
+		next_tick_pending = (dma_repetition == 1) &&
+							spin.data.isDispatchCallbackPending();
+	}
+	else
+	{
+		next_tick_pending = _is_next_tick_pending();
+	}
+
+	task_deadline_end(task_profiling_get_timestamp(), next_tick_pending);
+#endif
 }
 
 /* Public API */
@@ -185,6 +245,31 @@ int8_t scheduling_define_uninterruptible_synchronous_task(
 
 		return 0;
 	}
+	else if (interrupt_source == source_adc_dma)
+	{
+		/* ADC 1 is expected to be triggered once per HRTIM period */
+		uint32_t hrtim_period_us = hrtim_period_Master_get_us();
+
+		if (hrtim_period_us == 0)
+			return -1;
+
+		if (task_period_us % hrtim_period_us != 0)
+			return -1;
+
+		uint32_t repetition = task_period_us / hrtim_period_us;
+
+		if (repetition == 0)
+			return -1;
+
+		/* Callback is registered on start, as it requires data to be started */
+		task_period = task_period_us;
+		dma_repetition = repetition;
+		user_periodic_task = periodic_task;
+
+		uninterruptibleTaskStatus = task_status_t::defined;
+
+		return 0;
+	}
 
 	return -1;
 }
@@ -199,6 +284,46 @@ void scheduling_start_uninterruptible_synchronous_task(
 	if (interrupt_source == scheduling_interrupt_source_t::source_uninitialized)
 		return;
 
+#if defined(CONFIG_OWNTECH_TASK_ENABLE_PROFILING) || \
+	defined(CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR) || \
+	defined(CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS)
+	task_profiling_init();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_CRITICAL_SUBTASKS
+	task_subtasks_restart();
+#endif
+
+#ifdef CONFIG_OWNTECH_TASK_ENABLE_DEADLINE_MONITOR
+	task_deadline_init(task_period * (SystemCoreClock / 1000000));
+#endif
+
+	if (interrupt_source == source_adc_dma)
+	{
+		/**
+		 * Task is called by data dispatch on DMA interrupt:
+		 * no dispatch to do in the task.
+		 */
+		if ( (manage_data_acquisition == true) && (spin.data.started() == false) )
+		{
+			spin.data.setDispatchMethod(DispatchMethod_t::on_dma_interrupt);
+			spin.data.start();
+		}
+
+		if ( (spin.data.started() == false) ||
+			 (spin.data.dispatch_method != DispatchMethod_t::on_dma_interrupt) )
+			return;
+
+		if (spin.data.setDispatchCallback(ADC_1,
+										  user_task_proxy,
+										  dma_repetition) != 0)
+			return;
+
+		uninterruptibleTaskStatus = task_status_t::running;
+
+		return;
+	}
+
 	if ( (manage_data_acquisition == true) && (spin.data.started() == false) )
 	{
 		/**
@@ -269,6 +394,12 @@ void scheduling_stop_uninterruptible_synchronous_task()
 	{
 		hrtim_PeriodicEvent_dis(MSTR);
 
+		uninterruptibleTaskStatus = task_status_t::suspended;
+	}
+	else if (interrupt_source == source_adc_dma)
+	{
+		spin.data.setDispatchCallback(ADC_1, nullptr, 0);
+
 		uninterruptibleTaskStatus = task_status_t::suspended;
 	}
 }
@@ -37,9 +37,10 @@
  * @brief Set the interrupt source used for the uninterruptible synchronous task.
  *
  * This determines whether the task will be triggered using a hardware timer
- * (e.g., TIM6) or HRTIM. Must be called before defining the task.
+ * (e.g., TIM6), HRTIM or ADC DMA. Must be called before defining the task.
  *
- * @param int_source Interrupt source to use (e.g., source_tim6 or source_hrtim).
+ * @param int_source Interrupt source to use (e.g., source_tim6, source_hrtim
+ *                   or source_adc_dma).
  */
 void scheduling_set_uninterruptible_synchronous_task_interrupt_source(
                                     scheduling_interrupt_source_t int_source);
@@ -55,6 +56,9 @@ void scheduling_set_uninterruptible_synchronous_task_interrupt_source(
  * 
  * - For `HRTIM`: configures a periodic event tied to the HRTIM master period.
  *
+ * - For ADC DMA: computes the number of ADC 1 dispatches per period, ADC 1
+ *   being triggered once per HRTIM master period.
+ *
  * @param periodic_task Pointer to the task function (must not be `NULL`).
  * @param task_period_us Task execution period in microseconds.
  *
@@ -71,6 +75,8 @@ int8_t scheduling_define_uninterruptible_synchronous_task(
  * Enables the periodic task previously defined using the selected interrupt 
  * source. Optionally starts data acquisition if not already active and 
  * configures it for external triggering and synchronized dispatching.
+ * With ADC DMA source, data acquisition is configured for dispatch on DMA
+ * interrupt instead, and the task is registered as the dispatch callback.
  *
  * @param manage_data_acquisition Set to `true` if data acquisition should 
  *                              be managed automatically during task execution.
@@ -81,7 +87,8 @@ void scheduling_start_uninterruptible_synchronous_task(
 /**
  * @brief Stop the currently running uninterruptible synchronous task.
  *
- * Disables the interrupt source triggering the task (either `TIM6` or `HRTIM`)
+ * Disables the interrupt source triggering the task (`TIM6`, `HRTIM` or the
+ * ADC DMA dispatch callback)
  * and updates the task status accordingly.
  */
 void scheduling_stop_uninterruptible_synchronous_task();
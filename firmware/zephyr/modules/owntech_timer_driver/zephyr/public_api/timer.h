@@ -170,6 +170,18 @@ typedef void     (*timer_api_stop)     (const struct device* dev);
  */
 typedef uint32_t (*timer_api_get_count)(const struct device* dev);
 
+/**
+ * @brief Function pointer type for reading the timer pending update flag.
+ *
+ * This function tells if an update event occurred and has not been
+ * handled yet by the timer interrupt.
+ *
+ * @param dev Pointer to the timer device.
+ *
+ * @return 1 if an update event is pending, 0 otherwise.
+ */
+typedef uint32_t (*timer_api_is_pending)(const struct device* dev);
+
 /**
  * @brief Driver API structure for timer devices.
  *
@@ -184,16 +196,19 @@ typedef uint32_t (*timer_api_get_count)(const struct device* dev);
  *
  * - `get_count` retrieves the current timer counter value.
  *
+ * - `is_pending` tells if an update event is waiting to be handled.
+ *
  * This structure is registered as a Zephyr subsystem using the
  * `__subsystem` keyword.
  *
  */
 __subsystem struct timer_driver_api
 {
-	timer_api_config    config;
-	timer_api_start     start;
-	timer_api_stop      stop;
-	timer_api_get_count get_count;
+	timer_api_config     config;
+	timer_api_start      start;
+	timer_api_stop       stop;
+	timer_api_get_count  get_count;
+	timer_api_is_pending is_pending;
 };
 
 
@@ -258,6 +273,23 @@ static inline uint32_t timer_get_count(const struct device* dev)
 	return api->get_count(dev);
 }
 
+/**
+ * @brief Check if an update event of the timer is pending.
+ *
+ * When called at the end of the timer interrupt callback, a pending
+ * event means the callback ran longer than the timer period.
+ *
+ * @param  dev Zephyr device representing the timer.
+ * @return     1 if an update event is pending, 0 otherwise.
+ */
+static inline uint32_t timer_is_pending(const struct device* dev)
+{
+	const struct timer_driver_api* api =
+								(const struct timer_driver_api*)(dev->api);
+
+	return api->is_pending(dev);
+}
+
 
 #ifdef __cplusplus
 }
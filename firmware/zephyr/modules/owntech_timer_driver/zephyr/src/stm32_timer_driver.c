@@ -85,10 +85,11 @@ static void timer_stm32_callback(const void* arg)
 /** @brief Defines a structure to hold the timer functions   */
 static const struct timer_driver_api timer_funcs =
 {
-	.config    = timer_stm32_config,
-	.start     = timer_stm32_start,
-	.stop      = timer_stm32_stop,
-	.get_count = timer_stm32_get_count
+	.config     = timer_stm32_config,
+	.start      = timer_stm32_start,
+	.stop       = timer_stm32_stop,
+	.get_count  = timer_stm32_get_count,
+	.is_pending = timer_stm32_is_pending
 };
 
 void timer_stm32_config(const struct device* dev,
@@ -329,6 +330,17 @@ uint32_t timer_stm32_get_count(const struct device* dev)
 	return LL_TIM_GetCounter(tim_dev);
 }
 
+uint32_t timer_stm32_is_pending(const struct device* dev)
+{
+	TIM_TypeDef* tim_dev =
+				((struct stm32_timer_driver_data*)dev->data)->timer_struct;
+
+	if (tim_dev == NULL)
+		return 0;
+
+	return LL_TIM_IsActiveFlag_UPDATE(tim_dev);
+}
+
 /* Per-timer inits */
 
  void init_timer_3()
@@ -155,6 +155,14 @@ void timer_stm32_stop(const struct device* dev);
  */
 uint32_t timer_stm32_get_count(const struct device* dev);
 
+/**
+ * @brief Check the update flag of the timer.
+ *
+ * @param dev Pointer to the timer device.
+ * @return 1 if the update flag is set, 0 otherwise.
+ */
+uint32_t timer_stm32_is_pending(const struct device* dev);
+
 /**
  * @brief Clear the timer counter.
  *